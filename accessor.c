@@ -7,6 +7,8 @@
 #include <fcntl.h>          // open
 #include <errno.h>          // errno_t
 #include <limits.h>         // CHAR_BIT
+#include <time.h>           // clock_gettime
+#include <sys/resource.h>   // getrusage
 
 // if ACCESSOR_USE_MMAP is true, accessor will try mapping data in memory instead of reading it.
 #if defined(TARGET_MSYS) && TARGET_MSYS
@@ -16,7 +18,21 @@
 #endif
 
 #if ACCESSOR_USE_MMAP
-#include <sys/mman.h>       // mmap, munmap
+#include <sys/mman.h>       // mmap, munmap, shm_open
+#endif
+
+#if defined(__linux__)
+#include <sys/syscall.h>    // SYS_memfd_create
+#endif
+
+// if ACCESSOR_PROBES is true, USDT probes of provider "accessor" are placed on open, close, grow, mmap... (see ACCESSOR_PROBE below)
+// probes are usable with bpftrace, perf or systemtap. an untraced probe costs a nop instruction
+#ifndef ACCESSOR_PROBES
+#define ACCESSOR_PROBES                     0
+#endif
+
+#if ACCESSOR_PROBES
+#include <sys/sdt.h>        // DTRACE_PROBE, from systemtap
 #endif
 
 #if CHAR_BIT != 8
@@ -35,7 +51,7 @@
 // maximum read() transfer size. 1 GB seems safe as 2 GB leads to EINVAL errors, Linux limit is just under 2 GB
 #define ACCESSOR_FILE_READ_SIZE_LIMIT       (1 * GB)
 
-// file read accessors with a window smaller than ACCESSOR_MMAP_MIN_FILESIZE will not be mapped but read in memory.
+// file read accessors with a window smaller than ACCESSOR_MMAP_MIN_FILESIZE will not be mapped but read in memory. can be changed at run time, see accessorSetMmapMinFileSize()
 #ifndef ACCESSOR_MMAP_MIN_FILESIZE
 #define ACCESSOR_MMAP_MIN_FILESIZE          (16 * 1024)
 #endif
@@ -43,6 +59,102 @@
 // helper to select a value in 32/64 bit code
 #define ACCESSOR_SELECT_32_64(X32, X64)     ((sizeof (void *) * CHAR_BIT < 64) ? (X32) : (X64))
 
+// hint the processor that memory at address p will soon be accessed
+#if defined(__GNUC__) || defined(__llvm__)
+#define ACCESSOR_PREFETCH(p)                __builtin_prefetch(p)
+#else
+#define ACCESSOR_PREFETCH(p)                ((void) (p))
+#endif
+
+// memory budget counters are shared among all threads
+#if defined(__GNUC__) || defined(__llvm__)
+#define ACCESSOR_ATOMIC_ADD(p, x)           __atomic_add_fetch(p, x, __ATOMIC_RELAXED)
+#define ACCESSOR_ATOMIC_SUB(p, x)           __atomic_sub_fetch(p, x, __ATOMIC_RELAXED)
+#define ACCESSOR_ATOMIC_LOAD(p)             __atomic_load_n(p, __ATOMIC_RELAXED)
+#define ACCESSOR_ATOMIC_MAX(p, x)           do { size_t _old = __atomic_load_n(p, __ATOMIC_RELAXED); while (_old < (x) && !__atomic_compare_exchange_n(p, &_old, x, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED)); } while (0)
+#else
+#define ACCESSOR_ATOMIC_ADD(p, x)           (*(p) += (x))
+#define ACCESSOR_ATOMIC_SUB(p, x)           (*(p) -= (x))
+#define ACCESSOR_ATOMIC_LOAD(p)             (*(p))
+#define ACCESSOR_ATOMIC_MAX(p, x)           do { if (*(p) < (x)) *(p) = (x); } while (0)
+#endif
+
+// index files
+#define ACCESSOR_INDEX_MAGIC                "accindex"
+#define ACCESSOR_INDEX_VERSION              1
+#define ACCESSOR_INDEX_BYTE_ORDER_MARK      0x01020304
+
+#if defined(__APPLE__)
+#define ACCESSOR_STAT_MTIME_NSEC(st)        ((st).st_mtimespec.tv_nsec)
+#else
+#define ACCESSOR_STAT_MTIME_NSEC(st)        ((st).st_mtim.tv_nsec)
+#endif
+
+// null write accessors scratch buffer size, large enough for any number or varint
+#define ACCESSOR_NULL_SCRATCH_SIZE              16
+
+// accessorApplyRelocations prefetches relocated fields this many table entries ahead
+#define ACCESSOR_RELOCATION_PREFETCH_DISTANCE   16
+
+// USDT probes, offsets are root offsets (see accessorRootWindowOffset()):
+//  open_file(path, rootOffset, size, isMapped)         read file accessor opened
+//  open_write_file(path, initialAllocation)            write file accessor opened
+//  open_memory(size, writeEnabled)                     memory accessor opened
+//  open_sub(rootOffset, size)                          sub-accessor opened
+//  close(rootOffset, size, isBaseAccessor)             accessor closed, not only dereferenced
+//  grow(oldSize, newSize)                              write accessor size increased
+//  realloc(oldAllocation, newAllocation, moved)        write accessor data reallocated
+//  mmap(rootOffset, size)                              file data mapped, rootOffset and size are page aligned
+//  munmap(rootOffset, size)                            file data unmapped
+//  coverage_summarize(recordCount, mergedRecordCount)  coverage records sorted and merged
+//  write_back(fileDescriptor, rootOffset, size)        write accessor data written to file, by accessorClose() or accessorWriteToFile()
+#if ACCESSOR_PROBES
+#define ACCESSOR_PROBE2(name, x1, x2)               DTRACE_PROBE2(accessor, name, x1, x2)
+#define ACCESSOR_PROBE3(name, x1, x2, x3)           DTRACE_PROBE3(accessor, name, x1, x2, x3)
+#define ACCESSOR_PROBE4(name, x1, x2, x3, x4)       DTRACE_PROBE4(accessor, name, x1, x2, x3, x4)
+#else
+#define ACCESSOR_PROBE2(name, x1, x2)               ((void) 0)
+#define ACCESSOR_PROBE3(name, x1, x2, x3)           ((void) 0)
+#define ACCESSOR_PROBE4(name, x1, x2, x3, x4)       ((void) 0)
+#endif
+
+// if ACCESSOR_STATISTICS is true, base accessors count calls, bytes, grows... see accessorGetStats()
+#ifndef ACCESSOR_STATISTICS
+#define ACCESSOR_STATISTICS                     0
+#endif
+
+#if ACCESSOR_STATISTICS
+#define ACCESSOR_STATS_ADD(a, field, n)         ((a)->baseAccessor->stats.field += (n))
+#define ACCESSOR_STATS_WRITE(a, family, n)      accessorPrivateStatsTransfer(&(a)->baseAccessor->stats.bytesWritten, a, family, n)
+#else
+#define ACCESSOR_STATS_ADD(a, field, n)         ((void) 0)
+#define ACCESSOR_STATS_WRITE(a, family, n)      ((void) 0)
+#endif
+
+// if ACCESSOR_TRACING is true, reads of accessors with a trace are recorded, see accessorSetTrace()
+#ifndef ACCESSOR_TRACING
+#define ACCESSOR_TRACING                        0
+#endif
+
+// successful reads of n bytes, just after cursor moved, are counted by statistics and recorded by traces
+#if ACCESSOR_STATISTICS || ACCESSOR_TRACING
+#define ACCESSOR_HOOK_READ(a, family, n)        accessorPrivateHookRead(a, family, n)
+#else
+#define ACCESSOR_HOOK_READ(a, family, n)        ((void) 0)
+#endif
+
+// trace files
+#define ACCESSOR_TRACE_MAGIC                    "acctrace"
+#define ACCESSOR_TRACE_VERSION                  1
+#define ACCESSOR_TRACE_DEFAULT_BUFFER_SIZE      (1 * MB)
+
+// paths of opened files are built in a stack buffer, longer paths are allocated
+#define ACCESSOR_PATH_BUFFER_SIZE               1024
+
+// checkpoints
+#define ACCESSOR_CHECKPOINT_MAGIC               "accchkpt"
+#define ACCESSOR_CHECKPOINT_VERSION             1
+
 
 
 // private typedefs
@@ -57,22 +169,28 @@ typedef struct _accessor_t
     size_t availableBytes;              // in the [0, windowSize] range
     char isBaseAccessor;
     char writeEnabled;
-    struct _accessor_t * baseAccessor;  // "weak" reference, base accessor are their own base accessor
+    struct _accessor_t * baseAccessor;  // base accessors are their own base accessor. sub-accessors, at any depth, hold a "strong" reference incrementing base's referenceCount
 
     // for base accessor_t only
     uint8_t * data;                     // for readonly accessors, can't be moved/reallocated
     size_t dataMaxSize;                 // allocated or mapped memory segment size
     size_t dataFileOffset;              // offset of allocated or mapped memory in readonly file
+    size_t dataCharge;                  // bytes of data charged to the memory budget, 0 for mapped or caller's memory
     size_t granularity;
     char isMapped;
     char mayBeReallocated;
     char freeOnClose;
     int inputFileDescriptor;
     int outputFileDescriptor;
+    int sharedFileDescriptor;           // shared memory backing a shared write accessor's data, see accessorOpenWritingShared()
     char writeOnClose;
-
-    // for sub accessor_t only
-    struct _accessor_t * superAccessor; // "strong" reference incrementing super's referenceCount
+    char isNull;                        // null write accessor, data is only a scratch buffer. see accessorOpenWritingNull()
+#if ACCESSOR_STATISTICS
+    accessorStats stats;                // for this accessor and all its sub-accessors
+#endif
+#if ACCESSOR_TRACING
+    accessorTrace_t * trace;            // records reads of this accessor and all its sub-accessors, may be NULL
+#endif
 
     // common data for all accessor types
     accessorEndianness endianness;
@@ -87,10 +205,232 @@ typedef struct _accessor_t
     size_t coverageArrayAllocation;
     uintmax_t coverageUsage1;
     const void * coverageUsage2;
+
+    // for writeEnabled accessor_t only
+    struct _accessorPrivateSlot * slots;    // deferred fields, see accessorReserveSlot()
+    size_t slotCount;
+    size_t slotAllocation;
 } _accessor_t;
 
 
 
+typedef struct _accessorPrivateSlot
+{
+    size_t offset;                      // in accessor's window
+    uintmax_t value;
+    accessorEndianness endianness;
+    uint8_t nbytes;
+    char hasValue;
+} accessorPrivateSlot;
+
+
+
+// catalog entry, fixed width types so that catalog arrays may be saved and mapped as is
+typedef struct
+{
+    uint64_t nameOffset;                // in catalog's names pool
+    uint64_t nameLength;
+    uint64_t offset;
+    uint64_t size;
+} accessorPrivateCatalogEntry;
+
+// catalog hash table slot
+typedef struct
+{
+    uint32_t hash;                      // low 32 bits of the entry's name hash
+    uint32_t entry;                     // entry index + 1, 0 for empty slots
+} accessorPrivateCatalogSlot;
+
+typedef struct _accessorCatalog_t
+{
+    accessor_t * accessor;              // "strong" reference incrementing accessor's referenceCount
+    accessorPrivateCatalogEntry * entries;
+    size_t entryCount;
+    size_t entryAllocation;
+    uint8_t * names;                    // names pool, names aren't NUL terminated
+    size_t namesSize;
+    size_t namesAllocation;
+    accessorPrivateCatalogSlot * slots; // open addressing hash table, using linear probing
+    size_t slotCount;                   // a power of 2, 0 if slots isn't allocated yet
+    uint32_t * sortedEntries;           // entry indexes sorted by name, valid only if isSorted
+    size_t sortedAllocation;            // in entries, 0 if sortedEntries isn't allocated
+    char isSorted;
+    char isMapped;                      // entries, names and slots are used in place from an index file and can't be modified
+    char isSortedMapped;                // sortedEntries is used in place from an index file
+} _accessorCatalog_t;
+
+
+
+// index file header, followed by sections, followed by the section directory
+// all fields use native endianness
+typedef struct
+{
+    uint8_t magic[8];                   // ACCESSOR_INDEX_MAGIC
+    uint32_t version;                   // ACCESSOR_INDEX_VERSION
+    uint32_t byteOrderMark;             // ACCESSOR_INDEX_BYTE_ORDER_MARK, detects endianness mismatch
+    uint64_t sourceDevice;              // source file key, all 0 if source isn't a file
+    uint64_t sourceInode;
+    uint64_t sourceSize;
+    uint64_t sourceModificationSeconds;
+    uint64_t sourceModificationNanoseconds;
+    uint64_t sourceWindowOffset;        // as returned by accessorRootWindowOffset()
+    uint64_t sourceWindowSize;
+    uint64_t options;                   // accessorIndexOptions used when writing index
+    uint64_t contentHash;               // valid if options include accessorIndexOptionHashContent
+    uint64_t directoryOffset;
+    uint64_t sectionCount;
+} accessorPrivateIndexHeader;
+
+typedef struct
+{
+    uint32_t tag;
+    uint32_t reserved;                  // 0
+    uint64_t offset;                    // from start of index file, 8 bytes aligned
+    uint64_t size;
+} accessorPrivateIndexSection;
+
+// catalog section header, followed by entries, slots, sorted entries (if any, padded to 8 bytes) and names
+typedef struct
+{
+    uint64_t entryCount;
+    uint64_t slotCount;
+    uint64_t namesSize;
+    uint64_t isSorted;
+} accessorPrivateIndexCatalogHeader;
+
+typedef struct _accessorIndex_t
+{
+    accessor_t * accessor;              // index file content: a write accessor when writing, a read accessor when reading
+    accessorPrivateIndexHeader header;  // when writing only, the header being built
+    accessorPrivateIndexSection * sections;     // when writing only, the directory being built
+    size_t sectionCount;
+    size_t sectionAllocation;
+    const accessorPrivateIndexHeader * mappedHeader;    // when reading only
+    const accessorPrivateIndexSection * mappedSections; // when reading only
+} _accessorIndex_t;
+
+
+
+typedef struct _accessorRecordIndex_t
+{
+    accessor_t * accessor;              // stream, as a strong reference
+    accessor_t * record;                // sub-accessor of stream, rewindowed to each parsed record
+    size_t interval;
+    accessorStatus (* recordLength)(accessor_t * record, void * context, size_t * length);
+    void * context;
+    size_t * checkpoints;               // checkpoints[i] is the offset of record i * interval, for all i * interval <= parsedCount
+    size_t checkpointCount;
+    size_t checkpointAllocation;
+    size_t parsedCount;                 // count of records whose length is known
+    size_t parsedOffset;                // offset of record parsedCount, stream's size if the whole stream was parsed
+} _accessorRecordIndex_t;
+
+
+
+// memo entries are linked by their index + 1, 0 meaning none
+typedef struct
+{
+    uint64_t offset;                    // from the start of base accessor's data
+    uint64_t size;
+    uintmax_t decoderId;
+    uint64_t hash;
+    void * value;                       // NULL for unused entries
+    size_t cost;
+    void (* destroy)(void * value);
+    uint32_t hashNext;                  // next entry of same bucket, or next free entry
+    uint32_t lruPrevious;               // more recently used entry
+    uint32_t lruNext;                   // less recently used entry
+} accessorPrivateMemoEntry;
+
+typedef struct _accessorMemo_t
+{
+    accessor_t * accessor;              // stream, as a strong reference
+    size_t maxCost;
+    size_t cost;
+    accessorPrivateMemoEntry * entries;
+    size_t entryCount;                  // used and free entries
+    size_t entryAllocation;
+    uint32_t freeEntries;
+    uint32_t * buckets;                 // a power of 2 count of buckets, chaining entries
+    size_t bucketCount;
+    size_t valueCount;
+    uint32_t lruFirst;                  // most recently used entry
+    uint32_t lruLast;                   // least recently used entry
+} _accessorMemo_t;
+
+
+
+typedef struct _accessorBlockHashes_t
+{
+    size_t blockSize;
+    size_t size;                        // hashed window size
+    uint64_t * hashes;
+    size_t hashCount;
+} _accessorBlockHashes_t;
+
+// block hashes section header, followed by hashes
+typedef struct
+{
+    uint64_t blockSize;
+    uint64_t size;
+    uint64_t hashCount;
+} accessorPrivateIndexBlockHashesHeader;
+
+
+
+typedef struct _accessorPool_t
+{
+    accessor_t ** accessors;            // idle accessors
+    size_t count;
+    size_t maxCount;
+    size_t initialAllocation;
+    size_t granularity;
+} _accessorPool_t;
+
+
+
+// pack plan operation kinds
+typedef enum
+{
+    accessorPrivatePackCopy = 0,        // copy size bytes as is
+    accessorPrivatePackSwap16,          // full width members in reverse endianness
+    accessorPrivatePackSwap32,
+    accessorPrivatePackSwap64,
+    accessorPrivatePackUInt,            // any other member: truncated to size bytes, written in endianness
+} accessorPrivatePackKind;
+
+typedef struct
+{
+    accessorPrivatePackKind kind;
+    size_t structOffset;
+    size_t memberSize;
+    size_t size;                        // written size
+    accessorEndianness endianness;
+} accessorPrivatePackOp;
+
+typedef struct _accessorPackPlan_t
+{
+    accessorPrivatePackOp * ops;        // in written order
+    size_t opCount;
+    size_t structSize;
+    size_t packedSize;
+    char isStructLayout;                // written layout is struct layout: structs are copied at once...
+    size_t swapSize;                    // ...then, if not 0, swapped in place every swapSize bytes
+} _accessorPackPlan_t;
+
+
+
+typedef struct _accessorTrace_t
+{
+    accessor_t * buffer;                // records not yet written to file
+    size_t bufferSize;                  // buffer is written to file once this size is reached
+    int fileDescriptor;
+    uint64_t previousEnd;               // previous record's rootOffset + size
+    accessorStatus status;              // first error met while recording, returned by accessorCloseTrace()
+} _accessorTrace_t;
+
+
+
 // private prototypes
 static inline uintmax_t accessorPrivateReadUIntAtPointer(const void * ptr, accessorEndianness e, size_t nbytes);
 static inline uint16_t accessorPrivateReadUInt16AtPointer(const uint8_t * ptr, accessorEndianness e);
@@ -114,11 +454,43 @@ static void accessorPrivateInitializeEndianness(void);
 
 static accessorStatus accessorPrivateCreateEmpty(accessor_t ** a);
 
-static accessorStatus accessorPrivateGetPointerForWrite(uint8_t ** r, accessor_t * a, size_t nbytes);  // accessor will grow if needed
+static accessorStatus accessorPrivateGetPointerForWrite(uint8_t ** r, accessor_t * a, size_t nbytes, accessorApiFamily family);  // accessor will grow if needed. *r is NULL for null accessors when nbytes is larger than their scratch buffer
+static accessorStatus accessorPrivateGetPointerForNullWrite(uint8_t ** r, accessor_t * a, size_t nbytes);
 static accessorStatus accessorPrivateGrow(accessor_t * a, size_t newSize);
+#if ACCESSOR_STATISTICS
+static inline void accessorPrivateStatsTransfer(uint64_t * bytes, accessor_t * a, accessorApiFamily family, size_t nbytes);
+#endif
+#if ACCESSOR_STATISTICS || ACCESSOR_TRACING
+static inline void accessorPrivateHookRead(accessor_t * a, accessorApiFamily family, size_t nbytes);
+#endif
+#if ACCESSOR_TRACING
+static void accessorPrivateTraceRead(accessorTrace_t * t, uint64_t rootOffset, size_t nbytes, accessorApiFamily family, uintmax_t usage1);
+#endif
+static accessorStatus accessorPrivateTraceFlush(accessorTrace_t * t);
+
+static size_t accessorPrivateFindCheckpointParent(accessor_t * const * accessors, size_t i);               // returns index of the last accessor listed before accessors[i] whose window contains its own, i if none
+static accessorStatus accessorPrivateWriteCheckpointState(accessor_t * checkpoint, const accessor_t * a, accessorCheckpointOptions options);
+static accessorStatus accessorPrivateReadCheckpointState(accessor_t * checkpoint, accessor_t * a, accessorCheckpointOptions options);
+static accessorStatus accessorPrivateReadCheckpointSize(accessor_t * checkpoint, size_t * x, size_t max);      // read a varint, accessorInvalidReadData if beyond end or above max
+
+static accessorStatus accessorPrivateGetResidency(const accessor_t * a, size_t offset, size_t size, accessorResidency * residency, unsigned char ** vector, size_t * vectorAllocation);    // vector is grown as needed and reused by caller
+static void accessorPrivateGetFaultCount(accessorFaultCount * f);                                  // absolute counts and times
+
+static int accessorPrivateCharge(size_t size);                                                      // returns 0 if size bytes could be charged to the memory budget
+static void accessorPrivateDischarge(size_t size);
+static int accessorPrivateIsUnderPressure(void);                                                    // true if budget's soft limit is exceeded
+static void * accessorPrivateAllocate(size_t size);                                                 // malloc() charged to the memory budget
+static void * accessorPrivateReallocate(void * ptr, size_t oldSize, size_t newSize);                // realloc() charged to the memory budget
+static void accessorPrivateRelease(void * ptr, size_t size);                                        // free() of a charged allocation of size bytes
+static accessorStatus accessorPrivateOpenReadingDescriptor(accessor_t ** a, int file, const char * name, size_t fileSize, size_t windowOffset, size_t windowSize, size_t mmapMinFileSize, char isShared);     // file is owned by *a, even on error. if isShared, non empty windows must be mapped shared
+static int accessorPrivateCreateSharedMemory(void);                                                 // returns a descriptor of a new anonymous shared memory object, or -1
+static uint8_t * accessorPrivateRemapShared(accessor_t * a, size_t newSize);                        // grow a shared write accessor's data, returns NULL on failure
+static accessorStatus accessorPrivateResolveSlots(const accessor_t * a);                                // slots are part of data, not of accessor's state
 
 static inline void accessorPrivateOpenCoverage(accessor_t * a);
-static void accessorPrivateCloseCoverage(accessor_t * a);
+static accessorStatus accessorPrivateCloseCoverage(accessor_t * a);                                 // on failure, cursor is restored to where coverage was opened
+static accessorStatus accessorPrivateAppendCoverageRecord(accessor_t * a, size_t offset, size_t size, uintmax_t usage1, const void * usage2);
+static accessorStatus accessorPrivateReserveCoverageRecord(accessor_t * a);                         // ensure the next coverage record can be appended without allocation
 static int accessorPrivateCoverageCompare(const void * p1, const void * p2);
 static accessorMergeResult accessorPrivateCoverageMerge(void * p1, const void * p2);
 
@@ -126,9 +498,39 @@ static inline int accessorPrivateExtendPointerSizeAllocation(void ** ptr, size_t
 
 static inline char accessorPrivateIsPathSeparator(char c, accessorPathOptions pathOptions);                     // reply true for '/' (and for '\\' if accessorPathOptionConvertBackslash)
 static accessorStatus accessorPrivateCreateEnclosingDirectory(char * path, accessorPathOptions pathOptions);    // private specialized code. path MUST NOT be const and MUST have been cleaned up by accessorBuildPath. only accessorPathOptionCreatePath option is honored
+static accessorStatus accessorPrivateBuildPath(char * buffer, size_t bufferSize, char ** result, size_t * length, const char * basePath, const char * path, accessorPathOptions pathOptions, size_t additionalAllocationLength);  // *result is buffer if large enough, else allocated. additionalAllocationLength SIZE_MAX forbids allocation
+static inline size_t accessorPrivateCopyPath(char * dst, const char * src, size_t length, accessorPathOptions pathOptions);             // returns length
+static inline void accessorPrivateReleasePath(char * path, const char * buffer);                                // free path unless it is buffer
 
 static inline uintmax_t accessorPrivateRoundUpwardsToNonNullMultiple(uintmax_t x, uintmax_t m);     // return value is a non-null multiple of m and strictly greater than x
 
+static inline uintmax_t accessorPrivateReadOffsetAtPointer(const uint8_t * ptr, accessorEndianness e, size_t nbytes);              // accessorPrivateReadUIntAtPointer, with fast paths for usual offset sizes
+static void accessorPrivateRelocateRun(uint8_t * ptr, size_t count, size_t fieldSize, accessorEndianness e, uintmax_t base);     // relocate count adjacent fields
+
+static inline uint64_t accessorPrivateMix64(uint64_t x);                                            // bit mixer, a bijection of 64 bits integers
+static uint64_t accessorPrivateHashBytes(const void * ptr, size_t nbytes, uint64_t seed);           // fast non cryptographic hash
+
+static accessorStatus accessorPrivateCatalogResize(accessorCatalog_t * c, size_t slotCount);
+static size_t accessorPrivateCatalogFindSlot(const accessorCatalog_t * c, const void * name, size_t nameLength, uint32_t hash);    // returns the slot holding name, or the empty slot where it would be inserted
+static int accessorPrivateCatalogCompareEntries(const accessorCatalog_t * c, uint32_t e1, const void * name2, size_t nameLength2, size_t prefixLength);
+static accessorStatus accessorPrivateCatalogValidate(const accessorCatalog_t * c);                  // check a mapped catalog's tables, returns accessorInvalidReadData if any is inconsistent
+
+static accessorStatus accessorPrivateIndexGetSourceKey(accessorPrivateIndexHeader * header, const accessor_t * source, accessorIndexOptions options);
+static accessorStatus accessorPrivateIndexBeginSection(accessorIndex_t * x, uint32_t tag);        // sections are written by accessorPrivateIndexBeginSection(), accessorWriteBytes()..., accessorPrivateIndexEndSection()
+static void accessorPrivateIndexEndSection(accessorIndex_t * x);
+
+static accessorStatus accessorPrivateRecordIndexLength(accessorRecordIndex_t * r, size_t offset, size_t * length);
+
+static uint32_t * accessorPrivateMemoFindLink(accessorMemo_t * m, uint64_t offset, uintmax_t decoderId, uint64_t hash);  // returns the link to the entry with this key, or the null link ending its bucket
+static void accessorPrivateMemoLruUnlink(accessorMemo_t * m, uint32_t e);
+static void accessorPrivateMemoLruInsertFirst(accessorMemo_t * m, uint32_t e);
+static void accessorPrivateMemoRemove(accessorMemo_t * m, uint32_t e);   // destroy value and free entry
+static inline uint64_t accessorPrivateMemoHash(uint64_t offset, uintmax_t decoderId);
+
+static int accessorPrivateRangesOverlap(const accessorRange * ranges, size_t rangeCount, uint64_t offset, uint64_t size);    // ranges are sorted and non overlapping
+
+static void accessorPrivateSwapRun(uint8_t * ptr, size_t count, size_t size);                       // swap count adjacent size bytes wide fields in place
+
 
 
 // private global variables
@@ -137,6 +539,15 @@ static char accessorPrivateIsBigEndianness[ACCESSOR_ENDIANNESS_COUNT];
 static char accessorPrivateIsReverseEndianness[ACCESSOR_ENDIANNESS_COUNT];      // resolve all 4 endianness to accessorNative or accessorReverse
 static accessorEndianness accessorPrivateNativeEndianness = accessorNative;     // will be set to either accessorBig or accessorLittle by accessorPrivateInitializeEndianness()
 static accessorEndianness accessorPrivateDefaultEndianness = accessorNative;    // can be any endianness
+static size_t accessorPrivateMmapMinFileSize = ACCESSOR_MMAP_MIN_FILESIZE;      // see accessorSetMmapMinFileSize()
+static size_t accessorPrivateBudgetSoftLimit = SIZE_MAX;                        // see accessorSetMemoryBudget()
+static size_t accessorPrivateBudgetHardLimit = SIZE_MAX;
+static size_t accessorPrivateBudgetInUse = 0;
+static size_t accessorPrivateBudgetPeak = 0;
+static uint64_t accessorPrivateBudgetFailures = 0;
+static uint64_t accessorPrivateBudgetEvictions = 0;
+static void (* accessorPrivateBudgetPressureHandler)(size_t size, void * context) = NULL;
+static void * accessorPrivateBudgetPressureContext = NULL;
 
 
 
@@ -202,7 +613,7 @@ static inline int accessorPrivateExtendPointerSizeAllocation(void ** ptr, size_t
     if (newsize > *alloc)
     {
         newalloc = (newsize - 1 + allocChunk) - (newsize - 1) % allocChunk;
-        newptr = realloc(*ptr, newalloc * sizeofdata);
+        newptr = accessorPrivateReallocate(*ptr, *alloc * sizeofdata, newalloc * sizeofdata);
         if (newptr == NULL)
             return 1;
         else
@@ -228,7 +639,7 @@ static accessorStatus accessorPrivateCreateEmpty(accessor_t ** a)
     if (*a != ACCESSOR_INIT)
         return accessorInvalidParameter;
 
-    result = malloc(sizeof(*result));
+    result = accessorPrivateAllocate(sizeof(*result));
     if (result == NULL)
         return accessorOutOfMemory;
 
@@ -244,6 +655,7 @@ static accessorStatus accessorPrivateCreateEmpty(accessor_t ** a)
 
     result->data = NULL;
     result->dataMaxSize = 0;
+    result->dataCharge = 0;
     result->dataFileOffset = 0;
     result->granularity = ACCESSOR_SELECT_32_64(4 * KB, 64 * KB);
     result->isMapped = 0;
@@ -251,9 +663,15 @@ static accessorStatus accessorPrivateCreateEmpty(accessor_t ** a)
     result->freeOnClose = 0;
     result->inputFileDescriptor = -1;
     result->outputFileDescriptor = -1;
+    result->sharedFileDescriptor = -1;
     result->writeOnClose = 0;
-
-    result->superAccessor = ACCESSOR_INIT;
+    result->isNull = 0;
+#if ACCESSOR_STATISTICS
+    memset(&result->stats, 0, sizeof(result->stats));
+#endif
+#if ACCESSOR_TRACING
+    result->trace = NULL;
+#endif
 
     result->endianness = accessorPrivateDefaultEndianness;
 
@@ -270,6 +688,9 @@ static accessorStatus accessorPrivateCreateEmpty(accessor_t ** a)
     result->coverageUsage1 = 0;
     result->coverageUsage2 = NULL;
 
+    result->slots = NULL;
+    result->slotCount = 0;
+    result->slotAllocation = 0;
 
     *a = result;
 
@@ -302,6 +723,8 @@ accessorStatus accessorOpenReadingMemory(accessor_t ** a, const void * ptr, size
     (*a)->mayBeReallocated = 0;             // other code may access data even if freeOption == accessorFreeOnClose
     (*a)->freeOnClose = freeOption == accessorFreeOnClose ? 1 : 0;
 
+    ACCESSOR_PROBE2(open_memory, windowSize, 0);
+
     return accessorOk;
 }
 
@@ -312,6 +735,7 @@ accessorStatus accessorOpenReadingFile(accessor_t ** a, const char * basePath, c
     accessorStatus status;
     struct stat st;
     char * name;
+    char nameBuffer[ACCESSOR_PATH_BUFFER_SIZE];
     int file;
     size_t fileSize;
 
@@ -321,13 +745,13 @@ accessorStatus accessorOpenReadingFile(accessor_t ** a, const char * basePath, c
         return status;
 
     pathOptions &= (accessorPathOptions) ~(accessorPathOptionCreateDirectory | accessorPathOptionCreatePath);    // no directory should be created
-    status = accessorBuildPath(&name, basePath, path, pathOptions, 0);
+    status = accessorPrivateBuildPath(nameBuffer, sizeof(nameBuffer), &name, NULL, basePath, path, pathOptions, 0);
     if (status != accessorOk)
         return status;
 
     if (stat(name, &st) != 0)
     {
-        free(name);
+        accessorPrivateReleasePath(name, nameBuffer);
         return accessorOpenError;
     }
 
@@ -335,15 +759,57 @@ accessorStatus accessorOpenReadingFile(accessor_t ** a, const char * basePath, c
 
     if ((file = open(name, O_RDONLY)) == -1)
     {
-        free(name);
+        accessorPrivateReleasePath(name, nameBuffer);
+        accessorClose(a);
+        return accessorOpenError;
+    }
+
+    status = accessorPrivateOpenReadingDescriptor(a, file, name, fileSize, windowOffset, windowSize, accessorPrivateMmapMinFileSize, 0);
+    accessorPrivateReleasePath(name, nameBuffer);
+
+    return status;
+}
+
+
+
+accessorStatus accessorOpenReadingFileDescriptor(accessor_t ** a, int fd, size_t windowOffset, size_t windowSize)
+{
+#if ACCESSOR_USE_MMAP
+    accessorStatus status;
+    struct stat st;
+    int file;
+
+
+    status = accessorPrivateCreateEmpty(a);
+    if (status != accessorOk)
+        return status;
+
+    if (fstat(fd, &st) != 0 || (file = dup(fd)) == -1)
+    {
         accessorClose(a);
         return accessorOpenError;
     }
 
+    return accessorPrivateOpenReadingDescriptor(a, file, "", (size_t) st.st_size, windowOffset, windowSize, 0, 1);
+#else
+    (void) a;
+    (void) fd;
+    (void) windowOffset;
+    (void) windowSize;
+
+    return accessorNotFound;
+#endif
+}
+
+
+
+static accessorStatus accessorPrivateOpenReadingDescriptor(accessor_t ** a, int file, const char * name, size_t fileSize, size_t windowOffset, size_t windowSize, size_t mmapMinFileSize, char isShared)
+{
+    (void) name;                            // only used by probes
+
     if (windowOffset > fileSize)
     {
         close(file);
-        free(name);
         accessorClose(a);
 
         return accessorBeyondEnd;
@@ -355,7 +821,6 @@ accessorStatus accessorOpenReadingFile(accessor_t ** a, const char * basePath, c
     if (windowOffset + windowSize > fileSize)
     {
         close(file);
-        free(name);
         accessorClose(a);
 
         return accessorBeyondEnd;
@@ -366,12 +831,13 @@ accessorStatus accessorOpenReadingFile(accessor_t ** a, const char * basePath, c
     if (pageSize == -1)
         pageSize = sysconf(_SC_PAGESIZE);
 
-    if (windowSize && windowSize >= ACCESSOR_MMAP_MIN_FILESIZE && pageSize != -1)
+    if (windowSize && windowSize >= mmapMinFileSize && pageSize != -1)
     {
         size_t fileMapOffset = windowOffset - (windowOffset % (size_t) pageSize);
         size_t fileMapSize = windowSize + (windowOffset % (size_t) pageSize);
 
-        (*a)->data = mmap(NULL, fileMapSize, PROT_READ, MAP_FILE | MAP_PRIVATE, file, (off_t) fileMapOffset);
+        // a private mapping may or may not see later writes to file, a shared read only mapping always does
+        (*a)->data = mmap(NULL, fileMapSize, PROT_READ, MAP_FILE | (isShared ? MAP_SHARED : MAP_PRIVATE), file, (off_t) fileMapOffset);
         if ((*a)->data != MAP_FAILED)
         {
             (*a)->isMapped = 1;
@@ -380,22 +846,37 @@ accessorStatus accessorOpenReadingFile(accessor_t ** a, const char * basePath, c
             (*a)->windowOffset = windowOffset % (size_t) pageSize;
             (*a)->dataMaxSize = fileMapSize;
             (*a)->baseAccessorWindowOffset = (*a)->windowOffset;
+            ACCESSOR_PROBE2(mmap, fileMapOffset, fileMapSize);
         }
         else
         {
             (*a)->data = NULL;  // MAP_FAILED is (or may be) different from NULL as mmap can be instructed to map a segment at address 0
+            if (isShared)
+            {
+                // a copy wouldn't see later writes
+                close(file);
+                accessorClose(a);
+
+                return accessorHostError;
+            }
         }
     }
+#else
+    (void) isShared;
 #endif
     // if the contitional ACCESSOR_USE_MMAP block was compiled: if mmap was ruled out or failed, read the file data in memory
     // if the contitional ACCESSOR_USE_MMAP block wasn't compiled: simply read the file data in memory
     if ((*a)->data == NULL)
     {
-        (*a)->data = malloc(windowSize > 0 ? windowSize : 1);   // ensure at least 1 byte is allocated
-        if ((*a)->data == NULL || lseek(file, (off_t) windowOffset, SEEK_SET) == -1)
+        (*a)->data = accessorPrivateAllocate(windowSize > 0 ? windowSize : 1);   // ensure at least 1 byte is allocated
+        if ((*a)->data != NULL)
+        {
+            (*a)->dataCharge = windowSize > 0 ? windowSize : 1;
+            (*a)->freeOnClose = 1;
+        }
+        if ((*a)->data == NULL)
         {
             close(file);
-            free(name);
             accessorClose(a);
 
             return accessorOutOfMemory;
@@ -411,11 +892,11 @@ accessorStatus accessorOpenReadingFile(accessor_t ** a, const char * basePath, c
             if (transferSize > ACCESSOR_FILE_READ_SIZE_LIMIT)
                  transferSize = ACCESSOR_FILE_READ_SIZE_LIMIT;  // limit transfer size to a reasonable value
 
-            bytesTransferred = read(file, (*a)->data + offset, transferSize);
+            // pread() doesn't move file offset, which is shared with caller's descriptor if file is a dup() of it
+            bytesTransferred = pread(file, (*a)->data + offset, transferSize, (off_t) (windowOffset + offset));
             if (bytesTransferred == -1 || bytesTransferred == 0)
             {
                 close(file);
-                free(name);
                 accessorClose(a);
 
                 return accessorHostError;
@@ -435,13 +916,85 @@ accessorStatus accessorOpenReadingFile(accessor_t ** a, const char * basePath, c
     (*a)->mayBeReallocated = 0;
     (*a)->inputFileDescriptor = file;
 
-    free(name);
+    ACCESSOR_PROBE4(open_file, name, accessorRootWindowOffset(*a), windowSize, (int) (*a)->isMapped);
 
     return accessorOk;
 }
 
 
 
+static int accessorPrivateCreateSharedMemory(void)
+{
+#if defined(SYS_memfd_create)
+    return (int) syscall(SYS_memfd_create, "accessor", 1);     // 1 is MFD_CLOEXEC, only declared with _GNU_SOURCE
+#elif ACCESSOR_USE_MMAP
+    static unsigned int counter = 0;
+    char name[64];
+    int fd;
+
+
+    // an unlinked shared memory object behaves as an anonymous one
+    for (int attempt = 0; attempt < 16; attempt++)
+    {
+        snprintf(name, sizeof(name), "/accessor.%ld.%u", (long) getpid(), counter++);
+        fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+        if (fd != -1)
+        {
+            shm_unlink(name);
+            return fd;
+        }
+        if (errno != EEXIST)
+            break;
+    }
+
+    return -1;
+#else
+    return -1;
+#endif
+}
+
+
+
+static uint8_t * accessorPrivateRemapShared(accessor_t * a, size_t newSize)
+{
+#if ACCESSOR_USE_MMAP
+    uint8_t * newData;
+
+
+    if (accessorPrivateCharge(newSize - a->dataCharge))
+        return NULL;
+
+    // map the grown object before unmapping the old mapping, so that a failure leaves a unchanged
+    newData = MAP_FAILED;
+    if (ftruncate(a->sharedFileDescriptor, (off_t) newSize) == 0)
+        newData = mmap(NULL, newSize, PROT_READ | PROT_WRITE, MAP_SHARED, a->sharedFileDescriptor, 0);
+    if (newData == MAP_FAILED)
+    {
+        if (a->data != NULL)
+            (void) ftruncate(a->sharedFileDescriptor, (off_t) a->dataMaxSize);
+        accessorPrivateDischarge(newSize - a->dataCharge);
+        return NULL;
+    }
+
+    if (a->data != NULL)
+        (void) munmap(a->data, a->dataMaxSize);
+    ACCESSOR_PROBE2(mmap, 0, newSize);
+    a->data = newData;
+    a->dataMaxSize = newSize;
+    a->dataCharge = newSize;
+    a->isMapped = 1;
+
+    return newData;
+#else
+    (void) a;
+    (void) newSize;
+
+    return NULL;
+#endif
+}
+
+
+
 accessorStatus accessorOpenWritingMemory(accessor_t ** a, size_t initialAllocation, size_t granularity)
 {
     accessorStatus status;
@@ -454,17 +1007,16 @@ accessorStatus accessorOpenWritingMemory(accessor_t ** a, size_t initialAllocati
         granularity = ACCESSOR_SELECT_32_64(4 * KB, 64 * KB);
 
     if (initialAllocation > ACCESSOR_SELECT_32_64(1 * MB, 16 * MB))
-    {
-        initialAllocation = ACCESSOR_SELECT_32_64(1 * MB, 16 * MB);
-        granularity = ACCESSOR_SELECT_32_64(1 * MB, 16 * MB);
-    }
+        granularity = ACCESSOR_SELECT_32_64(1 * MB, 16 * MB);       // large initial allocations are honored, e.g. when measured with a null accessor
 
     initialAllocation = accessorPrivateRoundUpwardsToNonNullMultiple(initialAllocation, granularity);
-    if (((*a)->data = malloc(initialAllocation)) == NULL)
+    if (((*a)->data = accessorPrivateAllocate(initialAllocation)) == NULL)
     {
         accessorClose(a);
         return accessorOutOfMemory;
     }
+    (*a)->dataCharge = initialAllocation;
+    (*a)->freeOnClose = 1;
     memset((*a)->data, 0, initialAllocation);
 
     (*a)->dataMaxSize = initialAllocation;
@@ -478,15 +1030,43 @@ accessorStatus accessorOpenWritingMemory(accessor_t ** a, size_t initialAllocati
     (*a)->mayBeReallocated = 1;
     (*a)->freeOnClose = 1;
 
+    ACCESSOR_PROBE2(open_memory, initialAllocation, 1);
+
     return accessorOk;
 }
 
 
 
-accessorStatus accessorOpenWritingFile(accessor_t ** a, const char * basePath, const char * path, accessorPathOptions pathOptions, mode_t mode, size_t initialAllocation, size_t granularity)
+accessorStatus accessorOpenWritingNull(accessor_t ** a)
 {
     accessorStatus status;
-    char * name;
+
+    status = accessorPrivateCreateEmpty(a);
+    if (status != accessorOk)
+        return status;
+
+    if (((*a)->data = accessorPrivateAllocate(ACCESSOR_NULL_SCRATCH_SIZE)) == NULL)
+    {
+        accessorClose(a);
+        return accessorOutOfMemory;
+    }
+    (*a)->dataCharge = ACCESSOR_NULL_SCRATCH_SIZE;
+
+    (*a)->dataMaxSize = ACCESSOR_NULL_SCRATCH_SIZE;
+    (*a)->writeEnabled = 1;
+    (*a)->freeOnClose = 1;
+    (*a)->isNull = 1;
+
+    return accessorOk;
+}
+
+
+
+accessorStatus accessorOpenWritingShared(accessor_t ** a, size_t initialAllocation, size_t granularity)
+{
+#if ACCESSOR_USE_MMAP
+    accessorStatus status;
+    uint8_t * data;
 
 
     status = accessorPrivateCreateEmpty(a);
@@ -497,26 +1077,95 @@ accessorStatus accessorOpenWritingFile(accessor_t ** a, const char * basePath, c
         granularity = ACCESSOR_SELECT_32_64(4 * KB, 64 * KB);
 
     if (initialAllocation > ACCESSOR_SELECT_32_64(1 * MB, 16 * MB))
-    {
-        initialAllocation = ACCESSOR_SELECT_32_64(1 * MB, 16 * MB);
         granularity = ACCESSOR_SELECT_32_64(1 * MB, 16 * MB);
+
+    initialAllocation = accessorPrivateRoundUpwardsToNonNullMultiple(initialAllocation, granularity);
+
+    if (((*a)->sharedFileDescriptor = accessorPrivateCreateSharedMemory()) == -1)
+    {
+        accessorClose(a);
+        return accessorNotFound;
+    }
+
+    // data is mapped from the shared memory object, which is zero filled as it grows
+    (*a)->writeEnabled = 1;
+    (*a)->granularity = granularity;
+    (*a)->mayBeReallocated = 1;
+    data = accessorPrivateRemapShared(*a, initialAllocation);
+    if (data == NULL)
+    {
+        accessorClose(a);
+        return accessorOutOfMemory;
     }
 
+    ACCESSOR_PROBE2(open_memory, initialAllocation, 1);
+
+    return accessorOk;
+#else
+    (void) a;
+    (void) initialAllocation;
+    (void) granularity;
+
+    return accessorNotFound;
+#endif
+}
+
+
+
+accessorStatus accessorExportFileDescriptor(const accessor_t * a, int * fd, size_t * offset, size_t * size)
+{
+    int descriptor;
+
+
+    descriptor = a->baseAccessor->sharedFileDescriptor != -1 ? a->baseAccessor->sharedFileDescriptor : a->baseAccessor->inputFileDescriptor;
+    if (descriptor == -1)
+        return accessorNotFound;
+
+    if ((*fd = dup(descriptor)) == -1)
+        return accessorHostError;
+
+    *offset = accessorRootWindowOffset(a);
+    *size = a->windowSize;
+
+    return accessorOk;
+}
+
+
+
+accessorStatus accessorOpenWritingFile(accessor_t ** a, const char * basePath, const char * path, accessorPathOptions pathOptions, mode_t mode, size_t initialAllocation, size_t granularity)
+{
+    accessorStatus status;
+    char * name;
+    char nameBuffer[ACCESSOR_PATH_BUFFER_SIZE];
+
+
+    status = accessorPrivateCreateEmpty(a);
+    if (status != accessorOk)
+        return status;
+
+    if (granularity == 0)
+        granularity = ACCESSOR_SELECT_32_64(4 * KB, 64 * KB);
+
+    if (initialAllocation > ACCESSOR_SELECT_32_64(1 * MB, 16 * MB))
+        granularity = ACCESSOR_SELECT_32_64(1 * MB, 16 * MB);       // large initial allocations are honored, e.g. when measured with a null accessor
+
     initialAllocation = accessorPrivateRoundUpwardsToNonNullMultiple(initialAllocation, granularity);
-    if (((*a)->data = malloc(initialAllocation)) == NULL)
+    if (((*a)->data = accessorPrivateAllocate(initialAllocation)) == NULL)
     {
         accessorClose(a);
         return accessorOutOfMemory;
     }
+    (*a)->dataCharge = initialAllocation;
+    (*a)->freeOnClose = 1;
     memset((*a)->data, 0, initialAllocation);
 
-    status = accessorBuildPath(&name, basePath, path, pathOptions, 0);
+    status = accessorPrivateBuildPath(nameBuffer, sizeof(nameBuffer), &name, NULL, basePath, path, pathOptions, 0);
     if (status != accessorOk)
         return status;
 
     if (((*a)->outputFileDescriptor = open(name, O_WRONLY | O_CREAT | O_TRUNC, mode)) == -1)
     {
-        free(name);
+        accessorPrivateReleasePath(name, nameBuffer);
         accessorClose(a);
         return accessorOpenError;
     }
@@ -533,7 +1182,8 @@ accessorStatus accessorOpenWritingFile(accessor_t ** a, const char * basePath, c
     (*a)->freeOnClose = 1;
     (*a)->writeOnClose = 1;
 
-    free(name);
+    ACCESSOR_PROBE2(open_write_file, name, initialAllocation);
+    accessorPrivateReleasePath(name, nameBuffer);
 
     return accessorOk;
 }
@@ -545,9 +1195,13 @@ accessorStatus accessorWriteToFile(const accessor_t * a, const char * basePath,
     accessorStatus status;
     int fileDescriptor;
     char * name;
+    char nameBuffer[ACCESSOR_PATH_BUFFER_SIZE];
     ssize_t writtenBytes;
 
 
+    if (a->baseAccessor->isNull)
+        return accessorInvalidParameter;
+
     if (windowOffset > a->windowSize)
         return accessorBeyondEnd;
 
@@ -557,17 +1211,22 @@ accessorStatus accessorWriteToFile(const accessor_t * a, const char * basePath,
     if (windowOffset + windowSize > a->windowSize)
         return accessorBeyondEnd;
 
-    status = accessorBuildPath(&name, basePath, path, pathOptions, 0);
+    status = accessorPrivateResolveSlots(a);
+    if (status != accessorOk)
+        return status;
+
+    status = accessorPrivateBuildPath(nameBuffer, sizeof(nameBuffer), &name, NULL, basePath, path, pathOptions, 0);
     if (status != accessorOk)
         return status;
 
     if ((fileDescriptor = open(name, O_WRONLY | O_CREAT | O_TRUNC, mode)) == -1)
     {
-        free(name);
+        accessorPrivateReleasePath(name, nameBuffer);
         return accessorOpenError;
     }
-    free(name);
+    accessorPrivateReleasePath(name, nameBuffer);
 
+    ACCESSOR_PROBE3(write_back, fileDescriptor, accessorRootWindowOffset(a) + windowOffset, windowSize);
     writtenBytes = write(fileDescriptor, a->baseAccessor->data + a->baseAccessorWindowOffset + windowOffset, windowSize);
 
     close(fileDescriptor);
@@ -597,7 +1256,7 @@ accessorStatus accessorOpenReadingAccessorBytes(accessor_t ** a, accessor_t * su
     if (status != accessorOk)
         return status;
 
-    supera->referenceCount++;
+    supera->baseAccessor->referenceCount++;     // not supera's: closing a sub-accessor never walks up a chain of super-accessors
 
     (*a)->windowOffset = supera->cursor;
     (*a)->baseAccessorWindowOffset = supera->baseAccessorWindowOffset + supera->cursor;
@@ -607,15 +1266,20 @@ accessorStatus accessorOpenReadingAccessorBytes(accessor_t ** a, accessor_t * su
     (*a)->isBaseAccessor = 0;
     (*a)->writeEnabled = 0;
     (*a)->baseAccessor = supera->baseAccessor;
-    (*a)->superAccessor = supera;
     (*a)->endianness = supera->endianness;      // inherit from supera
+    ACCESSOR_STATS_ADD(supera, subAccessorsOpened, 1);
+    ACCESSOR_PROBE2(open_sub, accessorRootWindowOffset(*a), count);
 
     accessorPrivateOpenCoverage(supera);
 
     supera->cursor += count;
     supera->availableBytes -= count;
 
-    accessorPrivateCloseCoverage(supera);
+    if (accessorPrivateCloseCoverage(supera) != accessorOk)
+    {
+        accessorClose(a);
+        return accessorOutOfMemory;
+    }
 
     return accessorOk;
 }
@@ -649,7 +1313,7 @@ accessorStatus accessorOpenReadingAccessorWindow(accessor_t ** a, accessor_t * s
         return accessorBeyondEnd;
     }
 
-    supera->referenceCount++;
+    supera->baseAccessor->referenceCount++;     // not supera's: closing a sub-accessor never walks up a chain of super-accessors
 
     (*a)->windowOffset = windowOffset;
     (*a)->baseAccessorWindowOffset = windowOffset + supera->baseAccessorWindowOffset;
@@ -659,8 +1323,9 @@ accessorStatus accessorOpenReadingAccessorWindow(accessor_t ** a, accessor_t * s
     (*a)->isBaseAccessor = 0;
     (*a)->writeEnabled = 0;
     (*a)->baseAccessor = supera->baseAccessor;
-    (*a)->superAccessor = supera;
     (*a)->endianness = supera->endianness;      // inherit endianness from supera
+    ACCESSOR_STATS_ADD(supera, subAccessorsOpened, 1);
+    ACCESSOR_PROBE2(open_sub, accessorRootWindowOffset(*a), windowSize);
 
     return accessorOk;
 }
@@ -670,6 +1335,7 @@ accessorStatus accessorOpenReadingAccessorWindow(accessor_t ** a, accessor_t * s
 accessorStatus accessorClose(accessor_t ** a)
 {
     accessorStatus status;
+    accessorStatus slotsStatus;
 
 
     if (*a == ACCESSOR_INIT)
@@ -683,11 +1349,20 @@ accessorStatus accessorClose(accessor_t ** a)
         return accessorOk;
     }
 
+    ACCESSOR_PROBE3(close, accessorRootWindowOffset(*a), (*a)->windowSize, (int) (*a)->isBaseAccessor);
+
+    slotsStatus = accessorOk;
     if ((*a)->writeOnClose && (*a)->outputFileDescriptor != -1 && (*a)->data != NULL)
     {
-        ssize_t writtenBytes = write((*a)->outputFileDescriptor, (*a)->data, (*a)->windowSize);
-        if (writtenBytes < 0 || (size_t) writtenBytes != (*a)->windowSize)
-            return accessorWriteError;
+        // if slots can't be resolved, accessor is closed without writing its file
+        slotsStatus = accessorPrivateResolveSlots(*a);
+        if (slotsStatus == accessorOk)
+        {
+            ACCESSOR_PROBE3(write_back, (*a)->outputFileDescriptor, accessorRootWindowOffset(*a), (*a)->windowSize);
+            ssize_t writtenBytes = write((*a)->outputFileDescriptor, (*a)->data, (*a)->windowSize);
+            if (writtenBytes < 0 || (size_t) writtenBytes != (*a)->windowSize)
+                return accessorWriteError;
+        }
     }
 
     if ((*a)->inputFileDescriptor != -1)
@@ -696,58 +1371,73 @@ accessorStatus accessorClose(accessor_t ** a)
     if ((*a)->outputFileDescriptor != -1)
         close((*a)->outputFileDescriptor);
 
+    if ((*a)->sharedFileDescriptor != -1)
+        close((*a)->sharedFileDescriptor);
+
     if ((*a)->isBaseAccessor)
     {
 #if ACCESSOR_USE_MMAP
         if ((*a)->isMapped)
         {
+            ACCESSOR_PROBE2(munmap, (*a)->dataFileOffset, (*a)->dataMaxSize);
             (void) munmap((*a)->data, (*a)->dataMaxSize);    // errors intentionally ignored
+            accessorPrivateDischarge((*a)->dataCharge);       // shared write accessors' data
         }
 #endif
 
         if ((*a)->freeOnClose && (*a)->data != NULL)
         {
-            free((*a)->data);
+            accessorPrivateRelease((*a)->data, (*a)->dataCharge);
         }
     }
     else
     {
-        status = accessorClose(&(*a)->superAccessor);
+        status = accessorClose(&(*a)->baseAccessor);
         if (status != accessorOk)
             return status;
     }
 
     if ((*a)->cursorStackAllocation)
-        free((*a)->cursorStack);
+        accessorPrivateRelease((*a)->cursorStack, (*a)->cursorStackAllocation * sizeof(*(*a)->cursorStack));
 
     if ((*a)->coverageArrayAllocation)
-        free((*a)->coverageArray);
+        accessorPrivateRelease((*a)->coverageArray, (*a)->coverageArrayAllocation * sizeof(*(*a)->coverageArray));
 
-    free(*a);
+    accessorPrivateRelease((*a)->slots, (*a)->slotAllocation * sizeof(*(*a)->slots));
+
+    accessorPrivateRelease(*a, sizeof(**a));
     *a = ACCESSOR_INIT;
 
-    return accessorOk;
+    return slotsStatus;
 }
 
 
 
-static accessorStatus accessorPrivateGetPointerForWrite(uint8_t ** r, accessor_t * a, size_t nbytes)
+static accessorStatus accessorPrivateGetPointerForWrite(uint8_t ** r, accessor_t * a, size_t nbytes, accessorApiFamily family)
 {
     accessorStatus status;
     size_t offset;
-    size_t endOffset;
 
 
+    (void) family;      // only used by statistics
+
     offset = a->baseAccessorWindowOffset + a->cursor;
-    endOffset = offset + nbytes;
 
-    if (endOffset > a->windowSize)
+    // null accessors always have 0 available bytes, so they only cost a test on this slow path
+    if (a->availableBytes < nbytes)
     {
-        status = accessorPrivateGrow(a->baseAccessor, endOffset);
+        if (a->isNull)
+        {
+            ACCESSOR_STATS_WRITE(a, family, nbytes);
+            return accessorPrivateGetPointerForNullWrite(r, a, nbytes);
+        }
+
+        status = accessorPrivateGrow(a->baseAccessor, offset + nbytes);
         if (status != accessorOk)
             return  status;
     }
 
+    ACCESSOR_STATS_WRITE(a, family, nbytes);
     a->cursor += nbytes;
     a->availableBytes -= nbytes;
 
@@ -758,6 +1448,22 @@ static accessorStatus accessorPrivateGetPointerForWrite(uint8_t ** r, accessor_t
 
 
 
+static accessorStatus accessorPrivateGetPointerForNullWrite(uint8_t ** r, accessor_t * a, size_t nbytes)
+{
+    if (nbytes > SIZE_MAX - a->cursor)
+        return accessorBeyondEnd;
+
+    a->cursor += nbytes;
+    if (a->cursor > a->windowSize)
+        a->windowSize = a->cursor;
+
+    *r = nbytes <= a->dataMaxSize ? a->data : NULL;
+
+    return accessorOk;
+}
+
+
+
 size_t accessorCursor(const accessor_t * a)
 {
     return a->cursor;
@@ -798,6 +1504,8 @@ accessorStatus accessorSeek(accessor_t * a, ssize_t offset, int whence)
     size_t newCursor;
 
 
+    ACCESSOR_STATS_ADD(a, seeks, 1);
+
     switch(whence)
     {
     default:
@@ -813,7 +1521,18 @@ accessorStatus accessorSeek(accessor_t * a, ssize_t offset, int whence)
         break;
     }
 
-    if (a->writeEnabled && newCursor > a->windowSize)
+    if (a->writeEnabled && a->isNull)
+    {
+        if (newCursor > (size_t) SSIZE_MAX)
+            return accessorBeyondEnd;
+        if (newCursor > a->windowSize)
+            a->windowSize = newCursor;
+        a->cursor = newCursor;
+
+        return accessorOk;
+    }
+
+    if (a->writeEnabled && newCursor > a->windowSize)
     {
         size_t windowSizeBeforeGrow;
 
@@ -852,6 +1571,7 @@ accessorStatus accessorPushCursor(accessor_t * a)
     if (accessorPrivateExtendPointerSizeAllocation((void *) &a->cursorStack, &a->cursorStackSize, &a->cursorStackAllocation, a->cursorStackSize + 1, 64, sizeof(*a->cursorStack)))
         return accessorOutOfMemory;
     a->cursorStack[a->cursorStackSize - 1] = a->cursor;
+    ACCESSOR_STATS_ADD(a, cursorPushes, 1);
 
     return accessorOk;
 }
@@ -863,6 +1583,8 @@ accessorStatus accessorPopCursor(accessor_t * a)
     if (a->cursorStackSize < 1)
         return accessorInvalidParameter;
 
+    ACCESSOR_STATS_ADD(a, cursorPops, 1);
+
     return accessorSeek(a, (ssize_t) a->cursorStack[--a->cursorStackSize], SEEK_SET);
 }
 
@@ -873,6 +1595,8 @@ accessorStatus accessorPopCursors(accessor_t * a, size_t n)
     if (a->cursorStackSize < n)
         return accessorInvalidParameter;
 
+    ACCESSOR_STATS_ADD(a, cursorPops, n);
+
     return accessorSeek(a, (ssize_t) a->cursorStack[a->cursorStackSize -= n], SEEK_SET);
 }
 
@@ -906,6 +1630,9 @@ static accessorStatus accessorPrivateGrow(accessor_t * a, size_t newSize)
 {
     uint8_t * newData;
     size_t newDataSize;
+#if ACCESSOR_STATISTICS || ACCESSOR_PROBES
+    uintptr_t previousData;
+#endif
 
 
     if (newSize <= a->windowOffset + a->windowSize)
@@ -917,15 +1644,27 @@ static accessorStatus accessorPrivateGrow(accessor_t * a, size_t newSize)
             return accessorInvalidParameter;
 
         newDataSize = accessorPrivateRoundUpwardsToNonNullMultiple(newSize, a->granularity);
-        newData = realloc(a->data, newDataSize);
+#if ACCESSOR_STATISTICS || ACCESSOR_PROBES
+        previousData = (uintptr_t) a->data;                 // pointer value only, data may be freed by realloc
+#endif
+        if (a->sharedFileDescriptor != -1)
+            newData = accessorPrivateRemapShared(a, newDataSize);
+        else
+            newData = accessorPrivateReallocate(a->data, a->dataCharge, newDataSize);
 
         if (newData == NULL)
             return accessorOutOfMemory;
 
+        ACCESSOR_PROBE3(realloc, a->dataMaxSize, newDataSize, (int) ((uintptr_t) newData != previousData));
+        ACCESSOR_STATS_ADD(a, reallocations, 1);
+        ACCESSOR_STATS_ADD(a, reallocationBytesCopied, (uintptr_t) newData != previousData ? a->windowOffset + a->windowSize : 0);
         a->data = newData;
         a->dataMaxSize = newDataSize;
+        a->dataCharge = newDataSize;
     }
 
+    ACCESSOR_STATS_ADD(a, grows, 1);
+    ACCESSOR_PROBE2(grow, a->windowOffset + a->windowSize, newSize);
     a->windowSize = newSize;
     a->availableBytes = newSize - a->cursor;
 
@@ -961,6 +1700,23 @@ static inline uintmax_t accessorPrivateRoundUpwardsToNonNullMultiple(uintmax_t x
 
 
 accessorStatus accessorBuildPath(char ** result, const char * basePath, const char * path, accessorPathOptions pathOptions, size_t additionalAllocationLength)
+{
+    return accessorPrivateBuildPath(NULL, 0, result, NULL, basePath, path, pathOptions, additionalAllocationLength);
+}
+
+
+
+accessorStatus accessorBuildPathInBuffer(char * buffer, size_t bufferSize, size_t * length, const char * basePath, const char * path, accessorPathOptions pathOptions)
+{
+    char * result;
+
+
+    return accessorPrivateBuildPath(buffer, bufferSize, &result, length, basePath, path, pathOptions, SIZE_MAX);
+}
+
+
+
+static accessorStatus accessorPrivateBuildPath(char * buffer, size_t bufferSize, char ** result, size_t * length, const char * basePath, const char * path, accessorPathOptions pathOptions, size_t additionalAllocationLength)
 {
     size_t basePathLength;
     size_t pathLength;
@@ -1030,111 +1786,123 @@ accessorStatus accessorBuildPath(char ** result, const char * basePath, const ch
     if (pathLength == 0)
         return accessorInvalidParameter;
 
-    // ensure destination is large enough
-    dst = malloc(basePathLength + 1 + pathLength + 1 + additionalAllocationLength);
-    if (dst == NULL)
-        return accessorOutOfMemory;
+    // ensure destination is large enough: buffer is used if it is, otherwise destination is allocated unless additionalAllocationLength is SIZE_MAX
+    if (buffer != NULL && basePathLength + 1 + pathLength + 1 <= bufferSize)
+        dst = buffer;
+    else if (additionalAllocationLength == SIZE_MAX)
+        return accessorBeyondEnd;
+    else
+    {
+        dst = malloc(basePathLength + 1 + pathLength + 1 + additionalAllocationLength);
+        if (dst == NULL)
+            return accessorOutOfMemory;
+    }
 
     if (accessorPrivateIsPathSeparator(path[0], pathOptions))
     {
         // result is simply path
-        memcpy(dst, path, pathLength);
-        resultLength = pathLength;
+        resultLength = accessorPrivateCopyPath(dst, path, pathLength, pathOptions);
     }
     else
     {
-        if (pathLength == 0)
-        {
-            // result is simply basePath
-            memcpy(dst, basePath, basePathLength);
-            resultLength = basePathLength;
-        }
-        else
-        {
-            // if basePath exists AND is not a directory, result is parentPath(basePath) + '/' + path, or parentPath(basePath) + path if basePath ends with '/')
-            // if basePath doesn't exist OR is a directory, result is basePath + '/' + path, or basePath + path if basePath ends with '/')
-            struct stat st;
+        // if basePath exists AND is not a directory, result is parentPath(basePath) + '/' + path, or parentPath(basePath) + path if basePath ends with '/')
+        // if basePath doesn't exist OR is a directory, result is basePath + '/' + path, or basePath + path if basePath ends with '/')
+        struct stat st;
 
 
-            memcpy(dst, basePath, basePathLength);
-            dst[basePathLength] = 0;
+        basePathLength = accessorPrivateCopyPath(dst, basePath, basePathLength, pathOptions);
+        dst[basePathLength] = 0;
 
-            if (pathOptions & accessorPathOptionConvertBackslash)  // convert \ to / for the first part of the path
-                for (size_t i = 0; i < basePathLength; i++)
-                    if (dst[i] == '\\')
-                        dst[i] = '/';
-
-            if (!basePathIsDirectoryPath && stat(dst, &st) == 0 && !(st.st_mode & S_IFDIR))
-            {
-                // basePath exists AND is not a directory, convert it to its parent path
-                char foundSeparator;
+        if (!basePathIsDirectoryPath && basePathLength > 0 && stat(dst, &st) == 0 && !(st.st_mode & S_IFDIR))
+        {
+            // basePath exists AND is not a directory, convert it to its parent path
+            char foundSeparator;
 
 
-                foundSeparator = 0;
-                for (size_t i = basePathLength; i > 1; i--)
-                {
-                    if (dst[i - 1] == '/')
-                    {
-                        basePathLength = i - 1;
-                        foundSeparator = 1;
-                        break;
-                    }
-                }
-                if (!foundSeparator)
+            foundSeparator = 0;
+            for (size_t i = basePathLength; i > 1; i--)
+            {
+                if (dst[i - 1] == '/')
                 {
-                    basePathLength = 0;
+                    basePathLength = i - 1;
+                    foundSeparator = 1;
+                    break;
                 }
             }
+            if (!foundSeparator)
+            {
+                basePathLength = 0;
+            }
+        }
 
-            resultLength = basePathLength;
+        resultLength = basePathLength;
 
-            if (basePathLength >= 1 && !accessorPrivateIsPathSeparator(basePath[basePathLength - 1], pathOptions))
-                dst[resultLength++] = '/';
+        if (basePathLength >= 1 && !accessorPrivateIsPathSeparator(basePath[basePathLength - 1], pathOptions))
+            dst[resultLength++] = '/';
 
-            memcpy(dst + resultLength, path, pathLength);
-            resultLength += pathLength;
-        }
+        resultLength += accessorPrivateCopyPath(dst + resultLength, path, pathLength, pathOptions);
     }
 
-    if (pathOptions & accessorPathOptionConvertBackslash)
-        for (size_t i = basePathLength; i < resultLength; i++)  // convert \ to / for the second part of the path
-            if (dst[i] == '\\')
-                dst[i] = '/';
-
-
     dst[resultLength] = 0;
 
     if (pathOptions & accessorPathOptionCreateDirectory || pathOptions & accessorPathOptionCreatePath)
         accessorPrivateCreateEnclosingDirectory(dst, pathOptions);
 
     *result = dst;
+    if (length != NULL)
+        *length = resultLength;
 
     return accessorOk;
 }
 
 
 
+static inline size_t accessorPrivateCopyPath(char * dst, const char * src, size_t length, accessorPathOptions pathOptions)
+{
+    if (pathOptions & accessorPathOptionConvertBackslash)
+    {
+        // copy and convert \ to / in a single pass
+        for (size_t i = 0; i < length; i++)
+            dst[i] = src[i] == '\\' ? '/' : src[i];
+    }
+    else
+        memcpy(dst, src, length);
+
+    return length;
+}
+
+
+
+static inline void accessorPrivateReleasePath(char * path, const char * buffer)
+{
+    if (path != buffer)
+        free(path);
+}
+
+
+
 accessorStatus accessorCreateDirectory(const char * basePath, const char * path, accessorPathOptions pathOptions)
 {
     accessorStatus status;
     int mkdirStatus;
     char * directoryPath;
+    char directoryPathBuffer[ACCESSOR_PATH_BUFFER_SIZE];
 
 
-    status = accessorBuildPath(&directoryPath, basePath, path, pathOptions & (accessorPathOptions) ~(accessorPathOptionCreateDirectory | accessorPathOptionCreatePath), 0);  // don't request directory creation
+    status = accessorPrivateBuildPath(directoryPathBuffer, sizeof(directoryPathBuffer), &directoryPath, NULL, basePath, path, pathOptions & (accessorPathOptions) ~(accessorPathOptionCreateDirectory | accessorPathOptionCreatePath), 0);  // don't request directory creation
     if (status != accessorOk)
         return status;
 
     mkdirStatus = mkdir(directoryPath, 0777);
     if (mkdirStatus == 0)
     {
-        free(directoryPath);
+        accessorPrivateReleasePath(directoryPath, directoryPathBuffer);
         return accessorOk;
     }
 
     if (mkdirStatus == -1 && (errno == EEXIST || errno == EISDIR))
     {
-        free(directoryPath);
+        accessorPrivateReleasePath(directoryPath, directoryPathBuffer);
         return accessorOk;
     }
 
@@ -1145,25 +1913,25 @@ accessorStatus accessorCreateDirectory(const char * basePath, const char * path,
         status = accessorPrivateCreateEnclosingDirectory(directoryPath, pathOptions);
         if (status != 0)
         {
-            free(directoryPath);
+            accessorPrivateReleasePath(directoryPath, directoryPathBuffer);
             return status;
         }
 
         mkdirStatus = mkdir(directoryPath, 0777);
         if (mkdirStatus == 0)
         {
-            free(directoryPath);
+            accessorPrivateReleasePath(directoryPath, directoryPathBuffer);
             return accessorOk;
         }
 
         if (mkdirStatus == -1 && (errno == EEXIST || errno == EISDIR))
         {
-            free(directoryPath);
+            accessorPrivateReleasePath(directoryPath, directoryPathBuffer);
             return accessorOk;
         }
     }
 
-    free(directoryPath);
+    accessorPrivateReleasePath(directoryPath, directoryPathBuffer);
     return accessorHostError;
 }
 
@@ -1290,6 +2058,22 @@ accessorStatus accessorSetDefaultEndianness(accessorEndianness e)
 
 
 
+size_t accessorMmapMinFileSize(void)
+{
+    return accessorPrivateMmapMinFileSize;
+}
+
+
+
+accessorStatus accessorSetMmapMinFileSize(size_t size)
+{
+    accessorPrivateMmapMinFileSize = size;
+
+    return accessorOk;
+}
+
+
+
 accessorStatus accessorSwap(accessor_t ** a1, accessor_t ** a2)
 {
     accessor_t * tmp;
@@ -1346,27 +2130,58 @@ static inline void accessorPrivateOpenCoverage(accessor_t * a)
 
 
 
-static void accessorPrivateCloseCoverage(accessor_t * a)
+static accessorStatus accessorPrivateCloseCoverage(accessor_t * a)
 {
     if (a->coverageEnabled && a->coverageSuspendCount == 0)
     {
-        a->coverageArraySize++;
-        if (a->coverageArraySize > a->coverageArrayAllocation)
+        if (accessorPrivateAppendCoverageRecord(a, a->coverageStartOffset, a->cursor - a->coverageStartOffset, a->coverageUsage1, a->coverageUsage2) != accessorOk)
         {
-            if (a->coverageArrayAllocation < 64) a->coverageArrayAllocation = 64;
-            a->coverageArrayAllocation *= 2;
-            a->coverageArray = realloc(a->coverageArray, a->coverageArrayAllocation * sizeof(accessorCoverageRecord));
-            if (a->coverageArray == NULL)
-            {
-                perror("fatal: can't allocate coverage structure");
-                exit(127);
-            }
+            // the read fails as a whole: its bytes aren't consumed, so that caller may retry
+            a->cursor = a->coverageStartOffset;
+            a->availableBytes = a->windowSize - a->cursor;
+            return accessorOutOfMemory;
         }
-        a->coverageArray[a->coverageArraySize - 1].offset = a->coverageStartOffset;
-        a->coverageArray[a->coverageArraySize - 1].size = a->cursor - a->coverageStartOffset;
-        a->coverageArray[a->coverageArraySize - 1].usage1 = a->coverageUsage1;
-        a->coverageArray[a->coverageArraySize - 1].usage2 = a->coverageUsage2;
     }
+
+    return accessorOk;
+}
+
+
+
+static accessorStatus accessorPrivateAppendCoverageRecord(accessor_t * a, size_t offset, size_t size, uintmax_t usage1, const void * usage2)
+{
+    if (accessorPrivateReserveCoverageRecord(a) != accessorOk)
+        return accessorOutOfMemory;
+
+    a->coverageArraySize++;
+    ACCESSOR_STATS_ADD(a, coverageRecords, 1);
+    a->coverageArray[a->coverageArraySize - 1].offset = offset;
+    a->coverageArray[a->coverageArraySize - 1].size = size;
+    a->coverageArray[a->coverageArraySize - 1].usage1 = usage1;
+    a->coverageArray[a->coverageArraySize - 1].usage2 = usage2;
+
+    return accessorOk;
+}
+
+
+
+static accessorStatus accessorPrivateReserveCoverageRecord(accessor_t * a)
+{
+    if (a->coverageArraySize >= a->coverageArrayAllocation)
+    {
+        accessorCoverageRecord * newArray;
+        size_t newAllocation;
+
+
+        newAllocation = a->coverageArrayAllocation < 64 ? 128 : a->coverageArrayAllocation * 2;
+        newArray = accessorPrivateReallocate(a->coverageArray, a->coverageArrayAllocation * sizeof(*a->coverageArray), newAllocation * sizeof(*a->coverageArray));
+        if (newArray == NULL)
+            return accessorOutOfMemory;
+        a->coverageArray = newArray;
+        a->coverageArrayAllocation = newAllocation;
+    }
+
+    return accessorOk;
 }
 
 
@@ -1379,34 +2194,21 @@ void accessorSetCoverageUsage(accessor_t * a, uintmax_t usage1, const void * usa
 
 
 
-void accessorAddCoverageRecord(accessor_t * a, size_t offset, size_t count, uintmax_t usage1, const void * usage2, accessorCoverageForceOption forceOption)
+accessorStatus accessorAddCoverageRecord(accessor_t * a, size_t offset, size_t count, uintmax_t usage1, const void * usage2, accessorCoverageForceOption forceOption)
 {
     if ((a->coverageEnabled || forceOption) && a->coverageSuspendCount == 0)
     {
         if (offset > a->windowSize)                                             // only add valid coverage records
-            return;
+            return accessorOk;
         if (count == ACCESSOR_UNTIL_END)
             count = a->windowSize - offset;
         if (offset + count > a->windowSize)                                     // only add valid coverage records
-            return;
+            return accessorOk;
 
-        a->coverageArraySize++;
-        if (a->coverageArraySize > a->coverageArrayAllocation)
-        {
-            if (a->coverageArrayAllocation < 64) a->coverageArrayAllocation = 64;
-            a->coverageArrayAllocation *= 2;
-            a->coverageArray = realloc(a->coverageArray, a->coverageArrayAllocation * sizeof(accessorCoverageRecord));
-            if (a->coverageArray == NULL)
-            {
-                perror("fatal: can't allocate coverage structure");
-                exit(127);
-            }
-        }
-        a->coverageArray[a->coverageArraySize - 1].offset = offset;
-        a->coverageArray[a->coverageArraySize - 1].size = count;
-        a->coverageArray[a->coverageArraySize - 1].usage1 = usage1;
-        a->coverageArray[a->coverageArraySize - 1].usage2 = usage2;
+        return accessorPrivateAppendCoverageRecord(a, offset, count, usage1, usage2);
     }
+
+    return accessorOk;
 }
 
 
@@ -1481,6 +2283,9 @@ void accessorSummarizeCoverage(accessor_t * a, int (*compare)(const void * a, co
     size_t c1, c2;
     int (*compareFunction)(const void * a, const void * b);
     accessorMergeResult (*mergeFunction)(void * a, const void * b);
+#if ACCESSOR_PROBES
+    size_t recordCount = a->coverageArraySize;
+#endif
 
 
     if (a->coverageArraySize == 0)
@@ -1512,2796 +2317,6022 @@ void accessorSummarizeCoverage(accessor_t * a, int (*compare)(const void * a, co
             }
         }
     }
+
+    ACCESSOR_PROBE2(coverage_summarize, recordCount, a->coverageArraySize);
 }
 
 
 
-static inline uintmax_t accessorPrivateReadUIntAtPointer(const void * ptr, accessorEndianness e, size_t nbytes)
+#if ACCESSOR_STATISTICS
+static inline void accessorPrivateStatsTransfer(uint64_t * bytes, accessor_t * a, accessorApiFamily family, size_t nbytes)
 {
-    uintmax_t result;
-    const uint8_t * bytes = (const uint8_t *) ptr;
+    *bytes += nbytes;
+    a->baseAccessor->stats.calls[family]++;
+}
+#endif
 
 
-    result = 0;
-    if (accessorPrivateIsBigEndianness[e])
-        for (size_t i = 0; i < nbytes; i++) result = (result << 8) | bytes[i];
-    else
-        for (size_t i = 0; i < nbytes; i++) result |= ((uintmax_t)bytes[i]) << (i * 8);
 
-    return result;
+#if ACCESSOR_STATISTICS || ACCESSOR_TRACING
+static inline void accessorPrivateHookRead(accessor_t * a, accessorApiFamily family, size_t nbytes)
+{
+#if ACCESSOR_STATISTICS
+    accessorPrivateStatsTransfer(&a->baseAccessor->stats.bytesRead, a, family, nbytes);
+#endif
+#if ACCESSOR_TRACING
+    if (a->baseAccessor->trace != NULL)
+        accessorPrivateTraceRead(a->baseAccessor->trace, accessorRootWindowOffset(a) + a->cursor - nbytes, nbytes, family, a->coverageUsage1);
+#endif
 }
+#endif
 
 
 
-static inline intmax_t accessorPrivateReadIntAtPointer(const void * ptr, accessorEndianness e, size_t nbytes)
+accessorStatus accessorGetStats(const accessor_t * a, accessorStats * stats)
 {
-    uintmax_t result;
-    const uint8_t * bytes = (const uint8_t *) ptr;
-    uintmax_t signBit;
-    uintmax_t signExtension;
-
-
-    signBit = 0x80;
-    signExtension = 0xff;
-    signExtension = ~signExtension;
-    result = 0;
-    if (accessorPrivateIsBigEndianness[e])
-        for (size_t i = 0; i < nbytes; i++)
-        {
-            result = (result << 8) | bytes[i];
-            if (i)
-            {
-                signBit <<= 8;
-                signExtension <<= 8;
-            }
-        }
-    else
-        for (size_t i = 0; i < nbytes; i++)
-        {
-            result |= ((uintmax_t) bytes[i]) << (i * 8);
-            if (i)
-            {
-                signBit <<= 8;
-                signExtension <<= 8;
-            }
-        }
+#if ACCESSOR_STATISTICS
+    *stats = a->baseAccessor->stats;
 
-    if (result & signBit) result |= signExtension;
+    return accessorOk;
+#else
+    (void) a;
+    memset(stats, 0, sizeof(*stats));
 
-    return (intmax_t) result;
+    return accessorNotFound;
+#endif
 }
 
 
 
-static inline void accessorPrivateWriteUIntAtPointer(void * ptr, uintmax_t x, accessorEndianness e, size_t nbytes)
+accessorStatus accessorOpenTrace(accessorTrace_t ** t, const char * basePath, const char * path, accessorPathOptions pathOptions, mode_t mode, size_t bufferSize)
 {
-    uint8_t * bytes = (uint8_t *) ptr;
+    accessorTrace_t * result;
+    accessorStatus status;
+    char * name;
+    char nameBuffer[ACCESSOR_PATH_BUFFER_SIZE];
 
 
-    if (accessorPrivateIsBigEndianness[e])
+    if (*t != ACCESSOR_INIT)
+        return accessorInvalidParameter;
+
+    if (bufferSize == 0)
+        bufferSize = ACCESSOR_TRACE_DEFAULT_BUFFER_SIZE;
+
+    result = malloc(sizeof(*result));
+    if (result == NULL)
+        return accessorOutOfMemory;
+
+    result->buffer = ACCESSOR_INIT;
+    result->bufferSize = bufferSize;
+    result->fileDescriptor = -1;
+    result->previousEnd = 0;
+    result->status = accessorOk;
+
+    // records are at most 31 bytes long, the buffer never has to grow
+    status = accessorOpenWritingMemory(&result->buffer, bufferSize + 32, 0);
+    if (status == accessorOk)
+        status = accessorWriteBytes(result->buffer, ACCESSOR_TRACE_MAGIC, strlen(ACCESSOR_TRACE_MAGIC));
+    if (status == accessorOk)
+        status = accessorWriteEndianUInt32(result->buffer, ACCESSOR_TRACE_VERSION, accessorBig);
+    if (status == accessorOk)
+        status = accessorPrivateBuildPath(nameBuffer, sizeof(nameBuffer), &name, NULL, basePath, path, pathOptions, 0);
+    if (status != accessorOk)
     {
-        for (size_t i = nbytes; i > 0; )
-        {
-            bytes[--i] = (uint8_t) x;
-            x >>= 8;
-        }
+        accessorClose(&result->buffer);
+        free(result);
+        return status;
     }
-    else
+
+    result->fileDescriptor = open(name, O_WRONLY | O_CREAT | O_TRUNC, mode);
+    accessorPrivateReleasePath(name, nameBuffer);
+    if (result->fileDescriptor == -1)
     {
-        for (size_t i = 0; i < nbytes; i++)
-        {
-            bytes[i] = (uint8_t) x;
-            x >>= 8;
-        }
+        accessorClose(&result->buffer);
+        free(result);
+        return accessorOpenError;
     }
-}
-
 
+    *t = result;
 
-static inline uint16_t accessorPrivateReadUInt16AtPointer(const uint8_t * ptr, accessorEndianness e)
-{
-    if (accessorPrivateIsBigEndianness[e])
-        return (uint16_t) ((uint16_t) ptr[0] << 8 | (uint16_t) ptr[1]);
-    else
-        return (uint16_t) ((uint16_t) ptr[1] << 8 | (uint16_t) ptr[0]);
+    return accessorOk;
 }
 
 
 
-static inline uint32_t accessorPrivateReadUInt24AtPointer(const uint8_t * ptr, accessorEndianness e)
+accessorStatus accessorCloseTrace(accessorTrace_t ** t)
 {
-    if (accessorPrivateIsBigEndianness[e])
-        return (uint32_t) ((uint32_t) ptr[0] << 16 | (uint32_t) ptr[1] << 8 | (uint32_t) ptr[2]);
-    else
-        return ((uint32_t) (uint32_t) ptr[2] << 16 | (uint32_t) ptr[1] << 8 | (uint32_t) ptr[0]);
-}
-
+    accessorStatus status;
 
 
-static inline uint32_t accessorPrivateReadUInt32AtPointer(const uint8_t * ptr, accessorEndianness e)
-{
-    if (accessorPrivateIsBigEndianness[e])
-        return (uint32_t) ((uint32_t) ptr[0] << 24 | (uint32_t) ptr[1] << 16 | (uint32_t) ptr[2] << 8 | (uint32_t) ptr[3]);
-    else
-        return (uint32_t) ((uint32_t) ptr[3] << 24 | (uint32_t) ptr[2] << 16 | (uint32_t) ptr[1] << 8 | (uint32_t) ptr[0]);
-}
+    if (*t == ACCESSOR_INIT)
+        return accessorInvalidParameter;
 
+    status = accessorPrivateTraceFlush(*t);
+    if ((*t)->status == accessorOk)
+        (*t)->status = status;
+    status = (*t)->status;
 
+    close((*t)->fileDescriptor);
+    accessorClose(&(*t)->buffer);
+    free(*t);
+    *t = ACCESSOR_INIT;
 
-static inline uint64_t accessorPrivateReadUInt64AtPointer(const uint8_t * ptr, accessorEndianness e)
-{
-    if (accessorPrivateIsBigEndianness[e])
-        return (uint64_t) ((uint64_t) ptr[0] << 56 | (uint64_t) ptr[1] << 48 | (uint64_t) ptr[2] << 40 | (uint64_t) ptr[3] << 32 | (uint64_t) ptr[4] << 24 | (uint64_t) ptr[5] << 16 | (uint64_t) ptr[6] << 8 | (uint64_t) ptr[7]);
-    else
-        return (uint64_t) ((uint64_t) ptr[7] << 56 | (uint64_t) ptr[6] << 48 | (uint64_t) ptr[5] << 40 | (uint64_t) ptr[4] << 32 | (uint64_t) ptr[3] << 24 | (uint64_t) ptr[2] << 16 | (uint64_t) ptr[1] << 8 | (uint64_t) ptr[0]);
+    return status;
 }
 
 
 
-static inline int16_t accessorPrivateReadInt16AtPointer(const uint8_t * ptr, accessorEndianness e)
+accessorStatus accessorSetTrace(accessor_t * a, accessorTrace_t * t)
 {
-    if (accessorPrivateIsBigEndianness[e])
-        return (int16_t) ((uint16_t) ptr[0] << 8 | (uint16_t) ptr[1]);
-    else
-        return (int16_t) ((uint16_t) ptr[1] << 8 | (uint16_t) ptr[0]);
+#if ACCESSOR_TRACING
+    a->baseAccessor->trace = t;
+
+    return accessorOk;
+#else
+    (void) a;
+    (void) t;
+
+    return accessorNotFound;
+#endif
 }
 
 
 
-static inline int32_t accessorPrivateReadInt24AtPointer(const uint8_t * ptr, accessorEndianness e)
+accessorStatus accessorReadTraceHeader(accessor_t * a)
 {
-    int32_t x;
+    accessorStatus status;
+    uint8_t magic[sizeof(ACCESSOR_TRACE_MAGIC) - 1];
+    uint32_t version;
 
 
-    if (accessorPrivateIsBigEndianness[e])
-        x = (int32_t) ((uint32_t) ptr[0] << 16 | (uint32_t) ptr[1] << 8 | (uint32_t) ptr[2]);
-    else
-        x = (int32_t) ((uint32_t) ptr[2] << 16 | (uint32_t) ptr[1] << 8 | (uint32_t) ptr[0]);
+    status = accessorReadBytes(a, magic, sizeof(magic));
+    if (status != accessorOk)
+        return status == accessorBeyondEnd ? accessorInvalidReadData : status;
 
-    if (x & 0x800000)
-        x |= 0xff000000;
+    status = accessorReadEndianUInt32(a, &version, accessorBig);
+    if (status != accessorOk)
+        return status == accessorBeyondEnd ? accessorInvalidReadData : status;
 
-    return x;
+    if (memcmp(magic, ACCESSOR_TRACE_MAGIC, sizeof(magic)) != 0 || version != ACCESSOR_TRACE_VERSION)
+        return accessorInvalidReadData;
+
+    return accessorOk;
 }
 
 
 
-static inline int32_t accessorPrivateReadInt32AtPointer(const uint8_t * ptr, accessorEndianness e)
+accessorStatus accessorReadTraceRecord(accessor_t * a, accessorTraceRecord * record, uint64_t * previousEnd)
 {
-    if (accessorPrivateIsBigEndianness[e])
-        return (int32_t) ((uint32_t) ptr[0] << 24 | (uint32_t) ptr[1] << 16 | (uint32_t) ptr[2] << 8 | (uint32_t) ptr[3]);
-    else
-        return (int32_t) ((uint32_t) ptr[3] << 24 | (uint32_t) ptr[2] << 16 | (uint32_t) ptr[1] << 8 | (uint32_t) ptr[0]);
-}
+    accessorStatus status;
+    intmax_t delta;
+    uintmax_t size;
+    uint8_t family;
+    uintmax_t usage1;
 
 
+    if (accessorAvailableBytesCount(a) == 0)
+        return accessorBeyondEnd;
 
-static inline int64_t accessorPrivateReadInt64AtPointer(const uint8_t * ptr, accessorEndianness e)
-{
-    if (accessorPrivateIsBigEndianness[e])
-        return (int64_t) ((uint64_t) ptr[0] << 56 | (uint64_t) ptr[1] << 48 | (uint64_t) ptr[2] << 40 | (uint64_t) ptr[3] << 32 | (uint64_t) ptr[4] << 24 | (uint64_t) ptr[5] << 16 | (uint64_t) ptr[6] << 8 | (uint64_t) ptr[7]);
-    else
-        return (int64_t) ((uint64_t) ptr[7] << 56 | (uint64_t) ptr[6] << 48 | (uint64_t) ptr[5] << 40 | (uint64_t) ptr[4] << 32 | (uint64_t) ptr[3] << 24 | (uint64_t) ptr[2] << 16 | (uint64_t) ptr[1] << 8 | (uint64_t) ptr[0]);
-}
-
+    // a truncated record is invalid, not the end of trace
+    status = accessorReadZigZagInt(a, &delta);
+    if (status == accessorOk)
+        status = accessorReadVarInt(a, &size);
+    if (status == accessorOk)
+        status = accessorReadUInt8(a, &family);
+    if (status == accessorOk)
+        status = accessorReadVarInt(a, &usage1);
+    if (status != accessorOk)
+        return status == accessorBeyondEnd ? accessorInvalidReadData : status;
 
+    if (family >= accessorApiFamilyCount)
+        return accessorInvalidReadData;
 
-static inline void accessorPrivateWriteUInt16AtPointer(uint8_t * ptr, uint16_t x, accessorEndianness e)
-{
-    if (accessorPrivateIsBigEndianness[e])
-        x = accessorSwapUInt16(x);
+    record->rootOffset = *previousEnd + (uint64_t) delta;
+    record->size = size;
+    record->family = (accessorApiFamily) family;
+    record->usage1 = usage1;
+    *previousEnd = record->rootOffset + record->size;
 
-    ptr[0] = (uint8_t) x;
-    ptr[1] = (uint8_t) (x >> 8);
+    return accessorOk;
 }
 
 
 
-static inline void accessorPrivateWriteUInt24AtPointer(uint8_t * ptr, uint32_t x, accessorEndianness e)
+#if ACCESSOR_TRACING
+static void accessorPrivateTraceRead(accessorTrace_t * t, uint64_t rootOffset, size_t nbytes, accessorApiFamily family, uintmax_t usage1)
 {
-    if (accessorPrivateIsBigEndianness[e])
-        x = accessorSwapUInt24(x);
-
-    ptr[0] = (uint8_t) x;
-    ptr[1] = (uint8_t) (x >> 8);
-    ptr[2] = (uint8_t) (x >> 16);
-}
-
+    accessorStatus status;
 
 
-static inline void accessorPrivateWriteUInt32AtPointer(uint8_t * ptr, uint32_t x, accessorEndianness e)
-{
-    if (accessorPrivateIsBigEndianness[e])
-        x = accessorSwapUInt32(x);
+    // buffer never grows, writes can't fail
+    accessorWriteZigZagInt(t->buffer, (intmax_t) (rootOffset - t->previousEnd));
+    accessorWriteVarInt(t->buffer, nbytes);
+    accessorWriteUInt8(t->buffer, (uint8_t) family);
+    accessorWriteVarInt(t->buffer, usage1);
+    t->previousEnd = rootOffset + nbytes;
 
-    ptr[0] = (uint8_t) x;
-    ptr[1] = (uint8_t) (x >> 8);
-    ptr[2] = (uint8_t) (x >> 16);
-    ptr[3] = (uint8_t) (x >> 24);
+    if (accessorSize(t->buffer) >= t->bufferSize)
+    {
+        status = accessorPrivateTraceFlush(t);
+        if (t->status == accessorOk)
+            t->status = status;
+    }
 }
+#endif
 
 
 
-static inline void accessorPrivateWriteUInt64AtPointer(uint8_t * ptr, uint64_t x, accessorEndianness e)
+static accessorStatus accessorPrivateTraceFlush(accessorTrace_t * t)
 {
-    if (accessorPrivateIsBigEndianness[e])
-        x = accessorSwapUInt64(x);
-
-    ptr[0] = (uint8_t) x;
-    ptr[1] = (uint8_t) (x >> 8);
-    ptr[2] = (uint8_t) (x >> 16);
-    ptr[3] = (uint8_t) (x >> 24);
-    ptr[4] = (uint8_t) (x >> 32);
-    ptr[5] = (uint8_t) (x >> 40);
-    ptr[6] = (uint8_t) (x >> 48);
-    ptr[7] = (uint8_t) (x >> 56);
-}
+    const uint8_t * ptr;
+    size_t size;
+    ssize_t writtenBytes;
 
 
+    size = accessorSize(t->buffer);
+    ptr = t->buffer->data;
+    while (size > 0)
+    {
+        writtenBytes = write(t->fileDescriptor, ptr, size);
+        if (writtenBytes <= 0)
+        {
+            accessorReset(t->buffer);
+            return accessorWriteError;
+        }
+        ptr += writtenBytes;
+        size -= (size_t) writtenBytes;
+    }
 
-accessorStatus accessorReadUInt(accessor_t * a, uintmax_t * x, size_t nbytes)
-{
-    return accessorReadEndianUInt(a, x, a->endianness, nbytes);
+    return accessorReset(t->buffer);
 }
 
 
 
-accessorStatus accessorReadUInt8(accessor_t * a, uint8_t * x)
+accessorStatus accessorWriteCheckpoint(accessor_t * checkpoint, accessor_t * const * accessors, size_t count, accessorCheckpointOptions options)
 {
-    if (a->availableBytes < 1)
-        return accessorBeyondEnd;
+    accessorStatus status;
+    size_t i;
+    size_t parent;
 
-    *x = * (uint8_t *) (a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor);
 
-    accessorPrivateOpenCoverage(a);
+    if (count == 0 || (options & ~(accessorCheckpointOptions) accessorCheckpointOptionCoverage) != 0)
+        return accessorInvalidParameter;
 
-    a->cursor += 1;
-    a->availableBytes -= 1;
+    // check the tree before writing anything
+    for (i = 1; i < count; i++)
+        if (accessorPrivateFindCheckpointParent(accessors, i) >= i)
+            return accessorInvalidParameter;
 
-    accessorPrivateCloseCoverage(a);
+    status = accessorWriteBytes(checkpoint, ACCESSOR_CHECKPOINT_MAGIC, strlen(ACCESSOR_CHECKPOINT_MAGIC));
+    if (status == accessorOk)
+        status = accessorWriteEndianUInt32(checkpoint, ACCESSOR_CHECKPOINT_VERSION, accessorBig);
+    if (status == accessorOk)
+        status = accessorWriteVarInt(checkpoint, options);
+    if (status == accessorOk)
+        status = accessorWriteVarInt(checkpoint, count);
 
-    return accessorOk;
+    for (i = 0; i < count && status == accessorOk; i++)
+    {
+        parent = i == 0 ? 0 : accessorPrivateFindCheckpointParent(accessors, i);
+        status = accessorWriteVarInt(checkpoint, parent);
+        if (status == accessorOk)
+            status = accessorWriteVarInt(checkpoint, i == 0 ? 0 : accessorRootWindowOffset(accessors[i]) - accessorRootWindowOffset(accessors[parent]));
+        if (status == accessorOk)
+            status = accessorWriteVarInt(checkpoint, accessors[i]->windowSize);
+        if (status == accessorOk)
+            status = accessorPrivateWriteCheckpointState(checkpoint, accessors[i], options);
+    }
+
+    return status;
 }
 
 
 
-accessorStatus accessorReadUInt16(accessor_t * a, uint16_t * x)
+accessorStatus accessorReadCheckpoint(accessor_t * checkpoint, accessor_t ** accessors, size_t maxCount, size_t * count)
 {
-    if (a->availableBytes < 2)
-        return accessorBeyondEnd;
-
-    *x = accessorPrivateReadUInt16AtPointer(a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor, a->endianness);
-
-    accessorPrivateOpenCoverage(a);
-
-    a->cursor += 2;
-    a->availableBytes -= 2;
+    accessorStatus status;
+    uint8_t magic[sizeof(ACCESSOR_CHECKPOINT_MAGIC) - 1];
+    uint32_t version;
+    uintmax_t options;
+    size_t n;
+    size_t i;
+    size_t parent;
+    size_t offset;
+    size_t windowSize;
 
-    accessorPrivateCloseCoverage(a);
 
-    return accessorOk;
-}
+    *count = 0;
+    if (maxCount == 0 || accessors[0]->writeEnabled)
+        return accessorInvalidParameter;
 
+    status = accessorReadBytes(checkpoint, magic, sizeof(magic));
+    if (status == accessorOk)
+        status = accessorReadEndianUInt32(checkpoint, &version, accessorBig);
+    if (status == accessorOk)
+        status = accessorReadVarInt(checkpoint, &options);
+    if (status != accessorOk)
+        return status == accessorBeyondEnd ? accessorInvalidReadData : status;
 
+    if (memcmp(magic, ACCESSOR_CHECKPOINT_MAGIC, sizeof(magic)) != 0 || version != ACCESSOR_CHECKPOINT_VERSION || (options & ~(uintmax_t) accessorCheckpointOptionCoverage) != 0)
+        return accessorInvalidReadData;
 
-accessorStatus accessorReadUInt24(accessor_t * a, uint32_t * x)
-{
-    if (a->availableBytes < 3)
-        return accessorBeyondEnd;
+    status = accessorPrivateReadCheckpointSize(checkpoint, &n, SIZE_MAX);
+    if (status != accessorOk)
+        return status;
+    if (n == 0)
+        return accessorInvalidReadData;
+    if (n > maxCount)
+        return accessorInvalidParameter;
+    for (i = 1; i < n; i++)
+        if (accessors[i] != ACCESSOR_INIT)
+            return accessorInvalidParameter;
 
-    *x = accessorPrivateReadUInt24AtPointer(a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor, a->endianness);
+    for (i = 0; i < n && status == accessorOk; i++)
+    {
+        status = accessorPrivateReadCheckpointSize(checkpoint, &parent, i == 0 ? 0 : i - 1);
+        if (status == accessorOk)
+            status = accessorPrivateReadCheckpointSize(checkpoint, &offset, i == 0 ? 0 : accessors[parent]->windowSize);
+        if (status == accessorOk)
+            status = accessorPrivateReadCheckpointSize(checkpoint, &windowSize, i == 0 ? SIZE_MAX : accessors[parent]->windowSize - offset);
+        if (status != accessorOk)
+            break;
 
-    accessorPrivateOpenCoverage(a);
+        if (i == 0)
+        {
+            if (windowSize != accessors[0]->windowSize)
+                status = accessorInvalidReadData;
+        }
+        else
+            status = accessorOpenReadingAccessorWindow(&accessors[i], accessors[parent], offset, windowSize);
+        if (status != accessorOk)
+            break;
+        *count = i + 1;
 
-    a->cursor += 3;
-    a->availableBytes -= 3;
+        status = accessorPrivateReadCheckpointState(checkpoint, accessors[i], (accessorCheckpointOptions) options);
+    }
 
-    accessorPrivateCloseCoverage(a);
+    if (status != accessorOk)
+    {
+        // close sub-accessors before their super-accessors
+        for (i = *count; i > 1; i--)
+            accessorClose(&accessors[i - 1]);
+        *count = 0;
+    }
 
-    return accessorOk;
+    return status;
 }
 
 
 
-accessorStatus accessorReadUInt32(accessor_t * a, uint32_t * x)
+static size_t accessorPrivateFindCheckpointParent(accessor_t * const * accessors, size_t i)
 {
-    if (a->availableBytes < 4)
-        return accessorBeyondEnd;
-
-    *x = accessorPrivateReadUInt32AtPointer(a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor, a->endianness);
+    const accessor_t * a;
+    const accessor_t * parent;
+    size_t j;
 
-    accessorPrivateOpenCoverage(a);
-
-    a->cursor += 4;
-    a->availableBytes -= 4;
 
-    accessorPrivateCloseCoverage(a);
+    // sub-accessors don't know their super-accessors: the last accessor listed before accessors[i] whose window contains accessors[i]'s one
+    a = accessors[i];
+    for (j = i; j > 0; j--)
+    {
+        parent = accessors[j - 1];
+        if (parent->baseAccessor == a->baseAccessor
+            && a->baseAccessorWindowOffset >= parent->baseAccessorWindowOffset
+            && a->baseAccessorWindowOffset + a->windowSize <= parent->baseAccessorWindowOffset + parent->windowSize)
+            return j - 1;
+    }
 
-    return accessorOk;
+    return i;
 }
 
 
 
-accessorStatus accessorReadUInt64(accessor_t * a, uint64_t * x)
+static accessorStatus accessorPrivateWriteCheckpointState(accessor_t * checkpoint, const accessor_t * a, accessorCheckpointOptions options)
 {
-    if (a->availableBytes < 8)
-        return accessorBeyondEnd;
+    accessorStatus status;
+    size_t i;
+
+
+    status = accessorWriteVarInt(checkpoint, a->cursor);
+    if (status == accessorOk)
+        status = accessorWriteUInt8(checkpoint, (uint8_t) a->endianness);
+    if (status == accessorOk)
+        status = accessorWriteVarInt(checkpoint, a->cursorStackSize);
+    for (i = 0; i < a->cursorStackSize && status == accessorOk; i++)
+        status = accessorWriteVarInt(checkpoint, a->cursorStack[i]);
+    if (status == accessorOk)
+        status = accessorWriteUInt8(checkpoint, (uint8_t) a->coverageEnabled);
+    if (status == accessorOk)
+        status = accessorWriteVarInt(checkpoint, a->coverageSuspendCount);
+    if (status == accessorOk)
+        status = accessorWriteVarInt(checkpoint, a->coverageUsage1);
+
+    if (options & accessorCheckpointOptionCoverage)
+    {
+        if (status == accessorOk)
+            status = accessorWriteVarInt(checkpoint, a->coverageArraySize);
+        for (i = 0; i < a->coverageArraySize && status == accessorOk; i++)
+        {
+            status = accessorWriteVarInt(checkpoint, a->coverageArray[i].offset);
+            if (status == accessorOk)
+                status = accessorWriteVarInt(checkpoint, a->coverageArray[i].size);
+            if (status == accessorOk)
+                status = accessorWriteVarInt(checkpoint, a->coverageArray[i].usage1);
+        }
+    }
 
-    *x = accessorPrivateReadUInt64AtPointer(a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor, a->endianness);
+    return status;
+}
 
-    accessorPrivateOpenCoverage(a);
 
-    a->cursor += 8;
-    a->availableBytes -= 8;
 
-    accessorPrivateCloseCoverage(a);
+static accessorStatus accessorPrivateReadCheckpointState(accessor_t * checkpoint, accessor_t * a, accessorCheckpointOptions options)
+{
+    accessorStatus status;
+    size_t cursor;
+    uint8_t endianness;
+    size_t stackSize;
+    uint8_t coverageEnabled;
+    uintmax_t suspendCount;
+    uintmax_t usage1;
+    size_t recordCount;
+    size_t offset;
+    size_t size;
+    uintmax_t recordUsage1;
+    size_t i;
+
+
+    // every stack entry and record takes at least one byte, which bounds allocations of corrupted checkpoints
+    status = accessorPrivateReadCheckpointSize(checkpoint, &cursor, a->windowSize);
+    if (status == accessorOk)
+        status = accessorReadUInt8(checkpoint, &endianness);
+    if (status == accessorOk)
+        status = accessorPrivateReadCheckpointSize(checkpoint, &stackSize, accessorAvailableBytesCount(checkpoint));
+    if (status == accessorOk && endianness >= ACCESSOR_ENDIANNESS_COUNT)
+        status = accessorInvalidReadData;
+    if (status != accessorOk)
+        return status == accessorBeyondEnd ? accessorInvalidReadData : status;
 
-    return accessorOk;
-}
+    if (accessorPrivateExtendPointerSizeAllocation((void *) &a->cursorStack, &a->cursorStackSize, &a->cursorStackAllocation, stackSize, 64, sizeof(*a->cursorStack)))
+        return accessorOutOfMemory;
+    for (i = 0; i < stackSize && status == accessorOk; i++)
+        status = accessorPrivateReadCheckpointSize(checkpoint, &a->cursorStack[i], a->windowSize);
+    if (status == accessorOk)
+        status = accessorReadUInt8(checkpoint, &coverageEnabled);
+    if (status == accessorOk)
+        status = accessorReadVarInt(checkpoint, &suspendCount);
+    if (status == accessorOk)
+        status = accessorReadVarInt(checkpoint, &usage1);
+    if (status != accessorOk)
+    {
+        a->cursorStackSize = 0;
+        return status == accessorBeyondEnd ? accessorInvalidReadData : status;
+    }
 
+    if (options & accessorCheckpointOptionCoverage)
+    {
+        a->coverageArraySize = 0;
+        status = accessorPrivateReadCheckpointSize(checkpoint, &recordCount, accessorAvailableBytesCount(checkpoint));
+        if (status != accessorOk)
+            return status;
+        for (i = 0; i < recordCount && status == accessorOk; i++)
+        {
+            status = accessorPrivateReadCheckpointSize(checkpoint, &offset, a->windowSize);
+            if (status == accessorOk)
+                status = accessorPrivateReadCheckpointSize(checkpoint, &size, a->windowSize - offset);
+            if (status == accessorOk)
+                status = accessorReadVarInt(checkpoint, &recordUsage1);
+            if (status == accessorOk)
+                status = accessorPrivateAppendCoverageRecord(a, offset, size, recordUsage1, NULL);
+        }
+        if (status != accessorOk)
+            return status == accessorBeyondEnd ? accessorInvalidReadData : status;
+    }
 
+    a->cursor = cursor;
+    a->availableBytes = a->windowSize - cursor;
+    a->endianness = (accessorEndianness) endianness;
+    a->coverageEnabled = coverageEnabled ? 1 : 0;
+    a->coverageSuspendCount = suspendCount;
+    a->coverageUsage1 = usage1;
+    a->coverageUsage2 = NULL;
 
-accessorStatus accessorReadInt(accessor_t * a, intmax_t * x, size_t nbytes)
-{
-    return accessorReadEndianInt(a, x, a->endianness, nbytes);
+    return accessorOk;
 }
 
 
 
-accessorStatus accessorReadInt8(accessor_t * a, int8_t * x)
+static accessorStatus accessorPrivateReadCheckpointSize(accessor_t * checkpoint, size_t * x, size_t max)
 {
-    if (a->availableBytes < 1)
-        return accessorBeyondEnd;
-
-    *x = * (int8_t *) (a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor);
-
-    accessorPrivateOpenCoverage(a);
+    accessorStatus status;
+    uintmax_t value;
 
-    a->cursor += 1;
-    a->availableBytes -= 1;
 
-    accessorPrivateCloseCoverage(a);
+    status = accessorReadVarInt(checkpoint, &value);
+    if (status != accessorOk)
+        return status == accessorBeyondEnd ? accessorInvalidReadData : status;
+    if (value > max)
+        return accessorInvalidReadData;
+    *x = (size_t) value;
 
     return accessorOk;
 }
 
 
 
-accessorStatus accessorReadInt16(accessor_t * a, int16_t * x)
+accessorStatus accessorGetResidency(const accessor_t * a, size_t offset, size_t size, accessorResidency * residency)
 {
-    if (a->availableBytes < 2)
-        return accessorBeyondEnd;
-
-    *x = accessorPrivateReadInt16AtPointer(a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor, a->endianness);
-
-    accessorPrivateOpenCoverage(a);
+    unsigned char * vector = NULL;
+    size_t vectorAllocation = 0;
+    accessorStatus status;
 
-    a->cursor += 2;
-    a->availableBytes -= 2;
 
-    accessorPrivateCloseCoverage(a);
+    status = accessorPrivateGetResidency(a, offset, size, residency, &vector, &vectorAllocation);
+    free(vector);
 
-    return accessorOk;
+    return status;
 }
 
 
 
-accessorStatus accessorReadInt24(accessor_t * a, int32_t * x)
+accessorStatus accessorGetCoverageResidency(const accessor_t * a, accessorResidency * residencies)
 {
-    if (a->availableBytes < 3)
-        return accessorBeyondEnd;
+    unsigned char * vector = NULL;
+    size_t vectorAllocation = 0;
+    accessorStatus status = accessorOk;
 
-    *x = accessorPrivateReadInt24AtPointer(a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor, a->endianness);
 
-    accessorPrivateOpenCoverage(a);
+    for (size_t i = 0; status == accessorOk && i < a->coverageArraySize; i++)
+        status = accessorPrivateGetResidency(a, a->coverageArray[i].offset, a->coverageArray[i].size, &residencies[i], &vector, &vectorAllocation);
+    free(vector);
+
+    return status;
+}
 
-    a->cursor += 3;
-    a->availableBytes -= 3;
 
-    accessorPrivateCloseCoverage(a);
+
+accessorStatus accessorStartFaultCount(accessorFaultCount * f)
+{
+    accessorPrivateGetFaultCount(f);
 
     return accessorOk;
 }
 
 
 
-accessorStatus accessorReadInt32(accessor_t * a, int32_t * x)
+accessorStatus accessorStopFaultCount(accessorFaultCount * f)
 {
-    if (a->availableBytes < 4)
-        return accessorBeyondEnd;
-
-    *x = accessorPrivateReadInt32AtPointer(a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor, a->endianness);
-
-    accessorPrivateOpenCoverage(a);
+    accessorFaultCount now;
 
-    a->cursor += 4;
-    a->availableBytes -= 4;
 
-    accessorPrivateCloseCoverage(a);
+    accessorPrivateGetFaultCount(&now);
+    f->minorFaults = now.minorFaults - f->minorFaults;
+    f->majorFaults = now.majorFaults - f->majorFaults;
+    f->userSeconds = now.userSeconds - f->userSeconds;
+    f->systemSeconds = now.systemSeconds - f->systemSeconds;
+    f->elapsedSeconds = now.elapsedSeconds - f->elapsedSeconds;
 
     return accessorOk;
 }
 
 
 
-accessorStatus accessorReadInt64(accessor_t * a, int64_t * x)
+accessorStatus accessorSetMemoryBudget(size_t softLimit, size_t hardLimit)
 {
-    if (a->availableBytes < 8)
-        return accessorBeyondEnd;
+    if (softLimit > hardLimit)
+        return accessorInvalidParameter;
 
-    *x = accessorPrivateReadInt64AtPointer(a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor, a->endianness);
+    accessorPrivateBudgetSoftLimit = softLimit;
+    accessorPrivateBudgetHardLimit = hardLimit;
 
-    accessorPrivateOpenCoverage(a);
+    return accessorOk;
+}
 
-    a->cursor += 8;
-    a->availableBytes -= 8;
 
-    accessorPrivateCloseCoverage(a);
 
-    return accessorOk;
+void accessorGetMemoryBudget(accessorMemoryBudget * budget)
+{
+    budget->softLimit = accessorPrivateBudgetSoftLimit;
+    budget->hardLimit = accessorPrivateBudgetHardLimit;
+    budget->inUse = ACCESSOR_ATOMIC_LOAD(&accessorPrivateBudgetInUse);
+    budget->peak = ACCESSOR_ATOMIC_LOAD(&accessorPrivateBudgetPeak);
+    budget->failures = ACCESSOR_ATOMIC_LOAD(&accessorPrivateBudgetFailures);
+    budget->evictions = ACCESSOR_ATOMIC_LOAD(&accessorPrivateBudgetEvictions);
 }
 
 
 
-accessorStatus accessorReadFloat32(accessor_t * a, float * x)
+int accessorIsMemoryUnderPressure(void)
 {
-    return accessorReadUInt32(a, (uint32_t *) x);
+    return accessorPrivateIsUnderPressure();
 }
 
 
 
-accessorStatus accessorReadFloat64(accessor_t * a, double * x)
+void accessorSetMemoryPressureHandler(void (* handler)(size_t size, void * context), void * context)
 {
-    return accessorReadUInt64(a, (uint64_t *) x);
+    accessorPrivateBudgetPressureHandler = handler;
+    accessorPrivateBudgetPressureContext = context;
 }
 
 
 
-accessorStatus accessorReadEndianUInt(accessor_t * a, uintmax_t * x, accessorEndianness e, size_t nbytes)
+static accessorStatus accessorPrivateGetResidency(const accessor_t * a, size_t offset, size_t size, accessorResidency * residency, unsigned char ** vector, size_t * vectorAllocation)
 {
-    if (nbytes > sizeof(uintmax_t))
-        return accessorInvalidParameter;
+    long pageSize;
 
-    if (a->availableBytes < nbytes)
+
+    memset(residency, 0, sizeof(*residency));
+    if (a->baseAccessor->isNull)
+        return accessorInvalidParameter;
+    if (offset > a->windowSize)
+        return accessorBeyondEnd;
+    if (size == ACCESSOR_UNTIL_END)
+        size = a->windowSize - offset;
+    if (size > a->windowSize - offset)
         return accessorBeyondEnd;
 
-    *x = accessorPrivateReadUIntAtPointer(a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor, e, nbytes);
+#if ACCESSOR_USE_MMAP
+    uintptr_t start;
+    uintptr_t end;
+    size_t pageCount;
 
-    accessorPrivateOpenCoverage(a);
 
-    a->cursor += nbytes;
-    a->availableBytes -= nbytes;
+    pageSize = sysconf(_SC_PAGESIZE);
+    if (pageSize == -1)
+        return accessorHostError;
+    residency->pageSize = (size_t) pageSize;
+    if (size == 0)
+        return accessorOk;
+
+    // mincore needs a page aligned address, pages partially in range are included
+    start = (uintptr_t) (a->baseAccessor->data + a->baseAccessorWindowOffset + offset);
+    end = start + size;
+    start -= start % (uintptr_t) pageSize;
+    end = end + (uintptr_t) pageSize - 1 - (end + (uintptr_t) pageSize - 1) % (uintptr_t) pageSize;
+    pageCount = (size_t) (end - start) / (size_t) pageSize;
+
+    if (pageCount > *vectorAllocation)
+    {
+        unsigned char * newVector = realloc(*vector, pageCount);
+        if (newVector == NULL)
+            return accessorOutOfMemory;
+        *vector = newVector;
+        *vectorAllocation = pageCount;
+    }
 
-    accessorPrivateCloseCoverage(a);
+    // vector is char * on some systems and unsigned char * on others
+    if (mincore((void *) start, (size_t) (end - start), (void *) *vector) == -1)
+        return accessorHostError;
+
+    for (size_t i = 0; i < pageCount; i++)
+    {
+        if ((*vector)[i] & 1)
+            residency->residentPages++;
+        else
+            residency->nonResidentPages++;
+    }
 
     return accessorOk;
+#else
+    (void) pageSize;
+    (void) vector;
+    (void) vectorAllocation;
+
+    return accessorNotFound;
+#endif
 }
 
 
 
-accessorStatus accessorReadEndianUInt16(accessor_t * a, uint16_t * x, accessorEndianness e)
+static void accessorPrivateGetFaultCount(accessorFaultCount * f)
 {
-    if (a->availableBytes < 2)
-        return accessorBeyondEnd;
+    struct rusage usage;
+    struct timespec now;
 
-    *x = accessorPrivateReadUInt16AtPointer(a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor, e);
 
-    accessorPrivateOpenCoverage(a);
+    memset(f, 0, sizeof(*f));
+#ifdef RUSAGE_THREAD
+    if (getrusage(RUSAGE_THREAD, &usage) == -1)
+#endif
+    if (getrusage(RUSAGE_SELF, &usage) == -1)
+        memset(&usage, 0, sizeof(usage));
+    f->minorFaults = (uint64_t) usage.ru_minflt;
+    f->majorFaults = (uint64_t) usage.ru_majflt;
+    f->userSeconds = (double) usage.ru_utime.tv_sec + (double) usage.ru_utime.tv_usec / 1e6;
+    f->systemSeconds = (double) usage.ru_stime.tv_sec + (double) usage.ru_stime.tv_usec / 1e6;
+    if (clock_gettime(CLOCK_MONOTONIC, &now) == 0)
+        f->elapsedSeconds = (double) now.tv_sec + (double) now.tv_nsec / 1e9;
+}
 
-    a->cursor += 2;
-    a->availableBytes -= 2;
 
-    accessorPrivateCloseCoverage(a);
 
-    return accessorOk;
-}
-
-
-
-accessorStatus accessorReadEndianUInt24(accessor_t * a, uint32_t * x, accessorEndianness e)
+static int accessorPrivateCharge(size_t size)
 {
-    if (a->availableBytes < 3)
-        return accessorBeyondEnd;
+    size_t inUse;
 
-    *x = accessorPrivateReadUInt24AtPointer(a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor, e);
-
-    accessorPrivateOpenCoverage(a);
 
-    a->cursor += 3;
-    a->availableBytes -= 3;
+    for (int attempt = 0; ; attempt++)
+    {
+        inUse = ACCESSOR_ATOMIC_ADD(&accessorPrivateBudgetInUse, size);
+        if (inUse >= size && inUse <= accessorPrivateBudgetHardLimit)
+            break;
+        ACCESSOR_ATOMIC_SUB(&accessorPrivateBudgetInUse, size);
 
-    accessorPrivateCloseCoverage(a);
+        // give the pressure handler a single chance to release memory
+        if (attempt > 0 || accessorPrivateBudgetPressureHandler == NULL)
+        {
+            ACCESSOR_ATOMIC_ADD(&accessorPrivateBudgetFailures, 1);
+            return 1;
+        }
+        accessorPrivateBudgetPressureHandler(size, accessorPrivateBudgetPressureContext);
+    }
+    ACCESSOR_ATOMIC_MAX(&accessorPrivateBudgetPeak, inUse);
 
-    return accessorOk;
+    return 0;
 }
 
 
 
-accessorStatus accessorReadEndianUInt32(accessor_t * a, uint32_t * x, accessorEndianness e)
+static void accessorPrivateDischarge(size_t size)
 {
-    if (a->availableBytes < 4)
-        return accessorBeyondEnd;
-
-    *x = accessorPrivateReadUInt32AtPointer(a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor, e);
-
-    accessorPrivateOpenCoverage(a);
+    ACCESSOR_ATOMIC_SUB(&accessorPrivateBudgetInUse, size);
+}
 
-    a->cursor += 4;
-    a->availableBytes -= 4;
 
-    accessorPrivateCloseCoverage(a);
 
-    return accessorOk;
+static int accessorPrivateIsUnderPressure(void)
+{
+    return ACCESSOR_ATOMIC_LOAD(&accessorPrivateBudgetInUse) > accessorPrivateBudgetSoftLimit;
 }
 
 
 
-accessorStatus accessorReadEndianUInt64(accessor_t * a, uint64_t * x, accessorEndianness e)
+static void * accessorPrivateAllocate(size_t size)
 {
-    if (a->availableBytes < 8)
-        return accessorBeyondEnd;
-
-    *x = accessorPrivateReadUInt64AtPointer(a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor, e);
+    void * result;
 
-    accessorPrivateOpenCoverage(a);
 
-    a->cursor += 8;
-    a->availableBytes -= 8;
+    if (accessorPrivateCharge(size))
+        return NULL;
 
-    accessorPrivateCloseCoverage(a);
+    result = malloc(size);
+    if (result == NULL)
+        accessorPrivateDischarge(size);
 
-    return accessorOk;
+    return result;
 }
 
 
 
-accessorStatus accessorReadEndianInt(accessor_t * a, intmax_t * x, accessorEndianness e, size_t nbytes)
+static void * accessorPrivateReallocate(void * ptr, size_t oldSize, size_t newSize)
 {
-    if (nbytes > sizeof(intmax_t))
-        return accessorInvalidParameter;
-
-    if (a->availableBytes < nbytes)
-        return accessorBeyondEnd;
+    void * result;
 
-    *x = accessorPrivateReadIntAtPointer(a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor, e, nbytes);
 
-    accessorPrivateOpenCoverage(a);
+    if (newSize > oldSize && accessorPrivateCharge(newSize - oldSize))
+        return NULL;
 
-    a->cursor += nbytes;
-    a->availableBytes -= nbytes;
+    result = realloc(ptr, newSize);
+    if (result == NULL)
+    {
+        if (newSize > oldSize)
+            accessorPrivateDischarge(newSize - oldSize);
+        return NULL;
+    }
 
-    accessorPrivateCloseCoverage(a);
+    if (newSize < oldSize)
+        accessorPrivateDischarge(oldSize - newSize);
 
-    return accessorOk;
+    return result;
 }
 
 
 
-accessorStatus accessorReadEndianInt16(accessor_t * a, int16_t * x, accessorEndianness e)
+static void accessorPrivateRelease(void * ptr, size_t size)
 {
-    if (a->availableBytes < 2)
-        return accessorBeyondEnd;
+    free(ptr);
+    accessorPrivateDischarge(size);
+}
 
-    *x = accessorPrivateReadInt16AtPointer(a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor, e);
 
-    accessorPrivateOpenCoverage(a);
 
-    a->cursor += 2;
-    a->availableBytes -= 2;
+static inline uintmax_t accessorPrivateReadUIntAtPointer(const void * ptr, accessorEndianness e, size_t nbytes)
+{
+    uintmax_t result;
+    const uint8_t * bytes = (const uint8_t *) ptr;
 
-    accessorPrivateCloseCoverage(a);
 
-    return accessorOk;
+    result = 0;
+    if (accessorPrivateIsBigEndianness[e])
+        for (size_t i = 0; i < nbytes; i++) result = (result << 8) | bytes[i];
+    else
+        for (size_t i = 0; i < nbytes; i++) result |= ((uintmax_t)bytes[i]) << (i * 8);
+
+    return result;
 }
 
 
 
-accessorStatus accessorReadEndianInt24(accessor_t * a, int32_t * x, accessorEndianness e)
+static inline intmax_t accessorPrivateReadIntAtPointer(const void * ptr, accessorEndianness e, size_t nbytes)
 {
-    if (a->availableBytes < 3)
-        return accessorBeyondEnd;
-
-    *x = accessorPrivateReadInt24AtPointer(a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor, e);
+    uintmax_t result;
+    const uint8_t * bytes = (const uint8_t *) ptr;
+    uintmax_t signBit;
+    uintmax_t signExtension;
 
-    accessorPrivateOpenCoverage(a);
 
-    a->cursor += 3;
-    a->availableBytes -= 3;
+    signBit = 0x80;
+    signExtension = 0xff;
+    signExtension = ~signExtension;
+    result = 0;
+    if (accessorPrivateIsBigEndianness[e])
+        for (size_t i = 0; i < nbytes; i++)
+        {
+            result = (result << 8) | bytes[i];
+            if (i)
+            {
+                signBit <<= 8;
+                signExtension <<= 8;
+            }
+        }
+    else
+        for (size_t i = 0; i < nbytes; i++)
+        {
+            result |= ((uintmax_t) bytes[i]) << (i * 8);
+            if (i)
+            {
+                signBit <<= 8;
+                signExtension <<= 8;
+            }
+        }
 
-    accessorPrivateCloseCoverage(a);
+    if (result & signBit) result |= signExtension;
 
-    return accessorOk;
+    return (intmax_t) result;
 }
 
 
 
-accessorStatus accessorReadEndianInt32(accessor_t * a, int32_t * x, accessorEndianness e)
+static inline void accessorPrivateWriteUIntAtPointer(void * ptr, uintmax_t x, accessorEndianness e, size_t nbytes)
 {
-    if (a->availableBytes < 4)
-        return accessorBeyondEnd;
+    uint8_t * bytes = (uint8_t *) ptr;
 
-    *x = accessorPrivateReadInt32AtPointer(a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor, e);
 
-    accessorPrivateOpenCoverage(a);
+    if (accessorPrivateIsBigEndianness[e])
+    {
+        for (size_t i = nbytes; i > 0; )
+        {
+            bytes[--i] = (uint8_t) x;
+            x >>= 8;
+        }
+    }
+    else
+    {
+        for (size_t i = 0; i < nbytes; i++)
+        {
+            bytes[i] = (uint8_t) x;
+            x >>= 8;
+        }
+    }
+}
 
-    a->cursor += 4;
-    a->availableBytes -= 4;
 
-    accessorPrivateCloseCoverage(a);
 
-    return accessorOk;
+static inline uint16_t accessorPrivateReadUInt16AtPointer(const uint8_t * ptr, accessorEndianness e)
+{
+    if (accessorPrivateIsBigEndianness[e])
+        return (uint16_t) ((uint16_t) ptr[0] << 8 | (uint16_t) ptr[1]);
+    else
+        return (uint16_t) ((uint16_t) ptr[1] << 8 | (uint16_t) ptr[0]);
 }
 
 
 
-accessorStatus accessorReadEndianInt64(accessor_t * a, int64_t * x, accessorEndianness e)
+static inline uint32_t accessorPrivateReadUInt24AtPointer(const uint8_t * ptr, accessorEndianness e)
 {
-    if (a->availableBytes < 8)
-        return accessorBeyondEnd;
-
-    *x = accessorPrivateReadInt64AtPointer(a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor, e);
-
-    accessorPrivateOpenCoverage(a);
+    if (accessorPrivateIsBigEndianness[e])
+        return (uint32_t) ((uint32_t) ptr[0] << 16 | (uint32_t) ptr[1] << 8 | (uint32_t) ptr[2]);
+    else
+        return ((uint32_t) (uint32_t) ptr[2] << 16 | (uint32_t) ptr[1] << 8 | (uint32_t) ptr[0]);
+}
 
-    a->cursor += 8;
-    a->availableBytes -= 8;
 
-    accessorPrivateCloseCoverage(a);
 
-    return accessorOk;
+static inline uint32_t accessorPrivateReadUInt32AtPointer(const uint8_t * ptr, accessorEndianness e)
+{
+    if (accessorPrivateIsBigEndianness[e])
+        return (uint32_t) ((uint32_t) ptr[0] << 24 | (uint32_t) ptr[1] << 16 | (uint32_t) ptr[2] << 8 | (uint32_t) ptr[3]);
+    else
+        return (uint32_t) ((uint32_t) ptr[3] << 24 | (uint32_t) ptr[2] << 16 | (uint32_t) ptr[1] << 8 | (uint32_t) ptr[0]);
 }
 
 
 
-accessorStatus accessorReadEndianFloat32(accessor_t * a, float * x, accessorEndianness e)
+static inline uint64_t accessorPrivateReadUInt64AtPointer(const uint8_t * ptr, accessorEndianness e)
 {
-    return accessorReadEndianUInt32(a, (uint32_t *) x, e);
+    if (accessorPrivateIsBigEndianness[e])
+        return (uint64_t) ((uint64_t) ptr[0] << 56 | (uint64_t) ptr[1] << 48 | (uint64_t) ptr[2] << 40 | (uint64_t) ptr[3] << 32 | (uint64_t) ptr[4] << 24 | (uint64_t) ptr[5] << 16 | (uint64_t) ptr[6] << 8 | (uint64_t) ptr[7]);
+    else
+        return (uint64_t) ((uint64_t) ptr[7] << 56 | (uint64_t) ptr[6] << 48 | (uint64_t) ptr[5] << 40 | (uint64_t) ptr[4] << 32 | (uint64_t) ptr[3] << 24 | (uint64_t) ptr[2] << 16 | (uint64_t) ptr[1] << 8 | (uint64_t) ptr[0]);
 }
 
 
 
-accessorStatus accessorReadEndianFloat64(accessor_t * a, double * x, accessorEndianness e)
+static inline int16_t accessorPrivateReadInt16AtPointer(const uint8_t * ptr, accessorEndianness e)
 {
-    return accessorReadEndianUInt64(a, (uint64_t *) x, e);
+    if (accessorPrivateIsBigEndianness[e])
+        return (int16_t) ((uint16_t) ptr[0] << 8 | (uint16_t) ptr[1]);
+    else
+        return (int16_t) ((uint16_t) ptr[1] << 8 | (uint16_t) ptr[0]);
 }
 
 
 
-accessorStatus accessorReadVarInt(accessor_t * a, uintmax_t * x)
+static inline int32_t accessorPrivateReadInt24AtPointer(const uint8_t * ptr, accessorEndianness e)
 {
-    uint8_t byte;
-    unsigned int shiftCount;
-    uintmax_t result;
-    size_t nbytes;
-    size_t availableBytes;
-    uint8_t * ptr;
+    int32_t x;
 
 
-    ptr = a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor;
-    availableBytes = a->availableBytes;
-    nbytes = 0;
+    if (accessorPrivateIsBigEndianness[e])
+        x = (int32_t) ((uint32_t) ptr[0] << 16 | (uint32_t) ptr[1] << 8 | (uint32_t) ptr[2]);
+    else
+        x = (int32_t) ((uint32_t) ptr[2] << 16 | (uint32_t) ptr[1] << 8 | (uint32_t) ptr[0]);
 
-    result = 0;
-    shiftCount = 0;
-    do
-    {
-        if (availableBytes < 1)
-            return accessorBeyondEnd;
-        byte = *ptr++;
-        availableBytes--;
-        nbytes++;
-        result |= ((uintmax_t) (byte & 0x7f)) << shiftCount;
-        shiftCount += 7;
-    } while ((byte & 0x80) && (shiftCount < (sizeof(uintmax_t) * 8)));
+    if (x & 0x800000)
+        x |= 0xff000000;
 
-    if (byte & 0x80)
-        return accessorInvalidReadData;
+    return x;
+}
 
-    a->availableBytes -= nbytes;
-    a->cursor += nbytes;
 
-    *x = result;
 
-    return accessorOk;
+static inline int32_t accessorPrivateReadInt32AtPointer(const uint8_t * ptr, accessorEndianness e)
+{
+    if (accessorPrivateIsBigEndianness[e])
+        return (int32_t) ((uint32_t) ptr[0] << 24 | (uint32_t) ptr[1] << 16 | (uint32_t) ptr[2] << 8 | (uint32_t) ptr[3]);
+    else
+        return (int32_t) ((uint32_t) ptr[3] << 24 | (uint32_t) ptr[2] << 16 | (uint32_t) ptr[1] << 8 | (uint32_t) ptr[0]);
 }
 
 
 
-accessorStatus accessorReadZigZagInt(accessor_t * a, intmax_t * x)
+static inline int64_t accessorPrivateReadInt64AtPointer(const uint8_t * ptr, accessorEndianness e)
 {
-    accessorStatus status;
-    uintmax_t varint;
+    if (accessorPrivateIsBigEndianness[e])
+        return (int64_t) ((uint64_t) ptr[0] << 56 | (uint64_t) ptr[1] << 48 | (uint64_t) ptr[2] << 40 | (uint64_t) ptr[3] << 32 | (uint64_t) ptr[4] << 24 | (uint64_t) ptr[5] << 16 | (uint64_t) ptr[6] << 8 | (uint64_t) ptr[7]);
+    else
+        return (int64_t) ((uint64_t) ptr[7] << 56 | (uint64_t) ptr[6] << 48 | (uint64_t) ptr[5] << 40 | (uint64_t) ptr[4] << 32 | (uint64_t) ptr[3] << 24 | (uint64_t) ptr[2] << 16 | (uint64_t) ptr[1] << 8 | (uint64_t) ptr[0]);
+}
 
 
-    status = accessorReadVarInt(a, &varint);
-    if (status != 0)
-        return status;
 
-    *x = (varint >> 1) ^ - (varint & 1);        // varint is unsigned, right shifts are OK
+static inline void accessorPrivateWriteUInt16AtPointer(uint8_t * ptr, uint16_t x, accessorEndianness e)
+{
+    if (accessorPrivateIsBigEndianness[e])
+        x = accessorSwapUInt16(x);
 
-    return accessorOk;
+    ptr[0] = (uint8_t) x;
+    ptr[1] = (uint8_t) (x >> 8);
 }
 
 
 
-accessorStatus accessorWriteEndianUInt(accessor_t * a, uintmax_t x, accessorEndianness e, size_t nbytes)
+static inline void accessorPrivateWriteUInt24AtPointer(uint8_t * ptr, uint32_t x, accessorEndianness e)
 {
-    accessorStatus status;
+    if (accessorPrivateIsBigEndianness[e])
+        x = accessorSwapUInt24(x);
 
+    ptr[0] = (uint8_t) x;
+    ptr[1] = (uint8_t) (x >> 8);
+    ptr[2] = (uint8_t) (x >> 16);
+}
+
+
+
+static inline void accessorPrivateWriteUInt32AtPointer(uint8_t * ptr, uint32_t x, accessorEndianness e)
+{
+    if (accessorPrivateIsBigEndianness[e])
+        x = accessorSwapUInt32(x);
+
+    ptr[0] = (uint8_t) x;
+    ptr[1] = (uint8_t) (x >> 8);
+    ptr[2] = (uint8_t) (x >> 16);
+    ptr[3] = (uint8_t) (x >> 24);
+}
+
+
+
+static inline void accessorPrivateWriteUInt64AtPointer(uint8_t * ptr, uint64_t x, accessorEndianness e)
+{
+    if (accessorPrivateIsBigEndianness[e])
+        x = accessorSwapUInt64(x);
+
+    ptr[0] = (uint8_t) x;
+    ptr[1] = (uint8_t) (x >> 8);
+    ptr[2] = (uint8_t) (x >> 16);
+    ptr[3] = (uint8_t) (x >> 24);
+    ptr[4] = (uint8_t) (x >> 32);
+    ptr[5] = (uint8_t) (x >> 40);
+    ptr[6] = (uint8_t) (x >> 48);
+    ptr[7] = (uint8_t) (x >> 56);
+}
+
+
+
+accessorStatus accessorReadUInt(accessor_t * a, uintmax_t * x, size_t nbytes)
+{
+    return accessorReadEndianUInt(a, x, a->endianness, nbytes);
+}
+
+
+
+accessorStatus accessorReadUInt8(accessor_t * a, uint8_t * x)
+{
+    if (a->availableBytes < 1)
+        return accessorBeyondEnd;
+
+    *x = * (uint8_t *) (a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor);
+
+    accessorPrivateOpenCoverage(a);
+
+    a->cursor += 1;
+    ACCESSOR_HOOK_READ(a, accessorApiReadScalar, 1);
+    a->availableBytes -= 1;
+
+    return accessorPrivateCloseCoverage(a);
+}
+
+
+
+accessorStatus accessorReadUInt16(accessor_t * a, uint16_t * x)
+{
+    if (a->availableBytes < 2)
+        return accessorBeyondEnd;
+
+    *x = accessorPrivateReadUInt16AtPointer(a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor, a->endianness);
+
+    accessorPrivateOpenCoverage(a);
+
+    a->cursor += 2;
+    ACCESSOR_HOOK_READ(a, accessorApiReadScalar, 2);
+    a->availableBytes -= 2;
+
+    return accessorPrivateCloseCoverage(a);
+}
+
+
+
+accessorStatus accessorReadUInt24(accessor_t * a, uint32_t * x)
+{
+    if (a->availableBytes < 3)
+        return accessorBeyondEnd;
+
+    *x = accessorPrivateReadUInt24AtPointer(a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor, a->endianness);
+
+    accessorPrivateOpenCoverage(a);
+
+    a->cursor += 3;
+    ACCESSOR_HOOK_READ(a, accessorApiReadScalar, 3);
+    a->availableBytes -= 3;
+
+    return accessorPrivateCloseCoverage(a);
+}
+
+
+
+accessorStatus accessorReadUInt32(accessor_t * a, uint32_t * x)
+{
+    if (a->availableBytes < 4)
+        return accessorBeyondEnd;
+
+    *x = accessorPrivateReadUInt32AtPointer(a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor, a->endianness);
+
+    accessorPrivateOpenCoverage(a);
+
+    a->cursor += 4;
+    ACCESSOR_HOOK_READ(a, accessorApiReadScalar, 4);
+    a->availableBytes -= 4;
+
+    return accessorPrivateCloseCoverage(a);
+}
+
+
+
+accessorStatus accessorReadUInt64(accessor_t * a, uint64_t * x)
+{
+    if (a->availableBytes < 8)
+        return accessorBeyondEnd;
+
+    *x = accessorPrivateReadUInt64AtPointer(a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor, a->endianness);
+
+    accessorPrivateOpenCoverage(a);
+
+    a->cursor += 8;
+    ACCESSOR_HOOK_READ(a, accessorApiReadScalar, 8);
+    a->availableBytes -= 8;
+
+    return accessorPrivateCloseCoverage(a);
+}
+
+
+
+accessorStatus accessorReadInt(accessor_t * a, intmax_t * x, size_t nbytes)
+{
+    return accessorReadEndianInt(a, x, a->endianness, nbytes);
+}
+
+
+
+accessorStatus accessorReadInt8(accessor_t * a, int8_t * x)
+{
+    if (a->availableBytes < 1)
+        return accessorBeyondEnd;
+
+    *x = * (int8_t *) (a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor);
+
+    accessorPrivateOpenCoverage(a);
+
+    a->cursor += 1;
+    ACCESSOR_HOOK_READ(a, accessorApiReadScalar, 1);
+    a->availableBytes -= 1;
+
+    return accessorPrivateCloseCoverage(a);
+}
+
+
+
+accessorStatus accessorReadInt16(accessor_t * a, int16_t * x)
+{
+    if (a->availableBytes < 2)
+        return accessorBeyondEnd;
+
+    *x = accessorPrivateReadInt16AtPointer(a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor, a->endianness);
+
+    accessorPrivateOpenCoverage(a);
+
+    a->cursor += 2;
+    ACCESSOR_HOOK_READ(a, accessorApiReadScalar, 2);
+    a->availableBytes -= 2;
+
+    return accessorPrivateCloseCoverage(a);
+}
+
+
+
+accessorStatus accessorReadInt24(accessor_t * a, int32_t * x)
+{
+    if (a->availableBytes < 3)
+        return accessorBeyondEnd;
+
+    *x = accessorPrivateReadInt24AtPointer(a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor, a->endianness);
+
+    accessorPrivateOpenCoverage(a);
+
+    a->cursor += 3;
+    ACCESSOR_HOOK_READ(a, accessorApiReadScalar, 3);
+    a->availableBytes -= 3;
+
+    return accessorPrivateCloseCoverage(a);
+}
+
+
+
+accessorStatus accessorReadInt32(accessor_t * a, int32_t * x)
+{
+    if (a->availableBytes < 4)
+        return accessorBeyondEnd;
+
+    *x = accessorPrivateReadInt32AtPointer(a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor, a->endianness);
+
+    accessorPrivateOpenCoverage(a);
+
+    a->cursor += 4;
+    ACCESSOR_HOOK_READ(a, accessorApiReadScalar, 4);
+    a->availableBytes -= 4;
+
+    return accessorPrivateCloseCoverage(a);
+}
+
+
+
+accessorStatus accessorReadInt64(accessor_t * a, int64_t * x)
+{
+    if (a->availableBytes < 8)
+        return accessorBeyondEnd;
+
+    *x = accessorPrivateReadInt64AtPointer(a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor, a->endianness);
+
+    accessorPrivateOpenCoverage(a);
+
+    a->cursor += 8;
+    ACCESSOR_HOOK_READ(a, accessorApiReadScalar, 8);
+    a->availableBytes -= 8;
+
+    return accessorPrivateCloseCoverage(a);
+}
+
+
+
+accessorStatus accessorReadFloat32(accessor_t * a, float * x)
+{
+    return accessorReadUInt32(a, (uint32_t *) x);
+}
+
+
+
+accessorStatus accessorReadFloat64(accessor_t * a, double * x)
+{
+    return accessorReadUInt64(a, (uint64_t *) x);
+}
+
+
+
+accessorStatus accessorReadEndianUInt(accessor_t * a, uintmax_t * x, accessorEndianness e, size_t nbytes)
+{
+    if (nbytes > sizeof(uintmax_t))
+        return accessorInvalidParameter;
+
+    if (a->availableBytes < nbytes)
+        return accessorBeyondEnd;
+
+    *x = accessorPrivateReadUIntAtPointer(a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor, e, nbytes);
+
+    accessorPrivateOpenCoverage(a);
+
+    a->cursor += nbytes;
+    ACCESSOR_HOOK_READ(a, accessorApiReadScalar, nbytes);
+    a->availableBytes -= nbytes;
+
+    return accessorPrivateCloseCoverage(a);
+}
+
+
+
+accessorStatus accessorReadEndianUInt16(accessor_t * a, uint16_t * x, accessorEndianness e)
+{
+    if (a->availableBytes < 2)
+        return accessorBeyondEnd;
+
+    *x = accessorPrivateReadUInt16AtPointer(a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor, e);
+
+    accessorPrivateOpenCoverage(a);
+
+    a->cursor += 2;
+    ACCESSOR_HOOK_READ(a, accessorApiReadScalar, 2);
+    a->availableBytes -= 2;
+
+    return accessorPrivateCloseCoverage(a);
+}
+
+
+
+accessorStatus accessorReadEndianUInt24(accessor_t * a, uint32_t * x, accessorEndianness e)
+{
+    if (a->availableBytes < 3)
+        return accessorBeyondEnd;
+
+    *x = accessorPrivateReadUInt24AtPointer(a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor, e);
+
+    accessorPrivateOpenCoverage(a);
+
+    a->cursor += 3;
+    ACCESSOR_HOOK_READ(a, accessorApiReadScalar, 3);
+    a->availableBytes -= 3;
+
+    return accessorPrivateCloseCoverage(a);
+}
+
+
+
+accessorStatus accessorReadEndianUInt32(accessor_t * a, uint32_t * x, accessorEndianness e)
+{
+    if (a->availableBytes < 4)
+        return accessorBeyondEnd;
+
+    *x = accessorPrivateReadUInt32AtPointer(a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor, e);
+
+    accessorPrivateOpenCoverage(a);
+
+    a->cursor += 4;
+    ACCESSOR_HOOK_READ(a, accessorApiReadScalar, 4);
+    a->availableBytes -= 4;
+
+    return accessorPrivateCloseCoverage(a);
+}
+
+
+
+accessorStatus accessorReadEndianUInt64(accessor_t * a, uint64_t * x, accessorEndianness e)
+{
+    if (a->availableBytes < 8)
+        return accessorBeyondEnd;
+
+    *x = accessorPrivateReadUInt64AtPointer(a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor, e);
+
+    accessorPrivateOpenCoverage(a);
+
+    a->cursor += 8;
+    ACCESSOR_HOOK_READ(a, accessorApiReadScalar, 8);
+    a->availableBytes -= 8;
+
+    return accessorPrivateCloseCoverage(a);
+}
+
+
+
+accessorStatus accessorReadEndianInt(accessor_t * a, intmax_t * x, accessorEndianness e, size_t nbytes)
+{
+    if (nbytes > sizeof(intmax_t))
+        return accessorInvalidParameter;
+
+    if (a->availableBytes < nbytes)
+        return accessorBeyondEnd;
+
+    *x = accessorPrivateReadIntAtPointer(a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor, e, nbytes);
+
+    accessorPrivateOpenCoverage(a);
+
+    a->cursor += nbytes;
+    ACCESSOR_HOOK_READ(a, accessorApiReadScalar, nbytes);
+    a->availableBytes -= nbytes;
+
+    return accessorPrivateCloseCoverage(a);
+}
+
+
+
+accessorStatus accessorReadEndianInt16(accessor_t * a, int16_t * x, accessorEndianness e)
+{
+    if (a->availableBytes < 2)
+        return accessorBeyondEnd;
+
+    *x = accessorPrivateReadInt16AtPointer(a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor, e);
+
+    accessorPrivateOpenCoverage(a);
+
+    a->cursor += 2;
+    ACCESSOR_HOOK_READ(a, accessorApiReadScalar, 2);
+    a->availableBytes -= 2;
+
+    return accessorPrivateCloseCoverage(a);
+}
+
+
+
+accessorStatus accessorReadEndianInt24(accessor_t * a, int32_t * x, accessorEndianness e)
+{
+    if (a->availableBytes < 3)
+        return accessorBeyondEnd;
+
+    *x = accessorPrivateReadInt24AtPointer(a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor, e);
+
+    accessorPrivateOpenCoverage(a);
+
+    a->cursor += 3;
+    ACCESSOR_HOOK_READ(a, accessorApiReadScalar, 3);
+    a->availableBytes -= 3;
+
+    return accessorPrivateCloseCoverage(a);
+}
+
+
+
+accessorStatus accessorReadEndianInt32(accessor_t * a, int32_t * x, accessorEndianness e)
+{
+    if (a->availableBytes < 4)
+        return accessorBeyondEnd;
+
+    *x = accessorPrivateReadInt32AtPointer(a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor, e);
+
+    accessorPrivateOpenCoverage(a);
+
+    a->cursor += 4;
+    ACCESSOR_HOOK_READ(a, accessorApiReadScalar, 4);
+    a->availableBytes -= 4;
+
+    return accessorPrivateCloseCoverage(a);
+}
+
+
+
+accessorStatus accessorReadEndianInt64(accessor_t * a, int64_t * x, accessorEndianness e)
+{
+    if (a->availableBytes < 8)
+        return accessorBeyondEnd;
+
+    *x = accessorPrivateReadInt64AtPointer(a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor, e);
+
+    accessorPrivateOpenCoverage(a);
+
+    a->cursor += 8;
+    ACCESSOR_HOOK_READ(a, accessorApiReadScalar, 8);
+    a->availableBytes -= 8;
+
+    return accessorPrivateCloseCoverage(a);
+}
+
+
+
+accessorStatus accessorReadEndianFloat32(accessor_t * a, float * x, accessorEndianness e)
+{
+    return accessorReadEndianUInt32(a, (uint32_t *) x, e);
+}
+
+
+
+accessorStatus accessorReadEndianFloat64(accessor_t * a, double * x, accessorEndianness e)
+{
+    return accessorReadEndianUInt64(a, (uint64_t *) x, e);
+}
+
+
+
+accessorStatus accessorReadVarInt(accessor_t * a, uintmax_t * x)
+{
+    uint8_t byte;
+    unsigned int shiftCount;
+    uintmax_t result;
+    size_t nbytes;
+    size_t availableBytes;
+    uint8_t * ptr;
+
+
+    ptr = a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor;
+    availableBytes = a->availableBytes;
+    nbytes = 0;
+
+    result = 0;
+    shiftCount = 0;
+    do
+    {
+        if (availableBytes < 1)
+            return accessorBeyondEnd;
+        byte = *ptr++;
+        availableBytes--;
+        nbytes++;
+        result |= ((uintmax_t) (byte & 0x7f)) << shiftCount;
+        shiftCount += 7;
+    } while ((byte & 0x80) && (shiftCount < (sizeof(uintmax_t) * 8)));
+
+    if (byte & 0x80)
+        return accessorInvalidReadData;
+
+    a->availableBytes -= nbytes;
+    a->cursor += nbytes;
+    ACCESSOR_HOOK_READ(a, accessorApiReadVarInt, nbytes);
+
+    *x = result;
+
+    return accessorOk;
+}
+
+
+
+accessorStatus accessorReadZigZagInt(accessor_t * a, intmax_t * x)
+{
+    accessorStatus status;
+    uintmax_t varint;
+
+
+    status = accessorReadVarInt(a, &varint);
+    if (status != 0)
+        return status;
+
+    *x = (varint >> 1) ^ - (varint & 1);        // varint is unsigned, right shifts are OK
+
+    return accessorOk;
+}
+
+
+
+accessorStatus accessorWriteEndianUInt(accessor_t * a, uintmax_t x, accessorEndianness e, size_t nbytes)
+{
+    accessorStatus status;
+    uint8_t * ptr;
+
+
+    if (!a->writeEnabled)
+        return accessorReadOnlyError;
+
+    if (nbytes > sizeof(uintmax_t))
+        return accessorInvalidParameter;
+
+    status = accessorPrivateGetPointerForWrite(&ptr, a, nbytes, accessorApiWriteScalar);
+    if (status != accessorOk)
+        return status;
+
+    accessorPrivateWriteUIntAtPointer(ptr, x, e, nbytes);
+
+    return accessorOk;
+}
+
+
+
+accessorStatus accessorWriteEndianUInt16(accessor_t * a, uint16_t x, accessorEndianness e)
+{
+    accessorStatus status;
+    uint8_t * ptr;
+
+
+    if (!a->writeEnabled)
+        return accessorReadOnlyError;
+
+    status = accessorPrivateGetPointerForWrite(&ptr, a, 2, accessorApiWriteScalar);
+    if (status != accessorOk)
+        return status;
+
+    accessorPrivateWriteUInt16AtPointer(ptr, x, e);
+
+    return accessorOk;
+}
+
+
+
+accessorStatus accessorWriteEndianUInt24(accessor_t * a, uint32_t x, accessorEndianness e)
+{
+    accessorStatus status;
+    uint8_t * ptr;
+
+
+    if (!a->writeEnabled)
+        return accessorReadOnlyError;
+
+    status = accessorPrivateGetPointerForWrite(&ptr, a, 3, accessorApiWriteScalar);
+    if (status != accessorOk)
+        return status;
+
+    accessorPrivateWriteUInt24AtPointer(ptr, x, e);
+
+    return accessorOk;
+}
+
+
+
+accessorStatus accessorWriteEndianUInt32(accessor_t * a, uint32_t x, accessorEndianness e)
+{
+    accessorStatus status;
+    uint8_t * ptr;
+
+
+    if (!a->writeEnabled)
+        return accessorReadOnlyError;
+
+    status = accessorPrivateGetPointerForWrite(&ptr, a, 4, accessorApiWriteScalar);
+    if (status != accessorOk)
+        return status;
+
+    accessorPrivateWriteUInt32AtPointer(ptr, x, e);
+
+    return accessorOk;
+}
+
+
+
+accessorStatus accessorWriteEndianUInt64(accessor_t * a, uint64_t x, accessorEndianness e)
+{
+    accessorStatus status;
+    uint8_t * ptr;
+
+
+    if (!a->writeEnabled)
+        return accessorReadOnlyError;
+
+    status = accessorPrivateGetPointerForWrite(&ptr, a, 8, accessorApiWriteScalar);
+    if (status != accessorOk)
+        return status;
+
+    accessorPrivateWriteUInt64AtPointer(ptr, x, e);
+
+    return accessorOk;
+}
+
+
+
+accessorStatus accessorWriteEndianInt(accessor_t * a, intmax_t x, accessorEndianness e, size_t nbytes)
+{
+    return accessorWriteEndianUInt(a, (uintmax_t) x, e, nbytes);
+}
+
+
+
+accessorStatus accessorWriteEndianInt16(accessor_t * a, int16_t x, accessorEndianness e)
+{
+    accessorStatus status;
+    uint8_t * ptr;
+
+
+    if (!a->writeEnabled)
+        return accessorReadOnlyError;
+
+    status = accessorPrivateGetPointerForWrite(&ptr, a, 2, accessorApiWriteScalar);
+    if (status != accessorOk)
+        return status;
+
+    accessorPrivateWriteUInt16AtPointer(ptr, (uint16_t) x, e);
+
+    return accessorOk;
+}
+
+
+
+accessorStatus accessorWriteEndianInt24(accessor_t * a, int32_t x, accessorEndianness e)
+{
+    accessorStatus status;
+    uint8_t * ptr;
+
+
+    if (!a->writeEnabled)
+        return accessorReadOnlyError;
+
+    status = accessorPrivateGetPointerForWrite(&ptr, a, 3, accessorApiWriteScalar);
+    if (status != accessorOk)
+        return status;
+
+    accessorPrivateWriteUInt24AtPointer(ptr, (uint32_t) x, e);
+
+    return accessorOk;
+}
+
+
+
+accessorStatus accessorWriteEndianInt32(accessor_t * a, int32_t x, accessorEndianness e)
+{
+    accessorStatus status;
+    uint8_t * ptr;
+
+
+    if (!a->writeEnabled)
+        return accessorReadOnlyError;
+
+    status = accessorPrivateGetPointerForWrite(&ptr, a, 4, accessorApiWriteScalar);
+    if (status != accessorOk)
+        return status;
+
+    accessorPrivateWriteUInt32AtPointer(ptr, (uint32_t) x, e);
+
+    return accessorOk;
+}
+
+
+
+accessorStatus accessorWriteEndianInt64(accessor_t * a, int64_t x, accessorEndianness e)
+{
+    accessorStatus status;
+    uint8_t * ptr;
+
+
+    if (!a->writeEnabled)
+        return accessorReadOnlyError;
+
+    status = accessorPrivateGetPointerForWrite(&ptr, a, 8, accessorApiWriteScalar);
+    if (status != accessorOk)
+        return status;
+
+    accessorPrivateWriteUInt64AtPointer(ptr, (uint64_t) x, e);
+
+    return accessorOk;
+}
+
+
+
+accessorStatus accessorWriteEndianFloat32(accessor_t * a, float x, accessorEndianness e)
+{
+    return accessorWriteEndianUInt32(a, * (uint32_t *) &x, e);
+}
+
+
+
+accessorStatus accessorWriteEndianFloat64(accessor_t * a, double x, accessorEndianness e)
+{
+    return accessorWriteEndianUInt64(a, * (uint64_t *) &x, e);
+}
+
+
+
+accessorStatus accessorWriteUInt(accessor_t * a, uintmax_t x, size_t nbytes)
+{
+    return accessorWriteEndianUInt(a, x, a->endianness, nbytes);
+}
+
+
+
+accessorStatus accessorWriteUInt8(accessor_t * a, uint8_t x)
+{
+    accessorStatus status;
+    uint8_t * ptr;
+
+
+    if (!a->writeEnabled)
+        return accessorReadOnlyError;
+
+    status = accessorPrivateGetPointerForWrite(&ptr, a, 1, accessorApiWriteScalar);
+    if (status != accessorOk)
+        return status;
+
+    * (uint8_t *) ptr = x;
+
+    return accessorOk;
+}
+
+
+
+accessorStatus accessorWriteUInt16(accessor_t * a, uint16_t x)
+{
+    accessorStatus status;
+    uint8_t * ptr;
+
+
+    if (!a->writeEnabled)
+        return accessorReadOnlyError;
+
+    status = accessorPrivateGetPointerForWrite(&ptr, a, 2, accessorApiWriteScalar);
+    if (status != accessorOk)
+        return status;
+
+    accessorPrivateWriteUInt16AtPointer(ptr, x, a->endianness);
+
+    return accessorOk;
+}
+
+
+
+accessorStatus accessorWriteUInt24(accessor_t * a, uint32_t x)
+{
+    accessorStatus status;
+    uint8_t * ptr;
+
+
+    if (!a->writeEnabled)
+        return accessorReadOnlyError;
+
+    status = accessorPrivateGetPointerForWrite(&ptr, a, 3, accessorApiWriteScalar);
+    if (status != accessorOk)
+        return status;
+
+    accessorPrivateWriteUInt24AtPointer(ptr, x, a->endianness);
+
+    return accessorOk;
+}
+
+
+
+accessorStatus accessorWriteUInt32(accessor_t * a, uint32_t x)
+{
+    accessorStatus status;
+    uint8_t * ptr;
+
+
+    if (!a->writeEnabled)
+        return accessorReadOnlyError;
+
+    status = accessorPrivateGetPointerForWrite(&ptr, a, 4, accessorApiWriteScalar);
+    if (status != accessorOk)
+        return status;
+
+    accessorPrivateWriteUInt32AtPointer(ptr, x, a->endianness);
+
+    return accessorOk;
+}
+
+
+
+accessorStatus accessorWriteUInt64(accessor_t * a, uint64_t x)
+{
+    accessorStatus status;
+    uint8_t * ptr;
+
+
+    if (!a->writeEnabled)
+        return accessorReadOnlyError;
+
+    status = accessorPrivateGetPointerForWrite(&ptr, a, 8, accessorApiWriteScalar);
+    if (status != accessorOk)
+        return status;
+
+    accessorPrivateWriteUInt64AtPointer(ptr, x, a->endianness);
+
+    return accessorOk;
+}
+
+
+
+accessorStatus accessorWriteInt(accessor_t * a, intmax_t x, size_t nbytes)
+{
+    return accessorWriteEndianInt(a, x, a->endianness, nbytes);
+}
+
+
+
+accessorStatus accessorWriteInt8(accessor_t * a, int8_t x)
+{
+    accessorStatus status;
+    uint8_t * ptr;
+
+
+    if (!a->writeEnabled)
+        return accessorReadOnlyError;
+
+    status = accessorPrivateGetPointerForWrite(&ptr, a, 1, accessorApiWriteScalar);
+    if (status != accessorOk)
+        return status;
+
+    * (int8_t *) ptr = x;
+
+    return accessorOk;
+}
+
+
+
+accessorStatus accessorWriteInt16(accessor_t * a, int16_t x)
+{
+    accessorStatus status;
+    uint8_t * ptr;
+
+
+    if (!a->writeEnabled)
+        return accessorReadOnlyError;
+
+    status = accessorPrivateGetPointerForWrite(&ptr, a, 2, accessorApiWriteScalar);
+    if (status != accessorOk)
+        return status;
+
+    accessorPrivateWriteUInt16AtPointer(ptr, (uint16_t) x, a->endianness);
+
+    return accessorOk;
+}
+
+
+
+accessorStatus accessorWriteInt24(accessor_t * a, int32_t x)
+{
+    accessorStatus status;
+    uint8_t * ptr;
+
+
+    if (!a->writeEnabled)
+        return accessorReadOnlyError;
+
+    status = accessorPrivateGetPointerForWrite(&ptr, a, 3, accessorApiWriteScalar);
+    if (status != accessorOk)
+        return status;
+
+    accessorPrivateWriteUInt24AtPointer(ptr, (uint32_t) x, a->endianness);
+
+    return accessorOk;
+}
+
+
+
+accessorStatus accessorWriteInt32(accessor_t * a, int32_t x)
+{
+    accessorStatus status;
+    uint8_t * ptr;
+
+
+    if (!a->writeEnabled)
+        return accessorReadOnlyError;
+
+    status = accessorPrivateGetPointerForWrite(&ptr, a, 4, accessorApiWriteScalar);
+    if (status != accessorOk)
+        return status;
+
+    accessorPrivateWriteUInt32AtPointer(ptr, (uint32_t) x, a->endianness);
+
+    return accessorOk;
+}
+
+
+
+accessorStatus accessorWriteInt64(accessor_t * a, int64_t x)
+{
+    accessorStatus status;
+    uint8_t * ptr;
+
+
+    if (!a->writeEnabled)
+        return accessorReadOnlyError;
+
+    status = accessorPrivateGetPointerForWrite(&ptr, a, 8, accessorApiWriteScalar);
+    if (status != accessorOk)
+        return status;
+
+    accessorPrivateWriteUInt64AtPointer(ptr, (uint64_t) x, a->endianness);
+
+    return accessorOk;
+}
+
+
+
+accessorStatus accessorWriteFloat32(accessor_t * a, float x)
+{
+    return accessorWriteUInt32(a, * (uint32_t *) &x);
+}
+
+
+
+accessorStatus accessorWriteFloat64(accessor_t * a, double x)
+{
+    return accessorWriteUInt64(a, * (uint64_t *) &x);
+}
+
+
+
+accessorStatus accessorWriteVarInt(accessor_t * a, uintmax_t x)
+{
+    accessorStatus status;
+    size_t nbytes;
+    uintmax_t tmp;
+    uint8_t * ptr;
+
+
+    if (!a->writeEnabled)
+        return accessorReadOnlyError;
+
+    tmp = x;
+    nbytes = 0;
+    do
+    {
+        nbytes++;
+        tmp >>= 7;                      // tmp is unsigned, right shifts are OK
+    } while (tmp != 0);
+
+    status = accessorPrivateGetPointerForWrite(&ptr, a, nbytes, accessorApiWriteVarInt);   // at most 10 bytes, null accessors return their scratch buffer
+    if (status != accessorOk)
+        return status;
+
+    while (--nbytes)                    // loop will be executed nbytes-1 times
+    {
+        *ptr++ = (x & 0x7f) | 0x80;     // another byte follows
+        x >>= 7;                        // x is unsigned, right shifts are OK
+    }
+    *ptr++ = x & 0x7f;                  // last byte
+
+    return accessorOk;
+}
+
+
+
+accessorStatus accessorWriteZigZagInt(accessor_t * a, intmax_t x)
+{
+    if (x >= 0)                         // avoid implementation dependent negative numbers right shifts
+        return accessorWriteVarInt(a, (uintmax_t) x << 1);
+    else
+        return accessorWriteVarInt(a, ~((uintmax_t) x << 1));
+}
+
+
+
+accessorStatus accessorReadEndianUInt16Array(accessor_t * a, uint16_t ** array, size_t count, accessorEndianness e)
+{
+    size_t byteCount;
+    uint16_t * dst;
+
+
+    byteCount = count * 2;
+    if (a->availableBytes < byteCount)
+        return accessorBeyondEnd;
+
+    dst = malloc(count * sizeof(**array));
+    if (dst == NULL)
+        return accessorOutOfMemory;
+
+    memcpy(dst, a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor, byteCount);
+
+    if (accessorPrivateIsReverseEndianness[e])
+        for (size_t i = 0; i < count; i++)
+            dst[i] = accessorSwapUInt16(dst[i]);
+
+    accessorPrivateOpenCoverage(a);
+
+    a->cursor += byteCount;
+    ACCESSOR_HOOK_READ(a, accessorApiReadArray, byteCount);
+    ACCESSOR_STATS_ADD(a, allocations, 1);
+    a->availableBytes -= byteCount;
+
+    if (accessorPrivateCloseCoverage(a) != accessorOk)
+    {
+        free(dst);
+        return accessorOutOfMemory;
+    }
+
+    * array = dst;
+
+    return accessorOk;
+}
+
+
+
+accessorStatus accessorReadEndianUInt24Array(accessor_t * a, uint32_t ** array, size_t count, accessorEndianness e)
+{
+    size_t byteCount;
+    uint32_t * dst;
+    uint8_t * src;
+
+
+    byteCount = count * 3;
+    if (a->availableBytes < byteCount)
+        return accessorBeyondEnd;
+
+    dst = malloc(count * sizeof(**array));
+    if (dst == NULL)
+        return accessorOutOfMemory;
+
+    src = a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor;
+    for (size_t i = 0; i < count; i++)
+    {
+        dst[i] = accessorPrivateReadUInt24AtPointer(src, e);
+        src += 3;
+    }
+
+    accessorPrivateOpenCoverage(a);
+
+    a->cursor += byteCount;
+    ACCESSOR_HOOK_READ(a, accessorApiReadArray, byteCount);
+    ACCESSOR_STATS_ADD(a, allocations, 1);
+    a->availableBytes -= byteCount;
+
+    if (accessorPrivateCloseCoverage(a) != accessorOk)
+    {
+        free(dst);
+        return accessorOutOfMemory;
+    }
+
+    * array = dst;
+
+    return accessorOk;
+}
+
+
+
+accessorStatus accessorReadEndianUInt32Array(accessor_t * a, uint32_t ** array, size_t count, accessorEndianness e)
+{
+    size_t byteCount;
+    uint32_t * dst;
+
+
+    byteCount = count * 4;
+    if (a->availableBytes < byteCount)
+        return accessorBeyondEnd;
+
+    dst = malloc(count * sizeof(**array));
+    if (dst == NULL)
+        return accessorOutOfMemory;
+
+    memcpy(dst, a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor, byteCount);
+
+    if (accessorPrivateIsReverseEndianness[e])
+        for (size_t i = 0; i < count; i++)
+            dst[i] = accessorSwapUInt32(dst[i]);
+
+    accessorPrivateOpenCoverage(a);
+
+    a->cursor += byteCount;
+    ACCESSOR_HOOK_READ(a, accessorApiReadArray, byteCount);
+    ACCESSOR_STATS_ADD(a, allocations, 1);
+    a->availableBytes -= byteCount;
+
+    if (accessorPrivateCloseCoverage(a) != accessorOk)
+    {
+        free(dst);
+        return accessorOutOfMemory;
+    }
+
+    * array = dst;
+
+    return accessorOk;
+}
+
+
+
+accessorStatus accessorReadEndianUInt64Array(accessor_t * a, uint64_t ** array, size_t count, accessorEndianness e)
+{
+    size_t byteCount;
+    uint64_t * dst;
+
+
+    byteCount = count * 8;
+    if (a->availableBytes < byteCount)
+        return accessorBeyondEnd;
+
+    dst = malloc(count * sizeof(**array));
+    if (dst == NULL)
+        return accessorOutOfMemory;
+
+    memcpy(dst, a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor, byteCount);
+
+    if (accessorPrivateIsReverseEndianness[e])
+        for (size_t i = 0; i < count; i++)
+            dst[i] = accessorSwapUInt64(dst[i]);
+
+    accessorPrivateOpenCoverage(a);
+
+    a->cursor += byteCount;
+    ACCESSOR_HOOK_READ(a, accessorApiReadArray, byteCount);
+    ACCESSOR_STATS_ADD(a, allocations, 1);
+    a->availableBytes -= byteCount;
+
+    if (accessorPrivateCloseCoverage(a) != accessorOk)
+    {
+        free(dst);
+        return accessorOutOfMemory;
+    }
+
+    * array = dst;
+
+    return accessorOk;
+}
+
+
+
+accessorStatus accessorReadEndianInt16Array(accessor_t * a, int16_t ** array, size_t count, accessorEndianness e)
+{
+    size_t byteCount;
+    int16_t * dst;
+
+
+    byteCount = count * 2;
+    if (a->availableBytes < byteCount)
+        return accessorBeyondEnd;
+
+    dst = malloc(count * sizeof(**array));
+    if (dst == NULL)
+        return accessorOutOfMemory;
+
+    memcpy(dst, a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor, byteCount);
+
+    if (accessorPrivateIsReverseEndianness[e])
+        for (size_t i = 0; i < count; i++)
+            dst[i] = (int16_t) accessorSwapUInt16((uint16_t) dst[i]);
+
+    accessorPrivateOpenCoverage(a);
+
+    a->cursor += byteCount;
+    ACCESSOR_HOOK_READ(a, accessorApiReadArray, byteCount);
+    ACCESSOR_STATS_ADD(a, allocations, 1);
+    a->availableBytes -= byteCount;
+
+    if (accessorPrivateCloseCoverage(a) != accessorOk)
+    {
+        free(dst);
+        return accessorOutOfMemory;
+    }
+
+    * array = dst;
+
+    return accessorOk;
+}
+
+
+
+accessorStatus accessorReadEndianInt24Array(accessor_t * a, int32_t ** array, size_t count, accessorEndianness e)
+{
+    size_t byteCount;
+    int32_t * dst;
+    uint8_t * src;
+
+
+    byteCount = count * 3;
+    if (a->availableBytes < byteCount)
+        return accessorBeyondEnd;
+
+    dst = malloc(count * sizeof(**array));
+    if (dst == NULL)
+        return accessorOutOfMemory;
+
+    src = a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor;
+    for (size_t i = 0; i < count; i++)
+    {
+        dst[i] = accessorPrivateReadInt24AtPointer(src, e);
+        src += 3;
+    }
+
+    accessorPrivateOpenCoverage(a);
+
+    a->cursor += byteCount;
+    ACCESSOR_HOOK_READ(a, accessorApiReadArray, byteCount);
+    ACCESSOR_STATS_ADD(a, allocations, 1);
+    a->availableBytes -= byteCount;
+
+    if (accessorPrivateCloseCoverage(a) != accessorOk)
+    {
+        free(dst);
+        return accessorOutOfMemory;
+    }
+
+    * array = dst;
+
+    return accessorOk;
+}
+
+
+
+accessorStatus accessorReadEndianInt32Array(accessor_t * a, int32_t ** array, size_t count, accessorEndianness e)
+{
+    size_t byteCount;
+    int32_t * dst;
+
+
+    byteCount = count * 4;
+    if (a->availableBytes < byteCount)
+        return accessorBeyondEnd;
+
+    dst = malloc(count * sizeof(**array));
+    if (dst == NULL)
+        return accessorOutOfMemory;
+
+    memcpy(dst, a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor, byteCount);
+
+    if (accessorPrivateIsReverseEndianness[e])
+        for (size_t i = 0; i < count; i++)
+            dst[i] = (int32_t) accessorSwapUInt32((uint32_t) dst[i]);
+
+    accessorPrivateOpenCoverage(a);
+
+    a->cursor += byteCount;
+    ACCESSOR_HOOK_READ(a, accessorApiReadArray, byteCount);
+    ACCESSOR_STATS_ADD(a, allocations, 1);
+    a->availableBytes -= byteCount;
+
+    if (accessorPrivateCloseCoverage(a) != accessorOk)
+    {
+        free(dst);
+        return accessorOutOfMemory;
+    }
+
+    * array = dst;
+
+    return accessorOk;
+}
+
+
+
+accessorStatus accessorReadEndianInt64Array(accessor_t * a, int64_t ** array, size_t count, accessorEndianness e)
+{
+    size_t byteCount;
+    int64_t * dst;
+
+
+    byteCount = count * 8;
+    if (a->availableBytes < byteCount)
+        return accessorBeyondEnd;
+
+    dst = malloc(count * sizeof(**array));
+    if (dst == NULL)
+        return accessorOutOfMemory;
+
+    memcpy(dst, a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor, byteCount);
+
+    if (accessorPrivateIsReverseEndianness[e])
+        for (size_t i = 0; i < count; i++)
+            dst[i] = (int64_t) accessorSwapUInt64((uint64_t) dst[i]);
+
+    accessorPrivateOpenCoverage(a);
+
+    a->cursor += byteCount;
+    ACCESSOR_HOOK_READ(a, accessorApiReadArray, byteCount);
+    ACCESSOR_STATS_ADD(a, allocations, 1);
+    a->availableBytes -= byteCount;
+
+    if (accessorPrivateCloseCoverage(a) != accessorOk)
+    {
+        free(dst);
+        return accessorOutOfMemory;
+    }
+
+    * array = dst;
+
+    return accessorOk;
+}
+
+
+
+accessorStatus accessorReadEndianFloat32Array(accessor_t * a, float ** array, size_t count, accessorEndianness e)
+{
+    return accessorReadEndianUInt32Array(a, (uint32_t **) array, count, e);
+}
+
+
+
+accessorStatus accessorReadEndianFloat64Array(accessor_t * a, double ** array, size_t count, accessorEndianness e)
+{
+    return accessorReadEndianUInt64Array(a, (uint64_t **) array, count, e);
+}
+
+
+
+accessorStatus accessorReadUInt16Array(accessor_t * a, uint16_t ** array, size_t count)
+{
+    return accessorReadEndianUInt16Array(a, array, count, a->endianness);
+}
+
+
+
+accessorStatus accessorReadUInt24Array(accessor_t * a, uint32_t ** array, size_t count)
+{
+    return accessorReadEndianUInt24Array(a, array, count, a->endianness);
+}
+
+
+
+accessorStatus accessorReadUInt32Array(accessor_t * a, uint32_t ** array, size_t count)
+{
+    return accessorReadEndianUInt32Array(a, array, count, a->endianness);
+}
+
+
+
+accessorStatus accessorReadUInt64Array(accessor_t * a, uint64_t ** array, size_t count)
+{
+    return accessorReadEndianUInt64Array(a, array, count, a->endianness);
+}
+
+
+
+accessorStatus accessorReadInt16Array(accessor_t * a, int16_t ** array, size_t count)
+{
+    return accessorReadEndianInt16Array(a, array, count, a->endianness);
+}
+
+
+
+accessorStatus accessorReadInt24Array(accessor_t * a, int32_t ** array, size_t count)
+{
+    return accessorReadEndianInt24Array(a, array, count, a->endianness);
+}
+
+
+
+accessorStatus accessorReadInt32Array(accessor_t * a, int32_t ** array, size_t count)
+{
+    return accessorReadEndianInt32Array(a, array, count, a->endianness);
+}
+
+
+
+accessorStatus accessorReadInt64Array(accessor_t * a, int64_t ** array, size_t count)
+{
+    return accessorReadEndianInt64Array(a, array, count, a->endianness);
+}
+
+
+
+accessorStatus accessorReadFloat32Array(accessor_t * a, float ** array, size_t count)
+{
+    return accessorReadEndianFloat32Array(a, array, count, a->endianness);
+}
+
+
+
+accessorStatus accessorReadFloat64Array(accessor_t * a, double ** array, size_t count)
+{
+    return accessorReadEndianFloat64Array(a, array, count, a->endianness);
+}
+
+
+
+accessorStatus accessorWriteEndianUInt16Array(accessor_t * a, const uint16_t * array, size_t count, accessorEndianness e)
+{
+    accessorStatus status;
+    size_t byteCount;
+    uint8_t * dst;
+
+
+    if (!a->writeEnabled)
+        return accessorReadOnlyError;
+
+    byteCount = count * 2;
+    status = accessorPrivateGetPointerForWrite(&dst, a, byteCount, accessorApiWriteArray);
+    if (status != accessorOk)
+        return status;
+
+    if (dst == NULL)                    // null accessor
+        return accessorOk;
+
+    memcpy(dst, array, byteCount);
+
+    if (accessorPrivateIsReverseEndianness[e])
+        for (size_t i = 0; i < count; i++)
+        {
+            accessorPrivateWriteUInt16AtPointer(dst, accessorPrivateReadUInt16AtPointer(dst, accessorBig), accessorLittle);
+            dst += 2;
+        }
+
+    return accessorOk;
+}
+
+
+
+accessorStatus accessorWriteEndianUInt24Array(accessor_t * a, const uint32_t * array, size_t count, accessorEndianness e)
+{
+    accessorStatus status;
+    size_t byteCount;
+    uint8_t * dst;
+
+
+    if (!a->writeEnabled)
+        return accessorReadOnlyError;
+
+    byteCount = count * 3;
+    status = accessorPrivateGetPointerForWrite(&dst, a, byteCount, accessorApiWriteArray);
+    if (status != accessorOk)
+        return status;
+
+    if (dst == NULL)                    // null accessor
+        return accessorOk;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        accessorPrivateWriteUInt24AtPointer(dst, array[i], e);
+        dst += 3;
+    }
+
+    return accessorOk;
+}
+
+
+
+accessorStatus accessorWriteEndianUInt32Array(accessor_t * a, const uint32_t * array, size_t count, accessorEndianness e)
+{
+    accessorStatus status;
+    size_t byteCount;
+    uint8_t * dst;
+
+
+    if (!a->writeEnabled)
+        return accessorReadOnlyError;
+
+    byteCount = count * 4;
+    status = accessorPrivateGetPointerForWrite(&dst, a, byteCount, accessorApiWriteArray);
+    if (status != accessorOk)
+        return status;
+
+    if (dst == NULL)                    // null accessor
+        return accessorOk;
+
+    memcpy(dst, array, byteCount);
+
+    if (accessorPrivateIsReverseEndianness[e])
+        for (size_t i = 0; i < count; i++)
+        {
+            accessorPrivateWriteUInt32AtPointer(dst, accessorPrivateReadUInt32AtPointer(dst, accessorBig), accessorLittle);
+            dst += 4;
+        }
+
+    return accessorOk;
+}
+
+
+
+accessorStatus accessorWriteEndianUInt64Array(accessor_t * a, const uint64_t * array, size_t count, accessorEndianness e)
+{
+    accessorStatus status;
+    size_t byteCount;
+    uint8_t * dst;
+
+
+    if (!a->writeEnabled)
+        return accessorReadOnlyError;
+
+    byteCount = count * 8;
+    status = accessorPrivateGetPointerForWrite(&dst, a, byteCount, accessorApiWriteArray);
+    if (status != accessorOk)
+        return status;
+
+    if (dst == NULL)                    // null accessor
+        return accessorOk;
+
+    memcpy(dst, array, byteCount);
+
+    if (accessorPrivateIsReverseEndianness[e])
+        for (size_t i = 0; i < count; i++)
+        {
+            accessorPrivateWriteUInt64AtPointer(dst, accessorPrivateReadUInt64AtPointer(dst, accessorBig), accessorLittle);
+            dst += 8;
+        }
+
+    return accessorOk;
+}
+
+
+
+accessorStatus accessorWriteEndianInt16Array(accessor_t * a, const int16_t * array, size_t count, accessorEndianness e)
+{
+    accessorStatus status;
+    size_t byteCount;
+    uint8_t * dst;
+
+
+    if (!a->writeEnabled)
+        return accessorReadOnlyError;
+
+    byteCount = count * 2;
+    status = accessorPrivateGetPointerForWrite(&dst, a, byteCount, accessorApiWriteArray);
+    if (status != accessorOk)
+        return status;
+
+    if (dst == NULL)                    // null accessor
+        return accessorOk;
+
+    memcpy(dst, array, byteCount);
+
+    if (accessorPrivateIsReverseEndianness[e])
+        for (size_t i = 0; i < count; i++)
+        {
+            accessorPrivateWriteUInt16AtPointer(dst, accessorPrivateReadUInt16AtPointer(dst, accessorBig), accessorLittle);
+            dst += 2;
+        }
+
+    return accessorOk;
+}
+
+
+
+accessorStatus accessorWriteEndianInt24Array(accessor_t * a, const int32_t * array, size_t count, accessorEndianness e)
+{
+    accessorStatus status;
+    size_t byteCount;
+    uint8_t * dst;
+
+
+    if (!a->writeEnabled)
+        return accessorReadOnlyError;
+
+    byteCount = count * 3;
+    status = accessorPrivateGetPointerForWrite(&dst, a, byteCount, accessorApiWriteArray);
+    if (status != accessorOk)
+        return status;
+
+    if (dst == NULL)                    // null accessor
+        return accessorOk;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        accessorPrivateWriteUInt24AtPointer(dst, (uint32_t) array[i], e);
+        dst += 3;
+    }
+
+    return accessorOk;
+}
+
+
+
+accessorStatus accessorWriteEndianInt32Array(accessor_t * a, const int32_t * array, size_t count, accessorEndianness e)
+{
+    accessorStatus status;
+    size_t byteCount;
+    uint8_t * dst;
+
+
+    if (!a->writeEnabled)
+        return accessorReadOnlyError;
+
+    byteCount = count * 4;
+    status = accessorPrivateGetPointerForWrite(&dst, a, byteCount, accessorApiWriteArray);
+    if (status != accessorOk)
+        return status;
+
+    if (dst == NULL)                    // null accessor
+        return accessorOk;
+
+    memcpy(dst, array, byteCount);
+
+    if (accessorPrivateIsReverseEndianness[e])
+        for (size_t i = 0; i < count; i++)
+        {
+            accessorPrivateWriteUInt32AtPointer(dst, accessorPrivateReadUInt32AtPointer(dst, accessorBig), accessorLittle);
+            dst += 4;
+        }
+
+    return accessorOk;
+}
+
+
+
+accessorStatus accessorWriteEndianInt64Array(accessor_t * a, const int64_t * array, size_t count, accessorEndianness e)
+{
+    accessorStatus status;
+    size_t byteCount;
+    uint8_t * dst;
+
+
+    if (!a->writeEnabled)
+        return accessorReadOnlyError;
+
+    byteCount = count * 8;
+    status = accessorPrivateGetPointerForWrite(&dst, a, byteCount, accessorApiWriteArray);
+    if (status != accessorOk)
+        return status;
+
+    if (dst == NULL)                    // null accessor
+        return accessorOk;
+
+    memcpy(dst, array, byteCount);
+
+    if (accessorPrivateIsReverseEndianness[e])
+        for (size_t i = 0; i < count; i++)
+        {
+            accessorPrivateWriteUInt64AtPointer(dst, accessorPrivateReadUInt64AtPointer(dst, accessorBig), accessorLittle);
+            dst += 8;
+        }
+
+    return accessorOk;
+}
+
+
+
+accessorStatus accessorWriteEndianFloat32Array(accessor_t * a, float * array, size_t count, accessorEndianness e)
+{
+    return accessorWriteEndianUInt32Array(a, (uint32_t *) array, count, e);
+}
+
+
+
+accessorStatus accessorWriteEndianFloat64Array(accessor_t * a, double * array, size_t count, accessorEndianness e)
+{
+    return accessorWriteEndianUInt64Array(a, (uint64_t *) array, count, e);
+}
+
+
+
+accessorStatus accessorWriteUInt16Array(accessor_t * a, const uint16_t * array, size_t count)
+{
+    return accessorWriteEndianUInt16Array(a, array, count, a->endianness);
+}
+
+
+
+accessorStatus accessorWriteUInt24Array(accessor_t * a, const uint32_t * array, size_t count)
+{
+    return accessorWriteEndianUInt24Array(a, array, count, a->endianness);
+}
+
+
+
+accessorStatus accessorWriteUInt32Array(accessor_t * a, const uint32_t * array, size_t count)
+{
+    return accessorWriteEndianUInt32Array(a, array, count, a->endianness);
+}
+
+
+
+accessorStatus accessorWriteUInt64Array(accessor_t * a, const uint64_t * array, size_t count)
+{
+    return accessorWriteEndianUInt64Array(a, array, count, a->endianness);
+}
+
+
+
+accessorStatus accessorWriteInt16Array(accessor_t * a, const int16_t * array, size_t count)
+{
+    return accessorWriteEndianInt16Array(a, array, count, a->endianness);
+}
+
+
+
+accessorStatus accessorWriteInt24Array(accessor_t * a, const int32_t * array, size_t count)
+{
+    return accessorWriteEndianInt24Array(a, array, count, a->endianness);
+}
+
+
+
+accessorStatus accessorWriteInt32Array(accessor_t * a, const int32_t * array, size_t count)
+{
+    return accessorWriteEndianInt32Array(a, array, count, a->endianness);
+}
+
+
+
+accessorStatus accessorWriteInt64Array(accessor_t * a, const int64_t * array, size_t count)
+{
+    return accessorWriteEndianInt64Array(a, array, count, a->endianness);
+}
+
+
+
+accessorStatus accessorWriteFloat32Array(accessor_t * a, float * array, size_t count)
+{
+    return accessorWriteEndianFloat32Array(a, array, count, a->endianness);
+}
+
+
+
+accessorStatus accessorWriteFloat64Array(accessor_t * a, double * array, size_t count)
+{
+    return accessorWriteEndianFloat64Array(a, array, count, a->endianness);
+}
+
+
+
+accessorStatus accessorReadEndianBytes(accessor_t * a, void * ptr, size_t count, accessorEndianness e)
+{
+    if (a->availableBytes < count)
+        return accessorBeyondEnd;
+
+    memcpy(ptr, a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor, count);
+
+    if (accessorPrivateIsReverseEndianness[e])
+        accessorSwapBytes(ptr, count);
+
+    accessorPrivateOpenCoverage(a);
+
+    a->cursor += count;
+    ACCESSOR_HOOK_READ(a, accessorApiReadBytes, count);
+    a->availableBytes -= count;
+
+    return accessorPrivateCloseCoverage(a);
+}
+
+
+
+accessorStatus accessorReadBytes(accessor_t * a, void * ptr, size_t count)
+{
+    if (a->availableBytes < count)
+        return accessorBeyondEnd;
+
+    memcpy(ptr, a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor, count);
+
+    accessorPrivateOpenCoverage(a);
+
+    a->cursor += count;
+    ACCESSOR_HOOK_READ(a, accessorApiReadBytes, count);
+    a->availableBytes -= count;
+
+    return accessorPrivateCloseCoverage(a);
+}
+
+
+
+accessorStatus accessorReadAllocatedEndianBytes(accessor_t * a, void ** ptr, size_t count, accessorEndianness e)
+{
+    if (a->availableBytes < count)
+    {
+        *ptr = NULL;
+        return accessorBeyondEnd;
+    }
+
+    if ((*ptr = malloc(count)) == NULL)
+        return accessorBeyondEnd;
+
+    memcpy(*ptr, a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor, count);
+
+    if (accessorPrivateIsReverseEndianness[e])
+        accessorSwapBytes(*ptr, count);
+
+    accessorPrivateOpenCoverage(a);
+
+    a->cursor += count;
+    ACCESSOR_HOOK_READ(a, accessorApiReadBytes, count);
+    ACCESSOR_STATS_ADD(a, allocations, 1);
+    a->availableBytes -= count;
+
+    if (accessorPrivateCloseCoverage(a) != accessorOk)
+    {
+        free(*ptr);
+        *ptr = NULL;
+        return accessorOutOfMemory;
+    }
+
+    return accessorOk;
+}
+
+
+
+accessorStatus accessorReadAllocatedBytes(accessor_t * a, void ** ptr, size_t count)
+{
+    if (a->availableBytes < count)
+        return accessorBeyondEnd;
+
+    if ((*ptr = malloc(count)) == NULL)
+        return accessorBeyondEnd;
+
+    memcpy(*ptr, a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor, count);
+
+    accessorPrivateOpenCoverage(a);
+
+    a->cursor += count;
+    ACCESSOR_HOOK_READ(a, accessorApiReadBytes, count);
+    ACCESSOR_STATS_ADD(a, allocations, 1);
+    a->availableBytes -= count;
 
-    if (!a->writeEnabled)
-        return accessorReadOnlyError;
+    if (accessorPrivateCloseCoverage(a) != accessorOk)
+    {
+        free(*ptr);
+        *ptr = NULL;
+        return accessorOutOfMemory;
+    }
 
-    if (nbytes > sizeof(uintmax_t))
+    return accessorOk;
+}
+
+
+
+size_t accessorLookAheadEndianBytes(const accessor_t * a, void * ptr, size_t count, accessorEndianness e)
+{
+    if (a->availableBytes < count)
+        count = a->availableBytes;
+
+    memcpy(ptr, a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor, count);
+
+    if (accessorPrivateIsReverseEndianness[e])
+        accessorSwapBytes(ptr, count);
+
+    return count;
+}
+
+
+
+size_t accessorLookAheadBytes(const accessor_t * a, void * ptr, size_t count)
+{
+    if (a->availableBytes < count)
+        count = a->availableBytes;
+
+    memcpy(ptr, a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor, count);
+
+    return count;
+}
+
+
+
+accessorStatus accessorLookAheadCountBytesBeforeDelimiter(const accessor_t * a, size_t * count, size_t countLimit, size_t delLength, const void * delimiter)
+{
+    size_t availableBytes;
+    uint8_t * ptr;
+    size_t nbytes;
+
+
+    if (delLength < 1)
         return accessorInvalidParameter;
 
-    if (a->availableBytes < nbytes)
+    if (a->availableBytes < delLength)
+        return accessorBeyondEnd;
+
+    if (countLimit == ACCESSOR_UNTIL_END)
+        countLimit = a->availableBytes - delLength;
+
+    ptr = a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor;
+    availableBytes = a->availableBytes;
+    if (availableBytes > countLimit)
+        availableBytes = countLimit;
+
+    nbytes = 0;
+    switch(delLength)
     {
-        status = accessorPrivateGrow(a->baseAccessor, a->cursor + nbytes);
-        if (status != accessorOk)
-            return status;
+    case 1:     // slightly optimized version for delLength == 1
+        while (ptr[0] != ((uint8_t *) delimiter)[0])
+        {
+            if (availableBytes-- == 0)
+                return accessorBeyondEnd;
+            ptr++;
+            nbytes++;
+        }
+        break;
+
+    case 2:     // slightly optimized version for delLength == 2
+        while ((ptr[0] != ((uint8_t *) delimiter)[0] || ptr[1] != ((uint8_t *) delimiter)[1]))
+        {
+            if (availableBytes-- == 0)
+                return accessorBeyondEnd;
+            ptr++;
+            nbytes++;
+        }
+        break;
+
+    default:
+        while (memcmp(ptr, delimiter, delLength) != 0)
+        {
+            if (availableBytes-- == 0)
+                return accessorBeyondEnd;
+            ptr++;
+            nbytes++;
+        }
+        break;
     }
-    accessorPrivateWriteUIntAtPointer(a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor, x, e, nbytes);
+    *count = nbytes;
 
-    a->cursor += nbytes;
-    a->availableBytes -= nbytes;
+    return accessorOk;
+}
+
+
+
+size_t accessorLookAheadAvailableBytes(const accessor_t * a, const void ** ptr)
+{
+    *ptr = a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor;
+
+    return a->availableBytes;
+}
+
+
+
+accessorStatus accessorWriteEndianBytes(accessor_t * a, const void * ptr, size_t count, accessorEndianness e)
+{
+    accessorStatus status;
+    uint8_t * dst;
+
+
+    if (!a->writeEnabled)
+        return accessorReadOnlyError;
+
+    status = accessorPrivateGetPointerForWrite(&dst, a, count, accessorApiWriteBytes);
+    if (status != accessorOk)
+        return status;
+
+    if (dst == NULL)                    // null accessor
+        return accessorOk;
+
+    memcpy(dst, ptr, count);
+
+    if (accessorPrivateIsReverseEndianness[e])
+        accessorSwapBytes(dst, count);
 
     return accessorOk;
 }
 
 
 
-accessorStatus accessorWriteEndianUInt16(accessor_t * a, uint16_t x, accessorEndianness e)
+accessorStatus accessorWriteBytes(accessor_t * a, const void * ptr, size_t count)
 {
     accessorStatus status;
+    uint8_t * dst;
 
 
     if (!a->writeEnabled)
         return accessorReadOnlyError;
 
-    if (a->availableBytes < 2)
+    status = accessorPrivateGetPointerForWrite(&dst, a, count, accessorApiWriteBytes);
+    if (status != accessorOk)
+        return status;
+
+    if (dst == NULL)                    // null accessor
+        return accessorOk;
+
+    memcpy(dst, ptr, count);
+
+    return accessorOk;
+}
+
+
+
+accessorStatus accessorWriteRepeatedByte(accessor_t * a, uint8_t byte, size_t count)
+{
+    accessorStatus status;
+    uint8_t * dst;
+
+
+    if (!a->writeEnabled)
+        return accessorReadOnlyError;
+
+    status = accessorPrivateGetPointerForWrite(&dst, a, count, accessorApiWriteBytes);
+    if (status != accessorOk)
+        return status;
+
+    if (dst == NULL)                    // null accessor
+        return accessorOk;
+
+    memset(dst, byte, count);
+
+    return accessorOk;
+}
+
+
+
+accessorStatus accessorGetPointerForBytesToRead(accessor_t * a, const void ** ptr, size_t count)
+{
+    if (a->availableBytes < count)
+        return accessorBeyondEnd;
+
+    *ptr = a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor;
+
+    accessorPrivateOpenCoverage(a);
+
+    a->cursor += count;
+    ACCESSOR_HOOK_READ(a, accessorApiReadBytes, count);
+    a->availableBytes -= count;
+
+    return accessorPrivateCloseCoverage(a);
+}
+
+
+
+accessorStatus accessorGetPointerForBytesToWrite(accessor_t * a, void ** ptr, size_t count)
+{
+    accessorStatus status;
+
+
+    if (!a->writeEnabled)
+        return accessorReadOnlyError;
+
+    // null accessors give a scratch buffer large enough for caller to write to
+    if (a->isNull && count > a->dataMaxSize)
     {
-        status = accessorPrivateGrow(a->baseAccessor, a->cursor + 2);
-        if (status != accessorOk)
-            return status;
+        uint8_t * newData = accessorPrivateReallocate(a->data, a->dataCharge, count);
+        if (newData == NULL)
+            return accessorOutOfMemory;
+
+        a->data = newData;
+        a->dataMaxSize = count;
+        a->dataCharge = count;
+    }
+
+    status = accessorPrivateGetPointerForWrite((uint8_t **) ptr, a, count, accessorApiWriteBytes);
+    if (status != accessorOk)
+        return status;
+
+    return accessorOk;
+}
+
+
+
+accessorStatus accessorReadCString(accessor_t * a, char ** str, size_t * length)
+{
+    size_t stringLength;
+    size_t availableBytes;
+    uint8_t * ptr;
+    char * result;
+
+
+    ptr = a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor;
+    availableBytes = a->availableBytes;
+    stringLength = 0;
+
+    while (availableBytes >= sizeof(**str) && ptr[stringLength])
+    {
+        stringLength++;
+        availableBytes--;
+    }
+    if (a->availableBytes < (stringLength + 1) * sizeof(**str))
+        return accessorBeyondEnd;
+
+    result = malloc(stringLength + 1);
+    if (result == NULL)
+        return accessorOutOfMemory;
+
+    memcpy(result, ptr, stringLength + 1);
+
+    accessorPrivateOpenCoverage(a);
+
+    a->cursor += stringLength + 1;
+    ACCESSOR_HOOK_READ(a, accessorApiReadString, stringLength + 1);
+    ACCESSOR_STATS_ADD(a, allocations, 1);
+    a->availableBytes -= stringLength + 1;
+
+    if (accessorPrivateCloseCoverage(a) != accessorOk)
+    {
+        free(result);
+        return accessorOutOfMemory;
     }
 
-    accessorPrivateWriteUInt16AtPointer(a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor, x, e);
+    *str = result;
+
+    if (length != NULL)
+        *length = stringLength;
+
+    return accessorOk;
+}
+
+
+
+accessorStatus accessorReadPString(accessor_t * a, char ** str, size_t * length)
+{
+    uint8_t stringLength;
+    size_t availableBytes;
+    uint8_t * ptr;
+    char * result;
+
+
+    availableBytes = a->availableBytes;
 
-    a->cursor += 2;
-    a->availableBytes -= 2;
+    if (availableBytes < 1)
+        return accessorBeyondEnd;
 
-    return accessorOk;
-}
+    ptr = a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor;
+    stringLength = *ptr++;
 
+    if (a->availableBytes < (stringLength + 1) * sizeof(**str))
+        return accessorBeyondEnd;
 
+    result = malloc((stringLength + 1) * sizeof(**str));
+    if (result == NULL)
+        return accessorOutOfMemory;
 
-accessorStatus accessorWriteEndianUInt24(accessor_t * a, uint32_t x, accessorEndianness e)
-{
-    accessorStatus status;
+    memcpy(result, ptr, stringLength);
+    result[stringLength] = 0;
 
+    *str = result;
 
-    if (!a->writeEnabled)
-        return accessorReadOnlyError;
+    accessorPrivateOpenCoverage(a);
 
-    if (a->availableBytes < 3)
+    a->cursor += stringLength + 1;
+    ACCESSOR_HOOK_READ(a, accessorApiReadString, stringLength + 1);
+    ACCESSOR_STATS_ADD(a, allocations, 1);
+    a->availableBytes -= stringLength + 1;
+
+    if (accessorPrivateCloseCoverage(a) != accessorOk)
     {
-        status = accessorPrivateGrow(a->baseAccessor, a->cursor + 3);
-        if (status != accessorOk)
-            return status;
+        free(*str);
+        *str = NULL;
+        return accessorOutOfMemory;
     }
 
-    accessorPrivateWriteUInt24AtPointer(a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor, x, e);
-
-    a->cursor += 3;
-    a->availableBytes -= 3;
+    if (length != NULL)
+        *length = stringLength;
 
     return accessorOk;
 }
 
 
 
-accessorStatus accessorWriteEndianUInt32(accessor_t * a, uint32_t x, accessorEndianness e)
+accessorStatus accessorReadFixedLengthString(accessor_t * a, char ** str, size_t length)
 {
-    accessorStatus status;
-
-
-    if (!a->writeEnabled)
-        return accessorReadOnlyError;
-
-    if (a->availableBytes < 4)
-    {
-        status = accessorPrivateGrow(a->baseAccessor, a->cursor + 4);
-        if (status != accessorOk)
-            return status;
-    }
-
-    accessorPrivateWriteUInt32AtPointer(a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor, x, e);
+    char * result;
 
-    a->cursor += 4;
-    a->availableBytes -= 4;
 
-    return accessorOk;
-}
+    if (a->availableBytes < length)
+        return accessorBeyondEnd;
 
+    result = malloc((length + 1) * sizeof(**str));
+    if (result == NULL)
+        return accessorOutOfMemory;
 
+    memcpy(result, a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor, length);
+    result[length] = 0;
 
-accessorStatus accessorWriteEndianUInt64(accessor_t * a, uint64_t x, accessorEndianness e)
-{
-    accessorStatus status;
+    *str = result;
 
+    accessorPrivateOpenCoverage(a);
 
-    if (!a->writeEnabled)
-        return accessorReadOnlyError;
+    a->cursor += length;
+    ACCESSOR_HOOK_READ(a, accessorApiReadString, length);
+    ACCESSOR_STATS_ADD(a, allocations, 1);
+    a->availableBytes -= length;
 
-    if (a->availableBytes < 8)
+    if (accessorPrivateCloseCoverage(a) != accessorOk)
     {
-        status = accessorPrivateGrow(a->baseAccessor, a->cursor + 8);
-        if (status != accessorOk)
-            return status;
+        free(*str);
+        *str = NULL;
+        return accessorOutOfMemory;
     }
 
-    accessorPrivateWriteUInt64AtPointer(a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor, x, e);
-
-    a->cursor += 8;
-    a->availableBytes -= 8;
-
     return accessorOk;
 }
 
 
 
-accessorStatus accessorWriteEndianInt(accessor_t * a, intmax_t x, accessorEndianness e, size_t nbytes)
+accessorStatus accessorReadPaddedString(accessor_t * a, char ** str, size_t * length, char pad)
 {
-    return accessorWriteEndianUInt(a, (uintmax_t) x, e, nbytes);
-}
+    char * result;
+    size_t stringLength;
 
 
+    stringLength = *length;
 
-accessorStatus accessorWriteEndianInt16(accessor_t * a, int16_t x, accessorEndianness e)
-{
-    accessorStatus status;
+    if (a->availableBytes < stringLength)
+        return accessorBeyondEnd;
 
+    result = malloc((stringLength + 1) * sizeof(**str));
+    if (result == NULL)
+        return accessorOutOfMemory;
 
-    if (!a->writeEnabled)
-        return accessorReadOnlyError;
+    memcpy(result, a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor, stringLength);
+    result[stringLength] = 0;
 
-    if (a->availableBytes < 2)
+    accessorPrivateOpenCoverage(a);
+
+    a->cursor += stringLength;
+    ACCESSOR_HOOK_READ(a, accessorApiReadString, stringLength);
+    ACCESSOR_STATS_ADD(a, allocations, 1);
+    a->availableBytes -= stringLength;
+
+    if (accessorPrivateCloseCoverage(a) != accessorOk)
     {
-        status = accessorPrivateGrow(a->baseAccessor, a->cursor + 2);
-        if (status != accessorOk)
-            return status;
+        free(result);
+        return accessorOutOfMemory;
     }
 
-    accessorPrivateWriteUInt16AtPointer(a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor, (uint16_t) x, e);
+    while (stringLength && result[stringLength - 1] == pad)
+        stringLength--;
+
+    result[stringLength] = 0;
 
-    a->cursor += 2;
-    a->availableBytes -= 2;
+    *str = result;
+
+    if (length != NULL)
+        *length = stringLength;
 
     return accessorOk;
 }
 
 
 
-accessorStatus accessorWriteEndianInt24(accessor_t * a, int32_t x, accessorEndianness e)
+accessorStatus accessorReadEndianString16(accessor_t * a, uint16_t ** str, size_t * length, accessorEndianness e)
 {
-    accessorStatus status;
+    size_t stringLength;
+    size_t availableBytes;
+    uint8_t * ptr;
+    uint16_t * result;
 
 
-    if (!a->writeEnabled)
-        return accessorReadOnlyError;
+    ptr = a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor;
+    availableBytes = a->availableBytes;
+    stringLength = 0;
 
-    if (a->availableBytes < 3)
+    while (availableBytes >= sizeof(**str) && accessorPrivateReadUInt16AtPointer(ptr, e))
     {
-        status = accessorPrivateGrow(a->baseAccessor, a->cursor + 3);
-        if (status != accessorOk)
-            return status;
+        availableBytes -= sizeof(**str);
+        ptr += sizeof(**str);
+        stringLength++;
     }
+    if (a->availableBytes < (stringLength + 1) * sizeof(**str))
+        return accessorBeyondEnd;
 
-    accessorPrivateWriteUInt24AtPointer(a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor, (uint32_t) x, e);
-
-    a->cursor += 3;
-    a->availableBytes -= 3;
+    result = malloc((stringLength + 1) * sizeof(**str));
+    if (result == NULL)
+        return accessorOutOfMemory;
 
-    return accessorOk;
-}
+    memcpy(result, a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor, stringLength * sizeof(**str));
+    result[stringLength] = 0;
 
+    if (accessorPrivateIsReverseEndianness[e])
+    {
+        for (size_t i = 0; i < stringLength; i++)
+            result[i] = accessorSwapUInt16(result[i]);
+    }
 
+    *str = result;
 
-accessorStatus accessorWriteEndianInt32(accessor_t * a, int32_t x, accessorEndianness e)
-{
-    accessorStatus status;
+    if (length != NULL)
+        *length = stringLength;
 
+    accessorPrivateOpenCoverage(a);
 
-    if (!a->writeEnabled)
-        return accessorReadOnlyError;
+    a->cursor += (stringLength + 1) * sizeof(**str);
+    ACCESSOR_HOOK_READ(a, accessorApiReadString, (stringLength + 1) * sizeof(**str));
+    ACCESSOR_STATS_ADD(a, allocations, 1);
+    a->availableBytes -= (stringLength + 1) * sizeof(**str);
 
-    if (a->availableBytes < 4)
+    if (accessorPrivateCloseCoverage(a) != accessorOk)
     {
-        status = accessorPrivateGrow(a->baseAccessor, a->cursor + 4);
-        if (status != accessorOk)
-            return status;
+        free(*str);
+        *str = NULL;
+        return accessorOutOfMemory;
     }
 
-    accessorPrivateWriteUInt32AtPointer(a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor, (uint32_t) x, e);
-
-    a->cursor += 4;
-    a->availableBytes -= 4;
-
     return accessorOk;
 }
 
 
 
-accessorStatus accessorWriteEndianInt64(accessor_t * a, int64_t x, accessorEndianness e)
+accessorStatus accessorReadEndianString32(accessor_t * a, uint32_t ** str, size_t * length, accessorEndianness e)
 {
-    accessorStatus status;
+    size_t stringLength;
+    size_t availableBytes;
+    uint8_t * ptr;
+    uint32_t * result;
 
 
-    if (!a->writeEnabled)
-        return accessorReadOnlyError;
+    ptr = a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor;
+    availableBytes = a->availableBytes;
+    stringLength = 0;
 
-    if (a->availableBytes < 8)
+    while (availableBytes >= sizeof(**str) && accessorPrivateReadUInt32AtPointer(ptr, e))
     {
-        status = accessorPrivateGrow(a->baseAccessor, a->cursor + 8);
-        if (status != accessorOk)
-            return status;
+        ptr += sizeof(**str);
+        stringLength++;
+        availableBytes -= sizeof(**str);
+    }
+    if (a->availableBytes < (stringLength + 1) * sizeof(**str))
+        return accessorBeyondEnd;
+
+    result = malloc((stringLength + 1) * sizeof(**str));
+    if (result == NULL)
+        return accessorOutOfMemory;
+
+    memcpy(result, a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor, stringLength * sizeof(**str));
+    result[stringLength] = 0;
+
+    if (accessorPrivateIsReverseEndianness[e])
+    {
+        for (size_t i = 0; i < stringLength; i++)
+            result[i] = accessorSwapUInt32(result[i]);
     }
 
-    accessorPrivateWriteUInt64AtPointer(a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor, (uint64_t) x, e);
+    *str = result;
 
-    a->cursor += 8;
-    a->availableBytes -= 8;
+    if (length != NULL)
+        *length = stringLength;
 
-    return accessorOk;
-}
+    accessorPrivateOpenCoverage(a);
 
+    a->cursor += (stringLength + 1) * sizeof(**str);
+    ACCESSOR_HOOK_READ(a, accessorApiReadString, (stringLength + 1) * sizeof(**str));
+    ACCESSOR_STATS_ADD(a, allocations, 1);
+    a->availableBytes -= (stringLength + 1) * sizeof(**str);
 
+    if (accessorPrivateCloseCoverage(a) != accessorOk)
+    {
+        free(*str);
+        *str = NULL;
+        return accessorOutOfMemory;
+    }
 
-accessorStatus accessorWriteEndianFloat32(accessor_t * a, float x, accessorEndianness e)
-{
-    return accessorWriteEndianUInt32(a, * (uint32_t *) &x, e);
+    return accessorOk;
 }
 
 
 
-accessorStatus accessorWriteEndianFloat64(accessor_t * a, double x, accessorEndianness e)
+accessorStatus accessorReadString16(accessor_t * a, uint16_t ** str, size_t * length)
 {
-    return accessorWriteEndianUInt64(a, * (uint64_t *) &x, e);
+    return accessorReadEndianString16(a, str, length, a->endianness);
 }
 
 
 
-accessorStatus accessorWriteUInt(accessor_t * a, uintmax_t x, size_t nbytes)
+accessorStatus accessorReadString32(accessor_t * a, uint32_t ** str, size_t * length)
 {
-    return accessorWriteEndianUInt(a, x, a->endianness, nbytes);
+    return accessorReadEndianString32(a, str, length, a->endianness);
 }
 
 
 
-accessorStatus accessorWriteUInt8(accessor_t * a, uint8_t x)
+accessorStatus accessorWriteCStringWithLength(accessor_t * a, const char * str, size_t length)
 {
     accessorStatus status;
+    uint8_t * ptr;
 
 
     if (!a->writeEnabled)
         return accessorReadOnlyError;
 
-    if (a->availableBytes < 1)
-    {
-        status = accessorPrivateGrow(a->baseAccessor, a->cursor + 1);
-        if (status != accessorOk)
-            return status;
-    }
+    status = accessorPrivateGetPointerForWrite(&ptr, a, length + 1, accessorApiWriteString);
+    if (status != accessorOk)
+        return status;
 
-    * (uint8_t *) (a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor) = x;
+    if (ptr == NULL)                    // null accessor
+        return accessorOk;
 
-    a->cursor += 1;
-    a->availableBytes -= 1;
+    memcpy(ptr, str, length);
+    ptr[length] = 0;            // str doesn't have to be NUL terminated
 
     return accessorOk;
 }
 
 
 
-accessorStatus accessorWriteUInt16(accessor_t * a, uint16_t x)
+
+accessorStatus accessorWritePStringWithLength(accessor_t * a, const char * str, size_t length)
 {
     accessorStatus status;
+    uint8_t * ptr;
 
 
     if (!a->writeEnabled)
         return accessorReadOnlyError;
 
-    if (a->availableBytes < 2)
-    {
-        status = accessorPrivateGrow(a->baseAccessor, a->cursor + 2);
-        if (status != accessorOk)
-            return status;
-    }
+    if (length > UINT8_MAX)
+        return accessorInvalidParameter;
 
-    accessorPrivateWriteUInt16AtPointer(a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor, x, a->endianness);
+    status = accessorPrivateGetPointerForWrite(&ptr, a, length + 1, accessorApiWriteString);
+    if (status != accessorOk)
+        return status;
 
-    a->cursor += 2;
-    a->availableBytes -= 2;
+    if (ptr == NULL)                    // null accessor
+        return accessorOk;
+
+    *ptr++ = (uint8_t) length;
+    memcpy(ptr, str, length);
 
     return accessorOk;
 }
 
 
 
-accessorStatus accessorWriteUInt24(accessor_t * a, uint32_t x)
+
+accessorStatus accessorWritePaddedStringWithLength(accessor_t * a, const char * str, size_t length, size_t paddedLength, char pad)
 {
     accessorStatus status;
+    uint8_t * ptr;
 
 
     if (!a->writeEnabled)
         return accessorReadOnlyError;
 
-    if (a->availableBytes < 3)
-    {
-        status = accessorPrivateGrow(a->baseAccessor, a->cursor + 3);
-        if (status != accessorOk)
-            return status;
-    }
+    if (length > paddedLength)
+        return accessorInvalidParameter;
 
-    accessorPrivateWriteUInt24AtPointer(a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor, x, a->endianness);
+    status = accessorPrivateGetPointerForWrite(&ptr, a, paddedLength, accessorApiWriteString);
+    if (status != accessorOk)
+        return status;
 
-    a->cursor += 3;
-    a->availableBytes -= 3;
+    if (ptr == NULL)                    // null accessor
+        return accessorOk;
+
+    memcpy(ptr, str, length);
+    if (length < paddedLength)
+        memset(ptr + length, pad, paddedLength - length);
 
     return accessorOk;
 }
 
 
 
-accessorStatus accessorWriteUInt32(accessor_t * a, uint32_t x)
+
+accessorStatus accessorWriteEndianString16WithLength(accessor_t * a, const uint16_t * str, size_t length, accessorEndianness e)
 {
     accessorStatus status;
+    uint8_t * ptr;
 
 
     if (!a->writeEnabled)
         return accessorReadOnlyError;
 
-    if (a->availableBytes < 4)
-    {
-        status = accessorPrivateGrow(a->baseAccessor, a->cursor + 4);
-        if (status != accessorOk)
-            return status;
-    }
+    status = accessorPrivateGetPointerForWrite(&ptr, a, (length + 1) * 2, accessorApiWriteString);
+    if (status != accessorOk)
+        return status;
 
-    accessorPrivateWriteUInt32AtPointer(a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor, x, a->endianness);
+    if (ptr == NULL)                    // null accessor
+        return accessorOk;
 
-    a->cursor += 4;
-    a->availableBytes -= 4;
+    memcpy(ptr, str, (length + 1) * 2);
+    if (accessorPrivateIsReverseEndianness[e])
+    {
+        for (size_t i = 0; i < length; i++)
+        {
+            accessorPrivateWriteUInt16AtPointer(ptr, accessorPrivateReadUInt16AtPointer(ptr, accessorBig), accessorLittle);
+            ptr += 2;
+        }
+    }
 
     return accessorOk;
 }
 
 
 
-accessorStatus accessorWriteUInt64(accessor_t * a, uint64_t x)
+
+accessorStatus accessorWriteEndianString32WithLength(accessor_t * a, const uint32_t * str, size_t length, accessorEndianness e)
 {
     accessorStatus status;
+    uint8_t * ptr;
 
 
     if (!a->writeEnabled)
         return accessorReadOnlyError;
 
-    if (a->availableBytes < 8)
-    {
-        status = accessorPrivateGrow(a->baseAccessor, a->cursor + 8);
-        if (status != accessorOk)
-            return status;
-    }
+    status = accessorPrivateGetPointerForWrite(&ptr, a, (length + 1) * 4, accessorApiWriteString);
+    if (status != accessorOk)
+        return status;
 
-    accessorPrivateWriteUInt64AtPointer(a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor, x, a->endianness);
+    if (ptr == NULL)                    // null accessor
+        return accessorOk;
 
-    a->cursor += 8;
-    a->availableBytes -= 8;
+    memcpy(ptr, str, (length + 1) * 4);
+    if (accessorPrivateIsReverseEndianness[e])
+    {
+        for (size_t i = 0; i < length; i++)
+        {
+            accessorPrivateWriteUInt32AtPointer(ptr, accessorPrivateReadUInt32AtPointer(ptr, accessorBig), accessorLittle);
+            ptr += 4;
+        }
+    }
 
     return accessorOk;
 }
 
 
 
-accessorStatus accessorWriteInt(accessor_t * a, intmax_t x, size_t nbytes)
+
+accessorStatus accessorWriteString16WithLength(accessor_t * a, const uint16_t * str, size_t length)
 {
-    return accessorWriteEndianInt(a, x, a->endianness, nbytes);
+    return accessorWriteEndianString16WithLength(a, str, length, a->endianness);
 }
 
 
 
-accessorStatus accessorWriteInt8(accessor_t * a, int8_t x)
-{
-    accessorStatus status;
 
+accessorStatus accessorWriteString32WithLength(accessor_t * a, const uint32_t * str, size_t length)
+{
+    return accessorWriteEndianString32WithLength(a, str, length, a->endianness);
+}
 
-    if (!a->writeEnabled)
-        return accessorReadOnlyError;
 
-    if (a->availableBytes < 1)
-    {
-        status = accessorPrivateGrow(a->baseAccessor, a->cursor + 1);
-        if (status != accessorOk)
-            return status;
-    }
 
-    * (int8_t *) (a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor) = x;
 
-    a->cursor += 1;
-    a->availableBytes -= 1;
 
-    return accessorOk;
+accessorStatus accessorWriteCString(accessor_t * a, const char * str)
+{
+    return accessorWriteCStringWithLength(a, str, strlen(str));
 }
 
 
 
-accessorStatus accessorWriteInt16(accessor_t * a, int16_t x)
-{
-    accessorStatus status;
-
 
-    if (!a->writeEnabled)
-        return accessorReadOnlyError;
+accessorStatus accessorWritePString(accessor_t * a, const char * str)
+{
+    return accessorWritePStringWithLength(a, str, strlen(str));
+}
 
-    if (a->availableBytes < 2)
-    {
-        status = accessorPrivateGrow(a->baseAccessor, a->cursor + 2);
-        if (status != accessorOk)
-            return status;
-    }
 
-    accessorPrivateWriteUInt16AtPointer(a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor, (uint16_t) x, a->endianness);
 
-    a->cursor += 2;
-    a->availableBytes -= 2;
 
-    return accessorOk;
+accessorStatus accessorWritePaddedString(accessor_t * a, const char * str, size_t paddedLength, char pad)
+{
+    return accessorWritePaddedStringWithLength(a, str, strlen(str), paddedLength, pad);
 }
 
 
 
-accessorStatus accessorWriteInt24(accessor_t * a, int32_t x)
-{
-    accessorStatus status;
-
 
-    if (!a->writeEnabled)
-        return accessorReadOnlyError;
-
-    if (a->availableBytes < 3)
-    {
-        status = accessorPrivateGrow(a->baseAccessor, a->cursor + 3);
-        if (status != accessorOk)
-            return status;
-    }
+accessorStatus accessorWriteEndianString16(accessor_t * a, const uint16_t * str, accessorEndianness e)
+{
+    size_t stringLength;
 
-    accessorPrivateWriteUInt24AtPointer(a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor, (uint32_t) x, a->endianness);
 
-    a->cursor += 3;
-    a->availableBytes -= 3;
+    stringLength = 0;
+    while (str[stringLength])
+        stringLength++;
 
-    return accessorOk;
+    return accessorWriteEndianString16WithLength(a, str, stringLength, e);
 }
 
 
 
-accessorStatus accessorWriteInt32(accessor_t * a, int32_t x)
+
+accessorStatus accessorWriteEndianString32(accessor_t * a, const uint32_t * str, accessorEndianness e)
 {
-    accessorStatus status;
+    size_t stringLength;
 
 
-    if (!a->writeEnabled)
-        return accessorReadOnlyError;
+    stringLength = 0;
+    while (str[stringLength])
+        stringLength++;
 
-    if (a->availableBytes < 4)
-    {
-        status = accessorPrivateGrow(a->baseAccessor, a->cursor + 4);
-        if (status != accessorOk)
-            return status;
-    }
+    return accessorWriteEndianString32WithLength(a, str, stringLength, e);
+}
 
-    accessorPrivateWriteUInt32AtPointer(a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor, (uint32_t) x, a->endianness);
 
-    a->cursor += 4;
-    a->availableBytes -= 4;
 
-    return accessorOk;
+
+accessorStatus accessorWriteString16(accessor_t * a, const uint16_t * str)
+{
+    return accessorWriteEndianString16(a, str, a->endianness);
 }
 
 
 
-accessorStatus accessorWriteInt64(accessor_t * a, int64_t x)
+
+accessorStatus accessorWriteString32(accessor_t * a, const uint32_t * str)
 {
-    accessorStatus status;
+    return accessorWriteEndianString32(a, str, a->endianness);
+}
 
 
-    if (!a->writeEnabled)
-        return accessorReadOnlyError;
 
-    if (a->availableBytes < 8)
+static inline uintmax_t accessorPrivateReadOffsetAtPointer(const uint8_t * ptr, accessorEndianness e, size_t nbytes)
+{
+    switch(nbytes)
     {
-        status = accessorPrivateGrow(a->baseAccessor, a->cursor + 8);
-        if (status != accessorOk)
-            return status;
+    case 4:
+        return accessorPrivateReadUInt32AtPointer(ptr, e);
+    case 8:
+        return accessorPrivateReadUInt64AtPointer(ptr, e);
+    default:
+        return accessorPrivateReadUIntAtPointer(ptr, e, nbytes);
     }
-
-    accessorPrivateWriteUInt64AtPointer(a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor, (uint64_t) x, a->endianness);
-
-    a->cursor += 8;
-    a->availableBytes -= 8;
-
-    return accessorOk;
 }
 
 
 
-accessorStatus accessorWriteFloat32(accessor_t * a, float x)
+static void accessorPrivateRelocateRun(uint8_t * ptr, size_t count, size_t fieldSize, accessorEndianness e, uintmax_t base)
 {
-    return accessorWriteUInt32(a, * (uint32_t *) &x);
-}
+    // native endianness loops are simple enough to be vectorized by the compiler
+    switch(fieldSize)
+    {
+    case 2:
+        if (accessorPrivateIsReverseEndianness[e])
+            for (size_t i = 0; i < count; i++, ptr += 2)
+                accessorPrivateWriteUInt16AtPointer(ptr, (uint16_t) (accessorPrivateReadUInt16AtPointer(ptr, e) + (uint16_t) base), e);
+        else
+            for (size_t i = 0; i < count; i++, ptr += 2)
+            {
+                uint16_t x;
+
+                memcpy(&x, ptr, 2);
+                x = (uint16_t) (x + (uint16_t) base);
+                memcpy(ptr, &x, 2);
+            }
+        break;
 
+    case 4:
+        if (accessorPrivateIsReverseEndianness[e])
+            for (size_t i = 0; i < count; i++, ptr += 4)
+                accessorPrivateWriteUInt32AtPointer(ptr, accessorPrivateReadUInt32AtPointer(ptr, e) + (uint32_t) base, e);
+        else
+            for (size_t i = 0; i < count; i++, ptr += 4)
+            {
+                uint32_t x;
 
+                memcpy(&x, ptr, 4);
+                x += (uint32_t) base;
+                memcpy(ptr, &x, 4);
+            }
+        break;
 
-accessorStatus accessorWriteFloat64(accessor_t * a, double x)
-{
-    return accessorWriteUInt64(a, * (uint64_t *) &x);
+    case 8:
+        if (accessorPrivateIsReverseEndianness[e])
+            for (size_t i = 0; i < count; i++, ptr += 8)
+                accessorPrivateWriteUInt64AtPointer(ptr, accessorPrivateReadUInt64AtPointer(ptr, e) + (uint64_t) base, e);
+        else
+            for (size_t i = 0; i < count; i++, ptr += 8)
+            {
+                uint64_t x;
+
+                memcpy(&x, ptr, 8);
+                x += (uint64_t) base;
+                memcpy(ptr, &x, 8);
+            }
+        break;
+    }
 }
 
 
 
-accessorStatus accessorWriteVarInt(accessor_t * a, uintmax_t x)
+accessorStatus accessorApplyRelocations(accessor_t * a, accessor_t * r, size_t count, size_t offsetSize, size_t fieldSize, accessorEndianness e, uintmax_t base)
 {
-    accessorStatus status;
-    size_t nbytes;
-    uintmax_t tmp;
-    uint8_t * ptr;
+    const uint8_t * table;
+    uint8_t * data;
+    size_t tableSize;
+    uintmax_t offset;
+    uintmax_t maxOffset;
+    size_t runLength;
 
 
     if (!a->writeEnabled)
         return accessorReadOnlyError;
 
-    tmp = x;
-    nbytes = 0;
-    do
-    {
-        nbytes++;
-        tmp >>= 7;                      // tmp is unsigned, right shifts are OK
-    } while (tmp != 0);
+    if (offsetSize < 1 || offsetSize > sizeof(uintmax_t))
+        return accessorInvalidParameter;
 
-    if (a->availableBytes < nbytes)
+    if (fieldSize != 2 && fieldSize != 4 && fieldSize != 8)
+        return accessorInvalidParameter;
+
+    if (count > SIZE_MAX / offsetSize)
+        return accessorBeyondEnd;
+
+    tableSize = count * offsetSize;
+    if (r->availableBytes < tableSize)
+        return accessorBeyondEnd;
+
+    table = r->baseAccessor->data + r->baseAccessorWindowOffset + r->cursor;
+
+    // first pass: validate all offsets at once, so that a is either completely relocated or untouched
+    maxOffset = 0;
+    for (size_t i = 0; i < count; i++)
     {
-        status = accessorPrivateGrow(a->baseAccessor, a->cursor + nbytes);
-        if (status != accessorOk)
-            return status;
+        offset = accessorPrivateReadOffsetAtPointer(table + i * offsetSize, r->endianness, offsetSize);
+        if (offset > maxOffset)
+            maxOffset = offset;
     }
+    if (count > 0 && (a->windowSize < fieldSize || maxOffset > a->windowSize - fieldSize))
+        return accessorBeyondEnd;
 
-    ptr = a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor;
-
-    a->cursor += nbytes;                // must be done before modifying nbytes
-    a->availableBytes -= nbytes;        // must be done before modifying nbytes
+    // a's relocation can't be undone: the coverage record of r must not fail afterwards
+    if (r->coverageEnabled && r->coverageSuspendCount == 0 && accessorPrivateReserveCoverageRecord(r) != accessorOk)
+        return accessorOutOfMemory;
 
-    while (--nbytes)                    // loop will be executed nbytes-1 times
+    // second pass: relocate, grouping adjacent fields in runs. null accessors have nothing to relocate
+    data = a->baseAccessor->data + a->baseAccessorWindowOffset;
+    for (size_t i = 0; i < count && !a->baseAccessor->isNull; i += runLength)
     {
-        *ptr++ = (x & 0x7f) | 0x80;     // another byte follows
-        x >>= 7;                        // x is unsigned, right shifts are OK
+        offset = accessorPrivateReadOffsetAtPointer(table + i * offsetSize, r->endianness, offsetSize);
+
+        runLength = 1;
+        while (i + runLength < count && accessorPrivateReadOffsetAtPointer(table + (i + runLength) * offsetSize, r->endianness, offsetSize) == offset + runLength * fieldSize)
+            runLength++;
+
+        if (i + runLength + ACCESSOR_RELOCATION_PREFETCH_DISTANCE < count)
+            ACCESSOR_PREFETCH(data + accessorPrivateReadOffsetAtPointer(table + (i + runLength + ACCESSOR_RELOCATION_PREFETCH_DISTANCE) * offsetSize, r->endianness, offsetSize));
+
+        accessorPrivateRelocateRun(data + offset, runLength, fieldSize, e, base);
     }
-    *ptr++ = x & 0x7f;                  // last byte
 
-    return accessorOk;
+    accessorPrivateOpenCoverage(r);
+
+    r->cursor += tableSize;
+    r->availableBytes -= tableSize;
+
+    return accessorPrivateCloseCoverage(r);
+}
+
+
+
+static inline uint64_t accessorPrivateMix64(uint64_t x)
+{
+    // MurmurHash3 finalizer
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccd;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53;
+    x ^= x >> 33;
+
+    return x;
 }
 
 
 
-accessorStatus accessorWriteZigZagInt(accessor_t * a, intmax_t x)
+static uint64_t accessorPrivateHashBytes(const void * ptr, size_t nbytes, uint64_t seed)
 {
-    if (x >= 0)                         // avoid implementation dependent negative numbers right shifts
-        return accessorWriteVarInt(a, (uintmax_t) x << 1);
-    else
-        return accessorWriteVarInt(a, ~((uintmax_t) x << 1));
+    const uint8_t * bytes = (const uint8_t *) ptr;
+    uint64_t hash;
+    uint64_t word;
+
+
+    hash = seed ^ ((uint64_t) nbytes * 0x9e3779b97f4a7c15);
+    for (; nbytes >= 8; nbytes -= 8, bytes += 8)
+    {
+        memcpy(&word, bytes, 8);        // native endianness: hashes are only comparable on hosts of the same endianness
+        hash = ((hash << 27 | hash >> 37) ^ word) * 0x9e3779b97f4a7c15;
+    }
+    if (nbytes > 0)
+    {
+        word = 0;
+        memcpy(&word, bytes, nbytes);
+        hash = ((hash << 27 | hash >> 37) ^ word) * 0x9e3779b97f4a7c15;
+    }
+
+    return accessorPrivateMix64(hash);
 }
 
 
 
-accessorStatus accessorReadEndianUInt16Array(accessor_t * a, uint16_t ** array, size_t count, accessorEndianness e)
+accessorStatus accessorOpenCatalog(accessorCatalog_t ** c, accessor_t * a, size_t entryCountHint)
 {
-    size_t byteCount;
-    uint16_t * dst;
+    accessorCatalog_t * result;
+    size_t slotCount;
 
 
-    byteCount = count * 2;
-    if (a->availableBytes < byteCount)
-        return accessorBeyondEnd;
+    if (*c != ACCESSOR_INIT)
+        return accessorInvalidParameter;
 
-    dst = malloc(count * sizeof(**array));
-    if (dst == NULL)
-        return accessorOutOfMemory;
+    if (a->writeEnabled)
+        return accessorInvalidParameter;
 
-    memcpy(dst, a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor, byteCount);
+    result = malloc(sizeof(*result));
+    if (result == NULL)
+        return accessorOutOfMemory;
 
-    if (accessorPrivateIsReverseEndianness[e])
-        for (size_t i = 0; i < count; i++)
-            dst[i] = accessorSwapUInt16(dst[i]);
+    result->accessor = a;
+    result->entries = NULL;
+    result->entryCount = 0;
+    result->entryAllocation = 0;
+    result->names = NULL;
+    result->namesSize = 0;
+    result->namesAllocation = 0;
+    result->slots = NULL;
+    result->slotCount = 0;
+    result->sortedEntries = NULL;
+    result->sortedAllocation = 0;
+    result->isSorted = 0;
+    result->isMapped = 0;
+    result->isSortedMapped = 0;
 
-    accessorPrivateOpenCoverage(a);
+    // keep the hash table at most half full
+    slotCount = 64;
+    while (slotCount < UINT32_MAX && slotCount / 2 < entryCountHint)
+        slotCount *= 2;
 
-    a->cursor += byteCount;
-    a->availableBytes -= byteCount;
+    if (accessorPrivateCatalogResize(result, slotCount) != accessorOk
+        || accessorPrivateExtendPointerSizeAllocation((void **) &result->entries, &result->entryCount, &result->entryAllocation, entryCountHint, entryCountHint > 0 ? entryCountHint : 1, sizeof(*result->entries)))
+    {
+        accessorPrivateRelease(result->slots, result->slotCount * sizeof(*result->slots));
+        accessorPrivateRelease(result->entries, result->entryAllocation * sizeof(*result->entries));
+        free(result);
+        return accessorOutOfMemory;
+    }
+    result->entryCount = 0;
 
-    accessorPrivateCloseCoverage(a);
+    a->referenceCount++;
 
-    * array = dst;
+    *c = result;
 
     return accessorOk;
 }
 
 
 
-accessorStatus accessorReadEndianUInt24Array(accessor_t * a, uint32_t ** array, size_t count, accessorEndianness e)
+accessorStatus accessorCloseCatalog(accessorCatalog_t ** c)
 {
-    size_t byteCount;
-    uint32_t * dst;
-    uint8_t * src;
+    accessorStatus status;
 
 
-    byteCount = count * 3;
-    if (a->availableBytes < byteCount)
-        return accessorBeyondEnd;
+    if (*c == ACCESSOR_INIT)
+        return accessorInvalidParameter;
 
-    dst = malloc(count * sizeof(**array));
-    if (dst == NULL)
-        return accessorOutOfMemory;
+    status = accessorClose(&(*c)->accessor);
+    if (status != accessorOk)
+        return status;
 
-    src = a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor;
-    for (size_t i = 0; i < count; i++)
+    if (!(*c)->isMapped)
     {
-        dst[i] = accessorPrivateReadUInt24AtPointer(src, e);
-        src += 3;
+        accessorPrivateRelease((*c)->entries, (*c)->entryAllocation * sizeof(*(*c)->entries));
+        accessorPrivateRelease((*c)->names, (*c)->namesAllocation);
+        accessorPrivateRelease((*c)->slots, (*c)->slotCount * sizeof(*(*c)->slots));
     }
+    if (!(*c)->isSortedMapped)
+        accessorPrivateRelease((*c)->sortedEntries, (*c)->sortedAllocation * sizeof(*(*c)->sortedEntries));
 
-    accessorPrivateOpenCoverage(a);
-
-    a->cursor += byteCount;
-    a->availableBytes -= byteCount;
-
-    accessorPrivateCloseCoverage(a);
-
-    * array = dst;
+    free(*c);
+    *c = ACCESSOR_INIT;
 
     return accessorOk;
 }
 
 
 
-accessorStatus accessorReadEndianUInt32Array(accessor_t * a, uint32_t ** array, size_t count, accessorEndianness e)
+static accessorStatus accessorPrivateCatalogResize(accessorCatalog_t * c, size_t slotCount)
 {
-    size_t byteCount;
-    uint32_t * dst;
+    accessorPrivateCatalogSlot * oldSlots;
+    size_t oldSlotCount;
+    size_t mask;
 
 
-    byteCount = count * 4;
-    if (a->availableBytes < byteCount)
-        return accessorBeyondEnd;
+    oldSlots = c->slots;
+    oldSlotCount = c->slotCount;
 
-    dst = malloc(count * sizeof(**array));
-    if (dst == NULL)
+    c->slots = accessorPrivateAllocate(slotCount * sizeof(*c->slots));
+    if (c->slots == NULL)
+    {
+        c->slots = oldSlots;
         return accessorOutOfMemory;
+    }
+    memset(c->slots, 0, slotCount * sizeof(*c->slots));
+    c->slotCount = slotCount;
 
-    memcpy(dst, a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor, byteCount);
-
-    if (accessorPrivateIsReverseEndianness[e])
-        for (size_t i = 0; i < count; i++)
-            dst[i] = accessorSwapUInt32(dst[i]);
-
-    accessorPrivateOpenCoverage(a);
+    // reinsert slots using their saved hash, names don't need to be read again
+    mask = slotCount - 1;
+    for (size_t i = 0; i < oldSlotCount; i++)
+    {
+        if (oldSlots[i].entry != 0)
+        {
+            size_t slot = oldSlots[i].hash & mask;
 
-    a->cursor += byteCount;
-    a->availableBytes -= byteCount;
 
-    accessorPrivateCloseCoverage(a);
+            while (c->slots[slot].entry != 0)
+                slot = (slot + 1) & mask;
+            c->slots[slot] = oldSlots[i];
+        }
+    }
 
-    * array = dst;
+    accessorPrivateRelease(oldSlots, oldSlotCount * sizeof(*oldSlots));
 
     return accessorOk;
 }
 
 
 
-accessorStatus accessorReadEndianUInt64Array(accessor_t * a, uint64_t ** array, size_t count, accessorEndianness e)
+static size_t accessorPrivateCatalogFindSlot(const accessorCatalog_t * c, const void * name, size_t nameLength, uint32_t hash)
 {
-    size_t byteCount;
-    uint64_t * dst;
-
+    size_t mask;
+    size_t slot;
 
-    byteCount = count * 8;
-    if (a->availableBytes < byteCount)
-        return accessorBeyondEnd;
 
-    dst = malloc(count * sizeof(**array));
-    if (dst == NULL)
-        return accessorOutOfMemory;
+    mask = c->slotCount - 1;
+    for (slot = hash & mask; c->slots[slot].entry != 0; slot = (slot + 1) & mask)
+    {
+        if (c->slots[slot].hash == hash)
+        {
+            const accessorPrivateCatalogEntry * entry = &c->entries[c->slots[slot].entry - 1];
 
-    memcpy(dst, a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor, byteCount);
 
-    if (accessorPrivateIsReverseEndianness[e])
-        for (size_t i = 0; i < count; i++)
-            dst[i] = accessorSwapUInt64(dst[i]);
+            if (entry->nameLength == nameLength && memcmp(c->names + entry->nameOffset, name, nameLength) == 0)
+                break;
+        }
+    }
 
-    accessorPrivateOpenCoverage(a);
+    return slot;
+}
 
-    a->cursor += byteCount;
-    a->availableBytes -= byteCount;
 
-    accessorPrivateCloseCoverage(a);
 
-    * array = dst;
+accessorStatus accessorCatalogAddEntry(accessorCatalog_t * c, const void * name, size_t nameLength, size_t offset, size_t size)
+{
+    accessorStatus status;
+    accessorPrivateCatalogEntry * entry;
+    uint32_t hash;
+    size_t slot;
+    size_t namesSize;
 
-    return accessorOk;
-}
 
+    if (c->isMapped)
+        return accessorReadOnlyError;
 
+    if (offset > c->accessor->windowSize || size > c->accessor->windowSize - offset)
+        return accessorBeyondEnd;
 
-accessorStatus accessorReadEndianInt16Array(accessor_t * a, int16_t ** array, size_t count, accessorEndianness e)
-{
-    size_t byteCount;
-    int16_t * dst;
+    hash = (uint32_t) accessorPrivateHashBytes(name, nameLength, 0);
+    slot = accessorPrivateCatalogFindSlot(c, name, nameLength, hash);
+    if (c->slots[slot].entry != 0)
+    {
+        entry = &c->entries[c->slots[slot].entry - 1];
+        entry->offset = offset;
+        entry->size = size;
 
+        return accessorOk;
+    }
 
-    byteCount = count * 2;
-    if (a->availableBytes < byteCount)
+    if (c->entryCount >= UINT32_MAX - 1)
         return accessorBeyondEnd;
 
-    dst = malloc(count * sizeof(**array));
-    if (dst == NULL)
-        return accessorOutOfMemory;
-
-    memcpy(dst, a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor, byteCount);
+    if ((c->entryCount + 1) * 2 > c->slotCount)
+    {
+        status = accessorPrivateCatalogResize(c, c->slotCount * 2);
+        if (status != accessorOk)
+            return status;
+        slot = accessorPrivateCatalogFindSlot(c, name, nameLength, hash);
+    }
 
-    if (accessorPrivateIsReverseEndianness[e])
-        for (size_t i = 0; i < count; i++)
-            dst[i] = (int16_t) accessorSwapUInt16((uint16_t) dst[i]);
+    namesSize = c->namesSize;
+    // allocation chunks grow with allocations, making growth geometric
+    if (accessorPrivateExtendPointerSizeAllocation((void **) &c->names, &c->namesSize, &c->namesAllocation, namesSize + nameLength, c->namesAllocation > 64 * KB ? c->namesAllocation : 64 * KB, 1))
+        return accessorOutOfMemory;
+    if (accessorPrivateExtendPointerSizeAllocation((void **) &c->entries, &c->entryCount, &c->entryAllocation, c->entryCount + 1, c->entryAllocation > 4 * KB ? c->entryAllocation : 4 * KB, sizeof(*c->entries)))
+    {
+        c->namesSize = namesSize;
+        return accessorOutOfMemory;
+    }
 
-    accessorPrivateOpenCoverage(a);
+    memcpy(c->names + namesSize, name, nameLength);
 
-    a->cursor += byteCount;
-    a->availableBytes -= byteCount;
+    entry = &c->entries[c->entryCount - 1];
+    entry->nameOffset = namesSize;
+    entry->nameLength = nameLength;
+    entry->offset = offset;
+    entry->size = size;
 
-    accessorPrivateCloseCoverage(a);
+    c->slots[slot].hash = hash;
+    c->slots[slot].entry = (uint32_t) c->entryCount;
 
-    * array = dst;
+    c->isSorted = 0;
 
     return accessorOk;
 }
 
 
 
-accessorStatus accessorReadEndianInt24Array(accessor_t * a, int32_t ** array, size_t count, accessorEndianness e)
+accessorStatus accessorCatalogFindEntry(const accessorCatalog_t * c, const void * name, size_t nameLength, size_t * offset, size_t * size)
 {
-    size_t byteCount;
-    int32_t * dst;
-    uint8_t * src;
+    size_t slot;
 
 
-    byteCount = count * 3;
-    if (a->availableBytes < byteCount)
-        return accessorBeyondEnd;
+    slot = accessorPrivateCatalogFindSlot(c, name, nameLength, (uint32_t) accessorPrivateHashBytes(name, nameLength, 0));
+    if (c->slots[slot].entry == 0)
+        return accessorNotFound;
 
-    dst = malloc(count * sizeof(**array));
-    if (dst == NULL)
-        return accessorOutOfMemory;
+    return accessorCatalogGetEntry(c, c->slots[slot].entry - 1, NULL, NULL, offset, size);
+}
 
-    src = a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor;
-    for (size_t i = 0; i < count; i++)
-    {
-        dst[i] = accessorPrivateReadInt24AtPointer(src, e);
-        src += 3;
-    }
 
-    accessorPrivateOpenCoverage(a);
 
-    a->cursor += byteCount;
-    a->availableBytes -= byteCount;
+accessorStatus accessorOpenReadingCatalogEntry(accessor_t ** a, const accessorCatalog_t * c, const void * name, size_t nameLength)
+{
+    accessorStatus status;
+    size_t offset;
+    size_t size;
 
-    accessorPrivateCloseCoverage(a);
 
-    * array = dst;
+    status = accessorCatalogFindEntry(c, name, nameLength, &offset, &size);
+    if (status != accessorOk)
+        return status;
 
-    return accessorOk;
+    return accessorOpenReadingAccessorWindow(a, c->accessor, offset, size);
 }
 
 
 
-accessorStatus accessorReadEndianInt32Array(accessor_t * a, int32_t ** array, size_t count, accessorEndianness e)
+size_t accessorCatalogEntryCount(const accessorCatalog_t * c)
 {
-    size_t byteCount;
-    int32_t * dst;
+    return c->entryCount;
+}
 
 
-    byteCount = count * 4;
-    if (a->availableBytes < byteCount)
+
+accessorStatus accessorCatalogGetEntry(const accessorCatalog_t * c, size_t index, const void ** name, size_t * nameLength, size_t * offset, size_t * size)
+{
+    const accessorPrivateCatalogEntry * entry;
+
+
+    if (index >= c->entryCount)
         return accessorBeyondEnd;
 
-    dst = malloc(count * sizeof(**array));
-    if (dst == NULL)
-        return accessorOutOfMemory;
+    entry = &c->entries[index];
 
-    memcpy(dst, a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor, byteCount);
+    if (name != NULL)
+        *name = c->names + entry->nameOffset;
+    if (nameLength != NULL)
+        *nameLength = (size_t) entry->nameLength;
+    if (offset != NULL)
+        *offset = (size_t) entry->offset;
+    if (size != NULL)
+        *size = (size_t) entry->size;
 
-    if (accessorPrivateIsReverseEndianness[e])
-        for (size_t i = 0; i < count; i++)
-            dst[i] = (int32_t) accessorSwapUInt32((uint32_t) dst[i]);
+    return accessorOk;
+}
 
-    accessorPrivateOpenCoverage(a);
 
-    a->cursor += byteCount;
-    a->availableBytes -= byteCount;
 
-    accessorPrivateCloseCoverage(a);
+// compare entry e1's name with name2, only considering their first prefixLength bytes. prefixLength may be SIZE_MAX
+static int accessorPrivateCatalogCompareEntries(const accessorCatalog_t * c, uint32_t e1, const void * name2, size_t nameLength2, size_t prefixLength)
+{
+    size_t nameLength1;
+    size_t length;
+    int result;
 
-    * array = dst;
 
-    return accessorOk;
+    nameLength1 = (size_t) c->entries[e1].nameLength;
+    if (nameLength1 > prefixLength)
+        nameLength1 = prefixLength;
+    if (nameLength2 > prefixLength)
+        nameLength2 = prefixLength;
+
+    length = nameLength1 < nameLength2 ? nameLength1 : nameLength2;
+    result = memcmp(c->names + c->entries[e1].nameOffset, name2, length);
+    if (result != 0)
+        return result;
+
+    if (nameLength1 < nameLength2) return -1;
+    if (nameLength1 > nameLength2) return +1;
+
+    return 0;
 }
 
 
 
-accessorStatus accessorReadEndianInt64Array(accessor_t * a, int64_t ** array, size_t count, accessorEndianness e)
+accessorStatus accessorCatalogSort(accessorCatalog_t * c)
 {
-    size_t byteCount;
-    int64_t * dst;
+    uint32_t * sorted;
+    uint32_t * tmp;
+    size_t allocation;
 
 
-    byteCount = count * 8;
-    if (a->availableBytes < byteCount)
-        return accessorBeyondEnd;
+    if (c->isSorted)
+        return accessorOk;
 
-    dst = malloc(count * sizeof(**array));
-    if (dst == NULL)
+    allocation = c->entryCount > 0 ? c->entryCount : 1;
+    sorted = accessorPrivateReallocate(c->sortedEntries, c->sortedAllocation * sizeof(*sorted), allocation * sizeof(*sorted));
+    if (sorted == NULL)
         return accessorOutOfMemory;
+    c->sortedEntries = sorted;
+    c->sortedAllocation = allocation;
 
-    memcpy(dst, a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor, byteCount);
+    tmp = accessorPrivateAllocate(allocation * sizeof(*tmp));
+    if (tmp == NULL)
+        return accessorOutOfMemory;
 
-    if (accessorPrivateIsReverseEndianness[e])
-        for (size_t i = 0; i < count; i++)
-            dst[i] = (int64_t) accessorSwapUInt64((uint64_t) dst[i]);
+    for (size_t i = 0; i < c->entryCount; i++)
+        sorted[i] = (uint32_t) i;
 
-    accessorPrivateOpenCoverage(a);
+    // bottom-up merge sort, as qsort() can't be given the catalog as context
+    for (size_t width = 1; width < c->entryCount; width *= 2)
+    {
+        uint32_t * swap;
 
-    a->cursor += byteCount;
-    a->availableBytes -= byteCount;
 
-    accessorPrivateCloseCoverage(a);
+        for (size_t left = 0; left < c->entryCount; left += 2 * width)
+        {
+            size_t middle = left + width < c->entryCount ? left + width : c->entryCount;
+            size_t right = left + 2 * width < c->entryCount ? left + 2 * width : c->entryCount;
+            size_t i = left;
+            size_t j = middle;
+            size_t k = left;
 
-    * array = dst;
+
+            while (i < middle && j < right)
+            {
+                const accessorPrivateCatalogEntry * entry = &c->entries[sorted[j]];
+
+
+                if (accessorPrivateCatalogCompareEntries(c, sorted[i], c->names + entry->nameOffset, (size_t) entry->nameLength, SIZE_MAX) <= 0)
+                    tmp[k++] = sorted[i++];
+                else
+                    tmp[k++] = sorted[j++];
+            }
+            while (i < middle)
+                tmp[k++] = sorted[i++];
+            while (j < right)
+                tmp[k++] = sorted[j++];
+        }
+
+        swap = sorted;
+        sorted = tmp;
+        tmp = swap;
+    }
+
+    if (sorted != c->sortedEntries)
+    {
+        memcpy(c->sortedEntries, sorted, c->entryCount * sizeof(*sorted));
+        tmp = sorted;
+    }
+    accessorPrivateRelease(tmp, allocation * sizeof(*tmp));
+
+    c->isSorted = 1;
 
     return accessorOk;
 }
 
 
 
-accessorStatus accessorReadEndianFloat32Array(accessor_t * a, float ** array, size_t count, accessorEndianness e)
+accessorStatus accessorCatalogFindPrefix(accessorCatalog_t * c, const void * prefix, size_t prefixLength, size_t * first, size_t * count)
 {
-    return accessorReadEndianUInt32Array(a, (uint32_t **) array, count, e);
+    accessorStatus status;
+    size_t low, high;
+
+
+    status = accessorCatalogSort(c);
+    if (status != accessorOk)
+        return status;
+
+    // first entry whose name is >= prefix
+    low = 0;
+    high = c->entryCount;
+    while (low < high)
+    {
+        size_t middle = low + (high - low) / 2;
+
+
+        if (accessorPrivateCatalogCompareEntries(c, c->sortedEntries[middle], prefix, prefixLength, SIZE_MAX) < 0)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    *first = low;
+
+    // first entry whose name, truncated to prefixLength, is > prefix
+    high = c->entryCount;
+    while (low < high)
+    {
+        size_t middle = low + (high - low) / 2;
+
+
+        if (accessorPrivateCatalogCompareEntries(c, c->sortedEntries[middle], prefix, prefixLength, prefixLength) <= 0)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    *count = low - *first;
+
+    return accessorOk;
 }
 
 
 
-accessorStatus accessorReadEndianFloat64Array(accessor_t * a, double ** array, size_t count, accessorEndianness e)
+accessorStatus accessorCatalogGetSortedEntry(const accessorCatalog_t * c, size_t position, const void ** name, size_t * nameLength, size_t * offset, size_t * size)
 {
-    return accessorReadEndianUInt64Array(a, (uint64_t **) array, count, e);
-}
-
+    if (!c->isSorted)
+        return accessorInvalidParameter;
 
+    if (position >= c->entryCount)
+        return accessorBeyondEnd;
 
-accessorStatus accessorReadUInt16Array(accessor_t * a, uint16_t ** array, size_t count)
-{
-    return accessorReadEndianUInt16Array(a, array, count, a->endianness);
+    return accessorCatalogGetEntry(c, c->sortedEntries[position], name, nameLength, offset, size);
 }
 
 
 
-accessorStatus accessorReadUInt24Array(accessor_t * a, uint32_t ** array, size_t count)
+static accessorStatus accessorPrivateIndexGetSourceKey(accessorPrivateIndexHeader * header, const accessor_t * source, accessorIndexOptions options)
 {
-    return accessorReadEndianUInt24Array(a, array, count, a->endianness);
-}
+    const accessor_t * base;
+    struct stat st;
 
 
+    base = source->baseAccessor;
+    if (base->isNull)
+        return accessorInvalidParameter;
 
-accessorStatus accessorReadUInt32Array(accessor_t * a, uint32_t ** array, size_t count)
-{
-    return accessorReadEndianUInt32Array(a, array, count, a->endianness);
+    header->sourceDevice = 0;
+    header->sourceInode = 0;
+    header->sourceSize = 0;
+    header->sourceModificationSeconds = 0;
+    header->sourceModificationNanoseconds = 0;
+    if (base->inputFileDescriptor != -1)
+    {
+        if (fstat(base->inputFileDescriptor, &st) != 0)
+            return accessorHostError;
+
+        header->sourceDevice = (uint64_t) st.st_dev;
+        header->sourceInode = (uint64_t) st.st_ino;
+        header->sourceSize = (uint64_t) st.st_size;
+        header->sourceModificationSeconds = (uint64_t) st.st_mtime;
+        header->sourceModificationNanoseconds = (uint64_t) ACCESSOR_STAT_MTIME_NSEC(st);
+    }
+    else if (!(options & accessorIndexOptionHashContent))
+        return accessorInvalidParameter;
+
+    header->sourceWindowOffset = accessorRootWindowOffset(source);
+    header->sourceWindowSize = source->windowSize;
+    header->options = options & accessorIndexOptionHashContent;
+    header->contentHash = 0;
+    if (options & accessorIndexOptionHashContent)
+        header->contentHash = accessorPrivateHashBytes(base->data + source->baseAccessorWindowOffset, source->windowSize, 0);
+
+    return accessorOk;
 }
 
 
 
-accessorStatus accessorReadUInt64Array(accessor_t * a, uint64_t ** array, size_t count)
+accessorStatus accessorOpenWritingIndex(accessorIndex_t ** x, const accessor_t * source, accessorIndexOptions options)
 {
-    return accessorReadEndianUInt64Array(a, array, count, a->endianness);
-}
+    accessorStatus status;
+    accessorIndex_t * result;
 
 
+    if (*x != ACCESSOR_INIT)
+        return accessorInvalidParameter;
 
-accessorStatus accessorReadInt16Array(accessor_t * a, int16_t ** array, size_t count)
-{
-    return accessorReadEndianInt16Array(a, array, count, a->endianness);
-}
+    result = malloc(sizeof(*result));
+    if (result == NULL)
+        return accessorOutOfMemory;
 
+    result->accessor = ACCESSOR_INIT;
+    memset(&result->header, 0, sizeof(result->header));
+    result->sections = NULL;
+    result->sectionCount = 0;
+    result->sectionAllocation = 0;
+    result->mappedHeader = NULL;
+    result->mappedSections = NULL;
+
+    memcpy(result->header.magic, ACCESSOR_INDEX_MAGIC, sizeof(result->header.magic));
+    result->header.version = ACCESSOR_INDEX_VERSION;
+    result->header.byteOrderMark = ACCESSOR_INDEX_BYTE_ORDER_MARK;
+
+    status = accessorPrivateIndexGetSourceKey(&result->header, source, options);
+    if (status == accessorOk)
+        status = accessorOpenWritingMemory(&result->accessor, 0, 0);
+    if (status == accessorOk)
+        status = accessorWriteBytes(result->accessor, &result->header, sizeof(result->header));     // placeholder, header is completed by accessorWriteIndexToFile()
+    if (status != accessorOk)
+    {
+        if (result->accessor != ACCESSOR_INIT)
+            accessorClose(&result->accessor);
+        free(result);
+        return status;
+    }
 
+    *x = result;
 
-accessorStatus accessorReadInt24Array(accessor_t * a, int32_t ** array, size_t count)
-{
-    return accessorReadEndianInt24Array(a, array, count, a->endianness);
+    return accessorOk;
 }
 
 
 
-accessorStatus accessorReadInt32Array(accessor_t * a, int32_t ** array, size_t count)
+static accessorStatus accessorPrivateIndexBeginSection(accessorIndex_t * x, uint32_t tag)
 {
-    return accessorReadEndianInt32Array(a, array, count, a->endianness);
-}
+    accessorStatus status;
+    accessorPrivateIndexSection * section;
 
 
+    if (!x->accessor->writeEnabled)
+        return accessorReadOnlyError;
 
-accessorStatus accessorReadInt64Array(accessor_t * a, int64_t ** array, size_t count)
-{
-    return accessorReadEndianInt64Array(a, array, count, a->endianness);
-}
+    status = accessorWriteRepeatedByte(x->accessor, 0, (8 - x->accessor->cursor % 8) % 8);
+    if (status != accessorOk)
+        return status;
 
+    if (accessorPrivateExtendPointerSizeAllocation((void **) &x->sections, &x->sectionCount, &x->sectionAllocation, x->sectionCount + 1, 16, sizeof(*x->sections)))
+        return accessorOutOfMemory;
 
+    section = &x->sections[x->sectionCount - 1];
+    section->tag = tag;
+    section->reserved = 0;
+    section->offset = x->accessor->cursor;
+    section->size = 0;
 
-accessorStatus accessorReadFloat32Array(accessor_t * a, float ** array, size_t count)
-{
-    return accessorReadEndianFloat32Array(a, array, count, a->endianness);
+    return accessorOk;
 }
 
 
 
-accessorStatus accessorReadFloat64Array(accessor_t * a, double ** array, size_t count)
+static void accessorPrivateIndexEndSection(accessorIndex_t * x)
 {
-    return accessorReadEndianFloat64Array(a, array, count, a->endianness);
+    accessorPrivateIndexSection * section;
+
+
+    section = &x->sections[x->sectionCount - 1];
+    section->size = x->accessor->cursor - section->offset;
 }
 
 
 
-accessorStatus accessorWriteEndianUInt16Array(accessor_t * a, const uint16_t * array, size_t count, accessorEndianness e)
+accessorStatus accessorIndexAddSection(accessorIndex_t * x, uint32_t tag, const void * ptr, size_t size)
 {
     accessorStatus status;
-    size_t byteCount;
-    uint8_t * dst;
 
 
-    if (!a->writeEnabled)
-        return accessorReadOnlyError;
+    status = accessorPrivateIndexBeginSection(x, tag);
+    if (status != accessorOk)
+        return status;
 
-    byteCount = count * 2;
-    if (a->availableBytes < byteCount)
+    status = accessorWriteBytes(x->accessor, ptr, size);
+    if (status != accessorOk)
     {
-        status = accessorPrivateGrow(a->baseAccessor, a->cursor + byteCount);
-        if (status != accessorOk)
-            return status;
+        x->sectionCount--;
+        return status;
     }
 
-    dst = a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor;
-    memcpy(dst, array, byteCount);
-
-    if (accessorPrivateIsReverseEndianness[e])
-        for (size_t i = 0; i < count; i++)
-        {
-            accessorPrivateWriteUInt16AtPointer(dst, accessorPrivateReadUInt16AtPointer(dst, accessorBig), accessorLittle);
-            dst += 2;
-        }
-
-    a->cursor += byteCount;
-    a->availableBytes -= byteCount;
+    accessorPrivateIndexEndSection(x);
 
     return accessorOk;
 }
 
 
 
-accessorStatus accessorWriteEndianUInt24Array(accessor_t * a, const uint32_t * array, size_t count, accessorEndianness e)
+accessorStatus accessorIndexAddCatalog(accessorIndex_t * x, uint32_t tag, const accessorCatalog_t * c)
 {
     accessorStatus status;
-    size_t byteCount;
-    uint8_t * dst;
+    accessorPrivateIndexCatalogHeader header;
 
 
-    if (!a->writeEnabled)
-        return accessorReadOnlyError;
+    status = accessorPrivateIndexBeginSection(x, tag);
+    if (status != accessorOk)
+        return status;
 
-    byteCount = count * 3;
-    if (a->availableBytes < byteCount)
+    header.entryCount = c->entryCount;
+    header.slotCount = c->slotCount;
+    header.namesSize = c->namesSize;
+    header.isSorted = c->isSorted ? 1 : 0;
+
+    status = accessorWriteBytes(x->accessor, &header, sizeof(header));
+    if (status == accessorOk)
+        status = accessorWriteBytes(x->accessor, c->entries, c->entryCount * sizeof(*c->entries));
+    if (status == accessorOk)
+        status = accessorWriteBytes(x->accessor, c->slots, c->slotCount * sizeof(*c->slots));
+    if (status == accessorOk && c->isSorted)
     {
-        status = accessorPrivateGrow(a->baseAccessor, a->cursor + byteCount);
-        if (status != accessorOk)
-            return status;
+        status = accessorWriteBytes(x->accessor, c->sortedEntries, c->entryCount * sizeof(*c->sortedEntries));
+        if (status == accessorOk)
+            status = accessorWriteRepeatedByte(x->accessor, 0, (8 - x->accessor->cursor % 8) % 8);
     }
-
-    dst = a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor;
-    for (size_t i = 0; i < count; i++)
+    if (status == accessorOk)
+        status = accessorWriteBytes(x->accessor, c->names, c->namesSize);
+    if (status != accessorOk)
     {
-        accessorPrivateWriteUInt24AtPointer(dst, array[i], e);
-        dst += 3;
+        x->sectionCount--;
+        return status;
     }
 
-    a->cursor += byteCount;
-    a->availableBytes -= byteCount;
+    accessorPrivateIndexEndSection(x);
 
     return accessorOk;
 }
 
 
 
-accessorStatus accessorWriteEndianUInt32Array(accessor_t * a, const uint32_t * array, size_t count, accessorEndianness e)
+accessorStatus accessorWriteIndexToFile(accessorIndex_t * x, const char * basePath, const char * path, accessorPathOptions pathOptions, mode_t mode)
 {
     accessorStatus status;
-    size_t byteCount;
-    uint8_t * dst;
+    size_t sectionsEnd;
 
 
-    if (!a->writeEnabled)
+    if (!x->accessor->writeEnabled)
         return accessorReadOnlyError;
 
-    byteCount = count * 4;
-    if (a->availableBytes < byteCount)
-    {
-        status = accessorPrivateGrow(a->baseAccessor, a->cursor + byteCount);
-        if (status != accessorOk)
-            return status;
-    }
+    // append directory, complete header, save, then remove directory so that more sections may be added
+    sectionsEnd = x->accessor->cursor;
 
-    dst = a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor;
-    memcpy(dst, array, byteCount);
+    status = accessorWriteRepeatedByte(x->accessor, 0, (8 - x->accessor->cursor % 8) % 8);
+    if (status != accessorOk)
+        return status;
 
-    if (accessorPrivateIsReverseEndianness[e])
-        for (size_t i = 0; i < count; i++)
-        {
-            accessorPrivateWriteUInt32AtPointer(dst, accessorPrivateReadUInt32AtPointer(dst, accessorBig), accessorLittle);
-            dst += 4;
-        }
+    x->header.directoryOffset = x->accessor->cursor;
+    x->header.sectionCount = x->sectionCount;
 
-    a->cursor += byteCount;
-    a->availableBytes -= byteCount;
+    status = accessorWriteBytes(x->accessor, x->sections, x->sectionCount * sizeof(*x->sections));
+    if (status == accessorOk)
+        status = accessorSeek(x->accessor, 0, SEEK_SET);
+    if (status == accessorOk)
+        status = accessorWriteBytes(x->accessor, &x->header, sizeof(x->header));
+    if (status == accessorOk)
+        status = accessorWriteToFile(x->accessor, basePath, path, pathOptions, mode, 0, ACCESSOR_UNTIL_END);
 
-    return accessorOk;
+    accessorSeek(x->accessor, (ssize_t) sectionsEnd, SEEK_SET);
+    accessorTruncate(x->accessor);
+
+    return status;
 }
 
 
 
-accessorStatus accessorWriteEndianUInt64Array(accessor_t * a, const uint64_t * array, size_t count, accessorEndianness e)
+accessorStatus accessorOpenReadingIndex(accessorIndex_t ** x, const accessor_t * source, const char * basePath, const char * path, accessorPathOptions pathOptions, accessorIndexOptions options)
 {
     accessorStatus status;
-    size_t byteCount;
-    uint8_t * dst;
+    accessorIndex_t * result;
+    const accessorPrivateIndexHeader * header;
+    accessorPrivateIndexHeader key;
+    accessorIndexOptions keyOptions;
+    const void * ptr;
+    size_t size;
 
 
-    if (!a->writeEnabled)
-        return accessorReadOnlyError;
+    if (*x != ACCESSOR_INIT)
+        return accessorInvalidParameter;
 
-    byteCount = count * 8;
-    if (a->availableBytes < byteCount)
+    result = malloc(sizeof(*result));
+    if (result == NULL)
+        return accessorOutOfMemory;
+
+    result->accessor = ACCESSOR_INIT;
+    result->sections = NULL;
+    result->sectionCount = 0;
+    result->sectionAllocation = 0;
+    result->mappedHeader = NULL;
+    result->mappedSections = NULL;
+
+    status = accessorOpenReadingFile(&result->accessor, basePath, path, pathOptions, 0, ACCESSOR_UNTIL_END);
+    if (status != accessorOk)
     {
-        status = accessorPrivateGrow(a->baseAccessor, a->cursor + byteCount);
-        if (status != accessorOk)
-            return status;
+        free(result);
+        return status;
     }
 
-    dst = a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor;
-    memcpy(dst, array, byteCount);
+    // mapped or read data is at least 8 bytes aligned, as are all index file structures
+    size = accessorLookAheadAvailableBytes(result->accessor, &ptr);
+    header = (const accessorPrivateIndexHeader *) ptr;
+
+    status = accessorInvalidReadData;
+    if (size >= sizeof(*header)
+        && memcmp(header->magic, ACCESSOR_INDEX_MAGIC, sizeof(header->magic)) == 0
+        && header->version == ACCESSOR_INDEX_VERSION
+        && header->byteOrderMark == ACCESSOR_INDEX_BYTE_ORDER_MARK
+        && header->directoryOffset % 8 == 0
+        && header->directoryOffset <= size
+        && header->sectionCount <= (size - header->directoryOffset) / sizeof(accessorPrivateIndexSection))
+    {
+        result->mappedHeader = header;
+        result->mappedSections = (const accessorPrivateIndexSection *) ((const uint8_t *) ptr + header->directoryOffset);
+        result->sectionCount = (size_t) header->sectionCount;
+
+        status = accessorOk;
+        for (size_t i = 0; i < result->sectionCount; i++)
+            if (result->mappedSections[i].offset % 8 != 0 || result->mappedSections[i].offset > size || result->mappedSections[i].size > size - result->mappedSections[i].offset)
+                status = accessorInvalidReadData;
+    }
 
-    if (accessorPrivateIsReverseEndianness[e])
-        for (size_t i = 0; i < count; i++)
-        {
-            accessorPrivateWriteUInt64AtPointer(dst, accessorPrivateReadUInt64AtPointer(dst, accessorBig), accessorLittle);
-            dst += 8;
-        }
+    // content is hashed only if both the caller and the index writer asked for it, or if there is no other way to identify source
+    if (status == accessorOk && !(options & accessorIndexOptionIgnoreSource))
+    {
+        keyOptions = (accessorIndexOptions) (header->options & accessorIndexOptionHashContent);
+        if (source->baseAccessor->inputFileDescriptor != -1 && !(options & accessorIndexOptionHashContent))
+            keyOptions = accessorIndexOptionNone;
+
+        status = accessorPrivateIndexGetSourceKey(&key, source, keyOptions);
+        if (status == accessorOk
+            && (key.sourceDevice != header->sourceDevice
+                || key.sourceInode != header->sourceInode
+                || key.sourceSize != header->sourceSize
+                || key.sourceModificationSeconds != header->sourceModificationSeconds
+                || key.sourceModificationNanoseconds != header->sourceModificationNanoseconds
+                || key.sourceWindowOffset != header->sourceWindowOffset
+                || key.sourceWindowSize != header->sourceWindowSize
+                || ((keyOptions & accessorIndexOptionHashContent) && key.contentHash != header->contentHash)))
+            status = accessorInvalidReadData;
+    }
 
-    a->cursor += byteCount;
-    a->availableBytes -= byteCount;
+    if (status != accessorOk)
+    {
+        accessorClose(&result->accessor);
+        free(result);
+        return status;
+    }
+
+    *x = result;
 
     return accessorOk;
 }
 
 
 
-accessorStatus accessorWriteEndianInt16Array(accessor_t * a, const int16_t * array, size_t count, accessorEndianness e)
+accessorStatus accessorIndexGetSection(const accessorIndex_t * x, uint32_t tag, const void ** ptr, size_t * size)
+{
+    const accessorPrivateIndexSection * sections;
+
+
+    sections = x->mappedSections != NULL ? x->mappedSections : x->sections;
+    for (size_t i = 0; i < x->sectionCount; i++)
+    {
+        if (sections[i].tag == tag)
+        {
+            *ptr = x->accessor->baseAccessor->data + x->accessor->baseAccessorWindowOffset + sections[i].offset;
+            *size = (size_t) sections[i].size;
+
+            return accessorOk;
+        }
+    }
+
+    return accessorNotFound;
+}
+
+
+
+accessorStatus accessorOpenIndexCatalog(accessorCatalog_t ** c, const accessorIndex_t * x, uint32_t tag, accessor_t * a)
 {
     accessorStatus status;
-    size_t byteCount;
-    uint8_t * dst;
+    accessorCatalog_t * result;
+    const accessorPrivateIndexCatalogHeader * header;
+    const uint8_t * ptr;
+    size_t size;
+    uint64_t entriesSize;
+    uint64_t slotsSize;
+    uint64_t sortedSize;
 
 
-    if (!a->writeEnabled)
-        return accessorReadOnlyError;
+    if (*c != ACCESSOR_INIT)
+        return accessorInvalidParameter;
 
-    byteCount = count * 2;
-    if (a->availableBytes < byteCount)
+    if (a->writeEnabled)
+        return accessorInvalidParameter;
+
+    status = accessorIndexGetSection(x, tag, (const void **) &ptr, &size);
+    if (status != accessorOk)
+        return status;
+
+    header = (const accessorPrivateIndexCatalogHeader *) ptr;
+    if (size < sizeof(*header)
+        || header->entryCount >= UINT32_MAX
+        || header->slotCount == 0 || header->slotCount > UINT32_MAX || (header->slotCount & (header->slotCount - 1)) != 0 || header->slotCount <= header->entryCount)
+        return accessorInvalidReadData;
+
+    entriesSize = header->entryCount * sizeof(accessorPrivateCatalogEntry);
+    slotsSize = header->slotCount * sizeof(accessorPrivateCatalogSlot);
+    sortedSize = header->isSorted ? (header->entryCount * sizeof(uint32_t) + 7) / 8 * 8 : 0;
+    if (header->namesSize > size || sizeof(*header) + entriesSize + slotsSize + sortedSize > size - header->namesSize)
+        return accessorInvalidReadData;
+
+    result = malloc(sizeof(*result));
+    if (result == NULL)
+        return accessorOutOfMemory;
+
+    // intentionally discarding const qualifiers: isMapped prevents any modification
+    ptr += sizeof(*header);
+    result->accessor = a;
+    result->entries = (accessorPrivateCatalogEntry *) ptr;
+    result->entryCount = (size_t) header->entryCount;
+    result->entryAllocation = 0;
+    ptr += entriesSize;
+    result->slots = (accessorPrivateCatalogSlot *) ptr;
+    result->slotCount = (size_t) header->slotCount;
+    ptr += slotsSize;
+    result->sortedEntries = header->isSorted ? (uint32_t *) ptr : NULL;
+    result->sortedAllocation = 0;
+    result->isSorted = header->isSorted ? 1 : 0;
+    ptr += sortedSize;
+    result->names = (uint8_t *) ptr;
+    result->namesSize = (size_t) header->namesSize;
+    result->namesAllocation = 0;
+    result->isMapped = 1;
+    result->isSortedMapped = result->isSorted;
+
+    // a truncated or corrupted index file must not lead to out of bounds accesses or endless lookups
+    if (accessorPrivateCatalogValidate(result) != accessorOk)
     {
-        status = accessorPrivateGrow(a->baseAccessor, a->cursor + byteCount);
-        if (status != accessorOk)
-            return status;
+        free(result);
+        return accessorInvalidReadData;
     }
 
-    dst = a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor;
-    memcpy(dst, array, byteCount);
-
-    if (accessorPrivateIsReverseEndianness[e])
-        for (size_t i = 0; i < count; i++)
-        {
-            accessorPrivateWriteUInt16AtPointer(dst, accessorPrivateReadUInt16AtPointer(dst, accessorBig), accessorLittle);
-            dst += 2;
-        }
+    a->referenceCount++;
 
-    a->cursor += byteCount;
-    a->availableBytes -= byteCount;
+    *c = result;
 
     return accessorOk;
 }
 
 
 
-accessorStatus accessorWriteEndianInt24Array(accessor_t * a, const int32_t * array, size_t count, accessorEndianness e)
+static accessorStatus accessorPrivateCatalogValidate(const accessorCatalog_t * c)
 {
-    accessorStatus status;
-    size_t byteCount;
-    uint8_t * dst;
-
+    size_t emptySlotCount;
 
-    if (!a->writeEnabled)
-        return accessorReadOnlyError;
 
-    byteCount = count * 3;
-    if (a->availableBytes < byteCount)
+    for (size_t i = 0; i < c->entryCount; i++)
     {
-        status = accessorPrivateGrow(a->baseAccessor, a->cursor + byteCount);
-        if (status != accessorOk)
-            return status;
+        const accessorPrivateCatalogEntry * entry = &c->entries[i];
+
+
+        if (entry->nameOffset > c->namesSize || entry->nameLength > c->namesSize - entry->nameOffset
+            || entry->offset > c->accessor->windowSize || entry->size > c->accessor->windowSize - entry->offset)
+            return accessorInvalidReadData;
     }
 
-    dst = a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor;
-    for (size_t i = 0; i < count; i++)
+    // lookups stop at the first empty slot: there must be one
+    emptySlotCount = 0;
+    for (size_t i = 0; i < c->slotCount; i++)
     {
-        accessorPrivateWriteUInt24AtPointer(dst, (uint32_t) array[i], e);
-        dst += 3;
+        if (c->slots[i].entry > c->entryCount)
+            return accessorInvalidReadData;
+        if (c->slots[i].entry == 0)
+            emptySlotCount++;
     }
+    if (emptySlotCount == 0)
+        return accessorInvalidReadData;
 
-    a->cursor += byteCount;
-    a->availableBytes -= byteCount;
+    if (c->isSorted)
+        for (size_t i = 0; i < c->entryCount; i++)
+            if (c->sortedEntries[i] >= c->entryCount)
+                return accessorInvalidReadData;
 
     return accessorOk;
 }
 
 
 
-accessorStatus accessorWriteEndianInt32Array(accessor_t * a, const int32_t * array, size_t count, accessorEndianness e)
+accessorStatus accessorCloseIndex(accessorIndex_t ** x)
 {
     accessorStatus status;
-    size_t byteCount;
-    uint8_t * dst;
-
-
-    if (!a->writeEnabled)
-        return accessorReadOnlyError;
 
-    byteCount = count * 4;
-    if (a->availableBytes < byteCount)
-    {
-        status = accessorPrivateGrow(a->baseAccessor, a->cursor + byteCount);
-        if (status != accessorOk)
-            return status;
-    }
 
-    dst = a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor;
-    memcpy(dst, array, byteCount);
+    if (*x == ACCESSOR_INIT)
+        return accessorInvalidParameter;
 
-    if (accessorPrivateIsReverseEndianness[e])
-        for (size_t i = 0; i < count; i++)
-        {
-            accessorPrivateWriteUInt32AtPointer(dst, accessorPrivateReadUInt32AtPointer(dst, accessorBig), accessorLittle);
-            dst += 4;
-        }
+    status = accessorClose(&(*x)->accessor);
+    if (status != accessorOk)
+        return status;
 
+    accessorPrivateRelease((*x)->sections, (*x)->sectionAllocation * sizeof(*(*x)->sections));
 
-    a->cursor += byteCount;
-    a->availableBytes -= byteCount;
+    free(*x);
+    *x = ACCESSOR_INIT;
 
     return accessorOk;
 }
 
 
 
-accessorStatus accessorWriteEndianInt64Array(accessor_t * a, const int64_t * array, size_t count, accessorEndianness e)
+accessorStatus accessorOpenRecordIndex(accessorRecordIndex_t ** r, accessor_t * a, size_t interval, accessorStatus (* recordLength)(accessor_t * record, void * context, size_t * length), void * context)
 {
     accessorStatus status;
-    size_t byteCount;
-    uint8_t * dst;
+    accessorRecordIndex_t * result;
 
 
-    if (!a->writeEnabled)
-        return accessorReadOnlyError;
+    if (*r != ACCESSOR_INIT)
+        return accessorInvalidParameter;
 
-    byteCount = count * 8;
-    if (a->availableBytes < byteCount)
+    if (a->writeEnabled || interval == 0 || recordLength == NULL)
+        return accessorInvalidParameter;
+
+    result = malloc(sizeof(*result));
+    if (result == NULL)
+        return accessorOutOfMemory;
+
+    result->record = ACCESSOR_INIT;
+    status = accessorOpenReadingAccessorWindow(&result->record, a, 0, ACCESSOR_UNTIL_END);
+    if (status != accessorOk)
     {
-        status = accessorPrivateGrow(a->baseAccessor, a->cursor + byteCount);
-        if (status != accessorOk)
-            return status;
+        free(result);
+        return status;
     }
 
-    dst = a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor;
-    memcpy(dst, array, byteCount);
+    result->checkpoints = NULL;
+    result->checkpointCount = 0;
+    result->checkpointAllocation = 0;
+    if (accessorPrivateExtendPointerSizeAllocation((void **) &result->checkpoints, &result->checkpointCount, &result->checkpointAllocation, 1, 1024, sizeof(*result->checkpoints)))
+    {
+        accessorClose(&result->record);
+        free(result);
+        return accessorOutOfMemory;
+    }
+    result->checkpoints[0] = 0;
 
-    if (accessorPrivateIsReverseEndianness[e])
-        for (size_t i = 0; i < count; i++)
-        {
-            accessorPrivateWriteUInt64AtPointer(dst, accessorPrivateReadUInt64AtPointer(dst, accessorBig), accessorLittle);
-            dst += 8;
-        }
+    a->referenceCount++;
 
+    result->accessor = a;
+    result->interval = interval;
+    result->recordLength = recordLength;
+    result->context = context;
+    result->parsedCount = 0;
+    result->parsedOffset = 0;
 
-    a->cursor += byteCount;
-    a->availableBytes -= byteCount;
+    *r = result;
 
     return accessorOk;
 }
 
 
 
-accessorStatus accessorWriteEndianFloat32Array(accessor_t * a, float * array, size_t count, accessorEndianness e)
+accessorStatus accessorCloseRecordIndex(accessorRecordIndex_t ** r)
 {
-    return accessorWriteEndianUInt32Array(a, (uint32_t *) array, count, e);
-}
+    accessorStatus status;
 
 
+    if (*r == ACCESSOR_INIT)
+        return accessorInvalidParameter;
 
-accessorStatus accessorWriteEndianFloat64Array(accessor_t * a, double * array, size_t count, accessorEndianness e)
-{
-    return accessorWriteEndianUInt64Array(a, (uint64_t *) array, count, e);
-}
+    status = accessorClose(&(*r)->record);
+    if (status != accessorOk)
+        return status;
 
+    status = accessorClose(&(*r)->accessor);
+    if (status != accessorOk)
+        return status;
 
+    accessorPrivateRelease((*r)->checkpoints, (*r)->checkpointAllocation * sizeof(*(*r)->checkpoints));
 
-accessorStatus accessorWriteUInt16Array(accessor_t * a, const uint16_t * array, size_t count)
-{
-    return accessorWriteEndianUInt16Array(a, array, count, a->endianness);
+    free(*r);
+    *r = ACCESSOR_INIT;
+
+    return accessorOk;
 }
 
 
 
-accessorStatus accessorWriteUInt24Array(accessor_t * a, const uint32_t * array, size_t count)
+// call recordLength for the record at offset, offset must be less than stream's size
+static accessorStatus accessorPrivateRecordIndexLength(accessorRecordIndex_t * r, size_t offset, size_t * length)
 {
-    return accessorWriteEndianUInt24Array(a, array, count, a->endianness);
+    accessorStatus status;
+    accessor_t * record;
+
+
+    // move record's window rather than opening a new sub-accessor for each record
+    record = r->record;
+    record->windowOffset = offset;
+    record->baseAccessorWindowOffset = r->accessor->baseAccessorWindowOffset + offset;
+    record->windowSize = r->accessor->windowSize - offset;
+    record->cursor = 0;
+    record->availableBytes = record->windowSize;
+    // and reset anything previous recordLength calls may have left behind, so that each record starts from a fresh accessor
+    record->endianness = r->accessor->endianness;
+    record->cursorStackSize = 0;
+    record->coverageEnabled = 0;
+    record->coverageSuspendCount = 0;
+    record->coverageArraySize = 0;
+
+    status = r->recordLength(record, r->context, length);
+    if (status != accessorOk)
+        return status;
+
+    if (*length == 0)
+        return accessorInvalidReadData;
+    if (*length > record->windowSize)
+        return accessorBeyondEnd;
+
+    return accessorOk;
 }
 
 
 
-accessorStatus accessorWriteUInt32Array(accessor_t * a, const uint32_t * array, size_t count)
+accessorStatus accessorRecordIndexGetRecord(accessorRecordIndex_t * r, size_t index, size_t * offset, size_t * size)
 {
-    return accessorWriteEndianUInt32Array(a, array, count, a->endianness);
-}
+    accessorStatus status;
+    size_t i;
+    size_t recordOffset;
+    size_t length;
 
 
+    // start from the nearest checkpoint, or from the first unparsed record
+    if (index < r->parsedCount)
+    {
+        i = index - index % r->interval;
+        recordOffset = r->checkpoints[index / r->interval];
+    }
+    else
+    {
+        i = r->parsedCount;
+        recordOffset = r->parsedOffset;
+    }
 
-accessorStatus accessorWriteUInt64Array(accessor_t * a, const uint64_t * array, size_t count)
-{
-    return accessorWriteEndianUInt64Array(a, array, count, a->endianness);
-}
+    for ( ; ; )
+    {
+        if (recordOffset >= r->accessor->windowSize)
+            return accessorBeyondEnd;
 
+        status = accessorPrivateRecordIndexLength(r, recordOffset, &length);
+        if (status != accessorOk)
+            return status;
 
+        if (i == r->parsedCount)
+        {
+            r->parsedCount++;
+            r->parsedOffset = recordOffset + length;
+            if (r->parsedCount % r->interval == 0)
+            {
+                if (accessorPrivateExtendPointerSizeAllocation((void **) &r->checkpoints, &r->checkpointCount, &r->checkpointAllocation, r->checkpointCount + 1, 1024, sizeof(*r->checkpoints)))
+                {
+                    // forget about this record, so that checkpoints stay consistent
+                    r->parsedCount--;
+                    r->parsedOffset = recordOffset;
+                    return accessorOutOfMemory;
+                }
+                r->checkpoints[r->checkpointCount - 1] = r->parsedOffset;
+            }
+        }
 
-accessorStatus accessorWriteInt16Array(accessor_t * a, const int16_t * array, size_t count)
-{
-    return accessorWriteEndianInt16Array(a, array, count, a->endianness);
-}
+        if (i == index)
+            break;
 
+        recordOffset += length;
+        i++;
+    }
 
+    if (offset != NULL)
+        *offset = recordOffset;
+    if (size != NULL)
+        *size = length;
 
-accessorStatus accessorWriteInt24Array(accessor_t * a, const int32_t * array, size_t count)
-{
-    return accessorWriteEndianInt24Array(a, array, count, a->endianness);
+    return accessorOk;
 }
 
 
 
-accessorStatus accessorWriteInt32Array(accessor_t * a, const int32_t * array, size_t count)
+accessorStatus accessorOpenReadingRecord(accessor_t ** a, accessorRecordIndex_t * r, size_t index)
 {
-    return accessorWriteEndianInt32Array(a, array, count, a->endianness);
-}
+    accessorStatus status;
+    size_t offset;
+    size_t size;
 
 
+    status = accessorRecordIndexGetRecord(r, index, &offset, &size);
+    if (status != accessorOk)
+        return status;
 
-accessorStatus accessorWriteInt64Array(accessor_t * a, const int64_t * array, size_t count)
-{
-    return accessorWriteEndianInt64Array(a, array, count, a->endianness);
+    return accessorOpenReadingAccessorWindow(a, r->accessor, offset, size);
 }
 
 
 
-accessorStatus accessorWriteFloat32Array(accessor_t * a, float * array, size_t count)
+accessorStatus accessorRecordIndexCount(accessorRecordIndex_t * r, size_t * count)
 {
-    return accessorWriteEndianFloat32Array(a, array, count, a->endianness);
-}
+    accessorStatus status;
 
 
+    while (r->parsedOffset < r->accessor->windowSize)
+    {
+        status = accessorRecordIndexGetRecord(r, r->parsedCount, NULL, NULL);
+        if (status != accessorOk)
+            return status;
+    }
 
-accessorStatus accessorWriteFloat64Array(accessor_t * a, double * array, size_t count)
-{
-    return accessorWriteEndianFloat64Array(a, array, count, a->endianness);
+    *count = r->parsedCount;
+
+    return accessorOk;
 }
 
 
 
-accessorStatus accessorReadEndianBytes(accessor_t * a, void * ptr, size_t count, accessorEndianness e)
+accessorStatus accessorOpenMemo(accessorMemo_t ** m, accessor_t * a, size_t maxCost)
 {
-    if (a->availableBytes < count)
-        return accessorBeyondEnd;
+    accessorMemo_t * result;
 
-    memcpy(ptr, a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor, count);
 
-    if (accessorPrivateIsReverseEndianness[e])
-        accessorSwapBytes(ptr, count);
+    if (*m != ACCESSOR_INIT)
+        return accessorInvalidParameter;
 
-    accessorPrivateOpenCoverage(a);
+    if (a->writeEnabled)
+        return accessorInvalidParameter;
 
-    a->cursor += count;
-    a->availableBytes -= count;
+    result = accessorPrivateAllocate(sizeof(*result));
+    if (result == NULL)
+        return accessorOutOfMemory;
+
+    result->bucketCount = 256;
+    result->buckets = accessorPrivateAllocate(result->bucketCount * sizeof(*result->buckets));
+    if (result->buckets == NULL)
+    {
+        accessorPrivateRelease(result, sizeof(*result));
+        return accessorOutOfMemory;
+    }
+    memset(result->buckets, 0, result->bucketCount * sizeof(*result->buckets));
+
+    a->referenceCount++;
 
-    accessorPrivateCloseCoverage(a);
+    result->accessor = a;
+    result->maxCost = maxCost;
+    result->cost = 0;
+    result->entries = NULL;
+    result->entryCount = 0;
+    result->entryAllocation = 0;
+    result->freeEntries = 0;
+    result->valueCount = 0;
+    result->lruFirst = 0;
+    result->lruLast = 0;
+
+    *m = result;
 
     return accessorOk;
 }
 
 
 
-accessorStatus accessorReadBytes(accessor_t * a, void * ptr, size_t count)
+accessorStatus accessorCloseMemo(accessorMemo_t ** m)
 {
-    if (a->availableBytes < count)
-        return accessorBeyondEnd;
+    accessorStatus status;
 
-    memcpy(ptr, a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor, count);
 
-    accessorPrivateOpenCoverage(a);
+    if (*m == ACCESSOR_INIT)
+        return accessorInvalidParameter;
 
-    a->cursor += count;
-    a->availableBytes -= count;
+    accessorMemoClear(*m);
 
-    accessorPrivateCloseCoverage(a);
+    status = accessorClose(&(*m)->accessor);
+    if (status != accessorOk)
+        return status;
+
+    accessorPrivateRelease((*m)->entries, (*m)->entryAllocation * sizeof(*(*m)->entries));
+    accessorPrivateRelease((*m)->buckets, (*m)->bucketCount * sizeof(*(*m)->buckets));
+
+    accessorPrivateRelease(*m, sizeof(**m));
+    *m = ACCESSOR_INIT;
 
     return accessorOk;
 }
 
 
 
-accessorStatus accessorReadAllocatedEndianBytes(accessor_t * a, void ** ptr, size_t count, accessorEndianness e)
+static inline uint64_t accessorPrivateMemoHash(uint64_t offset, uintmax_t decoderId)
 {
-    if (a->availableBytes < count)
-    {
-        *ptr = NULL;
-        return accessorBeyondEnd;
-    }
-
-    if ((*ptr = malloc(count)) == NULL)
-        return accessorBeyondEnd;
+    return accessorPrivateMix64(offset ^ accessorPrivateMix64((uint64_t) decoderId));
+}
 
-    memcpy(*ptr, a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor, count);
 
-    if (accessorPrivateIsReverseEndianness[e])
-        accessorSwapBytes(*ptr, count);
 
-    accessorPrivateOpenCoverage(a);
+static uint32_t * accessorPrivateMemoFindLink(accessorMemo_t * m, uint64_t offset, uintmax_t decoderId, uint64_t hash)
+{
+    uint32_t * link;
+    const accessorPrivateMemoEntry * entry;
 
-    a->cursor += count;
-    a->availableBytes -= count;
 
-    accessorPrivateCloseCoverage(a);
+    link = &m->buckets[hash & (m->bucketCount - 1)];
+    while (*link != 0)
+    {
+        entry = &m->entries[*link - 1];
+        if (entry->offset == offset && entry->decoderId == decoderId)
+            break;
+        link = &m->entries[*link - 1].hashNext;
+    }
 
-    return accessorOk;
+    return link;
 }
 
 
 
-accessorStatus accessorReadAllocatedBytes(accessor_t * a, void ** ptr, size_t count)
+static void accessorPrivateMemoLruUnlink(accessorMemo_t * m, uint32_t e)
 {
-    if (a->availableBytes < count)
-        return accessorBeyondEnd;
+    accessorPrivateMemoEntry * entry;
 
-    if ((*ptr = malloc(count)) == NULL)
-        return accessorBeyondEnd;
 
-    memcpy(*ptr, a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor, count);
+    entry = &m->entries[e - 1];
+    if (entry->lruPrevious != 0)
+        m->entries[entry->lruPrevious - 1].lruNext = entry->lruNext;
+    else
+        m->lruFirst = entry->lruNext;
+    if (entry->lruNext != 0)
+        m->entries[entry->lruNext - 1].lruPrevious = entry->lruPrevious;
+    else
+        m->lruLast = entry->lruPrevious;
+}
 
-    accessorPrivateOpenCoverage(a);
 
-    a->cursor += count;
-    a->availableBytes -= count;
 
-    accessorPrivateCloseCoverage(a);
+static void accessorPrivateMemoLruInsertFirst(accessorMemo_t * m, uint32_t e)
+{
+    accessorPrivateMemoEntry * entry;
 
-    return accessorOk;
+
+    entry = &m->entries[e - 1];
+    entry->lruPrevious = 0;
+    entry->lruNext = m->lruFirst;
+    if (m->lruFirst != 0)
+        m->entries[m->lruFirst - 1].lruPrevious = e;
+    else
+        m->lruLast = e;
+    m->lruFirst = e;
 }
 
 
 
-size_t accessorLookAheadEndianBytes(const accessor_t * a, void * ptr, size_t count, accessorEndianness e)
+static void accessorPrivateMemoRemove(accessorMemo_t * m, uint32_t e)
 {
-    if (a->availableBytes < count)
-        count = a->availableBytes;
+    accessorPrivateMemoEntry * entry;
+    uint32_t * link;
+    void * value;
 
-    memcpy(ptr, a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor, count);
 
-    if (accessorPrivateIsReverseEndianness[e])
-        accessorSwapBytes(ptr, count);
+    entry = &m->entries[e - 1];
 
-    return count;
+    link = &m->buckets[entry->hash & (m->bucketCount - 1)];
+    while (*link != e)
+        link = &m->entries[*link - 1].hashNext;
+    *link = entry->hashNext;
+
+    accessorPrivateMemoLruUnlink(m, e);
+
+    m->cost -= entry->cost;
+    m->valueCount--;
+
+    value = entry->value;
+    entry->value = NULL;
+    entry->hashNext = m->freeEntries;
+    m->freeEntries = e;
+    if (entry->destroy != NULL)
+        entry->destroy(value);
 }
 
 
 
-size_t accessorLookAheadBytes(const accessor_t * a, void * ptr, size_t count)
+accessorStatus accessorMemoFind(accessorMemo_t * m, const accessor_t * a, size_t offset, uintmax_t decoderId, void ** value)
 {
-    if (a->availableBytes < count)
-        count = a->availableBytes;
+    uint64_t rootOffset;
+    uint32_t e;
 
-    memcpy(ptr, a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor, count);
 
-    return count;
+    if (a->baseAccessor != m->accessor->baseAccessor)
+        return accessorInvalidParameter;
+
+    rootOffset = (uint64_t) a->baseAccessorWindowOffset + offset;
+    e = *accessorPrivateMemoFindLink(m, rootOffset, decoderId, accessorPrivateMemoHash(rootOffset, decoderId));
+    if (e == 0)
+        return accessorNotFound;
+
+    if (m->lruFirst != e)
+    {
+        accessorPrivateMemoLruUnlink(m, e);
+        accessorPrivateMemoLruInsertFirst(m, e);
+    }
+
+    *value = m->entries[e - 1].value;
+
+    return accessorOk;
 }
 
 
 
-accessorStatus accessorLookAheadCountBytesBeforeDelimiter(const accessor_t * a, size_t * count, size_t countLimit, size_t delLength, const void * delimiter)
+accessorStatus accessorMemoAdd(accessorMemo_t * m, const accessor_t * a, size_t offset, size_t size, uintmax_t decoderId, void * value, size_t cost, void (* destroy)(void * value))
 {
-    size_t availableBytes;
-    uint8_t * ptr;
-    size_t nbytes;
+    uint64_t rootOffset;
+    uint64_t hash;
+    uint32_t * link;
+    uint32_t e;
+    accessorPrivateMemoEntry * entry;
 
 
-    if (delLength < 1)
+    if (a->baseAccessor != m->accessor->baseAccessor || value == NULL)
         return accessorInvalidParameter;
 
-    if (a->availableBytes < delLength)
-        return accessorBeyondEnd;
-
-    if (countLimit == ACCESSOR_UNTIL_END)
-        countLimit = a->availableBytes - delLength;
-
-    ptr = a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor;
-    availableBytes = a->availableBytes;
-    if (availableBytes > countLimit)
-        availableBytes = countLimit;
+    rootOffset = (uint64_t) a->baseAccessorWindowOffset + offset;
+    hash = accessorPrivateMemoHash(rootOffset, decoderId);
 
-    nbytes = 0;
-    switch(delLength)
+    link = accessorPrivateMemoFindLink(m, rootOffset, decoderId, hash);
+    if (*link != 0 && m->entries[*link - 1].value == value)
     {
-    case 1:     // slightly optimized version for delLength == 1
-        while (ptr[0] != ((uint8_t *) delimiter)[0])
-        {
-            if (availableBytes-- == 0)
-                return accessorBeyondEnd;
-            ptr++;
-            nbytes++;
-        }
-        break;
-
-    case 2:     // slightly optimized version for delLength == 2
-        while ((ptr[0] != ((uint8_t *) delimiter)[0] || ptr[1] != ((uint8_t *) delimiter)[1]))
+        // the same value again, e.g. to refresh its cost: removing it would destroy it. update it in place
+        e = *link;
+        entry = &m->entries[e - 1];
+        m->cost -= entry->cost;
+        entry->size = size;
+        entry->cost = cost;
+        entry->destroy = destroy;
+        m->cost += cost;
+        accessorPrivateMemoLruUnlink(m, e);
+        accessorPrivateMemoLruInsertFirst(m, e);
+
+        // value is most recently used: other values are evicted first
+        while (m->lruLast != e && m->cost > m->maxCost)
+            accessorPrivateMemoRemove(m, m->lruLast);
+        while (m->lruLast != e && m->cost > m->maxCost / 2 && accessorPrivateIsUnderPressure())
         {
-            if (availableBytes-- == 0)
-                return accessorBeyondEnd;
-            ptr++;
-            nbytes++;
+            accessorPrivateMemoRemove(m, m->lruLast);
+            ACCESSOR_ATOMIC_ADD(&accessorPrivateBudgetEvictions, 1);
         }
-        break;
 
-    default:
-        while (memcmp(ptr, delimiter, delLength) != 0)
-        {
-            if (availableBytes-- == 0)
-                return accessorBeyondEnd;
-            ptr++;
-            nbytes++;
-        }
-        break;
+        return accessorOk;
     }
-    *count = nbytes;
-
-    return accessorOk;
-}
-
+    if (*link != 0)
+        accessorPrivateMemoRemove(m, *link);
 
+    // keep buckets at most as many as values
+    if (m->valueCount >= m->bucketCount && m->bucketCount <= UINT32_MAX / 2)
+    {
+        uint32_t * buckets;
+        size_t bucketCount;
 
-size_t accessorLookAheadAvailableBytes(const accessor_t * a, const void ** ptr)
-{
-    *ptr = a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor;
 
-    return a->availableBytes;
-}
+        bucketCount = m->bucketCount * 2;
+        buckets = accessorPrivateAllocate(bucketCount * sizeof(*buckets));
+        if (buckets == NULL)
+            return accessorOutOfMemory;
+        memset(buckets, 0, bucketCount * sizeof(*buckets));
 
+        for (size_t i = 0; i < m->entryCount; i++)
+        {
+            if (m->entries[i].value != NULL)
+            {
+                m->entries[i].hashNext = buckets[m->entries[i].hash & (bucketCount - 1)];
+                buckets[m->entries[i].hash & (bucketCount - 1)] = (uint32_t) (i + 1);
+            }
+        }
+        accessorPrivateRelease(m->buckets, m->bucketCount * sizeof(*m->buckets));
+        m->buckets = buckets;
+        m->bucketCount = bucketCount;
+    }
 
+    if (m->freeEntries != 0)
+    {
+        e = m->freeEntries;
+        m->freeEntries = m->entries[e - 1].hashNext;
+    }
+    else
+    {
+        if (m->entryCount >= UINT32_MAX - 1)
+            return accessorOutOfMemory;
+        if (accessorPrivateExtendPointerSizeAllocation((void **) &m->entries, &m->entryCount, &m->entryAllocation, m->entryCount + 1, m->entryAllocation > 1024 ? m->entryAllocation : 1024, sizeof(*m->entries)))
+            return accessorOutOfMemory;
+        e = (uint32_t) m->entryCount;
+    }
 
-accessorStatus accessorWriteEndianBytes(accessor_t * a, const void * ptr, size_t count, accessorEndianness e)
-{
-    accessorStatus status;
-    uint8_t * dst;
+    // evict least recently used values, before the new value is linked
+    while (m->lruLast != 0 && (cost > m->maxCost || m->cost > m->maxCost - cost))
+        accessorPrivateMemoRemove(m, m->lruLast);
 
+    // under memory pressure, shrink to half the maximum cost
+    while (m->lruLast != 0 && m->cost > m->maxCost / 2 && accessorPrivateIsUnderPressure())
+    {
+        accessorPrivateMemoRemove(m, m->lruLast);
+        ACCESSOR_ATOMIC_ADD(&accessorPrivateBudgetEvictions, 1);
+    }
 
-    if (!a->writeEnabled)
-        return accessorReadOnlyError;
+    entry = &m->entries[e - 1];
+    entry->offset = rootOffset;
+    entry->size = size;
+    entry->decoderId = decoderId;
+    entry->hash = hash;
+    entry->value = value;
+    entry->cost = cost;
+    entry->destroy = destroy;
+    link = &m->buckets[hash & (m->bucketCount - 1)];
+    entry->hashNext = *link;
+    *link = e;
+    accessorPrivateMemoLruInsertFirst(m, e);
+
+    m->cost += cost;
+    m->valueCount++;
 
-    status = accessorPrivateGetPointerForWrite(&dst, a, count);
-    if (status != accessorOk)
-        return status;
+    return accessorOk;
+}
 
-    memcpy(dst, ptr, count);
 
-    if (accessorPrivateIsReverseEndianness[e])
-        accessorSwapBytes(dst, count);
 
-    return accessorOk;
+void accessorMemoClear(accessorMemo_t * m)
+{
+    while (m->lruLast != 0)
+        accessorPrivateMemoRemove(m, m->lruLast);
 }
 
 
 
-accessorStatus accessorWriteBytes(accessor_t * a, const void * ptr, size_t count)
+accessorStatus accessorIndexAddBlockHashes(accessorIndex_t * x, uint32_t tag, const accessorBlockHashes_t * h)
 {
     accessorStatus status;
-    uint8_t * dst;
+    accessorPrivateIndexBlockHashesHeader header;
 
 
-    if (!a->writeEnabled)
-        return accessorReadOnlyError;
+    status = accessorPrivateIndexBeginSection(x, tag);
+    if (status != accessorOk)
+        return status;
 
-    status = accessorPrivateGetPointerForWrite(&dst, a, count);
+    header.blockSize = h->blockSize;
+    header.size = h->size;
+    header.hashCount = h->hashCount;
+
+    status = accessorWriteBytes(x->accessor, &header, sizeof(header));
+    if (status == accessorOk)
+        status = accessorWriteBytes(x->accessor, h->hashes, h->hashCount * sizeof(*h->hashes));
     if (status != accessorOk)
+    {
+        x->sectionCount--;
         return status;
+    }
 
-    memcpy(dst, ptr, count);
+    accessorPrivateIndexEndSection(x);
 
     return accessorOk;
 }
 
 
 
-accessorStatus accessorWriteRepeatedByte(accessor_t * a, uint8_t byte, size_t count)
+accessorStatus accessorOpenIndexBlockHashes(accessorBlockHashes_t ** h, const accessorIndex_t * x, uint32_t tag)
 {
     accessorStatus status;
-    uint8_t * dst;
+    accessorBlockHashes_t * result;
+    const accessorPrivateIndexBlockHashesHeader * header;
+    const void * ptr;
+    size_t size;
 
 
-    if (!a->writeEnabled)
-        return accessorReadOnlyError;
+    if (*h != ACCESSOR_INIT)
+        return accessorInvalidParameter;
 
-    status = accessorPrivateGetPointerForWrite(&dst, a, count);
+    status = accessorIndexGetSection(x, tag, &ptr, &size);
     if (status != accessorOk)
         return status;
 
-    memset(dst, byte, count);
+    header = (const accessorPrivateIndexBlockHashesHeader *) ptr;
+    if (size < sizeof(*header)
+        || header->blockSize == 0
+        || header->hashCount > (size - sizeof(*header)) / sizeof(uint64_t)
+        || header->hashCount != header->size / header->blockSize + (header->size % header->blockSize != 0))
+        return accessorInvalidReadData;
+
+    result = malloc(sizeof(*result));
+    if (result == NULL)
+        return accessorOutOfMemory;
+
+    result->blockSize = (size_t) header->blockSize;
+    result->size = (size_t) header->size;
+    result->hashCount = (size_t) header->hashCount;
+    result->hashes = malloc(result->hashCount * sizeof(*result->hashes) + 1);     // + 1 as malloc(0) may return NULL
+    if (result->hashes == NULL)
+    {
+        free(result);
+        return accessorOutOfMemory;
+    }
+    memcpy(result->hashes, header + 1, result->hashCount * sizeof(*result->hashes));
+
+    *h = result;
 
     return accessorOk;
 }
 
 
 
-accessorStatus accessorGetPointerForBytesToRead(accessor_t * a, const void ** ptr, size_t count)
+accessorStatus accessorOpenBlockHashes(accessorBlockHashes_t ** h, const accessor_t * a, size_t blockSize)
 {
-    if (a->availableBytes < count)
-        return accessorBeyondEnd;
+    accessorBlockHashes_t * result;
+    const uint8_t * data;
+    size_t size;
 
-    *ptr = a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor;
 
-    accessorPrivateOpenCoverage(a);
+    if (*h != ACCESSOR_INIT)
+        return accessorInvalidParameter;
 
-    a->cursor += count;
-    a->availableBytes -= count;
+    if (blockSize == 0 || a->baseAccessor->isNull)
+        return accessorInvalidParameter;
+
+    result = malloc(sizeof(*result));
+    if (result == NULL)
+        return accessorOutOfMemory;
+
+    result->blockSize = blockSize;
+    result->size = a->windowSize;
+    result->hashCount = a->windowSize / blockSize + (a->windowSize % blockSize != 0);
+    result->hashes = malloc(result->hashCount * sizeof(*result->hashes) + 1);     // + 1 as malloc(0) may return NULL
+    if (result->hashes == NULL)
+    {
+        free(result);
+        return accessorOutOfMemory;
+    }
+
+    data = a->baseAccessor->data + a->baseAccessorWindowOffset;
+    for (size_t i = 0; i < result->hashCount; i++)
+    {
+        size = a->windowSize - i * blockSize;
+        if (size > blockSize)
+            size = blockSize;
+        result->hashes[i] = accessorPrivateHashBytes(data + i * blockSize, size, 0);
+    }
 
-    accessorPrivateCloseCoverage(a);
+    *h = result;
 
     return accessorOk;
 }
 
 
 
-accessorStatus accessorGetPointerForBytesToWrite(accessor_t * a, void ** ptr, size_t count)
+accessorStatus accessorCloseBlockHashes(accessorBlockHashes_t ** h)
 {
-    accessorStatus status;
-
+    if (*h == ACCESSOR_INIT)
+        return accessorInvalidParameter;
 
-    if (!a->writeEnabled)
-        return accessorReadOnlyError;
+    free((*h)->hashes);
 
-    status = accessorPrivateGetPointerForWrite((uint8_t **) ptr, a, count);
-    if (status != accessorOk)
-        return status;
+    free(*h);
+    *h = ACCESSOR_INIT;
 
     return accessorOk;
 }
 
 
 
-accessorStatus accessorReadCString(accessor_t * a, char ** str, size_t * length)
+accessorStatus accessorCompareBlockHashes(const accessorBlockHashes_t * previous, const accessorBlockHashes_t * current, accessorRange ** ranges, size_t * rangeCount)
 {
-    size_t stringLength;
-    size_t availableBytes;
-    uint8_t * ptr;
-    char * result;
+    accessorRange * result;
+    size_t count;
+    size_t allocation;
+    size_t commonCount;
+    size_t commonSize;
+    size_t offset;
 
 
-    ptr = a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor;
-    availableBytes = a->availableBytes;
-    stringLength = 0;
+    if (previous->blockSize != current->blockSize)
+        return accessorInvalidParameter;
 
-    while (availableBytes >= sizeof(**str) && ptr[stringLength])
-    {
-        stringLength++;
-        availableBytes--;
-    }
-    if (a->availableBytes < (stringLength + 1) * sizeof(**str))
-        return accessorBeyondEnd;
+    result = NULL;
+    count = 0;
+    allocation = 0;
 
-    result = malloc(stringLength + 1);
-    if (result == NULL)
-        return accessorOutOfMemory;
+    // blocks are compared up to the shorter version's last full block, anything beyond is changed
+    commonSize = previous->size < current->size ? previous->size : current->size;
+    commonCount = commonSize / current->blockSize;
+    if (previous->size == current->size)
+        commonCount = current->hashCount;
 
-    memcpy(result, ptr, stringLength + 1);
+    for (size_t i = 0; i <= commonCount; i++)
+    {
+        if (i < commonCount && previous->hashes[i] == current->hashes[i])
+            continue;
 
-    accessorPrivateOpenCoverage(a);
+        offset = i * current->blockSize;
+        if (offset >= current->size && offset >= previous->size)
+            break;
 
-    a->cursor += stringLength + 1;
-    a->availableBytes -= stringLength + 1;
+        if (count > 0 && result[count - 1].offset + result[count - 1].size == offset)
+            result[count - 1].size += current->blockSize;
+        else
+        {
+            if (accessorPrivateExtendPointerSizeAllocation((void **) &result, &count, &allocation, count + 1, 256, sizeof(*result)))
+            {
+                accessorPrivateRelease(result, allocation * sizeof(*result));
+                return accessorOutOfMemory;
+            }
+            result[count - 1].offset = offset;
+            result[count - 1].size = current->blockSize;
+        }
 
-    accessorPrivateCloseCoverage(a);
+        // beyond the common part, a single range extends to the longer version's end
+        if (i == commonCount)
+            result[count - 1].size = (previous->size > current->size ? previous->size : current->size) - result[count - 1].offset;
+    }
 
-    *str = result;
+    // the last block may be shorter
+    if (count > 0 && result[count - 1].offset + result[count - 1].size > (previous->size > current->size ? previous->size : current->size))
+        result[count - 1].size = (previous->size > current->size ? previous->size : current->size) - result[count - 1].offset;
 
-    if (length != NULL)
-        *length = stringLength;
+    accessorPrivateDischarge(allocation * sizeof(*result));     // ranges belong to caller
+    *ranges = result;
+    *rangeCount = count;
 
     return accessorOk;
 }
 
 
 
-accessorStatus accessorReadPString(accessor_t * a, char ** str, size_t * length)
+static int accessorPrivateRangesOverlap(const accessorRange * ranges, size_t rangeCount, uint64_t offset, uint64_t size)
 {
-    uint8_t stringLength;
-    size_t availableBytes;
-    uint8_t * ptr;
-    char * result;
+    size_t low;
+    size_t high;
+    size_t middle;
 
 
-    availableBytes = a->availableBytes;
+    if (size == 0)
+        size = 1;
 
-    if (availableBytes < 1)
-        return accessorBeyondEnd;
+    // find first range ending after offset
+    low = 0;
+    high = rangeCount;
+    while (low < high)
+    {
+        middle = low + (high - low) / 2;
+        if ((uint64_t) ranges[middle].offset + ranges[middle].size <= offset)
+            low = middle + 1;
+        else
+            high = middle;
+    }
 
-    ptr = a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor;
-    stringLength = *ptr++;
+    return low < rangeCount && ranges[low].offset < offset + size;
+}
 
-    if (a->availableBytes < (stringLength + 1) * sizeof(**str))
-        return accessorBeyondEnd;
 
-    result = malloc((stringLength + 1) * sizeof(**str));
-    if (result == NULL)
-        return accessorOutOfMemory;
 
-    memcpy(result, ptr, stringLength);
-    result[stringLength] = 0;
+accessorStatus accessorMemoUpdate(accessorMemo_t * m, accessor_t * newStream, const accessorRange * ranges, size_t rangeCount)
+{
+    accessorStatus status;
+    accessor_t * oldStream;
+    accessorPrivateMemoEntry * entry;
+    uint64_t bucket;
 
-    *str = result;
 
-    accessorPrivateOpenCoverage(a);
+    if (newStream->writeEnabled)
+        return accessorInvalidParameter;
 
-    a->cursor += stringLength + 1;
-    a->availableBytes -= stringLength + 1;
+    // entry offsets are made relative to streams' windows, using unsigned modular arithmetic
+    oldStream = m->accessor;
+    for (size_t i = 0; i < m->entryCount; i++)
+    {
+        entry = &m->entries[i];
+        if (entry->value != NULL && accessorPrivateRangesOverlap(ranges, rangeCount, entry->offset - oldStream->baseAccessorWindowOffset, entry->size))
+            accessorPrivateMemoRemove(m, (uint32_t) (i + 1));
+    }
 
-    accessorPrivateCloseCoverage(a);
+    memset(m->buckets, 0, m->bucketCount * sizeof(*m->buckets));
+    for (size_t i = 0; i < m->entryCount; i++)
+    {
+        entry = &m->entries[i];
+        if (entry->value != NULL)
+        {
+            entry->offset = entry->offset - oldStream->baseAccessorWindowOffset + newStream->baseAccessorWindowOffset;
+            entry->hash = accessorPrivateMemoHash(entry->offset, entry->decoderId);
+            bucket = entry->hash & (m->bucketCount - 1);
+            entry->hashNext = m->buckets[bucket];
+            m->buckets[bucket] = (uint32_t) (i + 1);
+        }
+    }
 
-    if (length != NULL)
-        *length = stringLength;
+    newStream->referenceCount++;
+    m->accessor = newStream;
+
+    status = accessorClose(&oldStream);
+    if (status != accessorOk)
+        return status;
 
     return accessorOk;
 }
 
 
 
-accessorStatus accessorReadFixedLengthString(accessor_t * a, char ** str, size_t length)
+accessorStatus accessorRecordIndexUpdate(accessorRecordIndex_t * r, accessor_t * newStream, const accessorRange * ranges, size_t rangeCount)
 {
-    char * result;
-
+    accessorStatus status;
+    accessor_t * record;
+    size_t firstChange;
+    size_t checkpoint;
 
-    if (a->availableBytes < length)
-        return accessorBeyondEnd;
 
-    result = malloc((length + 1) * sizeof(**str));
-    if (result == NULL)
-        return accessorOutOfMemory;
+    if (newStream->writeEnabled)
+        return accessorInvalidParameter;
 
-    memcpy(result, a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor, length);
-    result[length] = 0;
+    record = ACCESSOR_INIT;
+    status = accessorOpenReadingAccessorWindow(&record, newStream, 0, ACCESSOR_UNTIL_END);
+    if (status != accessorOk)
+        return status;
 
-    *str = result;
+    // records parsed before the first change are unchanged, restart parsing from the last checkpoint before it
+    firstChange = rangeCount > 0 ? ranges[0].offset : SIZE_MAX;
+    if (r->parsedOffset > firstChange)
+    {
+        checkpoint = r->checkpointCount - 1;
+        while (r->checkpoints[checkpoint] > firstChange)
+            checkpoint--;
 
-    accessorPrivateOpenCoverage(a);
+        r->checkpointCount = checkpoint + 1;
+        r->parsedCount = checkpoint * r->interval;
+        r->parsedOffset = r->checkpoints[checkpoint];
+    }
 
-    a->cursor += length;
-    a->availableBytes -= length;
+    accessorClose(&r->record);
+    r->record = record;
 
-    accessorPrivateCloseCoverage(a);
+    newStream->referenceCount++;
+    status = accessorClose(&r->accessor);
+    r->accessor = newStream;
 
-    return accessorOk;
+    return status;
 }
 
 
 
-accessorStatus accessorReadPaddedString(accessor_t * a, char ** str, size_t * length, char pad)
+accessorStatus accessorReserveEndianSlot(accessor_t * a, size_t * slot, accessorEndianness e, size_t nbytes)
 {
-    char * result;
-    size_t stringLength;
+    accessorStatus status;
+    accessorPrivateSlot * s;
+    size_t offset;
 
 
-    stringLength = *length;
+    if (!a->writeEnabled)
+        return accessorReadOnlyError;
 
-    if (a->availableBytes < stringLength)
-        return accessorBeyondEnd;
+    if (nbytes < 1 || nbytes > sizeof(uintmax_t))
+        return accessorInvalidParameter;
 
-    result = malloc((stringLength + 1) * sizeof(**str));
-    if (result == NULL)
+    // extend slots first: a failed reserve writes nothing
+    if (accessorPrivateExtendPointerSizeAllocation((void **) &a->slots, &a->slotCount, &a->slotAllocation, a->slotCount + 1, 64, sizeof(*a->slots)))
         return accessorOutOfMemory;
 
-    memcpy(result, a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor, stringLength);
-    result[stringLength] = 0;
-
-    accessorPrivateOpenCoverage(a);
-
-    a->cursor += stringLength;
-    a->availableBytes -= stringLength;
+    offset = a->cursor;
+    status = accessorWriteRepeatedByte(a, 0x00, nbytes);
+    if (status != accessorOk)
+    {
+        a->slotCount--;
+        return status;
+    }
 
-    accessorPrivateCloseCoverage(a);
+    s = &a->slots[a->slotCount - 1];
+    s->offset = offset;
+    s->value = 0;
+    s->endianness = e;
+    s->nbytes = (uint8_t) nbytes;
+    s->hasValue = 0;
 
-    while (stringLength && result[stringLength - 1] == pad)
-        stringLength--;
+    *slot = a->slotCount - 1;
 
-    result[stringLength] = 0;
+    return accessorOk;
+}
 
-    *str = result;
 
-    if (length != NULL)
-        *length = stringLength;
 
-    return accessorOk;
+accessorStatus accessorReserveSlot(accessor_t * a, size_t * slot, size_t nbytes)
+{
+    return accessorReserveEndianSlot(a, slot, a->endianness, nbytes);
 }
 
 
 
-accessorStatus accessorReadEndianString16(accessor_t * a, uint16_t ** str, size_t * length, accessorEndianness e)
+accessorStatus accessorSetSlotValue(accessor_t * a, size_t slot, uintmax_t x)
 {
-    size_t stringLength;
-    size_t availableBytes;
-    uint8_t * ptr;
-    uint16_t * result;
+    accessorPrivateSlot * s;
 
 
-    ptr = a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor;
-    availableBytes = a->availableBytes;
-    stringLength = 0;
+    if (slot >= a->slotCount)
+        return accessorInvalidParameter;
 
-    while (availableBytes >= sizeof(**str) && accessorPrivateReadUInt16AtPointer(ptr, e))
-    {
-        availableBytes -= sizeof(**str);
-        ptr += sizeof(**str);
-        stringLength++;
-    }
-    if (a->availableBytes < (stringLength + 1) * sizeof(**str))
-        return accessorBeyondEnd;
+    s = &a->slots[slot];
+    if (s->nbytes < sizeof(uintmax_t) && (x >> (CHAR_BIT * s->nbytes)) != 0)
+        return accessorInvalidParameter;
 
-    result = malloc((stringLength + 1) * sizeof(**str));
-    if (result == NULL)
-        return accessorOutOfMemory;
+    s->value = x;
+    s->hasValue = 1;
 
-    memcpy(result, a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor, stringLength * sizeof(**str));
-    result[stringLength] = 0;
+    return accessorOk;
+}
 
-    if (accessorPrivateIsReverseEndianness[e])
-    {
-        for (size_t i = 0; i < stringLength; i++)
-            result[i] = accessorSwapUInt16(result[i]);
-    }
 
-    *str = result;
 
-    if (length != NULL)
-        *length = stringLength;
+accessorStatus accessorSetSlotToCursor(accessor_t * a, size_t slot)
+{
+    return accessorSetSlotValue(a, slot, a->cursor);
+}
 
-    accessorPrivateOpenCoverage(a);
 
-    a->cursor += (stringLength + 1) * sizeof(**str);
-    a->availableBytes -= (stringLength + 1) * sizeof(**str);
 
-    accessorPrivateCloseCoverage(a);
+accessorStatus accessorSetSlotToLengthSince(accessor_t * a, size_t slot, size_t offset)
+{
+    if (offset > a->cursor)
+        return accessorInvalidParameter;
 
-    return accessorOk;
+    return accessorSetSlotValue(a, slot, a->cursor - offset);
 }
 
 
 
-accessorStatus accessorReadEndianString32(accessor_t * a, uint32_t ** str, size_t * length, accessorEndianness e)
+static accessorStatus accessorPrivateResolveSlots(const accessor_t * a)
 {
-    size_t stringLength;
-    size_t availableBytes;
-    uint8_t * ptr;
-    uint32_t * result;
+    const accessorPrivateSlot * s;
+    uint8_t * data;
 
 
-    ptr = a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor;
-    availableBytes = a->availableBytes;
-    stringLength = 0;
-
-    while (availableBytes >= sizeof(**str) && accessorPrivateReadUInt32AtPointer(ptr, e))
+    for (size_t i = 0; i < a->slotCount; i++)
     {
-        ptr += sizeof(**str);
-        stringLength++;
-        availableBytes -= sizeof(**str);
+        s = &a->slots[i];
+        if (!s->hasValue)
+            return accessorInvalidParameter;
+        if (s->offset + s->nbytes > a->windowSize)
+            return accessorBeyondEnd;
     }
-    if (a->availableBytes < (stringLength + 1) * sizeof(**str))
-        return accessorBeyondEnd;
-
-    result = malloc((stringLength + 1) * sizeof(**str));
-    if (result == NULL)
-        return accessorOutOfMemory;
 
-    memcpy(result, a->baseAccessor->data + a->baseAccessorWindowOffset + a->cursor, stringLength * sizeof(**str));
-    result[stringLength] = 0;
+    if (a->baseAccessor->isNull)
+        return accessorOk;
 
-    if (accessorPrivateIsReverseEndianness[e])
+    data = a->baseAccessor->data + a->baseAccessorWindowOffset;
+    for (size_t i = 0; i < a->slotCount; i++)
     {
-        for (size_t i = 0; i < stringLength; i++)
-            result[i] = accessorSwapUInt32(result[i]);
+        s = &a->slots[i];
+        accessorPrivateWriteUIntAtPointer(data + s->offset, s->value, s->endianness, s->nbytes);
     }
 
-    *str = result;
-
-    if (length != NULL)
-        *length = stringLength;
+    return accessorOk;
+}
 
-    accessorPrivateOpenCoverage(a);
 
-    a->cursor += (stringLength + 1) * sizeof(**str);
-    a->availableBytes -= (stringLength + 1) * sizeof(**str);
 
-    accessorPrivateCloseCoverage(a);
+accessorStatus accessorResolveSlots(accessor_t * a)
+{
+    if (!a->writeEnabled)
+        return accessorReadOnlyError;
 
-    return accessorOk;
+    return accessorPrivateResolveSlots(a);
 }
 
 
 
-accessorStatus accessorReadString16(accessor_t * a, uint16_t ** str, size_t * length)
+accessorStatus accessorReset(accessor_t * a)
 {
-    return accessorReadEndianString16(a, str, length, a->endianness);
-}
+    if (!a->writeEnabled)
+        return accessorReadOnlyError;
 
+    if (a->referenceCount > 0)
+        return accessorInvalidParameter;
 
+    a->windowSize = 0;
+    a->cursor = 0;
+    a->availableBytes = 0;
+    a->cursorStackSize = 0;
+    a->coverageSuspendCount = 0;
+    a->coverageArraySize = 0;
+    a->slotCount = 0;
 
-accessorStatus accessorReadString32(accessor_t * a, uint32_t ** str, size_t * length)
-{
-    return accessorReadEndianString32(a, str, length, a->endianness);
+    return accessorOk;
 }
 
 
 
-accessorStatus accessorWriteCStringWithLength(accessor_t * a, const char * str, size_t length)
+accessorStatus accessorOpenPool(accessorPool_t ** p, size_t maxCount, size_t initialAllocation, size_t granularity)
 {
-    accessorStatus status;
-    uint8_t * ptr;
+    accessorPool_t * result;
 
 
-    if (!a->writeEnabled)
-        return accessorReadOnlyError;
+    if (*p != ACCESSOR_INIT)
+        return accessorInvalidParameter;
 
-    status = accessorPrivateGetPointerForWrite(&ptr, a, length + 1);
-    if (status != accessorOk)
-        return status;
+    result = malloc(sizeof(*result));
+    if (result == NULL)
+        return accessorOutOfMemory;
 
-    memcpy(ptr, str, length);
-    ptr[length] = 0;            // str doesn't have to be NUL terminated
+    result->accessors = malloc(maxCount * sizeof(*result->accessors) + 1);     // + 1 as malloc(0) may return NULL
+    if (result->accessors == NULL)
+    {
+        free(result);
+        return accessorOutOfMemory;
+    }
+
+    result->count = 0;
+    result->maxCount = maxCount;
+    result->initialAllocation = initialAllocation;
+    result->granularity = granularity;
+
+    *p = result;
 
     return accessorOk;
 }
 
 
 
-
-accessorStatus accessorWritePStringWithLength(accessor_t * a, const char * str, size_t length)
+accessorStatus accessorClosePool(accessorPool_t ** p)
 {
     accessorStatus status;
-    uint8_t * ptr;
-
 
-    if (!a->writeEnabled)
-        return accessorReadOnlyError;
 
-    if (length > UINT8_MAX)
+    if (*p == ACCESSOR_INIT)
         return accessorInvalidParameter;
 
-    status = accessorPrivateGetPointerForWrite(&ptr, a, length + 1);
-    if (status != accessorOk)
-        return status;
+    while ((*p)->count > 0)
+    {
+        status = accessorClose(&(*p)->accessors[(*p)->count - 1]);
+        if (status != accessorOk)
+            return status;
+        (*p)->count--;
+    }
 
-    *ptr++ = (uint8_t) length;
-    memcpy(ptr, str, length);
+    free((*p)->accessors);
+
+    free(*p);
+    *p = ACCESSOR_INIT;
 
     return accessorOk;
 }
 
 
 
-
-accessorStatus accessorWritePaddedStringWithLength(accessor_t * a, const char * str, size_t length, size_t paddedLength, char pad)
+accessorStatus accessorPoolAcquire(accessorPool_t * p, accessor_t ** a)
 {
-    accessorStatus status;
-    uint8_t * ptr;
-
-
-    if (!a->writeEnabled)
-        return accessorReadOnlyError;
-
-    if (length > paddedLength)
+    if (*a != ACCESSOR_INIT)
         return accessorInvalidParameter;
 
-    status = accessorPrivateGetPointerForWrite(&ptr, a, paddedLength);
-    if (status != accessorOk)
-        return status;
+    if (p->count == 0)
+        return accessorOpenWritingMemory(a, p->initialAllocation, p->granularity);
 
-    memcpy(ptr, str, length);
-    if (length < paddedLength)
-        memset(ptr + length, pad, paddedLength - length);
+    *a = p->accessors[--p->count];
 
     return accessorOk;
 }
 
 
 
-
-accessorStatus accessorWriteEndianString16WithLength(accessor_t * a, const uint16_t * str, size_t length, accessorEndianness e)
+accessorStatus accessorPoolRelease(accessorPool_t * p, accessor_t ** a)
 {
-    accessorStatus status;
-    uint8_t * ptr;
+    accessor_t * released;
 
 
-    if (!a->writeEnabled)
-        return accessorReadOnlyError;
-
-    status = accessorPrivateGetPointerForWrite(&ptr, a, (length + 1) * 2);
-    if (status != accessorOk)
-        return status;
+    if (*a == ACCESSOR_INIT)
+        return accessorInvalidParameter;
 
-    memcpy(ptr, str, (length + 1) * 2);
-    if (accessorPrivateIsReverseEndianness[e])
+    // under memory pressure, idle accessors are closed and released ones aren't kept
+    if (accessorPrivateIsUnderPressure())
     {
-        for (size_t i = 0; i < length; i++)
+        while (p->count > 0)
         {
-            accessorPrivateWriteUInt16AtPointer(ptr, accessorPrivateReadUInt16AtPointer(ptr, accessorBig), accessorLittle);
-            ptr += 2;
+            accessorClose(&p->accessors[--p->count]);
+            ACCESSOR_ATOMIC_ADD(&accessorPrivateBudgetEvictions, 1);
         }
+        ACCESSOR_ATOMIC_ADD(&accessorPrivateBudgetEvictions, 1);
+        return accessorClose(a);
     }
 
+    released = *a;
+    if (p->count >= p->maxCount || !released->writeEnabled || !released->mayBeReallocated || released->isNull || released->sharedFileDescriptor != -1 || released->writeOnClose || released->referenceCount > 0)
+        return accessorClose(a);
+
+    accessorReset(released);
+
+    // make it as if just opened
+    released->endianness = accessorPrivateDefaultEndianness;
+    released->coverageEnabled = 0;
+    released->coverageUsage1 = 0;
+    released->coverageUsage2 = NULL;
+
+    p->accessors[p->count++] = released;
+    *a = ACCESSOR_INIT;
+
     return accessorOk;
 }
 
 
 
-
-accessorStatus accessorWriteEndianString32WithLength(accessor_t * a, const uint32_t * str, size_t length, accessorEndianness e)
+accessorStatus accessorOpenPackPlan(accessorPackPlan_t ** p, const accessorPackField * fields, size_t fieldCount, size_t structSize)
 {
-    accessorStatus status;
-    uint8_t * ptr;
+    accessorPackPlan_t * result;
+    const accessorPackField * f;
+    accessorPrivatePackOp * op;
+    accessorPrivatePackKind kind;
+    size_t structOffset;
 
 
-    if (!a->writeEnabled)
-        return accessorReadOnlyError;
+    if (*p != ACCESSOR_INIT)
+        return accessorInvalidParameter;
 
-    status = accessorPrivateGetPointerForWrite(&ptr, a, (length + 1) * 4);
-    if (status != accessorOk)
-        return status;
+    accessorPrivateInitializeEndianness();                      // required to set up accessorPrivateIsReverseEndianness
 
-    memcpy(ptr, str, (length + 1) * 4);
-    if (accessorPrivateIsReverseEndianness[e])
+    for (size_t i = 0; i < fieldCount; i++)
     {
-        for (size_t i = 0; i < length; i++)
+        f = &fields[i];
+        if (f->memberSize != 1 && f->memberSize != 2 && f->memberSize != 4 && f->memberSize != 8)
+            return accessorInvalidParameter;
+        if (f->nbytes < 1 || f->nbytes > f->memberSize)
+            return accessorInvalidParameter;
+        if (f->structOffset > structSize || f->memberSize > structSize - f->structOffset)
+            return accessorInvalidParameter;
+    }
+
+    result = malloc(sizeof(*result));
+    if (result == NULL)
+        return accessorOutOfMemory;
+
+    result->ops = malloc(fieldCount * sizeof(*result->ops) + 1);     // + 1 as malloc(0) may return NULL
+    if (result->ops == NULL)
+    {
+        free(result);
+        return accessorOutOfMemory;
+    }
+
+    result->opCount = 0;
+    result->structSize = structSize;
+    result->packedSize = 0;
+    result->isStructLayout = 1;
+    result->swapSize = 0;
+
+    for (size_t i = 0; i < fieldCount; i++)
+    {
+        f = &fields[i];
+        structOffset = f->structOffset;
+
+        if (f->nbytes == 1 || !accessorPrivateIsReverseEndianness[f->endianness])
         {
-            accessorPrivateWriteUInt32AtPointer(ptr, accessorPrivateReadUInt32AtPointer(ptr, accessorBig), accessorLittle);
-            ptr += 4;
+            kind = accessorPrivatePackCopy;
+            if (accessorPrivateNativeEndianness == accessorBig)
+                structOffset += f->memberSize - f->nbytes;      // least significant bytes are the last ones
+        }
+        else if (f->nbytes < f->memberSize)
+            kind = accessorPrivatePackUInt;
+        else if (f->nbytes == 2)
+            kind = accessorPrivatePackSwap16;
+        else if (f->nbytes == 4)
+            kind = accessorPrivatePackSwap32;
+        else
+            kind = accessorPrivatePackSwap64;
+
+        if (structOffset != result->packedSize || f->nbytes != f->memberSize)
+            result->isStructLayout = 0;
+        if (kind != accessorPrivatePackCopy && result->isStructLayout)
+        {
+            if (result->swapSize == 0)
+                result->swapSize = f->nbytes;
+            else if (result->swapSize != f->nbytes)
+                result->isStructLayout = 0;
+        }
+        result->packedSize += f->nbytes;
+
+        // extend previous copy run if adjacent
+        if (result->opCount > 0 && kind == accessorPrivatePackCopy)
+        {
+            op = &result->ops[result->opCount - 1];
+            if (op->kind == accessorPrivatePackCopy && op->structOffset + op->size == structOffset)
+            {
+                op->size += f->nbytes;
+                continue;
+            }
         }
+
+        op = &result->ops[result->opCount++];
+        op->kind = kind;
+        op->structOffset = structOffset;
+        op->memberSize = f->memberSize;
+        op->size = f->nbytes;
+        op->endianness = f->endianness;
     }
 
+    // struct layout also requires members to be either all swapped or none, and no trailing padding
+    if (result->packedSize != structSize)
+        result->isStructLayout = 0;
+    if (result->swapSize != 0)
+        for (size_t i = 0; i < result->opCount; i++)
+            if (result->ops[i].kind == accessorPrivatePackCopy)
+                result->isStructLayout = 0;
+
+    *p = result;
+
     return accessorOk;
 }
 
 
 
-
-accessorStatus accessorWriteString16WithLength(accessor_t * a, const uint16_t * str, size_t length)
+accessorStatus accessorClosePackPlan(accessorPackPlan_t ** p)
 {
-    return accessorWriteEndianString16WithLength(a, str, length, a->endianness);
-}
-
+    if (*p == ACCESSOR_INIT)
+        return accessorInvalidParameter;
 
+    free((*p)->ops);
 
+    free(*p);
+    *p = ACCESSOR_INIT;
 
-accessorStatus accessorWriteString32WithLength(accessor_t * a, const uint32_t * str, size_t length)
-{
-    return accessorWriteEndianString32WithLength(a, str, length, a->endianness);
+    return accessorOk;
 }
 
 
 
+size_t accessorPackPlanSize(const accessorPackPlan_t * p)
+{
+    return p->packedSize;
+}
 
 
-accessorStatus accessorWriteCString(accessor_t * a, const char * str)
+
+accessorStatus accessorWritePacked(accessor_t * a, const accessorPackPlan_t * p, const void * structs, size_t count)
 {
-    return accessorWriteCStringWithLength(a, str, strlen(str));
-}
+    accessorStatus status;
+    const uint8_t * src;
+    const accessorPrivatePackOp * op;
+    uint8_t * dst;
+    uint16_t x16;
+    uint32_t x32;
+    uint64_t x64;
 
 
+    if (!a->writeEnabled)
+        return accessorReadOnlyError;
 
+    if (p->packedSize != 0 && count > SIZE_MAX / p->packedSize)
+        return accessorBeyondEnd;
 
-accessorStatus accessorWritePString(accessor_t * a, const char * str)
-{
-    return accessorWritePStringWithLength(a, str, strlen(str));
-}
+    status = accessorPrivateGetPointerForWrite(&dst, a, count * p->packedSize, accessorApiWriteBytes);
+    if (status != accessorOk)
+        return status;
 
+    if (dst == NULL)                    // null accessor
+        return accessorOk;
 
+    if (p->isStructLayout)
+    {
+        memcpy(dst, structs, count * p->packedSize);
+        if (p->swapSize != 0)
+            accessorPrivateSwapRun(dst, count * p->packedSize / p->swapSize, p->swapSize);
+        return accessorOk;
+    }
 
+    src = (const uint8_t *) structs;
+    for (size_t i = 0; i < count; i++)
+    {
+        for (size_t j = 0; j < p->opCount; j++)
+        {
+            op = &p->ops[j];
+            switch (op->kind)
+            {
+            case accessorPrivatePackCopy:
+                memcpy(dst, src + op->structOffset, op->size);
+                break;
+
+            case accessorPrivatePackSwap16:
+                memcpy(&x16, src + op->structOffset, 2);
+                x16 = accessorSwapUInt16(x16);
+                memcpy(dst, &x16, 2);
+                break;
+
+            case accessorPrivatePackSwap32:
+                memcpy(&x32, src + op->structOffset, 4);
+                x32 = accessorSwapUInt32(x32);
+                memcpy(dst, &x32, 4);
+                break;
+
+            case accessorPrivatePackSwap64:
+                memcpy(&x64, src + op->structOffset, 8);
+                x64 = accessorSwapUInt64(x64);
+                memcpy(dst, &x64, 8);
+                break;
+
+            case accessorPrivatePackUInt:
+                accessorPrivateWriteUIntAtPointer(dst, accessorPrivateReadUIntAtPointer(src + op->structOffset, accessorNative, op->memberSize), op->endianness, op->size);
+                break;
+            }
+            dst += op->size;
+        }
+        src += p->structSize;
+    }
 
-accessorStatus accessorWritePaddedString(accessor_t * a, const char * str, size_t paddedLength, char pad)
-{
-    return accessorWritePaddedStringWithLength(a, str, strlen(str), paddedLength, pad);
+    return accessorOk;
 }
 
 
 
-
-accessorStatus accessorWriteEndianString16(accessor_t * a, const uint16_t * str, accessorEndianness e)
+static void accessorPrivateSwapRun(uint8_t * ptr, size_t count, size_t size)
 {
-    size_t stringLength;
+    uint16_t x16;
+    uint32_t x32;
+    uint64_t x64;
 
 
-    stringLength = 0;
-    while (str[stringLength])
-        stringLength++;
+    // separate loops with fixed size accesses, so that compilers may vectorize them
+    switch (size)
+    {
+    case 2:
+        for (size_t i = 0; i < count; i++)
+        {
+            memcpy(&x16, ptr + i * 2, 2);
+            x16 = accessorSwapUInt16(x16);
+            memcpy(ptr + i * 2, &x16, 2);
+        }
+        break;
 
-    return accessorWriteEndianString16WithLength(a, str, stringLength, e);
-}
+    case 4:
+        for (size_t i = 0; i < count; i++)
+        {
+            memcpy(&x32, ptr + i * 4, 4);
+            x32 = accessorSwapUInt32(x32);
+            memcpy(ptr + i * 4, &x32, 4);
+        }
+        break;
 
+    case 8:
+        for (size_t i = 0; i < count; i++)
+        {
+            memcpy(&x64, ptr + i * 8, 8);
+            x64 = accessorSwapUInt64(x64);
+            memcpy(ptr + i * 8, &x64, 8);
+        }
+        break;
+    }
+}
 
 
 
-accessorStatus accessorWriteEndianString32(accessor_t * a, const uint32_t * str, accessorEndianness e)
+accessorStatus accessorOpenWriteSpan(accessor_t * a, accessorWriteSpan * span, size_t count)
 {
-    size_t stringLength;
+    accessorStatus status;
+    size_t previousSize;
+    void * ptr;
 
 
-    stringLength = 0;
-    while (str[stringLength])
-        stringLength++;
+    previousSize = a->windowSize;
+    status = accessorGetPointerForBytesToWrite(a, &ptr, count);
+    if (status != accessorOk)
+        return status;
 
-    return accessorWriteEndianString32WithLength(a, str, stringLength, e);
-}
+    span->ptr = (uint8_t *) ptr;
+    span->end = (uint8_t *) ptr + count;
+    span->previousSize = previousSize;
 
+    return accessorOk;
+}
 
 
 
-accessorStatus accessorWriteString16(accessor_t * a, const uint16_t * str)
+accessorStatus accessorCloseWriteSpan(accessor_t * a, accessorWriteSpan * span)
 {
-    return accessorWriteEndianString16(a, str, a->endianness);
-}
-
+    if (span->ptr == NULL)
+        return accessorInvalidParameter;
 
+    ACCESSOR_STATS_ADD(a, bytesWritten, 0 - (uint64_t) (span->end - span->ptr));     // unused reserved bytes weren't written
+    a->cursor -= (size_t) (span->end - span->ptr);
+    if (a->windowSize > span->previousSize)
+        a->windowSize = a->cursor > span->previousSize ? a->cursor : span->previousSize;
+    if (!a->isNull)                     // null accessors never have available bytes
+        a->availableBytes = a->windowSize - a->cursor;
 
+    span->ptr = NULL;
+    span->end = NULL;
 
-accessorStatus accessorWriteString32(accessor_t * a, const uint32_t * str)
-{
-    return accessorWriteEndianString32(a, str, a->endianness);
+    return accessorOk;
 }
 
 
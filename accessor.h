@@ -40,10 +40,31 @@ extern "C" {
 
 
 
-#define ACCESSOR_BUILD_NUMBER   104
+#define ACCESSOR_BUILD_NUMBER   125
 // Version history:
 //
 //  Build   Date            Comment
+//  125     18-OCT-2026     added accessorBuildPathInBuffer. file functions build paths in a stack buffer, long paths only are allocated
+//  124     18-OCT-2026     sub-accessors reference their base accessor directly: closing takes constant time whatever the nesting depth, super-accessors may be closed first
+//  123     18-OCT-2026     added checkpoints of accessor trees parse state (accessorWriteCheckpoint, accessorReadCheckpoint)
+//  122     18-OCT-2026     added shared memory write accessors (accessorOpenWritingShared), descriptor export and import
+//  121     18-OCT-2026     added a process-wide memory budget (accessorSetMemoryBudget). coverage allocation failures return accessorOutOfMemory instead of exiting
+//  120     18-OCT-2026     added page residency (accessorGetResidency) and fault counts (accessorFaultCount)
+//  119     18-OCT-2026     added access traces (accessorTrace_t), recorded with ACCESSOR_TRACING
+//  118     18-OCT-2026     added USDT probes, compiled in with ACCESSOR_PROBES
+//  117     18-OCT-2026     added statistics (accessorGetStats), compiled in with ACCESSOR_STATISTICS
+//  116     18-OCT-2026     added accessorSetMmapMinFileSize
+//  115     18-OCT-2026     added write spans (accessorOpenWriteSpan) and their inline writers
+//  114     18-OCT-2026     added pack plans (accessorPackPlan_t) and accessorWritePacked
+//  113     18-OCT-2026     added accessorReset and write accessor pools (accessorPool_t)
+//  112     18-OCT-2026     added null write accessors (accessorOpenWritingNull). large initialAllocation values are honored
+//  111     18-OCT-2026     added slots for deferred fields (accessorReserveSlot)
+//  110     18-OCT-2026     added block hashes (accessorBlockHashes_t) and changed ranges invalidation. accessorMemoAdd() takes the decoded structure's size
+//  109     18-OCT-2026     added memo tables (accessorMemo_t)
+//  108     18-OCT-2026     added record indexes (accessorRecordIndex_t)
+//  107     18-OCT-2026     added index files (accessorIndex_t)
+//  106     18-OCT-2026     added catalogs (accessorCatalog_t) and accessorNotFound status
+//  105     18-OCT-2026     added accessorApplyRelocations
 //  104     06-NOV-2022     corrected crash on munmap()
 //  103     05-NOV-2022     optimized accessorSwap[U]Int for common number width
 //  102     03-NOV-2022     stop using mktemp. when reading or mapping a file, only the window (possibly rounded to page boundary) is read or mapped
@@ -63,6 +84,38 @@ extern "C" {
 // accessor variables are of type "accessor_t *" and their initial value has to be set to ACCESSOR_INIT
 typedef struct _accessor_t accessor_t;
 
+// accessorCatalog_t is an opaque structure mapping names to (offset, size) in a readonly accessor
+// catalog variables are of type "accessorCatalog_t *" and their initial value has to be set to ACCESSOR_INIT
+typedef struct _accessorCatalog_t accessorCatalog_t;
+
+// accessorIndex_t is an opaque structure holding an index file's content, see accessorOpenWritingIndex()
+// index variables are of type "accessorIndex_t *" and their initial value has to be set to ACCESSOR_INIT
+typedef struct _accessorIndex_t accessorIndex_t;
+
+// accessorRecordIndex_t is an opaque structure giving random access to the variable length records of a readonly accessor
+// record index variables are of type "accessorRecordIndex_t *" and their initial value has to be set to ACCESSOR_INIT
+typedef struct _accessorRecordIndex_t accessorRecordIndex_t;
+
+// accessorMemo_t is an opaque structure memoizing structures decoded from a readonly accessor
+// memo variables are of type "accessorMemo_t *" and their initial value has to be set to ACCESSOR_INIT
+typedef struct _accessorMemo_t accessorMemo_t;
+
+// accessorBlockHashes_t is an opaque structure holding the hashes of fixed size blocks of an accessor, to find ranges changed between two versions of a file
+// block hashes variables are of type "accessorBlockHashes_t *" and their initial value has to be set to ACCESSOR_INIT
+typedef struct _accessorBlockHashes_t accessorBlockHashes_t;
+
+// accessorPool_t is an opaque structure keeping memory write accessors for reuse, see accessorOpenPool()
+// pool variables are of type "accessorPool_t *" and their initial value has to be set to ACCESSOR_INIT
+typedef struct _accessorPool_t accessorPool_t;
+
+// accessorPackPlan_t is an opaque structure describing how to write C structs' members, see accessorOpenPackPlan()
+// pack plan variables are of type "accessorPackPlan_t *" and their initial value has to be set to ACCESSOR_INIT
+typedef struct _accessorPackPlan_t accessorPackPlan_t;
+
+// accessorTrace_t is an opaque structure recording reads of accessors to a trace file, see accessorOpenTrace()
+// trace variables are of type "accessorTrace_t *" and their initial value has to be set to ACCESSOR_INIT
+typedef struct _accessorTrace_t accessorTrace_t;
+
 
 
 // accessor_t variables MUST be initialized to ACCESSOR_INIT, else accessorOpen... functions will fail
@@ -102,6 +155,7 @@ typedef enum
     accessorInvalidReadData,                        // attempt to read invalid data
     accessorWriteError,                             // error writing a file
     accessorReadOnlyError,                          // write operation attempted on readonly accessor
+    accessorNotFound,                               // looked up item doesn't exist
 } accessorStatus;
 
 
@@ -120,6 +174,27 @@ typedef uint32_t accessorPathOptions;
 
 
 
+// accessorIndexOptions may be ORed
+enum
+{
+    accessorIndexOptionNone             = 0x00,
+    accessorIndexOptionHashContent      = 0x01,     // the source accessor's window content is hashed and the hash is part of the index file key. slower, but detects changes that keep file identity, size and modification time
+    accessorIndexOptionIgnoreSource     = 0x02,     // when reading an index file, don't check it against its source, e.g. to get the block hashes of a previous version of source
+    accessorIndexOptionIs32Bits         = INT32_MAX // don't use, this is to force enum to 32 bits integers
+};
+typedef uint32_t accessorIndexOptions;
+
+// accessorCheckpointOptions may be ORed
+enum
+{
+    accessorCheckpointOptionNone        = 0x00,
+    accessorCheckpointOptionCoverage    = 0x01,     // coverage records are saved too. checkpoint size then grows with coverage arrays, see accessorSummarizeCoverage()
+    accessorCheckpointOptionIs32Bits    = INT32_MAX // don't use, this is to force enum to 32 bits integers
+};
+typedef uint32_t accessorCheckpointOptions;
+
+
+
 // non-ORable
 typedef enum
 {
@@ -166,6 +241,119 @@ typedef enum
 } accessorMergeResult;
 
 
+
+// a range of bytes of an accessor's window
+typedef struct
+{
+    size_t offset;
+    size_t size;
+} accessorRange;
+
+
+
+// a C struct member to write with accessorWritePacked(), see accessorOpenPackPlan()
+typedef struct
+{
+    size_t structOffset;                            // member's offset in struct, as returned by offsetof()
+    size_t memberSize;                              // member's size: 1, 2, 4 or 8. member is an integer (signed or unsigned), a float or a double
+    size_t nbytes;                                  // written size, 1 to memberSize. if less than memberSize, only the nbytes least significant bytes of an integer member are written
+    accessorEndianness endianness;                  // written endianness
+} accessorPackField;
+
+
+
+// a write span gives unchecked access to reserved bytes of a write accessor, see accessorOpenWriteSpan()
+typedef struct
+{
+    uint8_t * ptr;                                  // next byte to write
+    uint8_t * end;                                  // end of reserved bytes
+    size_t previousSize;                            // accessor size when span was opened
+} accessorWriteSpan;
+
+
+
+// API families, as counted by statistics
+typedef enum
+{
+    accessorApiReadScalar               = 0,        // integers and floats
+    accessorApiReadVarInt,                          // varints and zigzag integers
+    accessorApiReadArray,
+    accessorApiReadBytes,                           // bytes and pointers to bytes
+    accessorApiReadString,
+    accessorApiWriteScalar,
+    accessorApiWriteVarInt,
+    accessorApiWriteArray,
+    accessorApiWriteBytes,                          // bytes, repeated bytes, pointers to bytes and packed structs
+    accessorApiWriteString,
+    accessorApiFamilyCount,                         // not a family, number of families
+} accessorApiFamily;
+
+
+
+// statistics of a base accessor and all its sub-accessors, see accessorGetStats()
+typedef struct
+{
+    uint64_t bytesRead;
+    uint64_t bytesWritten;                          // including bytes "written" to null accessors
+    uint64_t calls[accessorApiFamilyCount];         // successful read and write calls, by API family
+    uint64_t seeks;                                 // including seeks done by cursor pops
+    uint64_t cursorPushes;
+    uint64_t cursorPops;
+    uint64_t grows;                                 // write accessor size increases
+    uint64_t reallocations;                         // data reallocations, at most one per grow
+    uint64_t reallocationBytesCopied;               // bytes copied by reallocations that moved data
+    uint64_t subAccessorsOpened;
+    uint64_t coverageRecords;                       // coverage records created, before merging
+    uint64_t allocations;                           // memory returned to caller: arrays, strings and allocated bytes
+} accessorStats;
+
+
+
+// a read recorded in a trace file, see accessorReadTraceRecord()
+typedef struct
+{
+    uint64_t rootOffset;                            // offset in base accessor's file or memory, see accessorRootWindowOffset()
+    uint64_t size;
+    accessorApiFamily family;
+    uintmax_t usage1;                               // coverage usage1 of the reading accessor, see accessorSetCoverageUsage()
+} accessorTraceRecord;
+
+
+
+// page residency of a range of an accessor's window, see accessorGetResidency()
+typedef struct
+{
+    size_t pageSize;
+    size_t residentPages;                           // pages in memory, reading them won't fault to disk
+    size_t nonResidentPages;                        // pages whose first read will wait for I/O
+} accessorResidency;
+
+
+
+// page faults and times between accessorStartFaultCount() and accessorStopFaultCount()
+typedef struct
+{
+    uint64_t minorFaults;                           // faults served from memory
+    uint64_t majorFaults;                           // faults that waited for I/O
+    double userSeconds;                             // CPU time
+    double systemSeconds;                           // CPU time in kernel, including fault handling
+    double elapsedSeconds;                          // wall clock time. if much larger than CPU time, with major faults, parse is I/O bound
+} accessorFaultCount;
+
+
+
+// process-wide memory budget, see accessorSetMemoryBudget()
+typedef struct
+{
+    size_t softLimit;                               // above it, caches shrink
+    size_t hardLimit;                               // charged allocations beyond it fail with accessorOutOfMemory
+    size_t inUse;                                   // bytes currently charged
+    size_t peak;                                    // highest inUse
+    uint64_t failures;                              // allocations refused by the hard limit
+    uint64_t evictions;                             // pooled accessors closed and memoized values destroyed under pressure
+} accessorMemoryBudget;
+
+
 // accessor open and close
 
 // read accessors
@@ -189,8 +377,15 @@ accessorStatus accessorOpenReadingMemory(accessor_t ** a, const void * ptr, size
 // options accessorPathOptionCreateDirectory and accessorPathOptionCreatePath are ignored
 // if the file data as limited by the window offset and size is modified between calls to accessor functions, behavior is undefined
 // initial endianness is accessorDefaultEndianness()
+// windows of at least accessorMmapMinFileSize() bytes are mapped in memory if possible, smaller windows are read in memory
 accessorStatus accessorOpenReadingFile(accessor_t ** a, const char * basePath, const char * path, accessorPathOptions pathOptions, size_t windowOffset, size_t windowSize);
 
+// same as accessorOpenReadingFile() for an open file or shared memory object, e.g. received from another process, see accessorExportFileDescriptor()
+// fd is duplicated, caller keeps ownership of fd
+// non empty windows are mapped shared whatever their size, so that processes share the same pages without any copy and readers see later writes
+// fd's file offset is left unchanged. returns accessorNotFound if accessor.c was compiled without mmap support, and accessorHostError if mapping fails
+accessorStatus accessorOpenReadingFileDescriptor(accessor_t ** a, int fd, size_t windowOffset, size_t windowSize);
+
 // create a readonly sub-accessor whose data is read from a readonly super-accessor's own window.
 // count == ACCESSOR_UNTIL_END means up to end of super-accessor's data, other values are taken literally
 // coverage for a sub-accessor future operations is handled by sub-accessor only, super-accessor's coverage is not affected by operations on sub-accessor.
@@ -204,7 +399,7 @@ accessorStatus accessorOpenReadingAccessorBytes(accessor_t ** a, accessor_t  *su
 // coverage for a sub-accessor future operations is handled by sub-accessor only, super-accessor's coverage is not affected by operations on sub-accessor.
 // no coverage record is added for super-accessor
 // sub-accessor inherits super-accessor's endianness
-// internal super-accessor reference count is incremented but is otherwise unmodified
+// internal base accessor reference count is incremented but super-accessor is otherwise unmodified
 accessorStatus accessorOpenReadingAccessorWindow(accessor_t ** a, accessor_t * supera, size_t windowOffset, size_t windowSize);
 
 // write accessors
@@ -218,6 +413,17 @@ accessorStatus accessorOpenReadingAccessorWindow(accessor_t ** a, accessor_t * s
 // initial endianness is accessorDefaultEndianness()
 accessorStatus accessorOpenWritingMemory(accessor_t ** a, size_t initialAllocation, size_t granularity);
 
+// same as accessorOpenWritingMemory(), but accessor's data is in shared memory: an anonymous memfd, or an unlinked POSIX shared memory object
+// another process can open a read accessor over the same pages, see accessorExportFileDescriptor()
+// returns accessorNotFound if shared memory isn't supported
+accessorStatus accessorOpenWritingShared(accessor_t ** a, size_t initialAllocation, size_t granularity);
+
+// get a duplicate of the descriptor backing a's data, for shared write accessors and read file accessors. caller closes *fd
+// *offset and *size delimit a's window in it, to be given to accessorOpenReadingFileDescriptor() in the same or another process (with fork() or SCM_RIGHTS)
+// readers see later writes to the exported window of a shared write accessor
+// returns accessorNotFound for accessors without a descriptor, such as memory accessors
+accessorStatus accessorExportFileDescriptor(const accessor_t * a, int * fd, size_t * offset, size_t * size);
+
 // create an empty read/write accessor, writing data to some internal memory buffer
 // accessor's data is written to file on accessorClose()
 // file is created immediately and truncated if needed
@@ -225,16 +431,48 @@ accessorStatus accessorOpenWritingMemory(accessor_t ** a, size_t initialAllocati
 // initial endianness is accessorDefaultEndianness()
 accessorStatus accessorOpenWritingFile(accessor_t ** a, const char * basePath, const char * path, accessorPathOptions pathOptions, mode_t mode, size_t initialAllocation, size_t granularity);
 
+// create an empty null write accessor, accepting all write operations but storing nothing: only its cursor and size are maintained, without any data transfer
+// useful to measure some output's size in a first pass, to give it as initialAllocation to the actual write accessor
+// reading from a null accessor returns accessorBeyondEnd and accessorAvailableBytesCount() always returns 0
+// accessorGetPointerForBytesToWrite() returns a scratch buffer whose content is discarded
+// accessorWriteToFile() returns accessorInvalidParameter
+accessorStatus accessorOpenWritingNull(accessor_t ** a);
+
 // write (part of) an accessor window's data to a file
 // especially useful when output filename is known only after accessorOpenWritingMemory() has been called
 // windowOffset and windowSize delimit a window on accessor's own window for the data to be written to file
 // windowSize == ACCESSOR_UNTIL_END means up to end of accessor's own window, other windowSize values are taken literally
 accessorStatus accessorWriteToFile(const accessor_t * a, const char * basePath, const char * path, accessorPathOptions pathOptions, mode_t mode, size_t windowOffset, size_t windowSize);
 
-// accessor is closed. if a is super-accessor to another accessor, it close actions may be delayed until all sub-accessors are closed
+// accessor is closed. if a is a base accessor of other accessors, its close actions are delayed until all its sub-accessors are closed
+// sub-accessors only depend on their base accessor: a super-accessor may be closed before its sub-accessors, and closing takes constant time whatever the nesting depth
 // on success, "a" will be set to ACCESSOR_INIT whether it is a super-accessor or not
 accessorStatus accessorClose(accessor_t ** a);
 
+// empty a write accessor, keeping its memory allocation and its cursor stack allocation for reuse
+// size, cursor, cursor stack, coverage records and slots are cleared. endianness and coverage enabled status are unchanged
+// returns accessorInvalidParameter if a is a super-accessor of some other accessor
+accessorStatus accessorReset(accessor_t * a);
+
+
+
+// write accessors pools
+// a pool keeps released memory write accessors, so that writing many small outputs doesn't allocate and free memory for each of them
+// a pool isn't thread-safe: use a pool per thread
+
+// open a pool keeping at most maxCount accessors. initialAllocation and granularity are used for new accessors, see accessorOpenWritingMemory()
+accessorStatus accessorOpenPool(accessorPool_t ** p, size_t maxCount, size_t initialAllocation, size_t granularity);
+
+// close pool and all accessors it keeps. accessors acquired from pool are still valid and may be closed with accessorClose(). on success, "p" will be set to ACCESSOR_INIT
+accessorStatus accessorClosePool(accessorPool_t ** p);
+
+// get an empty memory write accessor, as if just opened with accessorOpenWritingMemory(). *a must be ACCESSOR_INIT
+accessorStatus accessorPoolAcquire(accessorPool_t * p, accessor_t ** a);
+
+// give back a memory write accessor to pool, or close it if pool is full. on success, "a" will be set to ACCESSOR_INIT
+// accessors that aren't memory write accessors, or are super-accessors of some other accessor, are closed
+accessorStatus accessorPoolRelease(accessorPool_t * p, accessor_t ** a);
+
 
 
 
@@ -300,6 +538,12 @@ accessorEndianness accessorOppositeEndianness(accessorEndianness e);
 accessorEndianness accessorDefaultEndianness(void);                     // for future accessors
 accessorStatus accessorSetDefaultEndianness(accessorEndianness e);      // for future accessors
 
+// get or set the minimum window size for which accessorOpenReadingFile() maps files in memory, e.g. to tune it per host
+// initially, minimum size is the ACCESSOR_MMAP_MIN_FILESIZE build setting. SIZE_MAX disables mapping, 0 maps all non empty windows
+// minimum size is globally shared among all threads
+size_t accessorMmapMinFileSize(void);                                   // for future accessors
+accessorStatus accessorSetMmapMinFileSize(size_t size);                 // for future accessors
+
 // get or set current endianness for an accessor
 accessorEndianness accessorCurrentEndianness(const accessor_t * a);
 accessorStatus accessorSetCurrentEndianness(accessor_t * a, accessorEndianness e);
@@ -555,8 +799,327 @@ accessorStatus accessorGetPointerForBytesToWrite(accessor_t * a, void ** ptr, si
 
 
 
+// write spans
+// a write span reserves count bytes at cursor with a single check, then inline functions write to it without any check, typically compiling to a single store (with byte swap if needed)
+// span writes MUST NOT exceed reserved bytes, and no other function may be called on accessor between span opening and closing
+// closing a span moves cursor just after written bytes. unwritten reserved bytes beyond accessor's previous size are discarded
+// null accessors give a scratch buffer of count bytes, and closing a span only accounts for written bytes
+accessorStatus accessorOpenWriteSpan(accessor_t * a, accessorWriteSpan * span, size_t count);                                      // reserve count bytes at cursor. cursor does move
+accessorStatus accessorCloseWriteSpan(accessor_t * a, accessorWriteSpan * span);                                                    // move cursor back to the first unwritten byte of span
+
+static inline size_t accessorSpanAvailableBytes(const accessorWriteSpan * span)             { return (size_t) (span->end - span->ptr); }
+static inline void accessorSpanWriteUInt8(accessorWriteSpan * span, uint8_t x)              { *span->ptr++ = x; }
+static inline void accessorSpanWriteBytes(accessorWriteSpan * span, const void * ptr, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+        span->ptr[i] = ((const uint8_t *) ptr)[i];
+    span->ptr += count;
+}
+
+// shifts are endianness independent, and compilers merge them into single stores
+// span->ptr is copied to a local, else stores through uint8_t pointers could modify it, preventing stores merging
+static inline void accessorSpanWriteBigUInt16(accessorWriteSpan * span, uint16_t x)
+{
+    uint8_t * p = span->ptr;
+
+    p[0] = (uint8_t) (x >> 8);
+    p[1] = (uint8_t) x;
+    span->ptr = p + 2;
+}
+
+static inline void accessorSpanWriteBigUInt32(accessorWriteSpan * span, uint32_t x)
+{
+    uint8_t * p = span->ptr;
+
+    p[0] = (uint8_t) (x >> 24);
+    p[1] = (uint8_t) (x >> 16);
+    p[2] = (uint8_t) (x >> 8);
+    p[3] = (uint8_t) x;
+    span->ptr = p + 4;
+}
+
+static inline void accessorSpanWriteBigUInt64(accessorWriteSpan * span, uint64_t x)
+{
+    uint8_t * p = span->ptr;
+
+    p[0] = (uint8_t) (x >> 56);
+    p[1] = (uint8_t) (x >> 48);
+    p[2] = (uint8_t) (x >> 40);
+    p[3] = (uint8_t) (x >> 32);
+    p[4] = (uint8_t) (x >> 24);
+    p[5] = (uint8_t) (x >> 16);
+    p[6] = (uint8_t) (x >> 8);
+    p[7] = (uint8_t) x;
+    span->ptr = p + 8;
+}
+
+static inline void accessorSpanWriteLittleUInt16(accessorWriteSpan * span, uint16_t x)
+{
+    uint8_t * p = span->ptr;
+
+    p[0] = (uint8_t) x;
+    p[1] = (uint8_t) (x >> 8);
+    span->ptr = p + 2;
+}
+
+static inline void accessorSpanWriteLittleUInt32(accessorWriteSpan * span, uint32_t x)
+{
+    uint8_t * p = span->ptr;
+
+    p[0] = (uint8_t) x;
+    p[1] = (uint8_t) (x >> 8);
+    p[2] = (uint8_t) (x >> 16);
+    p[3] = (uint8_t) (x >> 24);
+    span->ptr = p + 4;
+}
+
+static inline void accessorSpanWriteLittleUInt64(accessorWriteSpan * span, uint64_t x)
+{
+    uint8_t * p = span->ptr;
+
+    p[0] = (uint8_t) x;
+    p[1] = (uint8_t) (x >> 8);
+    p[2] = (uint8_t) (x >> 16);
+    p[3] = (uint8_t) (x >> 24);
+    p[4] = (uint8_t) (x >> 32);
+    p[5] = (uint8_t) (x >> 40);
+    p[6] = (uint8_t) (x >> 48);
+    p[7] = (uint8_t) (x >> 56);
+    span->ptr = p + 8;
+}
+
+
+
+// slots
+// a slot is a fixed width unsigned integer field whose value is only known later, such as a length or offset field in a header
+// reserving a slot writes nbytes placeholder 0x00 bytes at cursor. the slot's value is set anytime later, without moving cursor
+// all slots are written in a single batch by accessorResolveSlots(), which is automatically called by accessorWriteToFile() and by accessorClose() for accessors opened with accessorOpenWritingFile()
+// if slots can't be resolved, accessorClose() closes accessor without writing its file and returns accessorResolveSlots()'s error
+// slots are identified by their index, in reservation order. they remain valid until accessor is closed, and may be set and resolved again
+// a slot's value must fit in nbytes, else accessorInvalidParameter is returned
+
+accessorStatus accessorReserveEndianSlot(accessor_t * a, size_t * slot, accessorEndianness e, size_t nbytes);                      // reserve a nbytes wide slot (1 to sizeof(uintmax_t)) at cursor
+accessorStatus accessorReserveSlot(accessor_t * a, size_t * slot, size_t nbytes);                                                  // the same, using accessor's current endianness
+accessorStatus accessorSetSlotValue(accessor_t * a, size_t slot, uintmax_t x);                                                      // set slot's value
+accessorStatus accessorSetSlotToCursor(accessor_t * a, size_t slot);                                                                // set slot's value to cursor, e.g. for an offset field
+accessorStatus accessorSetSlotToLengthSince(accessor_t * a, size_t slot, size_t offset);                                           // set slot's value to cursor - offset, e.g. for a length field
+
+// write all slots values in accessor's data. returns accessorInvalidParameter if some slot has no value, or accessorBeyondEnd if some slot was truncated, in which case nothing is written
+accessorStatus accessorResolveSlots(accessor_t * a);
+
+
+
+// struct packing
+// a pack plan is compiled once from a description of a C struct's members, then writes any number of such structs in a single call
+// each struct is written as its members, in fields order, without padding. fields may be listed in any order and needn't describe all members
+// adjacent members that need no byte swapping are copied as a single run, and a single capacity check is done for all structs
+// if struct layout matches written layout (same order, no padding, full width members), all structs are copied at once and swapped in place if needed
+
+accessorStatus accessorOpenPackPlan(accessorPackPlan_t ** p, const accessorPackField * fields, size_t fieldCount, size_t structSize);   // structSize is sizeof(struct). returns accessorInvalidParameter if some field is invalid or isn't inside struct
+accessorStatus accessorClosePackPlan(accessorPackPlan_t ** p);
+size_t accessorPackPlanSize(const accessorPackPlan_t * p);                                                                         // returns the number of bytes written for each struct
+accessorStatus accessorWritePacked(accessor_t * a, const accessorPackPlan_t * p, const void * structs, size_t count);              // write count adjacent structs at cursor
+
+
+
+// relocation
+
+// apply a relocation table, as found in executables or resource blobs, to a write accessor's data in a single batched pass
+// the relocation table is read at r's cursor: count offsets, each offsetSize bytes wide (1 to sizeof(uintmax_t)), using r's current endianness
+// each offset designates a fieldSize bytes wide (2, 4 or 8) unsigned field of a's window, stored with endianness e, to which base is added modulo 2^(8*fieldSize)
+// all offsets are validated before any field is modified: if any field isn't fully inside a's window, accessorBeyondEnd is returned and no field is modified
+// a's cursor doesn't move. r's cursor moves past the table and a single coverage record is added for r, if enabled and not suspended
+// runs of adjacent fields (e.g. from sorted tables) are relocated as arrays
+accessorStatus accessorApplyRelocations(accessor_t * a, accessor_t * r, size_t count, size_t offsetSize, size_t fieldSize, accessorEndianness e, uintmax_t base);
+
+
+
+// catalog
+
+// a catalog maps entry names, such as an archive directory's file names, to a window (offset and size) of a readonly accessor
+// lookups by name are done in constant time using an open-addressing hash table, whatever the entry count
+// names are byte strings of given length, they don't have to be NUL terminated. e.g. they may be obtained by accessorGetPointerForBytesToRead()
+// names are copied in the catalog, name pointers returned by catalog functions are only valid until next accessorCatalogAddEntry()
+// offset and size are relative to the catalog accessor's window, as for accessorOpenReadingAccessorWindow()
+// catalog isn't thread-safe, but accessorCatalogFindEntry() and accessorCatalogGetEntry() may be called concurrently as they don't modify the catalog
+
+// create an empty catalog for entries of readonly accessor a
+// a's internal reference count is incremented as for sub-accessors, so a may be closed before the catalog
+// entryCountHint is the expected entry count, used to presize the catalog. it may be 0
+accessorStatus accessorOpenCatalog(accessorCatalog_t ** c, accessor_t * a, size_t entryCountHint);
+
+// close catalog. on success, "c" will be set to ACCESSOR_INIT
+accessorStatus accessorCloseCatalog(accessorCatalog_t ** c);
+
+// add an entry. if an entry with the same name already exists, its offset and size are replaced
+// returns accessorBeyondEnd if the entry's window isn't inside the catalog accessor's window
+// returns accessorReadOnlyError for catalogs opened with accessorOpenIndexCatalog()
+accessorStatus accessorCatalogAddEntry(accessorCatalog_t * c, const void * name, size_t nameLength, size_t offset, size_t size);
+
+// find an entry by name, returns accessorNotFound if there is no such entry
+// offset and size may be NULL
+accessorStatus accessorCatalogFindEntry(const accessorCatalog_t * c, const void * name, size_t nameLength, size_t * offset, size_t * size);
+
+// create a readonly sub-accessor on the window of the named entry, see accessorOpenReadingAccessorWindow()
+accessorStatus accessorOpenReadingCatalogEntry(accessor_t ** a, const accessorCatalog_t * c, const void * name, size_t nameLength);
+
+// entries, in insertion order
+// index is in the [0, accessorCatalogEntryCount()[ range. any of name, nameLength, offset or size may be NULL
+size_t accessorCatalogEntryCount(const accessorCatalog_t * c);
+accessorStatus accessorCatalogGetEntry(const accessorCatalog_t * c, size_t index, const void ** name, size_t * nameLength, size_t * offset, size_t * size);
+
+// entries, sorted by name
+// names are compared bytewise, as by memcmp(), a name being sorted before any longer name it is a prefix of
+// the sorted index is built by accessorCatalogSort() or on demand by accessorCatalogFindPrefix(), it is invalidated by accessorCatalogAddEntry()
+// accessorCatalogFindPrefix() sets first and count so that sorted positions [first, first + count[ are all entries whose name begins with prefix
+// accessorCatalogGetSortedEntry() returns accessorInvalidParameter if the sorted index isn't up to date
+accessorStatus accessorCatalogSort(accessorCatalog_t * c);
+accessorStatus accessorCatalogFindPrefix(accessorCatalog_t * c, const void * prefix, size_t prefixLength, size_t * first, size_t * count);
+accessorStatus accessorCatalogGetSortedEntry(const accessorCatalog_t * c, size_t position, const void ** name, size_t * nameLength, size_t * offset, size_t * size);
+
+
+
+// index files
+
+// an index file persists structures derived from a source accessor (catalogs, record offset tables, coverage summaries...) so that they don't have to be computed again
+// an index file is keyed by its source accessor: source file's device, inode, size and modification time, source accessor's window and optionally a hash of the window's content
+// an index file is made of sections, identified by a caller defined tag, whose data is 8 bytes aligned
+// reopening an index file maps it in memory (see accessorOpenReadingFile()), sections are then directly used from mapped memory without any parsing
+// index files use native endianness and integer widths: they are specific to a host architecture, and are considered stale on other ones
+// sections are used in place: catalog sections are checked when opened, so that truncated or corrupted index files are rejected with accessorInvalidReadData
+// caller defined sections aren't checked by the index, their users should check them
+
+// create an empty index in memory for source accessor
+// if source's base accessor isn't a file read accessor, accessorIndexOptionHashContent is required
+accessorStatus accessorOpenWritingIndex(accessorIndex_t ** x, const accessor_t * source, accessorIndexOptions options);
+
+// add a section of size bytes. tag is free use, if several sections have the same tag, only the first one can be retrieved
+accessorStatus accessorIndexAddSection(accessorIndex_t * x, uint32_t tag, const void * ptr, size_t size);
+
+// add a section saving a catalog, its sorted index is saved only if it is up to date
+accessorStatus accessorIndexAddCatalog(accessorIndex_t * x, uint32_t tag, const accessorCatalog_t * c);
+
+// save index to a file, index can still be modified and saved again
+accessorStatus accessorWriteIndexToFile(accessorIndex_t * x, const char * basePath, const char * path, accessorPathOptions pathOptions, mode_t mode);
+
+// open an index file for source accessor
+// returns accessorInvalidReadData if the index file isn't a valid index file or if it is stale, i.e. it doesn't match source accessor, in which case it should be rebuilt
+// with accessorIndexOptionIgnoreSource, the index file is not checked against source, which may be NULL
+// source's content is hashed only if accessorIndexOptionHashContent is given and the index file was written with accessorIndexOptionHashContent
+accessorStatus accessorOpenReadingIndex(accessorIndex_t ** x, const accessor_t * source, const char * basePath, const char * path, accessorPathOptions pathOptions, accessorIndexOptions options);
+
+// get a section's data, returns accessorNotFound if there is no section with this tag
+// returned pointer is valid until next index modification or accessorCloseIndex()
+accessorStatus accessorIndexGetSection(const accessorIndex_t * x, uint32_t tag, const void ** ptr, size_t * size);
+
+// open a readonly catalog saved with accessorIndexAddCatalog(), whose entries are windows of a (usually the index source accessor)
+// catalog arrays are used in place, the catalog can't be modified but is otherwise a usual catalog, see accessorOpenCatalog()
+// index x must not be closed before catalog c
+accessorStatus accessorOpenIndexCatalog(accessorCatalog_t ** c, const accessorIndex_t * x, uint32_t tag, accessor_t * a);
+
+// close index. on success, "x" will be set to ACCESSOR_INIT
+accessorStatus accessorCloseIndex(accessorIndex_t ** x);
+
+// add a section saving block hashes
+accessorStatus accessorIndexAddBlockHashes(accessorIndex_t * x, uint32_t tag, const accessorBlockHashes_t * h);
+
+// open block hashes saved with accessorIndexAddBlockHashes(). they are copied and remain valid after accessorCloseIndex()
+accessorStatus accessorOpenIndexBlockHashes(accessorBlockHashes_t ** h, const accessorIndex_t * x, uint32_t tag);
+
+
+
+
+// record index
+// a record stream is a readonly accessor made of contiguous variable length records, from its start to its end
+// a record index lazily parses the stream, remembering the offset of every interval-th record, so that record i is reached by parsing at most interval records
+// records are only parsed when needed: opening a record index is free, and accessing record i the first time parses the stream up to record i
+// recordLength is called with a readonly accessor whose window starts at a record and extends to the stream's end, its cursor being 0. it must set *length to the record's length and return accessorOk
+// record's endianness is stream's, its cursor stack is empty and its coverage is disabled, whatever previous recordLength calls did to it
+// recordLength may read record using any accessorRead... function, but must close any accessor it opens from record before returning
+// recordLength's errors are returned as is. a null length returns accessorInvalidReadData, a length extending beyond stream's end returns accessorBeyondEnd
+// record index isn't thread-safe
+
+// open a record index for stream a. interval must not be null. a's internal reference count is incremented as for sub-accessors, so a may be closed before the record index
+accessorStatus accessorOpenRecordIndex(accessorRecordIndex_t ** r, accessor_t * a, size_t interval, accessorStatus (* recordLength)(accessor_t * record, void * context, size_t * length), void * context);
+
+// close record index. on success, "r" will be set to ACCESSOR_INIT
+accessorStatus accessorCloseRecordIndex(accessorRecordIndex_t ** r);
+
+// get record index's offset and size in stream. offset or size may be NULL
+// returns accessorBeyondEnd if there are not more than index records
+accessorStatus accessorRecordIndexGetRecord(accessorRecordIndex_t * r, size_t index, size_t * offset, size_t * size);
+
+// open a sub-accessor on record index
+accessorStatus accessorOpenReadingRecord(accessor_t ** a, accessorRecordIndex_t * r, size_t index);
+
+// get stream's record count. the whole stream is parsed, once
+accessorStatus accessorRecordIndexCount(accessorRecordIndex_t * r, size_t * count);
+
+
+
+
+// memo
+// a memo table stores values decoded from a readonly stream, so that structures referenced several times (shared nodes of object graphs...) are decoded once
+// values are keyed by their offset in the stream's base accessor and by a caller defined decoder id, telling apart different decodings of the same offset
+// any accessor sharing the stream's base accessor may be used for find and add, offsets being relative to its window
+// values are owned by the memo table, which calls their destroy function (if not NULL) when they are replaced, evicted, cleared or when the memo is closed. destroy must not use the memo table
+// each value has a caller defined cost (usually its size in memory). when the total cost exceeds maxCost, least recently found or added values are evicted
+// a value returned by accessorMemoFind() is valid until next accessorMemoAdd(), accessorMemoClear() or accessorCloseMemo(). callers needing longer lived values should reference count them in destroy
+// coverage is recorded when a structure is actually decoded: finding a memoized value doesn't read the stream, so doesn't record coverage
+// each value has a size: the bytes of stream it was decoded from, used to invalidate it when they change (see accessorMemoUpdate()). a value depending on other memoized values should be invalidated by the caller when they are
+// memo table isn't thread-safe
+
+// open a memo table for stream a. a's internal reference count is incremented as for sub-accessors, so a may be closed before the memo table
+// maxCost may be SIZE_MAX for an unbounded memo table
+accessorStatus accessorOpenMemo(accessorMemo_t ** m, accessor_t * a, size_t maxCost);
+
+// close memo table, destroying all values. on success, "m" will be set to ACCESSOR_INIT
+accessorStatus accessorCloseMemo(accessorMemo_t ** m);
+
+// find value decoded by decoderId at offset of a. returns accessorNotFound if there is no such value
+accessorStatus accessorMemoFind(accessorMemo_t * m, const accessor_t * a, size_t offset, uintmax_t decoderId, void ** value);
+
+// add value decoded by decoderId from size bytes at offset of a, replacing any previous value. value is never evicted by the call adding it, even if its cost exceeds maxCost
+// adding the value already memoized for this key updates its size, cost and destroy in place, and makes it most recently used: it isn't destroyed
+// on error, value isn't owned by the memo table and destroy isn't called
+accessorStatus accessorMemoAdd(accessorMemo_t * m, const accessor_t * a, size_t offset, size_t size, uintmax_t decoderId, void * value, size_t cost, void (* destroy)(void * value));
+
+// destroy all values
+void accessorMemoClear(accessorMemo_t * m);
+
+
+
+
+// changed ranges
+// to reparse a new version of a file, block hashes of its previous version (usually saved in an index file) are compared to the new version's
+// the resulting changed ranges are used to invalidate only the memoized values and record index checkpoints depending on them
+// the previous and new versions' accessors must have the same window in their respective files (usually the whole file)
+
+// hash a's window by blocks of blockSize bytes, the last block may be shorter. blockSize must not be null
+accessorStatus accessorOpenBlockHashes(accessorBlockHashes_t ** h, const accessor_t * a, size_t blockSize);
+
+// close block hashes. on success, "h" will be set to ACCESSOR_INIT
+accessorStatus accessorCloseBlockHashes(accessorBlockHashes_t ** h);
+
+// get ranges of current that differ from previous, in increasing offset order, adjacent changed blocks being merged. ranges are relative to the accessors windows
+// bytes beyond the end of the shorter version are part of the last range
+// ranges array is allocated, it is up to caller to free() it. it is NULL if rangeCount is 0
+// returns accessorInvalidParameter if previous and current don't have the same block size
+accessorStatus accessorCompareBlockHashes(const accessorBlockHashes_t * previous, const accessorBlockHashes_t * current, accessorRange ** ranges, size_t * rangeCount);
+
+// destroy memoized values overlapping changed ranges, then move remaining values to newStream, the new version of m's stream
+// ranges must be sorted and non overlapping, as returned by accessorCompareBlockHashes()
+accessorStatus accessorMemoUpdate(accessorMemo_t * m, accessor_t * newStream, const accessorRange * ranges, size_t rangeCount);
+
+// forget record offsets from the first changed range, then move record index to newStream, the new version of r's stream
+// ranges must be sorted and non overlapping, as returned by accessorCompareBlockHashes()
+accessorStatus accessorRecordIndexUpdate(accessorRecordIndex_t * r, accessor_t * newStream, const accessorRange * ranges, size_t rangeCount);
+
+
+
 
 // coverage related
+// a read recording coverage returns accessorOutOfMemory if its coverage record couldn't be allocated. the read then fails as a whole: cursor is unchanged and allocated results are freed
 
 // set usage1 and usage2 for accessor's future coverage records
 void accessorSetCoverageUsage(accessor_t * a, uintmax_t usage1, const void * usage2);
@@ -564,7 +1127,8 @@ void accessorSetCoverageUsage(accessor_t * a, uintmax_t usage1, const void * usa
 // add a single coverage record to accessor of count bytes at given offset of accessor's window
 // forceOption may be used to override disabled (but not suspended) coverage
 // count == ACCESSOR_UNTIL_END means "up to end of accessor's window", other count values are taken literally
-void accessorAddCoverageRecord(accessor_t * a, size_t offset, size_t count, uintmax_t usage1, const void * usage2, accessorCoverageForceOption forceOption);
+// returns accessorOutOfMemory if the record couldn't be allocated
+accessorStatus accessorAddCoverageRecord(accessor_t * a, size_t offset, size_t count, uintmax_t usage1, const void * usage2, accessorCoverageForceOption forceOption);
 
 // get or set coverage enabled status
 accessorCoverageOption accessorIsCoverageAllowed(const accessor_t * a);                                                             // returns either accessorEnableCoverage or accessorDisableCoverage
@@ -591,6 +1155,106 @@ void accessorSummarizeCoverage(accessor_t * a, int (* compare)(const void * a, c
 
 
 
+// statistics
+// statistics are only counted if accessor.c is compiled with ACCESSOR_STATISTICS defined to a non zero value, at a small cost for every call
+// they are aggregated to the base accessor: read, write, seek... calls on sub-accessors are counted in their base accessor's statistics
+// they are kept by accessorReset()
+
+// get a's base accessor statistics. returns accessorNotFound, with *stats set to 0, if statistics weren't compiled in
+accessorStatus accessorGetStats(const accessor_t * a, accessorStats * stats);
+
+
+
+
+// access traces
+// a trace file records reads as (root offset, size, API family, usage1), to replay a file's access pattern without the file itself
+// reads are only recorded if accessor.c is compiled with ACCESSOR_TRACING defined to a non zero value, trace files can be opened and read regardless
+// trace file format: "acctrace", big-endian uint32 version, then records:
+//  zigzag varint rootOffset - previous record's end (rootOffset + size), varint size, uint8 API family, varint usage1
+
+// open a trace file. records are buffered, then written by bufferSize bytes chunks (default if 0)
+accessorStatus accessorOpenTrace(accessorTrace_t ** t, const char * basePath, const char * path, accessorPathOptions pathOptions, mode_t mode, size_t bufferSize);
+
+// write buffered records and close trace. on success, "t" will be set to ACCESSOR_INIT
+// returns the first error met while writing records, if any. accessors must stop using t before it is closed
+accessorStatus accessorCloseTrace(accessorTrace_t ** t);
+
+// record reads of a's base accessor and all its sub-accessors to t, or stop recording them if t is NULL
+// returns accessorNotFound if tracing wasn't compiled in
+accessorStatus accessorSetTrace(accessor_t * a, accessorTrace_t * t);
+
+// check a trace file header at a's cursor
+// returns accessorInvalidReadData if a's data isn't a trace of a supported version
+accessorStatus accessorReadTraceHeader(accessor_t * a);
+
+// read the trace record at a's cursor. *previousEnd must be 0 for the first record, and is updated for the next one
+// returns accessorBeyondEnd at end of trace
+accessorStatus accessorReadTraceRecord(accessor_t * a, accessorTraceRecord * record, uint64_t * previousEnd);
+
+
+
+// page residency and faults
+// residency tells which pages of a window are in memory, as reported by mincore(). it is mostly useful for mapped read accessors
+// fault counts measure a parse: start a count, parse, stop the count. they are process wide, or thread wide where supported
+
+// get residency of window range [offset, offset + size[ of a. size may be ACCESSOR_UNTIL_END. pages partially in range are counted
+// returns accessorNotFound if accessor.c was compiled without mmap support, and accessorInvalidParameter for null write accessors
+accessorStatus accessorGetResidency(const accessor_t * a, size_t offset, size_t size, accessorResidency * residency);
+
+// get residency of each coverage record of a, see accessorCoverageArray(). residencies must hold as many entries as coverage records
+// a per-region breakdown is best obtained after accessorSummarizeCoverage()
+accessorStatus accessorGetCoverageResidency(const accessor_t * a, accessorResidency * residencies);
+
+// start a fault count, then stop it to get faults and times since start. f's fields are only meaningful once stopped
+accessorStatus accessorStartFaultCount(accessorFaultCount * f);
+accessorStatus accessorStopFaultCount(accessorFaultCount * f);
+
+
+
+// memory budget
+// accessor structures, data buffers (read copies of files, write buffers), coverage arrays, cursor stacks, slots,
+// catalog entries, names and hash tables, index sections, record index checkpoints and memo tables are charged to a process-wide budget, shared by all threads
+// memory returned to caller (strings, arrays, allocated bytes, paths, ranges) and mapped files aren't charged
+// above the soft limit, caches shrink cooperatively: pools close their idle accessors and don't keep released ones,
+// memo tables evict least recently used values down to half their maximum cost
+// above the hard limit, charged allocations fail with accessorOutOfMemory, reads recording coverage included: such reads leave cursor unchanged
+
+// set limits, in bytes. both default to SIZE_MAX, i.e. no limit. softLimit may not exceed hardLimit
+// limits apply to future allocations, memory already charged is kept even if above new limits
+accessorStatus accessorSetMemoryBudget(size_t softLimit, size_t hardLimit);
+void accessorGetMemoryBudget(accessorMemoryBudget * budget);
+
+// returns true if the soft limit is exceeded. caller's caches may use it to shrink as accessor's caches do
+int accessorIsMemoryUnderPressure(void);
+
+// handler is called once before an allocation fails for exceeding the hard limit, with the size of the refused allocation
+// it may release memory (e.g. clear memo tables, close pools) and allocation is retried once. handler may be NULL
+// handler is global: set it before other threads use accessors
+void accessorSetMemoryPressureHandler(void (* handler)(size_t size, void * context), void * context);
+
+
+
+// checkpoints
+// a checkpoint saves the parse state of an accessor tree: cursors, cursor stacks, endianness, coverage state and windows of sub-accessors
+// it doesn't save data, and is restored over a reopened base accessor, e.g. to resume a long parse after a crash
+// checkpoint format: "accchkpt", big-endian uint32 version, varint options, varint accessor count, then per accessor:
+//  varint parent index, varint window offset in parent's window, varint window size, varint cursor, uint8 endianness,
+//  varint cursor stack size, varint cursor stack entries, uint8 coverage allowed, varint coverage suspend count, varint coverage usage1,
+//  with accessorCheckpointOptionCoverage: varint coverage record count, then varint offset, varint size, varint usage1 per record
+
+// write a checkpoint at checkpoint's cursor. accessors[0] is the root, other accessors must be sub-accessors (at any depth) of root's base accessor within root's window
+// each accessor is saved relative to the last accessor listed before it whose window contains its own, e.g. its super-accessor. coverage usage2 values are pointers and aren't saved
+accessorStatus accessorWriteCheckpoint(accessor_t * checkpoint, accessor_t * const * accessors, size_t count, accessorCheckpointOptions options);
+
+// read a checkpoint at checkpoint's cursor and restore it. accessors[0] is the reopened root read accessor, its window size must match the saved one
+// accessors[1] to accessors[maxCount - 1] must be ACCESSOR_INIT, *count is set to the number of accessors restored, sub-accessors being reopened as windows
+// without accessorCheckpointOptionCoverage, the root keeps its coverage records. coverage usage2 values are restored as NULL
+// returns accessorInvalidReadData if checkpoint is invalid or doesn't match the root, and accessorInvalidParameter if maxCount is too small
+// on error, no sub-accessor is left open but the root's state is unspecified
+accessorStatus accessorReadCheckpoint(accessor_t * checkpoint, accessor_t ** accessors, size_t maxCount, size_t * count);
+
+
+
 // various helpers
 
 uint32_t accessorBuildNumber(void);                                                                                                 // get accessor toolkit build version
@@ -627,6 +1291,10 @@ uint64_t accessorSwapUInt64(uint64_t x);
 // file will not be created but accessorPathOptionCreateDirectory and accessorPathOptionCreatePath are honored
 accessorStatus accessorBuildPath(char ** result, const char * basePath, const char * path, accessorPathOptions pathOptions, size_t additionalAllocationLength);
 
+// same as accessorBuildPath(), but result is written to buffer, nothing is allocated. *length is set to result's length, terminating null character excluded
+// returns accessorBeyondEnd if bufferSize is less than strlen(basePath) + strlen(path) + 2, which is always enough
+accessorStatus accessorBuildPathInBuffer(char * buffer, size_t bufferSize, size_t * length, const char * basePath, const char * path, accessorPathOptions pathOptions);
+
 // create directory at specified path (and possibly parent directories)
 // accessorPathOptionCreateDirectory is implied and doesn't need to be set, accessorPathOptionCreatePath is optional
 accessorStatus accessorCreateDirectory(const char * basePath, const char * path, accessorPathOptions pathOptions);
@@ -0,0 +1,1431 @@
+// Micro-benchmarks of the "accessor" package primitives
+//
+// Each benchmark is calibrated to run about BENCH_TARGET_NS per repetition, warmed up, then repeated
+// Reported figures are the median, 10th and 90th percentiles of per operation times over all repetitions
+// Data is generated from a fixed seed and the process is pinned to a single CPU, so that numbers are comparable between builds
+// Where malloc can be interposed (glibc, without sanitizers), allocations made during measured repetitions are counted too
+// With --counters, an additional repetition is run under hardware event counters (cycles, instructions, cache and TLB misses, page faults),
+// reported per byte for benchmarks with a byte throughput, per operation otherwise. Unavailable counters are reported as "-"
+//
+// The workload benchmark parses a synthetic archive (directory, nested chunks, varint records, UTF-16 names, big-endian arrays),
+// its MB/s and allocations per MB are the single figures to track across library changes
+//
+// With --baseline, medians are compared to those of a previous --json output: a benchmark regressed if its median is more than --threshold
+// percent (default 5) slower and the about 95% confidence intervals of both medians don't overlap. Exit status is 1 if any benchmark regressed
+//
+// usage: bench [--filter substring] [--repetitions n] [--warmups n] [--seed n] [--cpu n|-1] [--counters] [--json file|-] [--baseline file] [--threshold percent]
+// results are printed in human readable form on stdout, and as JSON lines (one object per benchmark) to --json file
+
+
+#include "accessor.h"
+#include "benchharness.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+
+#define BENCH_DEFAULT_SEED          ((uint64_t) 0x0123456789abcdefULL)
+#define BENCH_DEFAULT_REPETITIONS   ((size_t) 21)
+#define BENCH_DEFAULT_WARMUPS       ((size_t) 3)
+#define BENCH_TARGET_NS             ((uint64_t) 10000000)      // about 10 ms per repetition
+#define BENCH_MAX_REPETITIONS       ((size_t) 1000)
+#define BENCH_VALUE_COUNT           ((size_t) 4096)            // values read or written per iteration
+#define BENCH_BUFFER_SIZE           (BENCH_VALUE_COUNT * 8)
+#define BENCH_DEFAULT_THRESHOLD     5.0                        // percent
+#define BENCH_MAX_BASELINES         ((size_t) 256)
+#define BENCH_MAX_NAME_LENGTH       ((size_t) 64)
+#define BENCH_NEST_DEPTH            ((size_t) 10000)           // sub-accessors chain length of nested windows benchmark
+
+// malloc interposition requires glibc's __libc_ entry points, and conflicts with sanitizers' own interposition
+#if defined(__has_feature)
+#if __has_feature(address_sanitizer) || __has_feature(memory_sanitizer)
+#define BENCH_SANITIZED             1
+#endif
+#endif
+#if defined(__GLIBC__) && !defined(__SANITIZE_ADDRESS__) && !defined(BENCH_SANITIZED)
+#define BENCH_COUNT_ALLOCATIONS     1
+#endif
+
+// synthetic archive, all numbers are big-endian
+// header: magic, uint16 version, uint16 reserved, uint32 entryCount, uint64 directoryOffset
+// entries: a NEST chunk each. chunks are a uint32 tag, a uint32 payload length, then payload:
+//  RECS: varint count, then count records of varint id, zigzag value and C string label
+//  ARRY: uint32 count, then count uint32
+//  NEST: chunks
+// directory: entryCount times a UTF-16 name, uint64 offset and uint64 size
+#define BENCH_ARCHIVE_MAGIC         ((uint32_t) 0x41434152)    // 'ACAR'
+#define BENCH_ARCHIVE_VERSION       ((uint16_t) 1)
+#define BENCH_ARCHIVE_ENTRIES       ((size_t) 64)
+#define BENCH_ARCHIVE_MAX_DEPTH     3
+#define BENCH_CHUNK_RECORDS         ((uint32_t) 0x52454353)    // 'RECS'
+#define BENCH_CHUNK_ARRAY           ((uint32_t) 0x41525259)    // 'ARRY'
+#define BENCH_CHUNK_NEST            ((uint32_t) 0x4e455354)    // 'NEST'
+
+
+// benchmark state, shared by all benchmark bodies
+typedef struct
+{
+    accessor_t * a;
+    accessorEndianness e;
+    size_t count;                   // operations per iteration
+    const char * delimiter;
+    size_t delimiterLength;
+    uint64_t * values;              // count values to write
+    accessorCoverageOption coverage;
+    uint64_t expected;              // expected checksum of parsed data
+} benchContext;
+
+typedef void (* benchBody)(benchContext * c, size_t iterations);
+
+// benchmarks of a group differ by their body and endianness
+typedef struct
+{
+    const char * name;
+    benchBody body;
+    size_t bytesPerOp;
+    accessorEndianness e;
+} benchCase;
+
+typedef struct
+{
+    double medianNs;                // per operation
+    double p10Ns;
+    double p90Ns;
+    double medianLowNs;             // about 95% confidence interval of median
+    double medianHighNs;
+    double gbps;
+    double allocationsPerOp;        // negative if allocations aren't counted
+    double counters[benchCounterCount];     // per byte if bytesPerOp > 0, per operation otherwise. negative if unavailable
+} benchResult;
+
+// a benchmark of --baseline file
+typedef struct
+{
+    char name[BENCH_MAX_NAME_LENGTH];
+    double medianNs;
+    double medianLowNs;
+    double medianHighNs;
+    int compared;
+} benchBaseline;
+
+
+// global variables
+static uint64_t benchSeed = BENCH_DEFAULT_SEED;
+static size_t benchRepetitions = BENCH_DEFAULT_REPETITIONS;
+static size_t benchWarmups = BENCH_DEFAULT_WARMUPS;
+static const char * benchFilter = NULL;
+static int benchCpu = -2;                                   // -2: current cpu, -1: no pinning
+static int benchCounters = 0;                               // --counters
+static FILE * benchJson = NULL;
+static volatile uint64_t benchSink;                         // results are accumulated here, so that compilers can't discard benchmarked code
+static uint64_t benchAllocationCount = 0;                   // malloc, calloc and realloc calls
+static double benchThreshold = BENCH_DEFAULT_THRESHOLD;
+static benchBaseline benchBaselines[BENCH_MAX_BASELINES];
+static size_t benchBaselineCount = 0;
+static size_t benchRegressionCount = 0;
+static size_t benchImprovementCount = 0;
+
+// prototypes
+benchResult benchMeasure(const char * name, benchBody body, benchContext * c, size_t bytesPerOp);
+void benchLoadBaseline(const char * path);
+void benchCompare(const char * name, const benchResult * r);
+
+void benchScalarReads(void);
+void benchScalarWrites(void);
+void benchArrays(void);
+void benchStrings(void);
+void benchVarInts(void);
+void benchDelimiters(void);
+void benchSubAccessors(void);
+void benchCursorStack(void);
+void benchCoverage(void);
+void benchWorkload(void);
+
+
+
+int main(int argc, char *argv[])
+{
+    for (int i = 1; i < argc; i++)
+    {
+        if (i + 1 < argc && strcmp(argv[i], "--filter") == 0)
+            benchFilter = argv[++i];
+        else if (i + 1 < argc && strcmp(argv[i], "--repetitions") == 0)
+            benchRepetitions = strtoul(argv[++i], NULL, 0);
+        else if (i + 1 < argc && strcmp(argv[i], "--warmups") == 0)
+            benchWarmups = strtoul(argv[++i], NULL, 0);
+        else if (i + 1 < argc && strcmp(argv[i], "--seed") == 0)
+            benchSeed = strtoull(argv[++i], NULL, 0);
+        else if (i + 1 < argc && strcmp(argv[i], "--cpu") == 0)
+            benchCpu = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--counters") == 0)
+            benchCounters = 1;
+        else if (i + 1 < argc && strcmp(argv[i], "--baseline") == 0)
+            benchLoadBaseline(argv[++i]);
+        else if (i + 1 < argc && strcmp(argv[i], "--threshold") == 0)
+            benchThreshold = strtod(argv[++i], NULL);
+        else if (i + 1 < argc && strcmp(argv[i], "--json") == 0)
+        {
+            i++;
+            benchJson = strcmp(argv[i], "-") == 0 ? stdout : fopen(argv[i], "w");
+            if (benchJson == NULL)
+            {
+                perror(argv[i]);
+                return 1;
+            }
+        }
+        else
+        {
+            fprintf(stderr, "usage: %s [--filter substring] [--repetitions n] [--warmups n] [--seed n] [--cpu n|-1] [--counters] [--json file|-] [--baseline file] [--threshold percent]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    if (benchRepetitions < 1)
+        benchRepetitions = 1;
+    if (benchRepetitions > BENCH_MAX_REPETITIONS)
+        benchRepetitions = BENCH_MAX_REPETITIONS;
+
+    benchPin(benchCpu);
+    if (benchCounters && benchCountersOpen() == 0)
+    {
+        printf("no counter available, --counters ignored\n");
+        benchCounters = 0;
+    }
+    printf("accessor build %u, seed 0x%016llx, %zu repetitions, %zu warmups\n", accessorBuildNumber(), (unsigned long long) benchSeed, benchRepetitions, benchWarmups);
+    printf("%-32s %12s %12s %12s %10s %10s\n", "benchmark", "median ns/op", "p10 ns/op", "p90 ns/op", "GB/s", "allocs/op");
+
+    benchScalarReads();
+    benchScalarWrites();
+    benchArrays();
+    benchStrings();
+    benchVarInts();
+    benchDelimiters();
+    benchSubAccessors();
+    benchCursorStack();
+    benchCoverage();
+    benchWorkload();
+
+    if (benchCounters)
+        benchCountersClose();
+    if (benchJson != NULL && benchJson != stdout)
+        fclose(benchJson);
+
+    if (benchBaselineCount > 0)
+    {
+        for (size_t i = 0; i < benchBaselineCount; i++)
+            if (!benchBaselines[i].compared && (benchFilter == NULL || strstr(benchBaselines[i].name, benchFilter) != NULL))
+                printf("%-32s missing, in baseline only\n", benchBaselines[i].name);
+        printf("baseline comparison: %zu regressions, %zu improvements, threshold %.1f%%\n", benchRegressionCount, benchImprovementCount, benchThreshold);
+    }
+
+    return benchRegressionCount > 0 ? 1 : 0;
+}
+
+
+
+#ifdef BENCH_COUNT_ALLOCATIONS
+extern void * __libc_malloc(size_t size);
+extern void * __libc_calloc(size_t count, size_t size);
+extern void * __libc_realloc(void * ptr, size_t size);
+
+// free() needs no interposition, memory still comes from glibc's allocator
+void * malloc(size_t size)
+{
+    benchAllocationCount++;
+    return __libc_malloc(size);
+}
+
+
+
+void * calloc(size_t count, size_t size)
+{
+    benchAllocationCount++;
+    return __libc_calloc(count, size);
+}
+
+
+
+void * realloc(void * ptr, size_t size)
+{
+    benchAllocationCount++;
+    return __libc_realloc(ptr, size);
+}
+#endif
+
+
+
+// calibrate, warm up, then time repetitions of body. each iteration of body does c->count operations
+benchResult benchMeasure(const char * name, benchBody body, benchContext * c, size_t bytesPerOp)
+{
+    double nsPerOp[BENCH_MAX_REPETITIONS];
+    size_t iterations;
+    uint64_t elapsed;
+    uint64_t allocations;
+    benchResult r = { 0, 0, 0, 0, 0, 0, -1, { 0 } };
+    char allocationsText[32];
+    char countersText[256];
+    char countersJson[512];
+    size_t length;
+    double units;
+
+
+    if (benchFilter != NULL && strstr(name, benchFilter) == NULL)
+        return r;
+
+    // double iterations until a run is long enough to be timed, then scale to target duration
+    iterations = 1;
+    for (;;)
+    {
+        elapsed = benchNow();
+        body(c, iterations);
+        elapsed = benchNow() - elapsed;
+        if (elapsed >= BENCH_TARGET_NS / 16)
+            break;
+        iterations *= 2;
+    }
+    iterations = (size_t) ((double) iterations * BENCH_TARGET_NS / (double) elapsed) + 1;
+
+    for (size_t i = 0; i < benchWarmups; i++)
+        body(c, iterations);
+
+    allocations = benchAllocationCount;
+    for (size_t i = 0; i < benchRepetitions; i++)
+    {
+        elapsed = benchNow();
+        body(c, iterations);
+        elapsed = benchNow() - elapsed;
+        nsPerOp[i] = (double) elapsed / ((double) iterations * (double) c->count);
+    }
+    allocations = benchAllocationCount - allocations;
+
+    // counted repetition is separate, so that counter control doesn't disturb timings
+    for (int i = 0; i < benchCounterCount; i++)
+        r.counters[i] = -1;
+    if (benchCounters)
+    {
+        benchCountersStart();
+        body(c, iterations);
+        benchCountersStop(r.counters);
+        units = (double) iterations * (double) c->count * (double) (bytesPerOp > 0 ? bytesPerOp : 1);
+        for (int i = 0; i < benchCounterCount; i++)
+            if (r.counters[i] >= 0)
+                r.counters[i] /= units;
+    }
+
+    qsort(nsPerOp, benchRepetitions, sizeof(*nsPerOp), benchCompareDouble);
+    r.medianNs = benchPercentile(nsPerOp, benchRepetitions, 50);
+    r.p10Ns = benchPercentile(nsPerOp, benchRepetitions, 10);
+    r.p90Ns = benchPercentile(nsPerOp, benchRepetitions, 90);
+    benchMedianInterval(nsPerOp, benchRepetitions, &r.medianLowNs, &r.medianHighNs);
+    r.gbps = bytesPerOp / r.medianNs;         // bytes per ns are GB/s
+#ifdef BENCH_COUNT_ALLOCATIONS
+    r.allocationsPerOp = (double) allocations / ((double) benchRepetitions * (double) iterations * (double) c->count);
+    snprintf(allocationsText, sizeof(allocationsText), "%.3f", r.allocationsPerOp);
+#else
+    snprintf(allocationsText, sizeof(allocationsText), "-");
+#endif
+
+    if (bytesPerOp > 0)
+        printf("%-32s %12.3f %12.3f %12.3f %10.3f %10s\n", name, r.medianNs, r.p10Ns, r.p90Ns, r.gbps, allocationsText);
+    else
+        printf("%-32s %12.3f %12.3f %12.3f %10s %10s\n", name, r.medianNs, r.p10Ns, r.p90Ns, "-", allocationsText);
+
+    snprintf(countersJson, sizeof(countersJson), "null");
+    if (benchCounters)
+    {
+        length = (size_t) snprintf(countersText, sizeof(countersText), "    per %s:", bytesPerOp > 0 ? "byte" : "op");
+        if (r.counters[benchCounterCycles] > 0 && r.counters[benchCounterInstructions] >= 0)
+            length += (size_t) snprintf(countersText + length, sizeof(countersText) - length, " IPC %.2f", r.counters[benchCounterInstructions] / r.counters[benchCounterCycles]);
+        for (int i = 0; i < benchCounterCount && length < sizeof(countersText); i++)
+        {
+            if (r.counters[i] >= 0)
+                length += (size_t) snprintf(countersText + length, sizeof(countersText) - length, " %s %.4f", benchCounterName(i), r.counters[i]);
+            else
+                length += (size_t) snprintf(countersText + length, sizeof(countersText) - length, " %s -", benchCounterName(i));
+        }
+        printf("%s\n", countersText);
+
+        length = (size_t) snprintf(countersJson, sizeof(countersJson), "{\"unit\":\"%s\"", bytesPerOp > 0 ? "byte" : "op");
+        for (int i = 0; i < benchCounterCount && length < sizeof(countersJson); i++)
+        {
+            if (r.counters[i] >= 0)
+                length += (size_t) snprintf(countersJson + length, sizeof(countersJson) - length, ",\"%s\":%.6f", benchCounterName(i), r.counters[i]);
+            else
+                length += (size_t) snprintf(countersJson + length, sizeof(countersJson) - length, ",\"%s\":null", benchCounterName(i));
+        }
+        if (length < sizeof(countersJson))
+            snprintf(countersJson + length, sizeof(countersJson) - length, "}");
+    }
+    fflush(stdout);
+
+    if (benchJson != NULL)
+        fprintf(benchJson, "{\"name\":\"%s\",\"build\":%u,\"seed\":%llu,\"repetitions\":%zu,\"iterations\":%zu,\"opsPerIteration\":%zu,\"bytesPerOp\":%zu,\"medianNs\":%.4f,\"p10Ns\":%.4f,\"p90Ns\":%.4f,\"medianLowNs\":%.4f,\"medianHighNs\":%.4f,\"gbps\":%.4f,\"allocationsPerOp\":%s,\"counters\":%s}\n",
+                name, accessorBuildNumber(), (unsigned long long) benchSeed, benchRepetitions, iterations, c->count, bytesPerOp, r.medianNs, r.p10Ns, r.p90Ns, r.medianLowNs, r.medianHighNs, r.gbps, r.allocationsPerOp < 0 ? "null" : allocationsText, countersJson);
+
+    benchCompare(name, &r);
+
+    return r;
+}
+
+
+
+// read the JSON lines written by --json. only the fields needed for comparison are parsed
+void benchLoadBaseline(const char * path)
+{
+    FILE * file;
+    char line[4096];
+    const char * field;
+    size_t length;
+    benchBaseline * b;
+
+
+    file = fopen(path, "r");
+    if (file == NULL)
+    {
+        perror(path);
+        exit(1);
+    }
+
+    while (fgets(line, sizeof(line), file) != NULL && benchBaselineCount < BENCH_MAX_BASELINES)
+    {
+        b = &benchBaselines[benchBaselineCount];
+        field = strstr(line, "\"name\":\"");
+        if (field == NULL)
+            continue;
+        field += strlen("\"name\":\"");
+        length = strcspn(field, "\"");
+        if (length >= sizeof(b->name))
+            continue;
+        memcpy(b->name, field, length);
+        b->name[length] = 0;
+
+        field = strstr(line, "\"medianNs\":");
+        if (field == NULL)
+            continue;
+        b->medianNs = strtod(field + strlen("\"medianNs\":"), NULL);
+
+        // baselines without intervals are compared to their median only
+        field = strstr(line, "\"medianLowNs\":");
+        b->medianLowNs = field != NULL ? strtod(field + strlen("\"medianLowNs\":"), NULL) : b->medianNs;
+        field = strstr(line, "\"medianHighNs\":");
+        b->medianHighNs = field != NULL ? strtod(field + strlen("\"medianHighNs\":"), NULL) : b->medianNs;
+
+        b->compared = 0;
+        benchBaselineCount++;
+    }
+    fclose(file);
+
+    if (benchBaselineCount == 0)
+    {
+        fprintf(stderr, "%s: no benchmark found\n", path);
+        exit(1);
+    }
+}
+
+
+
+// a change is significant if it exceeds threshold and confidence intervals don't overlap
+void benchCompare(const char * name, const benchResult * r)
+{
+    benchBaseline * b = NULL;
+    double change;
+    const char * verdict;
+
+
+    if (benchBaselineCount == 0)
+        return;
+
+    for (size_t i = 0; i < benchBaselineCount && b == NULL; i++)
+        if (strcmp(benchBaselines[i].name, name) == 0)
+            b = &benchBaselines[i];
+    if (b == NULL)
+    {
+        printf("    new, not in baseline\n");
+        return;
+    }
+    b->compared = 1;
+
+    change = (r->medianNs - b->medianNs) * 100 / b->medianNs;
+    if (change > benchThreshold && r->medianLowNs > b->medianHighNs)
+    {
+        verdict = "REGRESSION";
+        benchRegressionCount++;
+    }
+    else if (change < -benchThreshold && r->medianHighNs < b->medianLowNs)
+    {
+        verdict = "improvement";
+        benchImprovementCount++;
+    }
+    else
+        verdict = "unchanged";
+
+    printf("    baseline %.3f [%.3f, %.3f] ns/op, now %.3f [%.3f, %.3f] ns/op, %+.1f%%, %s\n",
+           b->medianNs, b->medianLowNs, b->medianHighNs, r->medianNs, r->medianLowNs, r->medianHighNs, change, verdict);
+}
+
+
+
+// scalar reads and writes
+
+static void benchReadUInt8(benchContext * c, size_t iterations)
+{
+    uint64_t sum = 0;
+    uint8_t x;
+
+
+    for (size_t i = 0; i < iterations; i++)
+    {
+        BENCH_CHECK(accessorSeek(c->a, 0, SEEK_SET));
+        for (size_t j = 0; j < c->count; j++)
+        {
+            BENCH_CHECK(accessorReadUInt8(c->a, &x));
+            sum += x;
+        }
+    }
+    benchSink += sum;
+}
+
+
+
+static void benchReadUInt16(benchContext * c, size_t iterations)
+{
+    uint64_t sum = 0;
+    uint16_t x;
+
+
+    for (size_t i = 0; i < iterations; i++)
+    {
+        BENCH_CHECK(accessorSeek(c->a, 0, SEEK_SET));
+        for (size_t j = 0; j < c->count; j++)
+        {
+            BENCH_CHECK(accessorReadEndianUInt16(c->a, &x, c->e));
+            sum += x;
+        }
+    }
+    benchSink += sum;
+}
+
+
+
+static void benchReadUInt24(benchContext * c, size_t iterations)
+{
+    uint64_t sum = 0;
+    uint32_t x;
+
+
+    for (size_t i = 0; i < iterations; i++)
+    {
+        BENCH_CHECK(accessorSeek(c->a, 0, SEEK_SET));
+        for (size_t j = 0; j < c->count; j++)
+        {
+            BENCH_CHECK(accessorReadEndianUInt24(c->a, &x, c->e));
+            sum += x;
+        }
+    }
+    benchSink += sum;
+}
+
+
+
+static void benchReadUInt32(benchContext * c, size_t iterations)
+{
+    uint64_t sum = 0;
+    uint32_t x;
+
+
+    for (size_t i = 0; i < iterations; i++)
+    {
+        BENCH_CHECK(accessorSeek(c->a, 0, SEEK_SET));
+        for (size_t j = 0; j < c->count; j++)
+        {
+            BENCH_CHECK(accessorReadEndianUInt32(c->a, &x, c->e));
+            sum += x;
+        }
+    }
+    benchSink += sum;
+}
+
+
+
+static void benchReadUInt64(benchContext * c, size_t iterations)
+{
+    uint64_t sum = 0;
+    uint64_t x;
+
+
+    for (size_t i = 0; i < iterations; i++)
+    {
+        BENCH_CHECK(accessorSeek(c->a, 0, SEEK_SET));
+        for (size_t j = 0; j < c->count; j++)
+        {
+            BENCH_CHECK(accessorReadEndianUInt64(c->a, &x, c->e));
+            sum += x;
+        }
+    }
+    benchSink += sum;
+}
+
+
+
+static void benchWriteUInt8(benchContext * c, size_t iterations)
+{
+    for (size_t i = 0; i < iterations; i++)
+    {
+        BENCH_CHECK(accessorSeek(c->a, 0, SEEK_SET));
+        for (size_t j = 0; j < c->count; j++)
+            BENCH_CHECK(accessorWriteUInt8(c->a, (uint8_t) c->values[j]));
+    }
+}
+
+
+
+static void benchWriteUInt16(benchContext * c, size_t iterations)
+{
+    for (size_t i = 0; i < iterations; i++)
+    {
+        BENCH_CHECK(accessorSeek(c->a, 0, SEEK_SET));
+        for (size_t j = 0; j < c->count; j++)
+            BENCH_CHECK(accessorWriteEndianUInt16(c->a, (uint16_t) c->values[j], c->e));
+    }
+}
+
+
+
+static void benchWriteUInt24(benchContext * c, size_t iterations)
+{
+    for (size_t i = 0; i < iterations; i++)
+    {
+        BENCH_CHECK(accessorSeek(c->a, 0, SEEK_SET));
+        for (size_t j = 0; j < c->count; j++)
+            BENCH_CHECK(accessorWriteEndianUInt24(c->a, (uint32_t) c->values[j] & 0xffffff, c->e));
+    }
+}
+
+
+
+static void benchWriteUInt32(benchContext * c, size_t iterations)
+{
+    for (size_t i = 0; i < iterations; i++)
+    {
+        BENCH_CHECK(accessorSeek(c->a, 0, SEEK_SET));
+        for (size_t j = 0; j < c->count; j++)
+            BENCH_CHECK(accessorWriteEndianUInt32(c->a, (uint32_t) c->values[j], c->e));
+    }
+}
+
+
+
+static void benchWriteUInt64(benchContext * c, size_t iterations)
+{
+    for (size_t i = 0; i < iterations; i++)
+    {
+        BENCH_CHECK(accessorSeek(c->a, 0, SEEK_SET));
+        for (size_t j = 0; j < c->count; j++)
+            BENCH_CHECK(accessorWriteEndianUInt64(c->a, c->values[j], c->e));
+    }
+}
+
+
+
+static void benchWriteSpanUInt32(benchContext * c, size_t iterations)
+{
+    accessorWriteSpan span;
+
+
+    for (size_t i = 0; i < iterations; i++)
+    {
+        BENCH_CHECK(accessorSeek(c->a, 0, SEEK_SET));
+        BENCH_CHECK(accessorOpenWriteSpan(c->a, &span, c->count * 4));
+        if (c->e == accessorBig)
+            for (size_t j = 0; j < c->count; j++)
+                accessorSpanWriteBigUInt32(&span, (uint32_t) c->values[j]);
+        else
+            for (size_t j = 0; j < c->count; j++)
+                accessorSpanWriteLittleUInt32(&span, (uint32_t) c->values[j]);
+        BENCH_CHECK(accessorCloseWriteSpan(c->a, &span));
+    }
+}
+
+
+
+static void benchWriteSpanUInt64(benchContext * c, size_t iterations)
+{
+    accessorWriteSpan span;
+
+
+    for (size_t i = 0; i < iterations; i++)
+    {
+        BENCH_CHECK(accessorSeek(c->a, 0, SEEK_SET));
+        BENCH_CHECK(accessorOpenWriteSpan(c->a, &span, c->count * 8));
+        if (c->e == accessorBig)
+            for (size_t j = 0; j < c->count; j++)
+                accessorSpanWriteBigUInt64(&span, c->values[j]);
+        else
+            for (size_t j = 0; j < c->count; j++)
+                accessorSpanWriteLittleUInt64(&span, c->values[j]);
+        BENCH_CHECK(accessorCloseWriteSpan(c->a, &span));
+    }
+}
+
+
+
+void benchScalarReads(void)
+{
+    static const benchCase cases[] =
+    {
+        { "read/uint8",             benchReadUInt8,  1, accessorBig    },
+        { "read/uint16-big",        benchReadUInt16, 2, accessorBig    },
+        { "read/uint16-little",     benchReadUInt16, 2, accessorLittle },
+        { "read/uint24-big",        benchReadUInt24, 3, accessorBig    },
+        { "read/uint24-little",     benchReadUInt24, 3, accessorLittle },
+        { "read/uint32-big",        benchReadUInt32, 4, accessorBig    },
+        { "read/uint32-little",     benchReadUInt32, 4, accessorLittle },
+        { "read/uint64-big",        benchReadUInt64, 8, accessorBig    },
+        { "read/uint64-little",     benchReadUInt64, 8, accessorLittle },
+    };
+    benchContext c = { 0 };
+    uint8_t * buffer;
+
+
+    benchSeedRandom(benchSeed);
+    buffer = malloc(BENCH_BUFFER_SIZE);
+    if (buffer == NULL)
+        benchFailure(__FILE__, __LINE__);
+    for (size_t i = 0; i < BENCH_BUFFER_SIZE; i++)
+        buffer[i] = (uint8_t) benchRandom();
+
+    c.a = ACCESSOR_INIT;
+    BENCH_CHECK(accessorOpenReadingMemory(&c.a, buffer, BENCH_BUFFER_SIZE, accessorFreeOnClose, 0, ACCESSOR_UNTIL_END));
+    c.count = BENCH_VALUE_COUNT;
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+    {
+        c.e = cases[i].e;
+        benchMeasure(cases[i].name, cases[i].body, &c, cases[i].bytesPerOp);
+    }
+    BENCH_CHECK(accessorClose(&c.a));
+}
+
+
+
+void benchScalarWrites(void)
+{
+    static const benchCase cases[] =
+    {
+        { "write/uint8",            benchWriteUInt8,      1, accessorBig    },
+        { "write/uint16-big",       benchWriteUInt16,     2, accessorBig    },
+        { "write/uint16-little",    benchWriteUInt16,     2, accessorLittle },
+        { "write/uint24-big",       benchWriteUInt24,     3, accessorBig    },
+        { "write/uint24-little",    benchWriteUInt24,     3, accessorLittle },
+        { "write/uint32-big",       benchWriteUInt32,     4, accessorBig    },
+        { "write/uint32-little",    benchWriteUInt32,     4, accessorLittle },
+        { "write/uint64-big",       benchWriteUInt64,     8, accessorBig    },
+        { "write/uint64-little",    benchWriteUInt64,     8, accessorLittle },
+        { "write-span/uint32-big",  benchWriteSpanUInt32, 4, accessorBig    },
+        { "write-span/uint32-little", benchWriteSpanUInt32, 4, accessorLittle },
+        { "write-span/uint64-big",  benchWriteSpanUInt64, 8, accessorBig    },
+        { "write-span/uint64-little", benchWriteSpanUInt64, 8, accessorLittle },
+    };
+    benchContext c = { 0 };
+
+
+    benchSeedRandom(benchSeed);
+    c.values = malloc(BENCH_VALUE_COUNT * sizeof(*c.values));
+    if (c.values == NULL)
+        benchFailure(__FILE__, __LINE__);
+    for (size_t i = 0; i < BENCH_VALUE_COUNT; i++)
+        c.values[i] = benchRandom();
+
+    // writes overwrite existing data, so that only write paths are measured, not accessor growth
+    c.a = ACCESSOR_INIT;
+    BENCH_CHECK(accessorOpenWritingMemory(&c.a, BENCH_BUFFER_SIZE, 0));
+    BENCH_CHECK(accessorWriteRepeatedByte(c.a, 0, BENCH_BUFFER_SIZE));
+    c.count = BENCH_VALUE_COUNT;
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+    {
+        c.e = cases[i].e;
+        benchMeasure(cases[i].name, cases[i].body, &c, cases[i].bytesPerOp);
+    }
+    BENCH_CHECK(accessorClose(&c.a));
+    free(c.values);
+}
+
+
+
+// arrays
+
+static void benchReadUInt32Array(benchContext * c, size_t iterations)
+{
+    uint32_t * array;
+
+
+    for (size_t i = 0; i < iterations; i++)
+    {
+        BENCH_CHECK(accessorSeek(c->a, 0, SEEK_SET));
+        BENCH_CHECK(accessorReadEndianUInt32Array(c->a, &array, c->count, c->e));
+        benchSink += array[c->count - 1];
+        free(array);
+    }
+}
+
+
+
+static void benchReadUInt64Array(benchContext * c, size_t iterations)
+{
+    uint64_t * array;
+
+
+    for (size_t i = 0; i < iterations; i++)
+    {
+        BENCH_CHECK(accessorSeek(c->a, 0, SEEK_SET));
+        BENCH_CHECK(accessorReadEndianUInt64Array(c->a, &array, c->count, c->e));
+        benchSink += array[c->count - 1];
+        free(array);
+    }
+}
+
+
+
+void benchArrays(void)
+{
+    static const benchCase cases[] =
+    {
+        { "array/uint32-big",       benchReadUInt32Array, 4, accessorBig    },
+        { "array/uint32-little",    benchReadUInt32Array, 4, accessorLittle },
+        { "array/uint64-big",       benchReadUInt64Array, 8, accessorBig    },
+        { "array/uint64-little",    benchReadUInt64Array, 8, accessorLittle },
+    };
+    benchContext c = { 0 };
+    uint8_t * buffer;
+
+
+    benchSeedRandom(benchSeed);
+    buffer = malloc(BENCH_BUFFER_SIZE);
+    if (buffer == NULL)
+        benchFailure(__FILE__, __LINE__);
+    for (size_t i = 0; i < BENCH_BUFFER_SIZE; i++)
+        buffer[i] = (uint8_t) benchRandom();
+
+    c.a = ACCESSOR_INIT;
+    BENCH_CHECK(accessorOpenReadingMemory(&c.a, buffer, BENCH_BUFFER_SIZE, accessorFreeOnClose, 0, ACCESSOR_UNTIL_END));
+    c.count = BENCH_VALUE_COUNT;        // elements per array, reported times are per element
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+    {
+        c.e = cases[i].e;
+        benchMeasure(cases[i].name, cases[i].body, &c, cases[i].bytesPerOp);
+    }
+    BENCH_CHECK(accessorClose(&c.a));
+}
+
+
+
+// strings
+
+static void benchReadCString(benchContext * c, size_t iterations)
+{
+    char * str;
+    size_t length;
+
+
+    for (size_t i = 0; i < iterations; i++)
+    {
+        BENCH_CHECK(accessorSeek(c->a, 0, SEEK_SET));
+        for (size_t j = 0; j < c->count; j++)
+        {
+            BENCH_CHECK(accessorReadCString(c->a, &str, &length));
+            benchSink += length;
+            free(str);
+        }
+    }
+}
+
+
+
+static const char * benchStringsToWrite[] = { "", "a", "name", "a somewhat longer string", "/usr/local/lib/libaccessor.a", "0123456789abcdef0123456789abcdef0123456789abcdef" };
+#define BENCH_STRINGS_TO_WRITE_COUNT    (sizeof(benchStringsToWrite) / sizeof(benchStringsToWrite[0]))
+
+
+
+static void benchWriteCString(benchContext * c, size_t iterations)
+{
+    for (size_t i = 0; i < iterations; i++)
+    {
+        BENCH_CHECK(accessorSeek(c->a, 0, SEEK_SET));
+        for (size_t j = 0; j < c->count; j++)
+            BENCH_CHECK(accessorWriteCString(c->a, benchStringsToWrite[c->values[j]]));
+    }
+}
+
+
+
+void benchStrings(void)
+{
+    benchContext c = { 0 };
+    size_t length;
+    size_t totalLength;
+
+
+    // c.count NUL terminated strings of 0 to 63 random printable chars
+    benchSeedRandom(benchSeed);
+    c.count = BENCH_VALUE_COUNT;
+    c.a = ACCESSOR_INIT;
+    BENCH_CHECK(accessorOpenWritingMemory(&c.a, 0, 0));
+    totalLength = 0;
+    for (size_t i = 0; i < c.count; i++)
+    {
+        length = benchRandom() % 64;
+        for (size_t j = 0; j < length; j++)
+            BENCH_CHECK(accessorWriteUInt8(c.a, (uint8_t) (' ' + benchRandom() % 95)));
+        BENCH_CHECK(accessorWriteUInt8(c.a, 0));
+        totalLength += length + 1;
+    }
+    BENCH_CHECK(accessorSeek(c.a, 0, SEEK_SET));
+    benchMeasure("string/read-cstring", benchReadCString, &c, totalLength / c.count);
+    BENCH_CHECK(accessorClose(&c.a));
+
+    c.values = malloc(c.count * sizeof(*c.values));
+    if (c.values == NULL)
+        benchFailure(__FILE__, __LINE__);
+    totalLength = 0;
+    for (size_t i = 0; i < c.count; i++)
+    {
+        c.values[i] = benchRandom() % BENCH_STRINGS_TO_WRITE_COUNT;
+        totalLength += strlen(benchStringsToWrite[c.values[i]]) + 1;
+    }
+    BENCH_CHECK(accessorOpenWritingMemory(&c.a, 0, 0));
+    benchMeasure("string/write-cstring", benchWriteCString, &c, totalLength / c.count);
+    BENCH_CHECK(accessorClose(&c.a));
+    free(c.values);
+}
+
+
+
+// varints
+
+static void benchReadVarInt(benchContext * c, size_t iterations)
+{
+    uint64_t sum = 0;
+    uintmax_t x;
+
+
+    for (size_t i = 0; i < iterations; i++)
+    {
+        BENCH_CHECK(accessorSeek(c->a, 0, SEEK_SET));
+        for (size_t j = 0; j < c->count; j++)
+        {
+            BENCH_CHECK(accessorReadVarInt(c->a, &x));
+            sum += x;
+        }
+    }
+    benchSink += sum;
+}
+
+
+
+static void benchWriteVarInt(benchContext * c, size_t iterations)
+{
+    for (size_t i = 0; i < iterations; i++)
+    {
+        BENCH_CHECK(accessorSeek(c->a, 0, SEEK_SET));
+        for (size_t j = 0; j < c->count; j++)
+            BENCH_CHECK(accessorWriteVarInt(c->a, c->values[j]));
+    }
+}
+
+
+
+void benchVarInts(void)
+{
+    benchContext c = { 0 };
+
+
+    // values of uniformly distributed bit lengths, so that all varint sizes are represented
+    benchSeedRandom(benchSeed);
+    c.count = BENCH_VALUE_COUNT;
+    c.values = malloc(c.count * sizeof(*c.values));
+    if (c.values == NULL)
+        benchFailure(__FILE__, __LINE__);
+    for (size_t i = 0; i < c.count; i++)
+        c.values[i] = benchRandomBitLength();
+
+    c.a = ACCESSOR_INIT;
+    BENCH_CHECK(accessorOpenWritingMemory(&c.a, 0, 0));
+    for (size_t i = 0; i < c.count; i++)
+        BENCH_CHECK(accessorWriteVarInt(c.a, c.values[i]));
+    benchMeasure("varint/write", benchWriteVarInt, &c, accessorSize(c.a) / c.count);
+    benchMeasure("varint/read", benchReadVarInt, &c, accessorSize(c.a) / c.count);
+    BENCH_CHECK(accessorClose(&c.a));
+    free(c.values);
+}
+
+
+
+// delimiter look-ahead
+
+static void benchCountBeforeDelimiter(benchContext * c, size_t iterations)
+{
+    size_t count;
+
+
+    for (size_t i = 0; i < iterations; i++)
+    {
+        BENCH_CHECK(accessorSeek(c->a, 0, SEEK_SET));
+        for (size_t j = 0; j < c->count; j++)
+        {
+            BENCH_CHECK(accessorLookAheadCountBytesBeforeDelimiter(c->a, &count, ACCESSOR_UNTIL_END, c->delimiterLength, c->delimiter));
+            BENCH_CHECK(accessorSeek(c->a, (ssize_t) (count + c->delimiterLength), SEEK_CUR));
+            benchSink += count;
+        }
+    }
+}
+
+
+
+void benchDelimiters(void)
+{
+    static const struct
+    {
+        const char * name;
+        const char * delimiter;
+    } cases[] =
+    {
+        { "lookahead/delimiter-lf",   "\n"   },
+        { "lookahead/delimiter-crlf", "\r\n" },
+    };
+    benchContext c = { 0 };
+    size_t length;
+
+
+    c.count = BENCH_VALUE_COUNT;
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+    {
+        // c.count lines of 0 to 79 random letters
+        benchSeedRandom(benchSeed);
+        c.delimiter = cases[i].delimiter;
+        c.delimiterLength = strlen(cases[i].delimiter);
+        c.a = ACCESSOR_INIT;
+        BENCH_CHECK(accessorOpenWritingMemory(&c.a, 0, 0));
+        for (size_t j = 0; j < c.count; j++)
+        {
+            length = benchRandom() % 80;
+            for (size_t k = 0; k < length; k++)
+                BENCH_CHECK(accessorWriteUInt8(c.a, (uint8_t) ('a' + benchRandom() % 26)));
+            BENCH_CHECK(accessorWriteBytes(c.a, c.delimiter, c.delimiterLength));
+        }
+        benchMeasure(cases[i].name, benchCountBeforeDelimiter, &c, accessorSize(c.a) / c.count);
+        BENCH_CHECK(accessorClose(&c.a));
+    }
+}
+
+
+
+// sub-accessors, cursor stack and coverage
+
+static void benchOpenCloseWindow(benchContext * c, size_t iterations)
+{
+    accessor_t * sub = ACCESSOR_INIT;
+
+
+    for (size_t i = 0; i < iterations; i++)
+        for (size_t j = 0; j < c->count; j++)
+        {
+            BENCH_CHECK(accessorOpenReadingAccessorWindow(&sub, c->a, j, 16));
+            BENCH_CHECK(accessorClose(&sub));
+        }
+}
+
+
+
+// a chain of c->count sub-accessors, each a window on the previous one, closed outermost first as parsers drop finished levels
+static void benchNestedWindows(benchContext * c, size_t iterations)
+{
+    static accessor_t * chain[BENCH_NEST_DEPTH];
+
+
+    for (size_t i = 0; i < iterations; i++)
+    {
+        BENCH_CHECK(accessorOpenReadingAccessorWindow(&chain[0], c->a, 1, ACCESSOR_UNTIL_END));
+        for (size_t j = 1; j < c->count; j++)
+            BENCH_CHECK(accessorOpenReadingAccessorWindow(&chain[j], chain[j - 1], 1, ACCESSOR_UNTIL_END));
+        for (size_t j = 0; j < c->count; j++)
+            BENCH_CHECK(accessorClose(&chain[j]));
+    }
+}
+
+
+
+static void benchPushPopCursor(benchContext * c, size_t iterations)
+{
+    for (size_t i = 0; i < iterations; i++)
+        for (size_t j = 0; j < c->count; j++)
+        {
+            BENCH_CHECK(accessorPushCursor(c->a));
+            BENCH_CHECK(accessorPopCursor(c->a));
+        }
+}
+
+
+
+// coverage array is discarded with its sub-accessor at each iteration, so that it doesn't grow without bounds
+static void benchCoverageReads(benchContext * c, size_t iterations)
+{
+    accessor_t * sub = ACCESSOR_INIT;
+    uint64_t sum = 0;
+    uint32_t x;
+
+
+    for (size_t i = 0; i < iterations; i++)
+    {
+        BENCH_CHECK(accessorOpenReadingAccessorWindow(&sub, c->a, 0, ACCESSOR_UNTIL_END));
+        accessorAllowCoverage(sub, c->coverage);
+        for (size_t j = 0; j < c->count; j++)
+        {
+            BENCH_CHECK(accessorReadEndianUInt32(sub, &x, accessorBig));
+            sum += x;
+        }
+        BENCH_CHECK(accessorClose(&sub));
+    }
+    benchSink += sum;
+}
+
+
+
+void benchSubAccessors(void)
+{
+    benchContext c = { 0 };
+    uint8_t * buffer;
+
+
+    buffer = calloc(BENCH_BUFFER_SIZE, 1);
+    if (buffer == NULL)
+        benchFailure(__FILE__, __LINE__);
+
+    c.a = ACCESSOR_INIT;
+    BENCH_CHECK(accessorOpenReadingMemory(&c.a, buffer, BENCH_BUFFER_SIZE, accessorFreeOnClose, 0, ACCESSOR_UNTIL_END));
+    c.count = BENCH_VALUE_COUNT;
+    benchMeasure("subaccessor/open-close", benchOpenCloseWindow, &c, 0);
+    c.count = BENCH_NEST_DEPTH;
+    benchMeasure("subaccessor/nested-10k", benchNestedWindows, &c, 0);
+    BENCH_CHECK(accessorClose(&c.a));
+}
+
+
+
+void benchCursorStack(void)
+{
+    benchContext c = { 0 };
+    uint8_t buffer[16] = { 0 };
+
+
+    c.a = ACCESSOR_INIT;
+    BENCH_CHECK(accessorOpenReadingMemory(&c.a, buffer, sizeof(buffer), accessorDontFreeOnClose, 0, ACCESSOR_UNTIL_END));
+    c.count = BENCH_VALUE_COUNT;
+    benchMeasure("cursor/push-pop", benchPushPopCursor, &c, 0);
+    BENCH_CHECK(accessorClose(&c.a));
+}
+
+
+
+void benchCoverage(void)
+{
+    benchContext c = { 0 };
+    uint8_t * buffer;
+
+
+    benchSeedRandom(benchSeed);
+    buffer = malloc(BENCH_BUFFER_SIZE);
+    if (buffer == NULL)
+        benchFailure(__FILE__, __LINE__);
+    for (size_t i = 0; i < BENCH_BUFFER_SIZE; i++)
+        buffer[i] = (uint8_t) benchRandom();
+
+    c.a = ACCESSOR_INIT;
+    BENCH_CHECK(accessorOpenReadingMemory(&c.a, buffer, BENCH_BUFFER_SIZE, accessorFreeOnClose, 0, ACCESSOR_UNTIL_END));
+    c.count = BENCH_VALUE_COUNT;
+    c.coverage = accessorDisableCoverage;
+    benchMeasure("coverage/off", benchCoverageReads, &c, 4);
+    c.coverage = accessorEnableCoverage;
+    benchMeasure("coverage/on", benchCoverageReads, &c, 4);
+    BENCH_CHECK(accessorClose(&c.a));
+}
+
+
+
+// reference workload
+
+static void benchWriteRecordsChunk(accessor_t * w, uint64_t * sum)
+{
+    size_t slot;
+    size_t start;
+    size_t count;
+    size_t labelLength;
+    uint64_t id;
+    int64_t value;
+    char label[32];
+
+
+    BENCH_CHECK(accessorWriteUInt32(w, BENCH_CHUNK_RECORDS));
+    BENCH_CHECK(accessorReserveSlot(w, &slot, 4));
+    start = accessorCursor(w);
+
+    count = 100 + benchRandom() % 200;
+    BENCH_CHECK(accessorWriteVarInt(w, count));
+    id = benchRandom() % 1000000;
+    for (size_t i = 0; i < count; i++)
+    {
+        id += 1 + benchRandom() % 16;
+        value = (int64_t) benchRandomBitLength();
+        value -= (int64_t) benchRandomBitLength();
+        labelLength = 4 + benchRandom() % 20;
+        for (size_t j = 0; j < labelLength; j++)
+            label[j] = (char) ('a' + benchRandom() % 26);
+        label[labelLength] = 0;
+
+        BENCH_CHECK(accessorWriteVarInt(w, id));
+        BENCH_CHECK(accessorWriteZigZagInt(w, value));
+        BENCH_CHECK(accessorWriteCString(w, label));
+        *sum += id + (uint64_t) value + labelLength;
+    }
+
+    BENCH_CHECK(accessorSetSlotToLengthSince(w, slot, start));
+}
+
+
+
+static void benchWriteArrayChunk(accessor_t * w, uint64_t * sum)
+{
+    size_t slot;
+    size_t start;
+    uint32_t count;
+    uint32_t x;
+
+
+    BENCH_CHECK(accessorWriteUInt32(w, BENCH_CHUNK_ARRAY));
+    BENCH_CHECK(accessorReserveSlot(w, &slot, 4));
+    start = accessorCursor(w);
+
+    count = (uint32_t) (500 + benchRandom() % 1000);
+    BENCH_CHECK(accessorWriteUInt32(w, count));
+    for (uint32_t i = 0; i < count; i++)
+    {
+        x = (uint32_t) benchRandom();
+        BENCH_CHECK(accessorWriteUInt32(w, x));
+        *sum += x;
+    }
+
+    BENCH_CHECK(accessorSetSlotToLengthSince(w, slot, start));
+}
+
+
+
+static void benchWriteNestChunk(accessor_t * w, int depth, uint64_t * sum)
+{
+    size_t slot;
+    size_t start;
+
+
+    BENCH_CHECK(accessorWriteUInt32(w, BENCH_CHUNK_NEST));
+    BENCH_CHECK(accessorReserveSlot(w, &slot, 4));
+    start = accessorCursor(w);
+
+    benchWriteRecordsChunk(w, sum);
+    if (depth + 1 < BENCH_ARCHIVE_MAX_DEPTH && benchRandom() % 2 == 0)
+        benchWriteNestChunk(w, depth + 1, sum);
+    benchWriteArrayChunk(w, sum);
+
+    BENCH_CHECK(accessorSetSlotToLengthSince(w, slot, start));
+}
+
+
+
+// write archive in w, returning the checksum of its data as parsed by benchParseArchive()
+static uint64_t benchWriteArchive(accessor_t * w)
+{
+    size_t directorySlot;
+    size_t offsets[BENCH_ARCHIVE_ENTRIES];
+    size_t sizes[BENCH_ARCHIVE_ENTRIES];
+    uint16_t name[32];
+    char asciiName[32];
+    uint64_t sum = 0;
+
+
+    BENCH_CHECK(accessorSetCurrentEndianness(w, accessorBig));
+    BENCH_CHECK(accessorWriteUInt32(w, BENCH_ARCHIVE_MAGIC));
+    BENCH_CHECK(accessorWriteUInt16(w, BENCH_ARCHIVE_VERSION));
+    BENCH_CHECK(accessorWriteUInt16(w, 0));
+    BENCH_CHECK(accessorWriteUInt32(w, (uint32_t) BENCH_ARCHIVE_ENTRIES));
+    BENCH_CHECK(accessorReserveSlot(w, &directorySlot, 8));
+
+    for (size_t i = 0; i < BENCH_ARCHIVE_ENTRIES; i++)
+    {
+        offsets[i] = accessorCursor(w);
+        benchWriteNestChunk(w, 0, &sum);
+        sizes[i] = accessorCursor(w) - offsets[i];
+    }
+
+    BENCH_CHECK(accessorSetSlotToCursor(w, directorySlot));
+    for (size_t i = 0; i < BENCH_ARCHIVE_ENTRIES; i++)
+    {
+        snprintf(asciiName, sizeof(asciiName), "entry-%04zu.dat", i);
+        for (size_t j = 0; j < sizeof(asciiName); j++)
+            name[j] = (uint16_t) asciiName[j];
+        BENCH_CHECK(accessorWriteString16(w, name));
+        BENCH_CHECK(accessorWriteUInt64(w, offsets[i]));
+        BENCH_CHECK(accessorWriteUInt64(w, sizes[i]));
+    }
+
+    BENCH_CHECK(accessorResolveSlots(w));
+
+    return sum;
+}
+
+
+
+static void benchParseChunks(accessor_t * a, uint64_t * sum)
+{
+    accessor_t * chunk = ACCESSOR_INIT;
+    uint32_t tag;
+    uint32_t length;
+    uintmax_t count;
+    uintmax_t id;
+    intmax_t value;
+    char * label;
+    size_t labelLength;
+    uint32_t arrayCount;
+    uint32_t * array;
+
+
+    while (accessorAvailableBytesCount(a) > 0)
+    {
+        BENCH_CHECK(accessorReadUInt32(a, &tag));
+        BENCH_CHECK(accessorReadUInt32(a, &length));
+        BENCH_CHECK(accessorOpenReadingAccessorBytes(&chunk, a, length));
+        accessorAllowCoverage(chunk, accessorEnableCoverage);
+
+        switch (tag)
+        {
+        case BENCH_CHUNK_RECORDS:
+            BENCH_CHECK(accessorReadVarInt(chunk, &count));
+            for (uintmax_t i = 0; i < count; i++)
+            {
+                BENCH_CHECK(accessorReadVarInt(chunk, &id));
+                BENCH_CHECK(accessorReadZigZagInt(chunk, &value));
+                BENCH_CHECK(accessorReadCString(chunk, &label, &labelLength));
+                *sum += (uint64_t) id + (uint64_t) value + labelLength;
+                free(label);
+            }
+            break;
+
+        case BENCH_CHUNK_ARRAY:
+            BENCH_CHECK(accessorReadUInt32(chunk, &arrayCount));
+            BENCH_CHECK(accessorReadUInt32Array(chunk, &array, arrayCount));
+            for (uint32_t i = 0; i < arrayCount; i++)
+                *sum += array[i];
+            free(array);
+            break;
+
+        case BENCH_CHUNK_NEST:
+            benchParseChunks(chunk, sum);
+            break;
+
+        default:
+            benchFailure(__FILE__, __LINE__);
+        }
+
+        BENCH_CHECK(accessorClose(&chunk));
+    }
+}
+
+
+
+static void benchParseArchive(benchContext * c, size_t iterations)
+{
+    accessor_t * entry = ACCESSOR_INIT;
+    const accessorCoverageRecord * coverage;
+    size_t coverageCount;
+    size_t covered;
+    uint32_t magic;
+    uint16_t version;
+    uint16_t reserved;
+    uint32_t entryCount;
+    uint64_t directoryOffset;
+    uint16_t * name;
+    size_t nameLength;
+    uint64_t offset;
+    uint64_t size;
+    uint64_t sum;
+
+
+    for (size_t i = 0; i < iterations; i++)
+    {
+        sum = 0;
+        BENCH_CHECK(accessorSeek(c->a, 0, SEEK_SET));
+        BENCH_CHECK(accessorReadUInt32(c->a, &magic));
+        BENCH_CHECK(accessorReadUInt16(c->a, &version));
+        BENCH_CHECK(accessorReadUInt16(c->a, &reserved));
+        BENCH_CHECK(accessorReadUInt32(c->a, &entryCount));
+        BENCH_CHECK(accessorReadUInt64(c->a, &directoryOffset));
+        if (magic != BENCH_ARCHIVE_MAGIC || version != BENCH_ARCHIVE_VERSION)
+            benchFailure(__FILE__, __LINE__);
+
+        BENCH_CHECK(accessorSeek(c->a, (ssize_t) directoryOffset, SEEK_SET));
+        for (uint32_t j = 0; j < entryCount; j++)
+        {
+            BENCH_CHECK(accessorReadString16(c->a, &name, &nameLength));
+            BENCH_CHECK(accessorReadUInt64(c->a, &offset));
+            BENCH_CHECK(accessorReadUInt64(c->a, &size));
+            free(name);
+
+            BENCH_CHECK(accessorOpenReadingAccessorWindow(&entry, c->a, offset, size));
+            accessorAllowCoverage(entry, accessorEnableCoverage);
+            benchParseChunks(entry, &sum);
+
+            // as a validating parser would, check that the whole entry was parsed
+            accessorSummarizeCoverage(entry, NULL, NULL);
+            coverage = accessorCoverageArray(entry, &coverageCount);
+            covered = 0;
+            for (size_t k = 0; k < coverageCount; k++)
+                covered += coverage[k].size;
+            if (covered != size)
+                benchFailure(__FILE__, __LINE__);
+            BENCH_CHECK(accessorClose(&entry));
+        }
+
+        if (sum != c->expected)
+            benchFailure(__FILE__, __LINE__);
+    }
+}
+
+
+
+void benchWorkload(void)
+{
+    benchContext c = { 0 };
+    accessor_t * w = ACCESSOR_INIT;
+    const void * data;
+    size_t size;
+    benchResult r;
+
+
+    benchSeedRandom(benchSeed);
+    BENCH_CHECK(accessorOpenWritingMemory(&w, 0, 0));
+    c.expected = benchWriteArchive(w);
+    BENCH_CHECK(accessorSeek(w, 0, SEEK_SET));
+    size = accessorLookAheadAvailableBytes(w, &data);
+
+    c.a = ACCESSOR_INIT;
+    BENCH_CHECK(accessorOpenReadingMemory(&c.a, data, size, accessorDontFreeOnClose, 0, ACCESSOR_UNTIL_END));
+    BENCH_CHECK(accessorSetCurrentEndianness(c.a, accessorBig));
+    c.count = 1;
+    r = benchMeasure("workload/archive-parse", benchParseArchive, &c, size);
+    if (r.medianNs > 0)
+    {
+        printf("workload: %zu bytes archive parsed at %.1f MB/s", size, r.gbps * 1000);
+        if (r.allocationsPerOp >= 0)
+            printf(", %.1f allocations/MB", r.allocationsPerOp * 1000000 / size);
+        printf("\n");
+    }
+    BENCH_CHECK(accessorClose(&c.a));
+    BENCH_CHECK(accessorClose(&w));
+}
@@ -0,0 +1,254 @@
+// Helpers shared by the "accessor" package benchmark programs
+
+
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE                 // for sched_setaffinity
+#endif
+
+#include "benchharness.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <libgen.h>     // for basename
+#include <time.h>       // for clock_gettime
+#ifdef __linux__
+#include <sched.h>      // for sched_setaffinity
+#include <string.h>
+#include <unistd.h>     // for syscall, read, close
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+
+static uint64_t benchRandomState = 1;
+static int benchCounterFiles[benchCounterCount] = { -1, -1, -1, -1, -1, -1, -1 };
+static const char * benchCounterNames[benchCounterCount] = { "cycles", "instructions", "branchMisses", "l1dMisses", "llcMisses", "dtlbMisses", "pageFaults" };
+
+
+
+void benchFailure(const char * file, int line)
+{
+    char path[256];
+
+
+    snprintf(path, sizeof(path), "%s", file);
+    fprintf(stderr, "benchmark failure in %s at line %u.\n", basename(path), line);
+    exit(1);
+}
+
+
+
+void benchSeedRandom(uint64_t seed)
+{
+    benchRandomState = seed != 0 ? seed : 1;
+}
+
+
+
+uint64_t benchRandom(void)
+{
+    benchRandomState ^= benchRandomState >> 12;
+    benchRandomState ^= benchRandomState << 25;
+    benchRandomState ^= benchRandomState >> 27;
+
+    return benchRandomState * 0x2545f4914f6cdd1dULL;
+}
+
+
+
+// benchRandom() calls are sequenced, so that data doesn't depend on the compiler
+uint64_t benchRandomBitLength(void)
+{
+    uint64_t x = benchRandom();
+
+
+    return x >> (benchRandom() % 64);
+}
+
+
+
+uint64_t benchNow(void)
+{
+    struct timespec ts;
+
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t) ts.tv_sec * 1000000000 + (uint64_t) ts.tv_nsec;
+}
+
+
+
+void benchPin(int cpu)
+{
+#ifdef __linux__
+    cpu_set_t set;
+
+
+    if (cpu == -1)
+    {
+        printf("not pinned to a cpu\n");
+        return;
+    }
+
+    if (cpu == -2)
+        cpu = sched_getcpu();
+
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    if (sched_setaffinity(0, sizeof(set), &set) != 0)
+    {
+        perror("sched_setaffinity");
+        return;
+    }
+    printf("pinned to cpu %d\n", cpu);
+#else
+    (void) cpu;
+    printf("not pinned to a cpu: unsupported on this platform\n");
+#endif
+}
+
+
+
+int benchCompareDouble(const void * p1, const void * p2)
+{
+    double d1 = *(const double *) p1;
+    double d2 = *(const double *) p2;
+
+
+    return (d1 > d2) - (d1 < d2);
+}
+
+
+
+double benchPercentile(const double * sorted, size_t count, unsigned percent)
+{
+    return sorted[((count - 1) * percent + 50) / 100];
+}
+
+
+
+// distribution free interval between order statistics, from the normal approximation of the binomial distribution: count / 2 +/- 0.98 * sqrt(count)
+// small counts give wide intervals, down to [min, max]
+void benchMedianInterval(const double * sorted, size_t count, double * low, double * high)
+{
+    size_t root = 0;
+    size_t halfWidth;
+
+
+    while ((root + 1) * (root + 1) <= count)
+        root++;
+    halfWidth = (98 * root + 99) / 100 + 1;
+
+    *low = sorted[count / 2 > halfWidth ? count / 2 - halfWidth : 0];
+    *high = sorted[(count - 1) / 2 + halfWidth < count ? (count - 1) / 2 + halfWidth : count - 1];
+}
+
+
+
+#ifdef __linux__
+static int benchPrivateOpenCounter(uint32_t type, uint64_t config)
+{
+    struct perf_event_attr attr;
+
+
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;                // allowed with perf_event_paranoid up to 2
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    return (int) syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+#endif
+
+
+
+int benchCountersOpen(void)
+{
+    int count = 0;
+
+
+#ifdef __linux__
+    benchCounterFiles[benchCounterCycles] = benchPrivateOpenCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+    benchCounterFiles[benchCounterInstructions] = benchPrivateOpenCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+    benchCounterFiles[benchCounterBranchMisses] = benchPrivateOpenCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+    benchCounterFiles[benchCounterL1dMisses] = benchPrivateOpenCounter(PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+    benchCounterFiles[benchCounterLlcMisses] = benchPrivateOpenCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+    benchCounterFiles[benchCounterDtlbMisses] = benchPrivateOpenCounter(PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+    benchCounterFiles[benchCounterPageFaults] = benchPrivateOpenCounter(PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS);
+#endif
+
+    for (int i = 0; i < benchCounterCount; i++)
+    {
+        if (benchCounterFiles[i] != -1)
+            count++;
+        else
+            printf("counter %s unavailable\n", benchCounterNames[i]);
+    }
+
+    return count;
+}
+
+
+
+void benchCountersClose(void)
+{
+    for (int i = 0; i < benchCounterCount; i++)
+    {
+#ifdef __linux__
+        if (benchCounterFiles[i] != -1)
+            close(benchCounterFiles[i]);
+#endif
+        benchCounterFiles[i] = -1;
+    }
+}
+
+
+
+const char * benchCounterName(benchCounter counter)
+{
+    return benchCounterNames[counter];
+}
+
+
+
+void benchCountersStart(void)
+{
+#ifdef __linux__
+    for (int i = 0; i < benchCounterCount; i++)
+        if (benchCounterFiles[i] != -1)
+        {
+            ioctl(benchCounterFiles[i], PERF_EVENT_IOC_RESET, 0);
+            ioctl(benchCounterFiles[i], PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+}
+
+
+
+void benchCountersStop(double values[benchCounterCount])
+{
+#ifdef __linux__
+    uint64_t data[3];                       // value, time enabled, time running
+#endif
+
+
+    for (int i = 0; i < benchCounterCount; i++)
+    {
+        values[i] = -1;
+#ifdef __linux__
+        if (benchCounterFiles[i] == -1)
+            continue;
+        ioctl(benchCounterFiles[i], PERF_EVENT_IOC_DISABLE, 0);
+        if (read(benchCounterFiles[i], data, sizeof(data)) != (ssize_t) sizeof(data))
+            continue;
+        if (data[2] != 0)                   // never scheduled in otherwise
+            values[i] = (double) data[0] * ((double) data[1] / (double) data[2]);
+#endif
+    }
+}
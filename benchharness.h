@@ -0,0 +1,51 @@
+// Helpers shared by the "accessor" package benchmark programs
+
+
+#ifndef benchharness_h
+#define benchharness_h
+
+#include <stdint.h>
+#include <stddef.h>
+
+
+#define BENCH_CHECK(x)              do { if ((x) != accessorOk) benchFailure(__FILE__, __LINE__); } while (0)
+
+
+void benchFailure(const char * file, int line);                             // report failure and exit
+
+// xorshift64*, good enough for reproducible benchmark data
+void benchSeedRandom(uint64_t seed);
+uint64_t benchRandom(void);
+uint64_t benchRandomBitLength(void);                                        // random value of uniformly distributed bit length
+
+uint64_t benchNow(void);                                                    // monotonic time in ns
+void benchPin(int cpu);                                                     // pin process to cpu. -2 pins to current cpu, -1 doesn't pin. prints outcome
+
+int benchCompareDouble(const void * p1, const void * p2);                   // qsort() helper, increasing order
+double benchPercentile(const double * sorted, size_t count, unsigned percent);  // nearest rank percentile of count sorted values, count > 0
+void benchMedianInterval(const double * sorted, size_t count, double * low, double * high);   // about 95% confidence interval of the median of count sorted values, count > 0
+
+// event counters of the calling thread, from perf_event_open() on Linux
+// counters that can't be opened (other platforms, virtual machines, perf_event_paranoid restrictions) are unavailable and read as -1
+// multiplexed counters are scaled to the time they were enabled
+typedef enum
+{
+    benchCounterCycles = 0,
+    benchCounterInstructions,
+    benchCounterBranchMisses,
+    benchCounterL1dMisses,
+    benchCounterLlcMisses,
+    benchCounterDtlbMisses,
+    benchCounterPageFaults,
+    benchCounterCount,
+} benchCounter;
+
+int benchCountersOpen(void);                                                // open counters, prints unavailable ones. returns number of available counters
+void benchCountersClose(void);
+const char * benchCounterName(benchCounter counter);                        // short name, suitable as JSON key
+void benchCountersStart(void);                                              // reset and enable counters
+void benchCountersStop(double values[benchCounterCount]);                   // disable counters and read values, -1 for unavailable counters
+
+
+
+#endif /* benchharness_h */
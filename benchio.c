@@ -0,0 +1,495 @@
+// I/O path benchmarks of the "accessor" package
+//
+// For each file size, read cases sweep warm vs cold page cache, mapped vs read file data (see accessorSetMmapMinFileSize()) and window offset,
+// write cases sweep output granularity and write-back method: accessorOpenWritingFile() + accessorClose(), or accessorWriteToFile()
+// Each case repetition runs in a forked child process, so that its peak RSS is measured in isolation
+// Reported figures are the median latency to first byte (open and first read), full scan or write-back throughput, and the largest peak RSS
+// These figures are meant to tune ACCESSOR_MMAP_MIN_FILESIZE and output granularity per host
+//
+// usage: benchio [--dir path] [--max-size size[K|M|G]] [--repetitions n] [--seed n] [--cpu n|-1] [--json file|-]
+// file sizes range from 1 KB to 8 GB, sizes above --max-size (default 256 MB) are skipped. files are created in a temporary directory in --dir (default /tmp)
+
+
+#include "accessor.h"
+#include "benchharness.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>         // for fork, pipe, mkdtemp
+#include <fcntl.h>          // for open, posix_fadvise
+#include <sys/wait.h>       // for wait4
+#include <sys/resource.h>   // for struct rusage
+
+
+#define BENCHIO_DEFAULT_SEED        ((uint64_t) 0x0123456789abcdefULL)
+#define BENCHIO_DEFAULT_REPETITIONS ((size_t) 5)
+#define BENCHIO_MAX_REPETITIONS     ((size_t) 100)
+#define BENCHIO_DEFAULT_MAX_SIZE    ((uint64_t) 256 << 20)
+#define BENCHIO_PATTERN_SIZE        ((size_t) 64 * 1024)      // files repeat a random pattern of this size
+#define BENCHIO_SCAN_CHUNK_SIZE     ((size_t) 1024 * 1024)
+#define BENCHIO_UNALIGNED_OFFSET    ((size_t) 4097)           // not a multiple of any page size
+#define BENCHIO_INPUT_NAME          "input.bin"
+#define BENCHIO_OUTPUT_NAME         "output.bin"
+
+#if defined(POSIX_FADV_DONTNEED)
+#define BENCHIO_HAS_COLD_CACHE      1
+#endif
+
+
+typedef enum
+{
+    benchIoRead = 0,
+    benchIoWriteOnClose,                // accessorOpenWritingFile() then accessorClose()
+    benchIoWriteToFile,                 // accessorOpenWritingMemory() then accessorWriteToFile()
+} benchIoKind;
+
+typedef struct
+{
+    benchIoKind kind;
+    uint64_t size;                      // file size
+    int cold;                           // page cache is emptied before each repetition
+    int mapped;                         // read file data is mapped instead of read
+    size_t windowOffset;
+    size_t granularity;                 // write accessor granularity, 0 for default
+} benchIoCase;
+
+// sent by child processes through a pipe
+typedef struct
+{
+    accessorStatus status;
+    uint64_t firstByteNs;               // reads only
+    uint64_t totalNs;                   // full scan or write-back
+} benchIoSample;
+
+
+// global variables
+static uint64_t benchIoSeed = BENCHIO_DEFAULT_SEED;
+static size_t benchIoRepetitions = BENCHIO_DEFAULT_REPETITIONS;
+static uint64_t benchIoMaxSize = BENCHIO_DEFAULT_MAX_SIZE;
+static const char * benchIoBaseDir = "/tmp";
+static char benchIoDir[1024];
+static int benchIoCpu = -2;                                 // -2: current cpu, -1: no pinning
+static FILE * benchIoJson = NULL;
+static uint8_t benchIoPattern[BENCHIO_PATTERN_SIZE];
+static volatile uint64_t benchIoSink;                       // scanned data is accumulated here, so that compilers can't discard the scan
+
+// prototypes
+uint64_t benchIoParseSize(const char * s);
+void benchIoFormatSize(char * s, size_t sSize, uint64_t size);
+void benchIoCreateInput(uint64_t size);
+void benchIoPrepareCache(const benchIoCase * k);
+benchIoSample benchIoRunRead(const benchIoCase * k);
+benchIoSample benchIoRunWrite(const benchIoCase * k);
+int benchIoRunChild(const benchIoCase * k, benchIoSample * sample, long * peakRssKB);
+void benchIoMeasure(const benchIoCase * k);
+
+
+
+int main(int argc, char *argv[])
+{
+    static const uint64_t sizes[] = { 1 << 10, 16 << 10, 64 << 10, 1 << 20, 16 << 20, 256 << 20, (uint64_t) 1 << 30, (uint64_t) 8 << 30 };
+    static const size_t granularities[] = { 0, 1 << 20, 64 << 20 };
+    benchIoCase k;
+    char * path;
+
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (i + 1 < argc && strcmp(argv[i], "--dir") == 0)
+            benchIoBaseDir = argv[++i];
+        else if (i + 1 < argc && strcmp(argv[i], "--max-size") == 0)
+            benchIoMaxSize = benchIoParseSize(argv[++i]);
+        else if (i + 1 < argc && strcmp(argv[i], "--repetitions") == 0)
+            benchIoRepetitions = strtoul(argv[++i], NULL, 0);
+        else if (i + 1 < argc && strcmp(argv[i], "--seed") == 0)
+            benchIoSeed = strtoull(argv[++i], NULL, 0);
+        else if (i + 1 < argc && strcmp(argv[i], "--cpu") == 0)
+            benchIoCpu = atoi(argv[++i]);
+        else if (i + 1 < argc && strcmp(argv[i], "--json") == 0)
+        {
+            i++;
+            benchIoJson = strcmp(argv[i], "-") == 0 ? stdout : fopen(argv[i], "w");
+            if (benchIoJson == NULL)
+            {
+                perror(argv[i]);
+                return 1;
+            }
+        }
+        else
+        {
+            fprintf(stderr, "usage: %s [--dir path] [--max-size size[K|M|G]] [--repetitions n] [--seed n] [--cpu n|-1] [--json file|-]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    if (benchIoRepetitions < 1)
+        benchIoRepetitions = 1;
+    if (benchIoRepetitions > BENCHIO_MAX_REPETITIONS)
+        benchIoRepetitions = BENCHIO_MAX_REPETITIONS;
+
+    snprintf(benchIoDir, sizeof(benchIoDir), "%s/accessorBenchIO.XXXXXXXX", benchIoBaseDir);
+    if (mkdtemp(benchIoDir) == NULL)
+    {
+        perror(benchIoDir);
+        return 1;
+    }
+
+    benchSeedRandom(benchIoSeed);
+    for (size_t i = 0; i < BENCHIO_PATTERN_SIZE; i++)
+        benchIoPattern[i] = (uint8_t) benchRandom();
+
+    benchPin(benchIoCpu);
+    printf("accessor build %u, seed 0x%016llx, %zu repetitions, default mmap minimum size %zu, files in %s\n", accessorBuildNumber(), (unsigned long long) benchIoSeed, benchIoRepetitions, accessorMmapMinFileSize(), benchIoDir);
+#ifndef BENCHIO_HAS_COLD_CACHE
+    printf("cold page cache cases skipped: posix_fadvise(POSIX_FADV_DONTNEED) unsupported on this platform\n");
+#endif
+    printf("%-46s %14s %12s %14s\n", "case", "first byte us", "GB/s", "peak RSS KB");
+
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]) && sizes[i] <= benchIoMaxSize; i++)
+    {
+        memset(&k, 0, sizeof(k));
+        k.size = sizes[i];
+
+        benchIoCreateInput(k.size);
+        k.kind = benchIoRead;
+        for (k.cold = 0; k.cold <= 1; k.cold++)
+        {
+#ifndef BENCHIO_HAS_COLD_CACHE
+            if (k.cold)
+                continue;
+#endif
+            for (k.mapped = 1; k.mapped >= 0; k.mapped--)
+            {
+                k.windowOffset = 0;
+                benchIoMeasure(&k);
+                if (k.size > 2 * BENCHIO_UNALIGNED_OFFSET)
+                {
+                    k.windowOffset = BENCHIO_UNALIGNED_OFFSET;
+                    benchIoMeasure(&k);
+                }
+            }
+        }
+        BENCH_CHECK(accessorBuildPath(&path, benchIoDir, BENCHIO_INPUT_NAME, accessorPathOptionNone, 0));
+        unlink(path);
+        free(path);
+
+        k.cold = 0;
+        k.mapped = 0;
+        k.windowOffset = 0;
+        for (size_t j = 0; j < sizeof(granularities) / sizeof(granularities[0]); j++)
+        {
+            k.granularity = granularities[j];
+            k.kind = benchIoWriteOnClose;
+            benchIoMeasure(&k);
+            k.kind = benchIoWriteToFile;
+            benchIoMeasure(&k);
+        }
+    }
+
+    rmdir(benchIoDir);
+    if (benchIoJson != NULL && benchIoJson != stdout)
+        fclose(benchIoJson);
+
+    return 0;
+}
+
+
+
+uint64_t benchIoParseSize(const char * s)
+{
+    char * end;
+    uint64_t size;
+
+
+    size = strtoull(s, &end, 0);
+    switch (*end)
+    {
+    case 'k': case 'K': return size << 10;
+    case 'm': case 'M': return size << 20;
+    case 'g': case 'G': return size << 30;
+    default:            return size;
+    }
+}
+
+
+
+void benchIoFormatSize(char * s, size_t sSize, uint64_t size)
+{
+    if (size >= ((uint64_t) 1 << 30) && size % ((uint64_t) 1 << 30) == 0)
+        snprintf(s, sSize, "%lluG", (unsigned long long) (size >> 30));
+    else if (size >= (1 << 20) && size % (1 << 20) == 0)
+        snprintf(s, sSize, "%lluM", (unsigned long long) (size >> 20));
+    else if (size >= (1 << 10) && size % (1 << 10) == 0)
+        snprintf(s, sSize, "%lluK", (unsigned long long) (size >> 10));
+    else
+        snprintf(s, sSize, "%llu", (unsigned long long) size);
+}
+
+
+
+// input file is written with plain I/O and synced, so that its pages are clean and can be dropped from page cache
+void benchIoCreateInput(uint64_t size)
+{
+    char * path;
+    int file;
+    size_t transferSize;
+
+
+    BENCH_CHECK(accessorBuildPath(&path, benchIoDir, BENCHIO_INPUT_NAME, accessorPathOptionNone, 0));
+    file = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (file == -1)
+    {
+        perror(path);
+        exit(1);
+    }
+
+    for (uint64_t offset = 0; offset < size; offset += transferSize)
+    {
+        transferSize = size - offset < BENCHIO_PATTERN_SIZE ? (size_t) (size - offset) : BENCHIO_PATTERN_SIZE;
+        if (write(file, benchIoPattern, transferSize) != (ssize_t) transferSize)
+        {
+            perror(path);
+            exit(1);
+        }
+    }
+
+    fsync(file);
+    close(file);
+    free(path);
+}
+
+
+
+// warm cases read the whole input file beforehand, cold cases drop it from page cache
+void benchIoPrepareCache(const benchIoCase * k)
+{
+    static uint8_t buffer[BENCHIO_SCAN_CHUNK_SIZE];
+    char * path;
+    int file;
+
+
+    if (k->kind != benchIoRead)
+        return;
+
+    BENCH_CHECK(accessorBuildPath(&path, benchIoDir, BENCHIO_INPUT_NAME, accessorPathOptionNone, 0));
+    file = open(path, O_RDONLY);
+    free(path);
+    if (file == -1)
+        benchFailure(__FILE__, __LINE__);
+
+    if (k->cold)
+    {
+#ifdef BENCHIO_HAS_COLD_CACHE
+        posix_fadvise(file, 0, 0, POSIX_FADV_DONTNEED);
+#endif
+    }
+    else
+        while (read(file, buffer, sizeof(buffer)) > 0)
+            ;
+
+    close(file);
+}
+
+
+
+benchIoSample benchIoRunRead(const benchIoCase * k)
+{
+    benchIoSample sample = { accessorOk, 0, 0 };
+    accessor_t * a = ACCESSOR_INIT;
+    const void * ptr;
+    uint64_t start;
+    uint64_t sum = 0;
+    uint64_t x;
+    size_t count;
+    uint8_t u8;
+
+
+    accessorSetMmapMinFileSize(k->mapped ? 0 : SIZE_MAX);
+
+    start = benchNow();
+    sample.status = accessorOpenReadingFile(&a, benchIoDir, BENCHIO_INPUT_NAME, accessorPathOptionNone, k->windowOffset, ACCESSOR_UNTIL_END);
+    if (sample.status != accessorOk)
+        return sample;
+    sample.status = accessorReadUInt8(a, &u8);
+    if (sample.status != accessorOk)
+    {
+        accessorClose(&a);
+        return sample;
+    }
+    sample.firstByteNs = benchNow() - start;
+
+    // scan whole window, one 64 bits word per 8 bytes
+    BENCH_CHECK(accessorSeek(a, 0, SEEK_SET));
+    while ((count = accessorAvailableBytesCount(a)) > 0)
+    {
+        if (count > BENCHIO_SCAN_CHUNK_SIZE)
+            count = BENCHIO_SCAN_CHUNK_SIZE;
+        BENCH_CHECK(accessorGetPointerForBytesToRead(a, &ptr, count));
+        for (size_t i = 0; i + 8 <= count; i += 8)
+        {
+            memcpy(&x, (const uint8_t *) ptr + i, 8);
+            sum += x;
+        }
+    }
+    sample.status = accessorClose(&a);
+    sample.totalNs = benchNow() - start;
+    benchIoSink += sum;
+
+    return sample;
+}
+
+
+
+benchIoSample benchIoRunWrite(const benchIoCase * k)
+{
+    benchIoSample sample = { accessorOk, 0, 0 };
+    accessor_t * a = ACCESSOR_INIT;
+    uint64_t start;
+    size_t transferSize;
+
+
+    start = benchNow();
+    if (k->kind == benchIoWriteOnClose)
+        sample.status = accessorOpenWritingFile(&a, benchIoDir, BENCHIO_OUTPUT_NAME, accessorPathOptionNone, 0644, 0, k->granularity);
+    else
+        sample.status = accessorOpenWritingMemory(&a, 0, k->granularity);
+    if (sample.status != accessorOk)
+        return sample;
+
+    for (uint64_t offset = 0; offset < k->size; offset += transferSize)
+    {
+        transferSize = k->size - offset < BENCHIO_PATTERN_SIZE ? (size_t) (k->size - offset) : BENCHIO_PATTERN_SIZE;
+        sample.status = accessorWriteBytes(a, benchIoPattern, transferSize);
+        if (sample.status != accessorOk)
+        {
+            accessorClose(&a);
+            return sample;
+        }
+    }
+
+    if (k->kind == benchIoWriteToFile)
+        sample.status = accessorWriteToFile(a, benchIoDir, BENCHIO_OUTPUT_NAME, accessorPathOptionNone, 0644, 0, ACCESSOR_UNTIL_END);
+    if (sample.status == accessorOk)
+        sample.status = accessorClose(&a);
+    else
+        accessorClose(&a);
+    sample.totalNs = benchNow() - start;
+
+    return sample;
+}
+
+
+
+// run a case repetition in a child process. returns 0 if child reported a sample
+int benchIoRunChild(const benchIoCase * k, benchIoSample * sample, long * peakRssKB)
+{
+    int fds[2];
+    pid_t pid;
+    int status;
+    struct rusage usage;
+    ssize_t bytesTransferred;
+
+
+    if (pipe(fds) != 0)
+        benchFailure(__FILE__, __LINE__);
+
+    fflush(stdout);
+    if (benchIoJson != NULL)
+        fflush(benchIoJson);
+    pid = fork();
+    if (pid == -1)
+        benchFailure(__FILE__, __LINE__);
+
+    if (pid == 0)
+    {
+        close(fds[0]);
+        *sample = k->kind == benchIoRead ? benchIoRunRead(k) : benchIoRunWrite(k);
+        _exit(write(fds[1], sample, sizeof(*sample)) == (ssize_t) sizeof(*sample) ? 0 : 1);
+    }
+
+    close(fds[1]);
+    bytesTransferred = read(fds[0], sample, sizeof(*sample));
+    close(fds[0]);
+    if (wait4(pid, &status, 0, &usage) == -1)
+        benchFailure(__FILE__, __LINE__);
+
+#ifdef __APPLE__
+    *peakRssKB = usage.ru_maxrss / 1024;        // bytes on macOS
+#else
+    *peakRssKB = usage.ru_maxrss;               // KB elsewhere
+#endif
+
+    return bytesTransferred == (ssize_t) sizeof(*sample) && WIFEXITED(status) && WEXITSTATUS(status) == 0 ? 0 : -1;
+}
+
+
+
+void benchIoMeasure(const benchIoCase * k)
+{
+    double firstByteNs[BENCHIO_MAX_REPETITIONS];
+    double totalNs[BENCHIO_MAX_REPETITIONS];
+    benchIoSample sample;
+    long peakRssKB = 0;
+    long rssKB;
+    char sizeText[32];
+    char granularityText[32];
+    char name[128];
+    double firstByte;
+    double total;
+    double gbps;
+    uint64_t bytes;
+    char * path;
+
+
+    benchIoFormatSize(sizeText, sizeof(sizeText), k->size);
+    if (k->kind == benchIoRead)
+        snprintf(name, sizeof(name), "read/%s/%s/%s/offset-%zu", sizeText, k->cold ? "cold" : "warm", k->mapped ? "mmap" : "read", k->windowOffset);
+    else
+    {
+        if (k->granularity == 0)
+            snprintf(granularityText, sizeof(granularityText), "default");
+        else
+            benchIoFormatSize(granularityText, sizeof(granularityText), k->granularity);
+        snprintf(name, sizeof(name), "write/%s/%s/granularity-%s", sizeText, k->kind == benchIoWriteOnClose ? "close" : "write-to-file", granularityText);
+    }
+
+    for (size_t i = 0; i < benchIoRepetitions; i++)
+    {
+        benchIoPrepareCache(k);
+        if (benchIoRunChild(k, &sample, &rssKB) != 0 || sample.status != accessorOk)
+        {
+            printf("%-46s failed, status %d\n", name, (int) sample.status);
+            return;
+        }
+
+        firstByteNs[i] = (double) sample.firstByteNs;
+        totalNs[i] = (double) sample.totalNs;
+        if (rssKB > peakRssKB)
+            peakRssKB = rssKB;
+
+        if (k->kind != benchIoRead)
+        {
+            BENCH_CHECK(accessorBuildPath(&path, benchIoDir, BENCHIO_OUTPUT_NAME, accessorPathOptionNone, 0));
+            unlink(path);
+            free(path);
+        }
+    }
+
+    qsort(firstByteNs, benchIoRepetitions, sizeof(*firstByteNs), benchCompareDouble);
+    qsort(totalNs, benchIoRepetitions, sizeof(*totalNs), benchCompareDouble);
+    firstByte = benchPercentile(firstByteNs, benchIoRepetitions, 50);
+    total = benchPercentile(totalNs, benchIoRepetitions, 50);
+    bytes = k->size - k->windowOffset;
+    gbps = (double) bytes / total;      // bytes per ns are GB/s
+
+    if (k->kind == benchIoRead)
+        printf("%-46s %14.1f %12.3f %14ld\n", name, firstByte / 1000, gbps, peakRssKB);
+    else
+        printf("%-46s %14s %12.3f %14ld\n", name, "-", gbps, peakRssKB);
+
+    if (benchIoJson != NULL)
+        fprintf(benchIoJson, "{\"name\":\"%s\",\"build\":%u,\"repetitions\":%zu,\"size\":%llu,\"cold\":%d,\"mapped\":%d,\"windowOffset\":%zu,\"granularity\":%zu,\"firstByteNs\":%.0f,\"totalNs\":%.0f,\"gbps\":%.4f,\"peakRssKB\":%ld}\n",
+                name, accessorBuildNumber(), benchIoRepetitions, (unsigned long long) k->size, k->cold, k->mapped, k->windowOffset, k->granularity, k->kind == benchIoRead ? firstByte : 0, total, gbps, peakRssKB);
+}
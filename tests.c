@@ -18,6 +18,7 @@
 #include <unistd.h>		// for mkdtemp etc.
 #include <libgen.h>     // for basename
 #include <time.h>       // for time
+#include <sys/wait.h>   // for waitpid
 
 
 #define CHECK_EQ(x, v)      do { if ((x) != (v)) debugBreakpoint(__LINE__); } while (0)
@@ -43,6 +44,26 @@ void testWriteProtection(void);
 void testCoverage(void);
 void testOffset(void);
 void testLimits(void);
+void testRelocations(void);
+void testCatalog(void);
+void testIndex(void);
+void testRecordIndex(void);
+void testMemo(void);
+void testChangedRanges(void);
+void testSlots(void);
+void testNullAccessor(void);
+void testPool(void);
+void testPack(void);
+void testWriteSpan(void);
+void testMmapMinFileSize(void);
+void testStats(void);
+void testTrace(void);
+void testResidency(void);
+void testMemoryBudget(void);
+void testSharedMemory(void);
+void testCheckpoint(void);
+void testDeepNesting(void);
+void testBuildPathInBuffer(void);
 
 
 
@@ -79,6 +100,26 @@ int main(int argc, char *argv[])
         testCoverage();
         testOffset();
         testLimits();
+        testRelocations();
+        testCatalog();
+        testIndex();
+        testRecordIndex();
+        testMemo();
+        testChangedRanges();
+        testSlots();
+        testNullAccessor();
+        testPool();
+        testPack();
+        testWriteSpan();
+        testMmapMinFileSize();
+        testStats();
+        testTrace();
+        testResidency();
+        testMemoryBudget();
+        testSharedMemory();
+        testCheckpoint();
+        testDeepNesting();
+        testBuildPathInBuffer();
     }
     printf("All tests were run.        \n");
 
@@ -87,6 +128,1841 @@ int main(int argc, char *argv[])
 
 
 
+static accessorStatus testRecordLength(accessor_t * record, void * context, size_t * length)
+{
+    accessorStatus status;
+    uint8_t u8;
+
+
+    (*(size_t *) context)++;
+    status = accessorReadUInt8(record, &u8);
+    *length = 1 + (size_t) u8;
+
+    return status;
+}
+
+
+
+// same as testRecordLength, but checks record is fresh, then leaves its state changed for the next call
+static accessorStatus testDirtyRecordLength(accessor_t * record, void * context, size_t * length)
+{
+    accessorStatus status;
+    const accessorCoverageRecord * coverage;
+    size_t coverageSize;
+
+
+    CHECK_EQ(accessorCurrentEndianness(record), accessorBig);
+    CHECK_EQ(accessorPopCursor(record), accessorInvalidParameter);
+    CHECK_EQ(accessorIsCoverageAllowed(record), accessorDisableCoverage);
+
+    accessorAllowCoverage(record, accessorEnableCoverage);
+    status = testRecordLength(record, context, length);
+    coverage = accessorCoverageArray(record, &coverageSize);
+    CHECK_EQ(coverageSize, 1);
+    CHECK_EQ(coverage[0].offset, 0);
+
+    CHECK_EQ(accessorPushCursor(record), accessorOk);
+    CHECK_EQ(accessorSetCurrentEndianness(record, accessorLittle), accessorOk);
+    accessorSuspendCoverage(record);
+
+    return status;
+}
+
+
+
+static size_t testMemoDecodeCount;
+static size_t testMemoReadCount;
+static size_t testMemoDestroyCount;
+
+
+
+static void testMemoDestroy(void * value)
+{
+    testMemoDestroyCount++;
+    free(value);
+}
+
+
+
+// decode node at offset: a uint8 child count followed by uint16 child offsets. value is the count of paths from node to leaves
+static uint64_t testMemoDecode(accessorMemo_t * m, accessor_t * a, size_t offset)
+{
+    void * value;
+    uint64_t * paths;
+    uint8_t childCount;
+    uint16_t childOffset;
+    size_t cursor;
+
+
+    if (m != NULL && accessorMemoFind(m, a, offset, 1, &value) == accessorOk)
+        return *(uint64_t *) value;
+
+    testMemoDecodeCount++;
+    paths = malloc(sizeof(*paths));
+    *paths = 0;
+    CHECK_EQ(accessorSeek(a, (ssize_t) offset, SEEK_SET), accessorOk);
+    CHECK_EQ(accessorReadUInt8(a, &childCount), accessorOk);
+    testMemoReadCount++;
+    if (childCount == 0)
+        *paths = 1;
+    for (uint8_t i = 0; i < childCount; i++)
+    {
+        CHECK_EQ(accessorReadEndianUInt16(a, &childOffset, accessorBig), accessorOk);
+        testMemoReadCount++;
+        cursor = accessorCursor(a);
+        *paths += testMemoDecode(m, a, childOffset);
+        CHECK_EQ(accessorSeek(a, (ssize_t) cursor, SEEK_SET), accessorOk);
+    }
+
+    if (m == NULL)
+    {
+        uint64_t result = *paths;
+        free(paths);
+        return result;
+    }
+
+    CHECK_EQ(accessorMemoAdd(m, a, offset, 1 + 2 * (size_t) childCount, 1, paths, sizeof(*paths), testMemoDestroy), accessorOk);
+
+    return *paths;
+}
+
+
+
+static void testNullAccessorSerialize(accessor_t * a)
+{
+    uint16_t u16Array[100];
+    uint64_t u64Array[100];
+    size_t slot;
+    void * ptr;
+
+
+    for (size_t i = 0; i < 100; i++) u16Array[i] = (uint16_t) i;
+    for (size_t i = 0; i < 100; i++) u64Array[i] = i;
+
+    CHECK_EQ(accessorReserveSlot(a, &slot, 4), accessorOk);
+    CHECK_EQ(accessorWriteUInt8(a, 1), accessorOk);
+    CHECK_EQ(accessorWriteEndianUInt24(a, 2, accessorBig), accessorOk);
+    CHECK_EQ(accessorWriteUInt(a, 3, 7), accessorOk);
+    CHECK_EQ(accessorWriteInt64(a, -4), accessorOk);
+    CHECK_EQ(accessorWriteFloat64(a, 5.0), accessorOk);
+    CHECK_EQ(accessorWriteVarInt(a, UINTMAX_MAX), accessorOk);
+    CHECK_EQ(accessorWriteZigZagInt(a, INTMAX_MIN), accessorOk);
+    CHECK_EQ(accessorWriteUInt16Array(a, u16Array, 100), accessorOk);
+    CHECK_EQ(accessorWriteEndianUInt64Array(a, u64Array, 100, accessorReverse), accessorOk);
+    CHECK_EQ(accessorWriteBytes(a, u64Array, sizeof(u64Array)), accessorOk);
+    CHECK_EQ(accessorWriteRepeatedByte(a, 0xaa, 1000), accessorOk);
+    CHECK_EQ(accessorWriteCString(a, "a C string"), accessorOk);
+    CHECK_EQ(accessorWritePaddedString(a, "padded", 100, ' '), accessorOk);
+    CHECK_EQ(accessorWriteEndianString16WithLength(a, u16Array + 1, 98, accessorReverse), accessorOk);
+    CHECK_EQ(accessorGetPointerForBytesToWrite(a, &ptr, 5000), accessorOk);
+    memset(ptr, 0x55, 5000);
+    CHECK_EQ(accessorSeek(a, 10000, SEEK_CUR), accessorOk);
+    CHECK_EQ(accessorWriteUInt32(a, 6), accessorOk);
+    CHECK_EQ(accessorSeek(a, -4, SEEK_CUR), accessorOk);
+    CHECK_EQ(accessorTruncate(a), accessorOk);
+    CHECK_EQ(accessorSeek(a, 4, SEEK_SET), accessorOk);
+    CHECK_EQ(accessorWriteUInt64(a, 7), accessorOk);
+    CHECK_EQ(accessorSeek(a, 0, SEEK_END), accessorOk);
+    CHECK_EQ(accessorSetSlotToCursor(a, slot), accessorOk);
+    CHECK_EQ(accessorResolveSlots(a), accessorOk);
+}
+
+
+
+void testBuildPathInBuffer(void)
+{
+    accessor_t * a = ACCESSOR_INIT;
+    char dirPath[256] = "//tmp/accessorTest.XXXXXXXX";
+    char * filename = "path.bin";
+    char longPath[2000];
+    char buffer[300];
+    char * fullPath;
+    size_t length;
+    uint8_t u8;
+
+
+    mkdtemp(dirPath);
+
+    // same results as accessorBuildPath, without allocation
+    CHECK_EQ(accessorBuildPathInBuffer(buffer, sizeof(buffer), &length, dirPath, filename, accessorPathOptionNone), accessorOk);
+    CHECK_EQ(accessorBuildPath(&fullPath, dirPath, filename, accessorPathOptionNone, 0), accessorOk);
+    CHECK_EQ(strcmp(buffer, fullPath), 0);
+    CHECK_EQ(length, strlen(fullPath));
+    free(fullPath);
+    CHECK_EQ(accessorBuildPathInBuffer(buffer, sizeof(buffer), &length, "a\\\\b\\", "c\\d\\\\", accessorPathOptionConvertBackslash), accessorOk);
+    CHECK_EQ(strcmp(buffer, "a//b/c/d"), 0);
+    CHECK_EQ(accessorBuildPathInBuffer(buffer, sizeof(buffer), &length, "base", "\\\\abs", accessorPathOptionConvertBackslash), accessorOk);
+    CHECK_EQ(strcmp(buffer, "/abs"), 0);
+    CHECK_EQ(accessorBuildPathInBuffer(buffer, sizeof(buffer), &length, "base/", "/rel", accessorPathOptionPathIsRelative), accessorOk);
+    CHECK_EQ(strcmp(buffer, "base/rel"), 0);
+    CHECK_EQ(length, 8);
+    CHECK_EQ(accessorBuildPathInBuffer(buffer, sizeof(buffer), &length, "base", "", accessorPathOptionNone), accessorInvalidParameter);
+    CHECK_EQ(accessorBuildPathInBuffer(buffer, 9, &length, "base", "rel", accessorPathOptionNone), accessorOk);
+    CHECK_EQ(accessorBuildPathInBuffer(buffer, 8, &length, "base", "rel", accessorPathOptionNone), accessorBeyondEnd);
+
+    // paths too long for internal stack buffers are allocated
+    length = 0;
+    for (size_t i = 0; i < 800; i++)
+    {
+        longPath[length++] = '.';
+        longPath[length++] = '/';
+    }
+    strcpy(longPath + length, filename);
+    CHECK_EQ(accessorOpenWritingFile(&a, dirPath, longPath, accessorPathOptionNone, 0666, 0, 0), accessorOk);
+    CHECK_EQ(accessorWriteUInt8(a, 42), accessorOk);
+    CHECK_EQ(accessorClose(&a), accessorOk);
+    CHECK_EQ(accessorOpenReadingFile(&a, dirPath, longPath, accessorPathOptionNone, 0, ACCESSOR_UNTIL_END), accessorOk);
+    CHECK_EQ(accessorReadUInt8(a, &u8), accessorOk);
+    CHECK_EQ(u8, 42);
+    CHECK_EQ(accessorClose(&a), accessorOk);
+
+    CHECK_EQ(accessorBuildPath(&fullPath, dirPath, filename, accessorPathOptionNone, 0), accessorOk);
+    CHECK_EQ(unlink(fullPath), 0);
+    free(fullPath);
+    CHECK_EQ(rmdir(dirPath), 0);
+}
+
+
+
+void testDeepNesting(void)
+{
+    static uint8_t data[200000];
+    static accessor_t * chain[100000];
+    uint8_t u8;
+
+
+    for (size_t i = 0; i < sizeof(data); i++)
+        data[i] = (uint8_t) i;
+
+    // super-accessors closed first, innermost sub-accessor keeps data alive without walking up the chain
+    CHECK_EQ(accessorOpenReadingMemory(&chain[0], data, sizeof(data), accessorDontFreeOnClose, 0, ACCESSOR_UNTIL_END), accessorOk);
+    for (size_t i = 1; i < sizeof(chain) / sizeof(chain[0]); i++)
+        CHECK_EQ(accessorOpenReadingAccessorWindow(&chain[i], chain[i - 1], 1, ACCESSOR_UNTIL_END), accessorOk);
+    for (size_t i = 0; i < sizeof(chain) / sizeof(chain[0]) - 1; i++)
+        CHECK_EQ(accessorClose(&chain[i]), accessorOk);
+    CHECK_EQ(accessorRootWindowOffset(chain[99999]), 99999);
+    CHECK_EQ(accessorReadUInt8(chain[99999], &u8), accessorOk);
+    CHECK_EQ(u8, (uint8_t) 99999);
+    CHECK_EQ(accessorClose(&chain[99999]), accessorOk);
+}
+
+
+
+void testCheckpoint(void)
+{
+    static uint8_t data[1000];
+    accessor_t * root = ACCESSOR_INIT;
+    accessor_t * sub = ACCESSOR_INIT;
+    accessor_t * subsub = ACCESSOR_INIT;
+    accessor_t * checkpoint = ACCESSOR_INIT;
+    accessor_t * c = ACCESSOR_INIT;
+    accessor_t * tree[4] = { ACCESSOR_INIT, ACCESSOR_INIT, ACCESSOR_INIT, ACCESSOR_INIT };
+    accessor_t * restored[4] = { ACCESSOR_INIT, ACCESSOR_INIT, ACCESSOR_INIT, ACCESSOR_INIT };
+    const accessorCoverageRecord * records;
+    size_t recordCount;
+    size_t count;
+    const void * ptr;
+    size_t size;
+    uint32_t u32;
+
+
+    for (size_t i = 0; i < sizeof(data); i++)
+        data[i] = (uint8_t) i;
+
+    // parse state: cursors, a cursor stack, endianness, coverage and nested windows
+    CHECK_EQ(accessorOpenReadingMemory(&root, data, sizeof(data), accessorDontFreeOnClose, 0, ACCESSOR_UNTIL_END), accessorOk);
+    accessorAllowCoverage(root, accessorEnableCoverage);
+    accessorSetCoverageUsage(root, 7, NULL);
+    CHECK_EQ(accessorReadUInt32(root, &u32), accessorOk);
+    CHECK_EQ(accessorPushCursor(root), accessorOk);
+    CHECK_EQ(accessorSeek(root, 100, SEEK_SET), accessorOk);
+    CHECK_EQ(accessorOpenReadingAccessorWindow(&sub, root, 200, 300), accessorOk);
+    CHECK_EQ(accessorSetCurrentEndianness(sub, accessorReverse), accessorOk);
+    CHECK_EQ(accessorSeek(sub, 50, SEEK_SET), accessorOk);
+    CHECK_EQ(accessorOpenReadingAccessorWindow(&subsub, sub, 10, 20), accessorOk);
+    CHECK_EQ(accessorSeek(subsub, 5, SEEK_SET), accessorOk);
+
+    tree[0] = root;
+    tree[1] = subsub;       // nearest listed super-accessor is root, sub isn't listed
+    CHECK_EQ(accessorOpenWritingMemory(&checkpoint, 0, 0), accessorOk);
+    CHECK_EQ(accessorWriteCheckpoint(checkpoint, tree, 2, accessorCheckpointOptionCoverage), accessorOk);
+    tree[1] = sub;
+    tree[2] = subsub;
+    CHECK_EQ(accessorWriteCheckpoint(checkpoint, tree, 3, accessorCheckpointOptionCoverage), accessorOk);
+
+    // only sub-accessors of the root may be saved
+    tree[0] = sub;
+    tree[1] = root;
+    CHECK_EQ(accessorWriteCheckpoint(checkpoint, tree, 2, accessorCheckpointOptionNone), accessorInvalidParameter);
+    CHECK_EQ(accessorClose(&subsub), accessorOk);
+    CHECK_EQ(accessorClose(&sub), accessorOk);
+    CHECK_EQ(accessorClose(&root), accessorOk);
+
+    // restore over a reopened root
+    CHECK_EQ(accessorSeek(checkpoint, 0, SEEK_SET), accessorOk);
+    size = accessorLookAheadAvailableBytes(checkpoint, &ptr);
+    CHECK_EQ(accessorOpenReadingMemory(&c, ptr, size, accessorDontFreeOnClose, 0, ACCESSOR_UNTIL_END), accessorOk);
+    CHECK_EQ(accessorOpenReadingMemory(&root, data, sizeof(data), accessorDontFreeOnClose, 0, ACCESSOR_UNTIL_END), accessorOk);
+    restored[0] = root;
+    CHECK_EQ(accessorReadCheckpoint(c, restored, 4, &count), accessorOk);
+    CHECK_EQ(count, 2);
+    CHECK_EQ(accessorRootWindowOffset(restored[1]), 210);
+    CHECK_EQ(accessorSize(restored[1]), 20);
+    CHECK_EQ(accessorCursor(restored[1]), 5);
+    CHECK_EQ(accessorCurrentEndianness(restored[1]), accessorReverse);
+    CHECK_EQ(accessorClose(&restored[1]), accessorOk);
+
+    CHECK_EQ(accessorReadCheckpoint(c, restored, 4, &count), accessorOk);
+    CHECK_EQ(count, 3);
+    CHECK_EQ(accessorCursor(root), 100);
+    CHECK_EQ(accessorPopCursor(root), accessorOk);
+    CHECK_EQ(accessorCursor(root), 4);
+    CHECK_EQ(accessorPopCursor(root), accessorInvalidParameter);
+    records = accessorCoverageArray(root, &recordCount);
+    CHECK_EQ(recordCount, 1);
+    CHECK_EQ(records[0].offset, 0);
+    CHECK_EQ(records[0].size, 4);
+    CHECK_EQ(records[0].usage1, 7);
+    CHECK_EQ(accessorIsCoverageAllowed(root), accessorEnableCoverage);
+    CHECK_EQ(accessorRootWindowOffset(restored[1]), 200);
+    CHECK_EQ(accessorCursor(restored[1]), 50);
+    CHECK_EQ(accessorCurrentEndianness(restored[1]), accessorReverse);
+    CHECK_EQ(accessorRootWindowOffset(restored[2]), 210);
+    CHECK_EQ(accessorCursor(restored[2]), 5);
+    CHECK_EQ(accessorReadUInt8(restored[2], (uint8_t *) &u32), accessorOk);
+    CHECK_EQ((uint8_t) u32, 215);
+    CHECK_EQ(accessorClose(&restored[2]), accessorOk);
+    CHECK_EQ(accessorClose(&restored[1]), accessorOk);
+    CHECK_EQ(accessorClose(&root), accessorOk);
+
+    // a root of another size, too few accessors, and truncated checkpoints are rejected without leaving sub-accessors open
+    CHECK_EQ(accessorOpenReadingMemory(&root, data, sizeof(data) - 1, accessorDontFreeOnClose, 0, ACCESSOR_UNTIL_END), accessorOk);
+    restored[0] = root;
+    CHECK_EQ(accessorSeek(c, 0, SEEK_SET), accessorOk);
+    CHECK_EQ(accessorReadCheckpoint(c, restored, 4, &count), accessorInvalidReadData);
+    CHECK_EQ(accessorClose(&root), accessorOk);
+    CHECK_EQ(accessorOpenReadingMemory(&root, data, sizeof(data), accessorDontFreeOnClose, 0, ACCESSOR_UNTIL_END), accessorOk);
+    restored[0] = root;
+    CHECK_EQ(accessorSeek(c, 0, SEEK_SET), accessorOk);
+    CHECK_EQ(accessorReadCheckpoint(c, restored, 1, &count), accessorInvalidParameter);
+    CHECK_EQ(accessorClose(&c), accessorOk);
+    CHECK_EQ(accessorOpenReadingMemory(&c, ptr, size - 1, accessorDontFreeOnClose, 0, ACCESSOR_UNTIL_END), accessorOk);
+    CHECK_EQ(accessorReadCheckpoint(c, restored, 4, &count), accessorOk);
+    CHECK_EQ(accessorClose(&restored[1]), accessorOk);
+    CHECK_EQ(accessorReadCheckpoint(c, restored, 4, &count), accessorInvalidReadData);
+    CHECK_EQ(count, 0);
+    CHECK_EQ(restored[1], ACCESSOR_INIT);
+    CHECK_EQ(restored[2], ACCESSOR_INIT);
+    CHECK_EQ(accessorClose(&c), accessorOk);
+    CHECK_EQ(accessorClose(&root), accessorOk);
+    CHECK_EQ(accessorClose(&checkpoint), accessorOk);
+}
+
+
+
+void testSharedMemory(void)
+{
+    accessor_t * w = ACCESSOR_INIT;
+    accessor_t * r = ACCESSOR_INIT;
+    accessor_t * sub = ACCESSOR_INIT;
+    int fd;
+    size_t offset;
+    size_t size;
+    const void * ptr;
+    uint8_t u8;
+    pid_t pid;
+    int childStatus;
+    accessorStatus status;
+
+
+    // shared write accessors may not be supported
+    status = accessorOpenWritingShared(&w, 0, 4096);
+    if (status == accessorNotFound)
+        return;
+    CHECK_EQ(status, accessorOk);
+
+    // grow beyond initial allocation, remapping data
+    for (size_t i = 0; i < 10000; i++)
+        CHECK_EQ(accessorWriteUInt8(w, (uint8_t) i), accessorOk);
+    CHECK_EQ(accessorExportFileDescriptor(w, &fd, &offset, &size), accessorOk);
+    CHECK_EQ(offset, 0);
+    CHECK_EQ(size, 10000);
+
+    // a reader maps the same pages and sees later writes. fd's offset, shared with its duplicates, doesn't move
+    CHECK_EQ(lseek(fd, 123, SEEK_SET), 123);
+    CHECK_EQ(accessorOpenReadingFileDescriptor(&r, fd, offset, size), accessorOk);
+    CHECK_EQ(lseek(fd, 0, SEEK_CUR), 123);
+    CHECK_EQ(accessorLookAheadAvailableBytes(r, &ptr), 10000);
+    for (size_t i = 0; i < 10000; i++)
+        CHECK_EQ(((const uint8_t *) ptr)[i], (uint8_t) i);
+    CHECK_EQ(accessorSeek(r, 9999, SEEK_SET), accessorOk);
+    CHECK_EQ(accessorReadUInt8(r, &u8), accessorOk);
+    CHECK_EQ(u8, (uint8_t) 9999);
+    CHECK_EQ(accessorSeek(w, 0, SEEK_SET), accessorOk);
+    CHECK_EQ(accessorWriteUInt8(w, 0xaa), accessorOk);
+    CHECK_EQ(accessorSeek(r, 0, SEEK_SET), accessorOk);
+    CHECK_EQ(accessorReadUInt8(r, &u8), accessorOk);
+    CHECK_EQ(u8, 0xaa);
+
+    // a sub-window is exported with its offset
+    CHECK_EQ(accessorOpenReadingAccessorWindow(&sub, r, 5000, 10), accessorOk);
+    CHECK_EQ(accessorClose(&r), accessorOk);
+    close(fd);
+    CHECK_EQ(accessorExportFileDescriptor(sub, &fd, &offset, &size), accessorOk);
+    CHECK_EQ(offset, 5000);
+    CHECK_EQ(size, 10);
+    CHECK_EQ(accessorClose(&sub), accessorOk);
+
+    // another process reads without any copy
+    pid = fork();
+    if (pid == 0)
+    {
+        if (accessorOpenReadingFileDescriptor(&r, fd, offset, size) != accessorOk || accessorReadUInt8(r, &u8) != accessorOk)
+            _exit(1);
+        _exit(u8 == (uint8_t) 5000 ? 0 : 2);
+    }
+    CHECK_EQ(pid > 0, 1);
+    CHECK_EQ(waitpid(pid, &childStatus, 0), pid);
+    CHECK_EQ(WIFEXITED(childStatus) && WEXITSTATUS(childStatus) == 0, 1);
+    close(fd);
+
+    CHECK_EQ(accessorOpenReadingFileDescriptor(&r, -1, 0, ACCESSOR_UNTIL_END), accessorOpenError);
+    CHECK_EQ(accessorClose(&w), accessorOk);
+
+    // memory accessors have no descriptor
+    CHECK_EQ(accessorOpenWritingMemory(&w, 0, 0), accessorOk);
+    CHECK_EQ(accessorExportFileDescriptor(w, &fd, &offset, &size), accessorNotFound);
+    CHECK_EQ(accessorClose(&w), accessorOk);
+}
+
+
+
+static void testMemoryPressureHandler(size_t size, void * context)
+{
+    (*(size_t *) context)++;
+    CHECK_EQ(accessorSetMemoryBudget(SIZE_MAX, SIZE_MAX), accessorOk);     // make room for size bytes
+    CHECK_EQ(size > 0, 1);
+}
+
+
+
+void testMemoryBudget(void)
+{
+    accessor_t * a = ACCESSOR_INIT;
+    accessor_t * b = ACCESSOR_INIT;
+    accessor_t * sub = ACCESSOR_INIT;
+    accessorPool_t * p = ACCESSOR_INIT;
+    accessorMemoryBudget budget;
+    size_t baseline;
+    size_t handlerCalls = 0;
+    uint8_t data[16] = { 0 };
+    uint8_t u8;
+    char * str;
+    uint16_t * array;
+    const void * ptr;
+    size_t slot;
+
+
+    // charges are released on close
+    accessorGetMemoryBudget(&budget);
+    CHECK_EQ(budget.softLimit, SIZE_MAX);
+    CHECK_EQ(budget.hardLimit, SIZE_MAX);
+    baseline = budget.inUse;
+    CHECK_EQ(accessorOpenWritingMemory(&a, 64 * 1024, 0), accessorOk);
+    accessorGetMemoryBudget(&budget);
+    CHECK_EQ(budget.inUse >= baseline + 64 * 1024, 1);
+    CHECK_EQ(budget.peak >= budget.inUse, 1);
+    CHECK_EQ(accessorClose(&a), accessorOk);
+    accessorGetMemoryBudget(&budget);
+    CHECK_EQ(budget.inUse, baseline);
+    CHECK_EQ(accessorSetMemoryBudget(2, 1), accessorInvalidParameter);
+
+    // hard limit: opens, grows and coverage records fail cleanly
+    CHECK_EQ(accessorOpenWritingMemory(&a, 0, 4096), accessorOk);
+    CHECK_EQ(accessorOpenReadingMemory(&b, data, sizeof(data), accessorDontFreeOnClose, 0, ACCESSOR_UNTIL_END), accessorOk);
+    accessorAllowCoverage(b, accessorEnableCoverage);
+    accessorGetMemoryBudget(&budget);
+    CHECK_EQ(accessorSetMemoryBudget(budget.inUse, budget.inUse), accessorOk);
+    CHECK_EQ(accessorOpenWritingMemory(&sub, 1024 * 1024, 0), accessorOutOfMemory);
+    CHECK_EQ(sub, ACCESSOR_INIT);
+    CHECK_EQ(accessorReserveEndianSlot(a, &slot, accessorBig, 4), accessorOutOfMemory);     // nothing is written
+    CHECK_EQ(accessorSize(a), 0);
+    CHECK_EQ(accessorCursor(a), 0);
+    CHECK_EQ(accessorWriteRepeatedByte(a, 0, 4096), accessorOk);            // within initial allocation
+    CHECK_EQ(accessorWriteUInt8(a, 0), accessorOutOfMemory);
+    CHECK_EQ(accessorReadUInt8(b, &u8), accessorOutOfMemory);              // failed reads don't consume bytes
+    CHECK_EQ(accessorCursor(b), 0);
+    CHECK_EQ(accessorAvailableBytesCount(b), sizeof(data));
+    CHECK_EQ(accessorReadFixedLengthString(b, &str, 2), accessorOutOfMemory);
+    CHECK_EQ(str, NULL);
+    CHECK_EQ(accessorCursor(b), 0);
+    CHECK_EQ(accessorReadEndianUInt16Array(b, &array, 2, accessorBig), accessorOutOfMemory);
+    CHECK_EQ(accessorCursor(b), 0);
+    CHECK_EQ(accessorAddCoverageRecord(b, 0, 1, 0, NULL, accessorCoverageOnlyIfEnabled), accessorOutOfMemory);
+    CHECK_EQ(accessorOpenReadingAccessorBytes(&sub, b, 1), accessorOutOfMemory);
+    CHECK_EQ(sub, ACCESSOR_INIT);
+    CHECK_EQ(accessorCursor(b), 0);
+    CHECK_EQ(accessorApplyRelocations(a, b, 1, 1, 2, accessorBig, 1), accessorOutOfMemory);     // a is left untouched
+    CHECK_EQ(accessorCursor(b), 0);
+    CHECK_EQ(accessorSeek(a, 0, SEEK_SET), accessorOk);
+    CHECK_EQ(accessorLookAheadAvailableBytes(a, &ptr) >= 2 && ((const uint8_t *) ptr)[1] == 0, 1);
+    CHECK_EQ(accessorSeek(a, 0, SEEK_END), accessorOk);
+    accessorGetMemoryBudget(&budget);
+    CHECK_EQ(budget.failures >= 7, 1);
+
+    // pressure handler makes room once
+    accessorSetMemoryPressureHandler(testMemoryPressureHandler, &handlerCalls);
+    CHECK_EQ(accessorWriteUInt8(a, 0), accessorOk);
+    CHECK_EQ(handlerCalls, 1);
+    CHECK_EQ(accessorReadUInt8(b, &u8), accessorOk);
+    CHECK_EQ(handlerCalls, 1);
+    accessorSetMemoryPressureHandler(NULL, NULL);
+    CHECK_EQ(accessorClose(&b), accessorOk);
+
+    // soft limit: pools stop keeping accessors
+    CHECK_EQ(accessorOpenPool(&p, 4, 0, 0), accessorOk);
+    CHECK_EQ(accessorPoolAcquire(p, &b), accessorOk);
+    CHECK_EQ(accessorPoolAcquire(p, &sub), accessorOk);
+    CHECK_EQ(accessorPoolRelease(p, &b), accessorOk);
+    accessorGetMemoryBudget(&budget);
+    CHECK_EQ(accessorSetMemoryBudget(budget.inUse - 1, SIZE_MAX), accessorOk);
+    CHECK_EQ(accessorIsMemoryUnderPressure(), 1);
+    CHECK_EQ(accessorPoolRelease(p, &sub), accessorOk);
+    accessorGetMemoryBudget(&budget);
+    CHECK_EQ(budget.evictions >= 2, 1);
+    CHECK_EQ(accessorClosePool(&p), accessorOk);
+    CHECK_EQ(accessorClose(&a), accessorOk);
+
+    CHECK_EQ(accessorSetMemoryBudget(SIZE_MAX, SIZE_MAX), accessorOk);
+    CHECK_EQ(accessorIsMemoryUnderPressure(), 0);
+    accessorGetMemoryBudget(&budget);
+    CHECK_EQ(budget.inUse, baseline);
+}
+
+
+
+void testResidency(void)
+{
+    accessor_t * a = ACCESSOR_INIT;
+    char dirPath[256] = "//tmp/accessorTest.XXXXXXXX";
+    char * filename = "residency.bin";
+    char * fullPath;
+    uint8_t data[100000];
+    uint8_t bytes[10];
+    const void * ptr;
+    size_t defaultMinSize;
+    size_t pageCount;
+    accessorResidency residency;
+    accessorResidency residencies[2];
+    const accessorCoverageRecord * coverage;
+    size_t coverageSize;
+    accessorFaultCount faults;
+    accessorStatus status;
+
+
+    mkdtemp(dirPath);
+    for (size_t i = 0; i < sizeof(data); i++)
+        data[i] = (uint8_t) (i * 3);
+    CHECK_EQ(accessorOpenReadingMemory(&a, data, sizeof(data), accessorDontFreeOnClose, 0, ACCESSOR_UNTIL_END), accessorOk);
+    CHECK_EQ(accessorWriteToFile(a, dirPath, filename, accessorPathOptionNone, 0666, 0, ACCESSOR_UNTIL_END), accessorOk);
+    CHECK_EQ(accessorClose(&a), accessorOk);
+
+    // a mapped window, entirely touched during a counted parse
+    defaultMinSize = accessorMmapMinFileSize();
+    CHECK_EQ(accessorSetMmapMinFileSize(0), accessorOk);
+    CHECK_EQ(accessorOpenReadingFile(&a, dirPath, filename, accessorPathOptionNone, 5000, ACCESSOR_UNTIL_END), accessorOk);
+    CHECK_EQ(accessorSetMmapMinFileSize(defaultMinSize), accessorOk);
+    CHECK_EQ(accessorStartFaultCount(&faults), accessorOk);
+    CHECK_EQ(accessorLookAheadAvailableBytes(a, &ptr), sizeof(data) - 5000);
+    CHECK_EQ(memcmp(ptr, data + 5000, sizeof(data) - 5000), 0);
+    CHECK_EQ(accessorStopFaultCount(&faults), accessorOk);
+    CHECK_EQ(faults.elapsedSeconds >= 0 && faults.userSeconds >= 0 && faults.systemSeconds >= 0, 1);
+
+    status = accessorGetResidency(a, 0, ACCESSOR_UNTIL_END, &residency);
+    if (status == accessorOk)
+    {
+        pageCount = (5000 % residency.pageSize + sizeof(data) - 5000 + residency.pageSize - 1) / residency.pageSize;
+        CHECK_EQ(residency.residentPages, pageCount);
+        CHECK_EQ(residency.nonResidentPages, 0);
+        CHECK_EQ(accessorGetResidency(a, 0, 0, &residency), accessorOk);
+        CHECK_EQ(residency.residentPages + residency.nonResidentPages, 0);
+        CHECK_EQ(accessorGetResidency(a, 1, 1, &residency), accessorOk);
+        CHECK_EQ(residency.residentPages + residency.nonResidentPages, 1);
+        CHECK_EQ(accessorGetResidency(a, 1, accessorSize(a), &residency), accessorBeyondEnd);
+        CHECK_EQ(accessorGetResidency(a, accessorSize(a) + 1, 0, &residency), accessorBeyondEnd);
+
+        // one residency per coverage record
+        accessorAllowCoverage(a, accessorEnableCoverage);
+        CHECK_EQ(accessorReadBytes(a, bytes, sizeof(bytes)), accessorOk);
+        CHECK_EQ(accessorSeek(a, 3 * (ssize_t) residency.pageSize, SEEK_SET), accessorOk);
+        CHECK_EQ(accessorReadBytes(a, bytes, sizeof(bytes)), accessorOk);
+        coverage = accessorCoverageArray(a, &coverageSize);
+        CHECK_EQ(coverageSize, 2);
+        CHECK_EQ(accessorGetCoverageResidency(a, residencies), accessorOk);
+        for (size_t i = 0; i < coverageSize; i++)
+        {
+            CHECK_EQ(coverage[i].size, sizeof(bytes));
+            CHECK_EQ(residencies[i].residentPages >= 1 && residencies[i].residentPages <= 2, 1);
+            CHECK_EQ(residencies[i].nonResidentPages, 0);
+        }
+    }
+    else
+        CHECK_EQ(status, accessorNotFound);
+    CHECK_EQ(accessorClose(&a), accessorOk);
+
+    CHECK_EQ(accessorBuildPath(&fullPath, dirPath, filename, accessorPathOptionNone, 0), accessorOk);
+    CHECK_EQ(unlink(fullPath), 0);
+    free(fullPath);
+    CHECK_EQ(rmdir(dirPath), 0);
+}
+
+
+
+void testTrace(void)
+{
+    accessor_t * a = ACCESSOR_INIT;
+    accessor_t * sub = ACCESSOR_INIT;
+    accessor_t * t = ACCESSOR_INIT;
+    accessorTrace_t * trace = ACCESSOR_INIT;
+    char dirPath[256] = "//tmp/accessorTest.XXXXXXXX";
+    char * filename = "trace.bin";
+    char * fullPath;
+    uint8_t data[64];
+    uint8_t bytes[3];
+    uint8_t u8;
+    uint16_t u16;
+    uint32_t u32;
+    accessorTraceRecord record;
+    uint64_t previousEnd = 0;
+    accessorTraceRecord expected[4] =
+    {
+        { 4, 1, accessorApiReadScalar, 0 },
+        { 14, 4, accessorApiReadScalar, 7 },
+        { 6, 3, accessorApiReadBytes, 7 },
+        { 24, 2, accessorApiReadScalar, 7 },
+    };
+    accessorStatus status;
+
+
+    mkdtemp(dirPath);
+    for (size_t i = 0; i < sizeof(data); i++)
+        data[i] = (uint8_t) i;
+
+    // a tiny buffer forces writes to file while recording
+    CHECK_EQ(accessorOpenTrace(&trace, dirPath, filename, accessorPathOptionNone, 0666, 8), accessorOk);
+    CHECK_EQ(accessorOpenReadingMemory(&a, data, sizeof(data), accessorDontFreeOnClose, 4, ACCESSOR_UNTIL_END), accessorOk);
+    status = accessorSetTrace(a, trace);
+    CHECK_EQ(status == accessorOk || status == accessorNotFound, 1);
+    CHECK_EQ(accessorReadUInt8(a, &u8), accessorOk);
+    accessorSetCoverageUsage(a, 7, NULL);
+    CHECK_EQ(accessorSeek(a, 10, SEEK_SET), accessorOk);
+    CHECK_EQ(accessorReadEndianUInt32(a, &u32, accessorBig), accessorOk);
+    CHECK_EQ(accessorSeek(a, 2, SEEK_SET), accessorOk);
+    CHECK_EQ(accessorReadBytes(a, bytes, sizeof(bytes)), accessorOk);
+    CHECK_EQ(accessorLookAheadBytes(a, bytes, 1), 1);             // look ahead isn't a read
+    CHECK_EQ(accessorOpenReadingAccessorWindow(&sub, a, 20, 2), accessorOk);
+    accessorSetCoverageUsage(sub, 7, NULL);
+    CHECK_EQ(accessorReadUInt16(sub, &u16), accessorOk);          // sub-accessors use their base accessor's trace
+    CHECK_EQ(accessorClose(&sub), accessorOk);
+    CHECK_EQ(accessorSetTrace(a, NULL), status);
+    CHECK_EQ(accessorReadUInt8(a, &u8), accessorOk);
+    CHECK_EQ(accessorClose(&a), accessorOk);
+    CHECK_EQ(accessorCloseTrace(&trace), accessorOk);
+    CHECK_EQ(trace, ACCESSOR_INIT);
+
+    // without tracing compiled in, trace file only has a header
+    CHECK_EQ(accessorOpenReadingFile(&t, dirPath, filename, accessorPathOptionNone, 0, ACCESSOR_UNTIL_END), accessorOk);
+    CHECK_EQ(accessorReadTraceHeader(t), accessorOk);
+    for (size_t i = 0; status == accessorOk && i < 4; i++)
+    {
+        CHECK_EQ(accessorReadTraceRecord(t, &record, &previousEnd), accessorOk);
+        CHECK_EQ(record.rootOffset, expected[i].rootOffset);
+        CHECK_EQ(record.size, expected[i].size);
+        CHECK_EQ(record.family, expected[i].family);
+        CHECK_EQ(record.usage1, expected[i].usage1);
+    }
+    CHECK_EQ(accessorReadTraceRecord(t, &record, &previousEnd), accessorBeyondEnd);
+
+    // truncated records and headers are invalid
+    if (status == accessorOk)
+    {
+        CHECK_EQ(accessorOpenReadingAccessorWindow(&sub, t, 0, accessorSize(t) - 1), accessorOk);
+        CHECK_EQ(accessorReadTraceHeader(sub), accessorOk);
+        previousEnd = 0;
+        for (size_t i = 0; i < 3; i++)
+            CHECK_EQ(accessorReadTraceRecord(sub, &record, &previousEnd), accessorOk);
+        CHECK_EQ(accessorReadTraceRecord(sub, &record, &previousEnd), accessorInvalidReadData);
+        CHECK_EQ(accessorClose(&sub), accessorOk);
+    }
+    CHECK_EQ(accessorOpenReadingAccessorWindow(&sub, t, 0, 10), accessorOk);
+    CHECK_EQ(accessorReadTraceHeader(sub), accessorInvalidReadData);
+    CHECK_EQ(accessorClose(&sub), accessorOk);
+    CHECK_EQ(accessorClose(&t), accessorOk);
+
+    CHECK_EQ(accessorBuildPath(&fullPath, dirPath, filename, accessorPathOptionNone, 0), accessorOk);
+    CHECK_EQ(unlink(fullPath), 0);
+    free(fullPath);
+    CHECK_EQ(rmdir(dirPath), 0);
+}
+
+
+
+void testStats(void)
+{
+    accessor_t * a = ACCESSOR_INIT;
+    accessor_t * b = ACCESSOR_INIT;
+    accessor_t * sub = ACCESSOR_INIT;
+    accessorStats stats;
+    uint8_t u8;
+    uint32_t u32;
+    uintmax_t um;
+    char * str;
+    size_t length;
+    const uint8_t data[8] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+
+
+    // statistics may not be compiled in
+    CHECK_EQ(accessorOpenWritingMemory(&a, 0, 4), accessorOk);
+    if (accessorGetStats(a, &stats) == accessorNotFound)
+    {
+        CHECK_EQ(stats.bytesWritten, 0);
+        CHECK_EQ(accessorClose(&a), accessorOk);
+        return;
+    }
+
+    // writes, each one growing a, two of them reallocating its data
+    CHECK_EQ(accessorWriteUInt8(a, 1), accessorOk);
+    CHECK_EQ(accessorWriteEndianUInt32(a, 0x01020304, accessorBig), accessorOk);
+    CHECK_EQ(accessorWriteVarInt(a, 300), accessorOk);
+    CHECK_EQ(accessorWriteCString(a, "abc"), accessorOk);
+    CHECK_EQ(accessorGetStats(a, &stats), accessorOk);
+    CHECK_EQ(stats.bytesWritten, 11);
+    CHECK_EQ(stats.calls[accessorApiWriteScalar], 2);
+    CHECK_EQ(stats.calls[accessorApiWriteVarInt], 1);
+    CHECK_EQ(stats.calls[accessorApiWriteString], 1);
+    CHECK_EQ(stats.grows, 4);
+    CHECK_EQ(stats.reallocations, 2);
+    CHECK_EQ(stats.reallocationBytesCopied <= 5 + 7, 1);
+    CHECK_EQ(stats.bytesRead, 0);
+
+    // reads and cursor moves
+    CHECK_EQ(accessorSeek(a, 0, SEEK_SET), accessorOk);
+    CHECK_EQ(accessorPushCursor(a), accessorOk);
+    CHECK_EQ(accessorReadUInt8(a, &u8), accessorOk);
+    CHECK_EQ(accessorPopCursor(a), accessorOk);
+    CHECK_EQ(accessorReadUInt8(a, &u8), accessorOk);
+    CHECK_EQ(accessorReadEndianUInt32(a, &u32, accessorBig), accessorOk);
+    CHECK_EQ(accessorReadVarInt(a, &um), accessorOk);
+    CHECK_EQ(accessorReadCString(a, &str, &length), accessorOk);
+    free(str);
+    CHECK_EQ(accessorReadUInt8(a, &u8), accessorBeyondEnd);       // failures aren't counted
+    CHECK_EQ(accessorGetStats(a, &stats), accessorOk);
+    CHECK_EQ(stats.bytesRead, 12);
+    CHECK_EQ(stats.calls[accessorApiReadScalar], 3);
+    CHECK_EQ(stats.calls[accessorApiReadVarInt], 1);
+    CHECK_EQ(stats.calls[accessorApiReadString], 1);
+    CHECK_EQ(stats.allocations, 1);
+    CHECK_EQ(stats.seeks, 2);
+    CHECK_EQ(stats.cursorPushes, 1);
+    CHECK_EQ(stats.cursorPops, 1);
+
+    // statistics survive resets
+    CHECK_EQ(accessorReset(a), accessorOk);
+    CHECK_EQ(accessorGetStats(a, &stats), accessorOk);
+    CHECK_EQ(stats.bytesWritten, 11);
+    CHECK_EQ(accessorClose(&a), accessorOk);
+
+    // sub-accessors are counted in their base accessor
+    CHECK_EQ(accessorOpenReadingMemory(&b, data, sizeof(data), accessorDontFreeOnClose, 0, ACCESSOR_UNTIL_END), accessorOk);
+    CHECK_EQ(accessorOpenReadingAccessorBytes(&sub, b, 4), accessorOk);
+    CHECK_EQ(accessorReadUInt32(sub, &u32), accessorOk);
+    CHECK_EQ(accessorGetStats(sub, &stats), accessorOk);
+    CHECK_EQ(stats.subAccessorsOpened, 1);
+    CHECK_EQ(stats.bytesRead, 4);
+    CHECK_EQ(stats.calls[accessorApiReadScalar], 1);
+    CHECK_EQ(accessorClose(&sub), accessorOk);
+
+    accessorAllowCoverage(b, accessorEnableCoverage);
+    CHECK_EQ(accessorReadUInt8(b, &u8), accessorOk);
+    CHECK_EQ(accessorReadUInt8(b, &u8), accessorOk);
+    CHECK_EQ(accessorGetStats(b, &stats), accessorOk);
+    CHECK_EQ(stats.coverageRecords, 2);
+    CHECK_EQ(stats.bytesRead, 6);
+    CHECK_EQ(accessorClose(&b), accessorOk);
+}
+
+
+
+void testMmapMinFileSize(void)
+{
+    accessor_t * a = ACCESSOR_INIT;
+    char dirPath[256] = "//tmp/accessorTest.XXXXXXXX";
+    char * filename = "mapped.bin";
+    char * fullPath;
+    size_t minSizes[3];
+    size_t defaultMinSize;
+    uint8_t data[100000];
+    const void * ptr;
+
+
+    mkdtemp(dirPath);
+    for (size_t i = 0; i < sizeof(data); i++)
+        data[i] = (uint8_t) (i * 7);
+    CHECK_EQ(accessorOpenReadingMemory(&a, data, sizeof(data), accessorDontFreeOnClose, 0, ACCESSOR_UNTIL_END), accessorOk);
+    CHECK_EQ(accessorWriteToFile(a, dirPath, filename, accessorPathOptionNone, 0666, 0, ACCESSOR_UNTIL_END), accessorOk);
+    CHECK_EQ(accessorClose(&a), accessorOk);
+
+    // mapped or read, file windows have the same content
+    defaultMinSize = accessorMmapMinFileSize();
+    minSizes[0] = 0;
+    minSizes[1] = SIZE_MAX;
+    minSizes[2] = defaultMinSize;
+    for (size_t i = 0; i < 3; i++)
+    {
+        CHECK_EQ(accessorSetMmapMinFileSize(minSizes[i]), accessorOk);
+        CHECK_EQ(accessorMmapMinFileSize(), minSizes[i]);
+        CHECK_EQ(accessorOpenReadingFile(&a, dirPath, filename, accessorPathOptionNone, 5000, ACCESSOR_UNTIL_END), accessorOk);
+        CHECK_EQ(accessorRootWindowOffset(a), 5000);
+        CHECK_EQ(accessorLookAheadAvailableBytes(a, &ptr), sizeof(data) - 5000);
+        CHECK_EQ(memcmp(ptr, data + 5000, sizeof(data) - 5000), 0);
+        CHECK_EQ(accessorClose(&a), accessorOk);
+    }
+
+    CHECK_EQ(accessorBuildPath(&fullPath, dirPath, filename, accessorPathOptionNone, 0), accessorOk);
+    CHECK_EQ(unlink(fullPath), 0);
+    free(fullPath);
+    CHECK_EQ(rmdir(dirPath), 0);
+}
+
+
+
+void testWriteSpan(void)
+{
+    accessor_t * a = ACCESSOR_INIT;
+    accessor_t * b = ACCESSOR_INIT;
+    accessorWriteSpan span;
+    const void * ptr1;
+    const void * ptr2;
+
+
+    // span writes are the same as checked writes
+    CHECK_EQ(accessorOpenWritingMemory(&a, 0, 0), accessorOk);
+    CHECK_EQ(accessorOpenWritingMemory(&b, 0, 0), accessorOk);
+    CHECK_EQ(accessorWriteUInt8(a, 0xff), accessorOk);
+    CHECK_EQ(accessorOpenWriteSpan(a, &span, 100), accessorOk);
+    CHECK_EQ(accessorSpanAvailableBytes(&span), 100);
+    accessorSpanWriteUInt8(&span, 1);
+    accessorSpanWriteBigUInt16(&span, 0x0203);
+    accessorSpanWriteBigUInt32(&span, 0x04050607);
+    accessorSpanWriteBigUInt64(&span, 0x08090a0b0c0d0e0fULL);
+    accessorSpanWriteLittleUInt16(&span, 0x0203);
+    accessorSpanWriteLittleUInt32(&span, 0x04050607);
+    accessorSpanWriteLittleUInt64(&span, 0x08090a0b0c0d0e0fULL);
+    accessorSpanWriteBytes(&span, "abc", 3);
+    CHECK_EQ(accessorSpanAvailableBytes(&span), 68);
+    CHECK_EQ(accessorCloseWriteSpan(a, &span), accessorOk);
+    CHECK_EQ(accessorCloseWriteSpan(a, &span), accessorInvalidParameter);
+    CHECK_EQ(accessorCursor(a), 33);
+    CHECK_EQ(accessorSize(a), 33);
+    CHECK_EQ(accessorWriteUInt8(a, 0xfe), accessorOk);
+
+    CHECK_EQ(accessorWriteUInt8(b, 0xff), accessorOk);
+    CHECK_EQ(accessorWriteUInt8(b, 1), accessorOk);
+    CHECK_EQ(accessorWriteEndianUInt16(b, 0x0203, accessorBig), accessorOk);
+    CHECK_EQ(accessorWriteEndianUInt32(b, 0x04050607, accessorBig), accessorOk);
+    CHECK_EQ(accessorWriteEndianUInt64(b, 0x08090a0b0c0d0e0fULL, accessorBig), accessorOk);
+    CHECK_EQ(accessorWriteEndianUInt16(b, 0x0203, accessorLittle), accessorOk);
+    CHECK_EQ(accessorWriteEndianUInt32(b, 0x04050607, accessorLittle), accessorOk);
+    CHECK_EQ(accessorWriteEndianUInt64(b, 0x08090a0b0c0d0e0fULL, accessorLittle), accessorOk);
+    CHECK_EQ(accessorWriteBytes(b, "abc", 3), accessorOk);
+    CHECK_EQ(accessorWriteUInt8(b, 0xfe), accessorOk);
+
+    CHECK_EQ(accessorSize(a), 34);
+    CHECK_EQ(accessorSize(b), 34);
+    CHECK_EQ(accessorSeek(a, 0, SEEK_SET), accessorOk);
+    CHECK_EQ(accessorSeek(b, 0, SEEK_SET), accessorOk);
+    accessorLookAheadAvailableBytes(a, &ptr1);
+    accessorLookAheadAvailableBytes(b, &ptr2);
+    CHECK_EQ(memcmp(ptr1, ptr2, 34), 0);
+
+    // spans inside existing data keep unwritten bytes
+    CHECK_EQ(accessorSeek(a, 1, SEEK_SET), accessorOk);
+    CHECK_EQ(accessorOpenWriteSpan(a, &span, 10), accessorOk);
+    accessorSpanWriteUInt8(&span, 1);
+    CHECK_EQ(accessorCloseWriteSpan(a, &span), accessorOk);
+    CHECK_EQ(accessorCursor(a), 2);
+    CHECK_EQ(accessorSize(a), 34);
+    CHECK_EQ(accessorSeek(a, 0, SEEK_SET), accessorOk);
+    accessorLookAheadAvailableBytes(a, &ptr1);
+    CHECK_EQ(memcmp(ptr1, ptr2, 34), 0);
+    CHECK_EQ(accessorClose(&b), accessorOk);
+    CHECK_EQ(accessorClose(&a), accessorOk);
+
+    // null accessors
+    CHECK_EQ(accessorOpenWritingNull(&a), accessorOk);
+    CHECK_EQ(accessorOpenWriteSpan(a, &span, 1000), accessorOk);
+    for (size_t i = 0; i < 100; i++)
+        accessorSpanWriteBigUInt64(&span, i);
+    CHECK_EQ(accessorCloseWriteSpan(a, &span), accessorOk);
+    CHECK_EQ(accessorSize(a), 800);
+    CHECK_EQ(accessorCursor(a), 800);
+    CHECK_EQ(accessorClose(&a), accessorOk);
+
+    // read accessors can't be written to
+    CHECK_EQ(accessorOpenReadingMemory(&a, "abc", 3, accessorDontFreeOnClose, 0, ACCESSOR_UNTIL_END), accessorOk);
+    CHECK_EQ(accessorOpenWriteSpan(a, &span, 1), accessorReadOnlyError);
+    CHECK_EQ(accessorClose(&a), accessorOk);
+}
+
+
+
+void testPack(void)
+{
+    typedef struct
+    {
+        uint32_t u32;
+        uint16_t u16;
+        uint8_t u8;
+        uint64_t u64;
+        int32_t i32;
+    } testStruct;
+    accessorPackField fields[] =
+    {
+        { offsetof(testStruct, u32), 4, 4, accessorBig },
+        { offsetof(testStruct, u16), 2, 2, accessorLittle },
+        { offsetof(testStruct, u8), 1, 1, accessorBig },
+        { offsetof(testStruct, u64), 8, 8, accessorBig },
+        { offsetof(testStruct, i32), 4, 3, accessorBig },
+    };
+    accessorPackField arrayFields[4];
+    accessorPackField badField;
+    uint32_t arrays[10][4];
+    testStruct structs[100];
+    accessor_t * a = ACCESSOR_INIT;
+    accessor_t * b = ACCESSOR_INIT;
+    accessorPackPlan_t * p = ACCESSOR_INIT;
+    const void * ptr1;
+    const void * ptr2;
+
+
+    for (size_t i = 0; i < 100; i++)
+    {
+        structs[i].u32 = (uint32_t) (0x01020304 * i);
+        structs[i].u16 = (uint16_t) (0x0506 + i);
+        structs[i].u8 = (uint8_t) i;
+        structs[i].u64 = 0x0102030405060708ULL * i;
+        structs[i].i32 = -(int32_t) i;
+    }
+
+    // invalid fields
+    badField = fields[0];
+    badField.memberSize = 3;
+    CHECK_EQ(accessorOpenPackPlan(&p, &badField, 1, sizeof(testStruct)), accessorInvalidParameter);
+    badField = fields[0];
+    badField.nbytes = 5;
+    CHECK_EQ(accessorOpenPackPlan(&p, &badField, 1, sizeof(testStruct)), accessorInvalidParameter);
+    badField = fields[4];
+    badField.structOffset = sizeof(testStruct) - 2;
+    CHECK_EQ(accessorOpenPackPlan(&p, &badField, 1, sizeof(testStruct)), accessorInvalidParameter);
+    CHECK_EQ(p, ACCESSOR_INIT);
+
+    // packed structs are written as per field writes
+    CHECK_EQ(accessorOpenPackPlan(&p, fields, sizeof(fields) / sizeof(fields[0]), sizeof(testStruct)), accessorOk);
+    CHECK_EQ(accessorPackPlanSize(p), 18);
+    CHECK_EQ(accessorOpenWritingMemory(&a, 0, 0), accessorOk);
+    CHECK_EQ(accessorOpenWritingMemory(&b, 0, 0), accessorOk);
+    CHECK_EQ(accessorWritePacked(a, p, structs, 1), accessorOk);
+    CHECK_EQ(accessorWritePacked(a, p, structs + 1, 99), accessorOk);
+    for (size_t i = 0; i < 100; i++)
+    {
+        CHECK_EQ(accessorWriteEndianUInt32(b, structs[i].u32, accessorBig), accessorOk);
+        CHECK_EQ(accessorWriteEndianUInt16(b, structs[i].u16, accessorLittle), accessorOk);
+        CHECK_EQ(accessorWriteUInt8(b, structs[i].u8), accessorOk);
+        CHECK_EQ(accessorWriteEndianUInt64(b, structs[i].u64, accessorBig), accessorOk);
+        CHECK_EQ(accessorWriteEndianUInt24(b, (uint32_t) structs[i].i32 & 0xffffff, accessorBig), accessorOk);
+    }
+    CHECK_EQ(accessorSize(a), 1800);
+    CHECK_EQ(accessorSize(b), 1800);
+    CHECK_EQ(accessorSeek(a, 0, SEEK_SET), accessorOk);
+    CHECK_EQ(accessorSeek(b, 0, SEEK_SET), accessorOk);
+    accessorLookAheadAvailableBytes(a, &ptr1);
+    accessorLookAheadAvailableBytes(b, &ptr2);
+    CHECK_EQ(memcmp(ptr1, ptr2, 1800), 0);
+    CHECK_EQ(accessorClose(&b), accessorOk);
+    CHECK_EQ(accessorClose(&a), accessorOk);
+
+    // null accessors only count bytes, read accessors can't be written to
+    CHECK_EQ(accessorOpenWritingNull(&a), accessorOk);
+    CHECK_EQ(accessorWritePacked(a, p, structs, 100), accessorOk);
+    CHECK_EQ(accessorSize(a), 1800);
+    CHECK_EQ(accessorWritePacked(a, p, structs, SIZE_MAX / 2), accessorBeyondEnd);     // total size overflows
+    CHECK_EQ(accessorSize(a), 1800);
+    CHECK_EQ(accessorClose(&a), accessorOk);
+    CHECK_EQ(accessorOpenReadingMemory(&a, structs, sizeof(structs), accessorDontFreeOnClose, 0, ACCESSOR_UNTIL_END), accessorOk);
+    CHECK_EQ(accessorWritePacked(a, p, structs, 1), accessorReadOnlyError);
+    CHECK_EQ(accessorClose(&a), accessorOk);
+    CHECK_EQ(accessorClosePackPlan(&p), accessorOk);
+    CHECK_EQ(p, ACCESSOR_INIT);
+
+    // structs whose layout is the written layout
+    for (size_t i = 0; i < 4; i++)
+    {
+        arrayFields[i].structOffset = i * 4;
+        arrayFields[i].memberSize = 4;
+        arrayFields[i].nbytes = 4;
+        arrayFields[i].endianness = accessorReverse;
+    }
+    for (size_t i = 0; i < 40; i++)
+        arrays[i / 4][i % 4] = (uint32_t) (0x01020304 * i);
+    CHECK_EQ(accessorOpenPackPlan(&p, arrayFields, 4, sizeof(arrays[0])), accessorOk);
+    CHECK_EQ(accessorOpenWritingMemory(&a, 0, 0), accessorOk);
+    CHECK_EQ(accessorOpenWritingMemory(&b, 0, 0), accessorOk);
+    CHECK_EQ(accessorWritePacked(a, p, arrays, 10), accessorOk);
+    CHECK_EQ(accessorWriteEndianUInt32Array(b, &arrays[0][0], 40, accessorReverse), accessorOk);
+    CHECK_EQ(accessorSize(a), 160);
+    CHECK_EQ(accessorSeek(a, 0, SEEK_SET), accessorOk);
+    CHECK_EQ(accessorSeek(b, 0, SEEK_SET), accessorOk);
+    accessorLookAheadAvailableBytes(a, &ptr1);
+    accessorLookAheadAvailableBytes(b, &ptr2);
+    CHECK_EQ(memcmp(ptr1, ptr2, 160), 0);
+    CHECK_EQ(accessorClose(&b), accessorOk);
+    CHECK_EQ(accessorClose(&a), accessorOk);
+    CHECK_EQ(accessorClosePackPlan(&p), accessorOk);
+}
+
+
+
+void testPool(void)
+{
+    accessor_t * a = ACCESSOR_INIT;
+    accessor_t * b = ACCESSOR_INIT;
+    accessorPool_t * p = ACCESSOR_INIT;
+    const void * ptr1;
+    const void * ptr2;
+    size_t size;
+    uint8_t u8;
+
+
+    // reset keeps allocation
+    CHECK_EQ(accessorOpenWritingMemory(&a, 0, 0), accessorOk);
+    CHECK_EQ(accessorWriteRepeatedByte(a, 0xaa, 1000), accessorOk);
+    CHECK_EQ(accessorPushCursor(a), accessorOk);
+    accessorAllowCoverage(a, accessorEnableCoverage);
+    CHECK_EQ(accessorSeek(a, 0, SEEK_SET), accessorOk);
+    CHECK_EQ(accessorReadUInt8(a, &u8), accessorOk);
+    accessorLookAheadAvailableBytes(a, &ptr1);
+    CHECK_EQ(accessorReset(a), accessorOk);
+    CHECK_EQ(accessorSize(a), 0);
+    CHECK_EQ(accessorCursor(a), 0);
+    CHECK_EQ(accessorPopCursor(a), accessorInvalidParameter);
+    accessorCoverageArray(a, &size);
+    CHECK_EQ(size, 0);
+    CHECK_EQ(accessorWriteRepeatedByte(a, 0x55, 10), accessorOk);
+    CHECK_EQ(accessorSeek(a, 1, SEEK_SET), accessorOk);
+    accessorLookAheadAvailableBytes(a, &ptr2);
+    CHECK_EQ(ptr1, ptr2);
+    CHECK_EQ(accessorSize(a), 10);
+    CHECK_EQ(accessorClose(&a), accessorOk);
+    CHECK_EQ(accessorOpenReadingMemory(&a, &u8, 1, accessorDontFreeOnClose, 0, ACCESSOR_UNTIL_END), accessorOk);
+    CHECK_EQ(accessorReset(a), accessorReadOnlyError);
+    CHECK_EQ(accessorClose(&a), accessorOk);
+
+    // pooled accessors are reused
+    CHECK_EQ(accessorOpenPool(&p, 1, 4096, 0), accessorOk);
+    CHECK_EQ(accessorPoolAcquire(p, &a), accessorOk);
+    CHECK_EQ(accessorPoolAcquire(p, &a), accessorInvalidParameter);
+    CHECK_EQ(accessorPoolAcquire(p, &b), accessorOk);
+    CHECK_EQ(accessorWriteUInt32(a, 1), accessorOk);
+    CHECK_EQ(accessorSetCurrentEndianness(a, accessorOppositeEndianness(accessorDefaultEndianness())), accessorOk);
+    CHECK_EQ(accessorSeek(a, 0, SEEK_SET), accessorOk);
+    accessorLookAheadAvailableBytes(a, &ptr1);
+    CHECK_EQ(accessorPoolRelease(p, &a), accessorOk);
+    CHECK_EQ(a, ACCESSOR_INIT);
+    CHECK_EQ(accessorPoolRelease(p, &b), accessorOk);            // pool is full, b is closed
+    CHECK_EQ(accessorPoolAcquire(p, &a), accessorOk);
+    CHECK_EQ(accessorSize(a), 0);
+    CHECK_EQ(accessorCurrentEndianness(a), accessorDefaultEndianness());
+    CHECK_EQ(accessorWriteUInt32(a, 2), accessorOk);
+    CHECK_EQ(accessorSeek(a, 0, SEEK_SET), accessorOk);
+    accessorLookAheadAvailableBytes(a, &ptr2);
+    CHECK_EQ(ptr1, ptr2);
+    CHECK_EQ(accessorOpenWritingNull(&b), accessorOk);
+    CHECK_EQ(accessorPoolRelease(p, &b), accessorOk);            // not a memory accessor, b is closed
+    CHECK_EQ(accessorPoolRelease(p, &a), accessorOk);
+    CHECK_EQ(accessorClosePool(&p), accessorOk);
+    CHECK_EQ(p, ACCESSOR_INIT);
+}
+
+
+
+void testNullAccessor(void)
+{
+    accessor_t * a = ACCESSOR_INIT;
+    accessor_t * b = ACCESSOR_INIT;
+    void * data;
+    const void * ptr;
+    size_t size;
+    size_t baseline;
+    accessorMemoryBudget budget;
+    uint8_t u8;
+
+
+    // first pass measures size
+    CHECK_EQ(accessorOpenWritingNull(&a), accessorOk);
+    testNullAccessorSerialize(a);
+    size = accessorSize(a);
+    CHECK_EQ(accessorCursor(a), size);
+    CHECK_EQ(accessorAvailableBytesCount(a), 0);
+    CHECK_EQ(accessorSeek(a, 0, SEEK_SET), accessorOk);
+    CHECK_EQ(accessorAvailableBytesCount(a), 0);
+    CHECK_EQ(accessorReadUInt8(a, &u8), accessorBeyondEnd);
+    CHECK_EQ(accessorSeek(a, -1, SEEK_SET), accessorBeyondEnd);
+    CHECK_EQ(accessorWriteToFile(a, NULL, "/dev/null", accessorPathOptionNone, 0666, 0, ACCESSOR_UNTIL_END), accessorInvalidParameter);
+    CHECK_EQ(accessorClose(&a), accessorOk);
+
+    // second pass never reallocates
+    CHECK_EQ(accessorOpenWritingMemory(&b, size, 0), accessorOk);
+    CHECK_EQ(accessorGetPointerForBytesToWrite(b, &data, 0), accessorOk);
+    testNullAccessorSerialize(b);
+    CHECK_EQ(accessorSize(b), size);
+    CHECK_EQ(accessorSeek(b, 0, SEEK_SET), accessorOk);
+    CHECK_EQ(accessorLookAheadAvailableBytes(b, &ptr), size);
+    CHECK_EQ(ptr, data);
+    CHECK_EQ(accessorClose(&b), accessorOk);
+
+    // file writers honor large initial allocations too
+    accessorGetMemoryBudget(&budget);
+    baseline = budget.inUse;
+    CHECK_EQ(accessorOpenWritingFile(&b, NULL, "/dev/null", accessorPathOptionNone, 0666, 32 * 1024 * 1024, 0), accessorOk);
+    accessorGetMemoryBudget(&budget);
+    CHECK_EQ(budget.inUse >= baseline + 32 * 1024 * 1024, 1);
+    CHECK_EQ(accessorClose(&b), accessorOk);
+}
+
+
+
+void testSlots(void)
+{
+    accessor_t * a = ACCESSOR_INIT;
+    accessor_t * b = ACCESSOR_INIT;
+    char dirPath[256] = "//tmp/accessorTest.XXXXXXXX";
+    char * filename = "slots.bin";
+    char * fullPath;
+    size_t lengthSlot;
+    size_t offsetSlot;
+    size_t countSlot;
+    size_t start;
+    uint16_t u16;
+    uint32_t u32;
+    uint64_t u64;
+    uint8_t u8;
+
+
+    mkdtemp(dirPath);
+
+    // a header with a length field, an offset field and a count field, only known once the payload is written
+    CHECK_EQ(accessorOpenWritingFile(&a, dirPath, filename, accessorPathOptionNone, 0666, 0, 0), accessorOk);
+    CHECK_EQ(accessorReserveEndianSlot(a, &lengthSlot, accessorBig, 4), accessorOk);
+    CHECK_EQ(accessorReserveEndianSlot(a, &offsetSlot, accessorLittle, 8), accessorOk);
+    CHECK_EQ(accessorReserveSlot(a, &countSlot, 1), accessorOk);
+    CHECK_EQ(accessorReserveSlot(a, &countSlot, 0), accessorInvalidParameter);
+    CHECK_EQ(accessorReserveSlot(a, &countSlot, sizeof(uintmax_t) + 1), accessorInvalidParameter);
+    CHECK_EQ(accessorSize(a), 13);
+    start = accessorCursor(a);
+    CHECK_EQ(accessorWriteRepeatedByte(a, 0xaa, 1000), accessorOk);
+    CHECK_EQ(accessorSetSlotToLengthSince(a, lengthSlot, start), accessorOk);
+    CHECK_EQ(accessorSetSlotToCursor(a, offsetSlot), accessorOk);
+    CHECK_EQ(accessorWriteUInt8(a, 0x55), accessorOk);
+    CHECK_EQ(accessorSetSlotValue(a, countSlot, 256), accessorInvalidParameter);     // doesn't fit
+    CHECK_EQ(accessorResolveSlots(a), accessorInvalidParameter);                     // count slot has no value
+    CHECK_EQ(accessorSetSlotValue(a, countSlot, 255), accessorOk);
+    CHECK_EQ(accessorSetSlotValue(a, countSlot + 1, 0), accessorInvalidParameter);
+    CHECK_EQ(accessorResolveSlots(a), accessorOk);
+    CHECK_EQ(accessorSetSlotValue(a, countSlot, 1), accessorOk);                     // slots may be set again
+    CHECK_EQ(accessorClose(&a), accessorOk);                                         // slots are resolved on close
+
+    CHECK_EQ(accessorOpenReadingFile(&a, dirPath, filename, accessorPathOptionNone, 0, ACCESSOR_UNTIL_END), accessorOk);
+    CHECK_EQ(accessorSize(a), 13 + 1000 + 1);
+    CHECK_EQ(accessorReadEndianUInt32(a, &u32, accessorBig), accessorOk);
+    CHECK_EQ(u32, 1000);
+    CHECK_EQ(accessorReadEndianUInt64(a, &u64, accessorLittle), accessorOk);
+    CHECK_EQ(u64, 13 + 1000);
+    CHECK_EQ(accessorReadUInt8(a, &u8), accessorOk);
+    CHECK_EQ(u8, 1);
+    CHECK_EQ(accessorReserveSlot(a, &countSlot, 1), accessorReadOnlyError);
+    CHECK_EQ(accessorResolveSlots(a), accessorReadOnlyError);
+    CHECK_EQ(accessorClose(&a), accessorOk);
+
+    // slots are resolved by accessorWriteToFile, and can't be truncated
+    CHECK_EQ(accessorOpenWritingMemory(&b, 0, 0), accessorOk);
+    CHECK_EQ(accessorWriteUInt8(b, 0), accessorOk);
+    CHECK_EQ(accessorReserveSlot(b, &lengthSlot, 2), accessorOk);
+    CHECK_EQ(accessorWriteToFile(b, dirPath, filename, accessorPathOptionNone, 0666, 0, ACCESSOR_UNTIL_END), accessorInvalidParameter);
+    CHECK_EQ(accessorSetSlotValue(b, lengthSlot, 0x1234), accessorOk);
+    CHECK_EQ(accessorWriteToFile(b, dirPath, filename, accessorPathOptionNone, 0666, 0, ACCESSOR_UNTIL_END), accessorOk);
+    CHECK_EQ(accessorSeek(b, 2, SEEK_SET), accessorOk);
+    CHECK_EQ(accessorTruncate(b), accessorOk);
+    CHECK_EQ(accessorResolveSlots(b), accessorBeyondEnd);
+    CHECK_EQ(accessorClose(&b), accessorOk);
+
+    CHECK_EQ(accessorOpenReadingFile(&a, dirPath, filename, accessorPathOptionNone, 1, ACCESSOR_UNTIL_END), accessorOk);
+    CHECK_EQ(accessorReadUInt16(a, &u16), accessorOk);
+    CHECK_EQ(u16, 0x1234);
+    CHECK_EQ(accessorClose(&a), accessorOk);
+
+    CHECK_EQ(accessorBuildPath(&fullPath, dirPath, filename, accessorPathOptionNone, 0), accessorOk);
+    CHECK_EQ(unlink(fullPath), 0);
+    free(fullPath);
+    CHECK_EQ(rmdir(dirPath), 0);
+}
+
+
+
+void testChangedRanges(void)
+{
+#define TEST_CHANGED_SIZE       100000
+#define TEST_CHANGED_BLOCK_SIZE 4096
+#define TEST_CHANGED_TAG        1
+    accessor_t * a = ACCESSOR_INIT;
+    accessor_t * b = ACCESSOR_INIT;
+    accessorBlockHashes_t * h1 = ACCESSOR_INIT;
+    accessorBlockHashes_t * h2 = ACCESSOR_INIT;
+    accessorIndex_t * x = ACCESSOR_INIT;
+    accessorMemo_t * m = ACCESSOR_INIT;
+    accessorRecordIndex_t * r = ACCESSOR_INIT;
+    char dirPath[256] = "//tmp/accessorTest.XXXXXXXX";
+    char * indexName = "hashes.index";
+    char * fullPath;
+    uint8_t * data1;
+    uint8_t * data2;
+    accessorRange * ranges;
+    size_t rangeCount;
+    size_t callCount = 0;
+    size_t offset;
+    size_t size;
+    void * value;
+
+
+    // data is a stream of 1 byte records (see testRecordLength), each being also memoized
+    data1 = malloc(TEST_CHANGED_SIZE);
+    data2 = malloc(TEST_CHANGED_SIZE + TEST_CHANGED_BLOCK_SIZE);
+    memset(data1, 0, TEST_CHANGED_SIZE);
+    memcpy(data2, data1, TEST_CHANGED_SIZE);
+    memset(data2 + TEST_CHANGED_SIZE, 0, TEST_CHANGED_BLOCK_SIZE);
+
+    // save previous version's block hashes, and reload them although source changed
+    mkdtemp(dirPath);
+    CHECK_EQ(accessorOpenReadingMemory(&a, data1, TEST_CHANGED_SIZE, accessorDontFreeOnClose, 0, ACCESSOR_UNTIL_END), accessorOk);
+    CHECK_EQ(accessorOpenBlockHashes(&h1, a, 0), accessorInvalidParameter);
+    CHECK_EQ(accessorOpenBlockHashes(&h1, a, TEST_CHANGED_BLOCK_SIZE), accessorOk);
+    CHECK_EQ(accessorOpenWritingIndex(&x, a, accessorIndexOptionHashContent), accessorOk);
+    CHECK_EQ(accessorIndexAddBlockHashes(x, TEST_CHANGED_TAG, h1), accessorOk);
+    CHECK_EQ(accessorWriteIndexToFile(x, dirPath, indexName, accessorPathOptionNone, 0666), accessorOk);
+    CHECK_EQ(accessorCloseIndex(&x), accessorOk);
+    CHECK_EQ(accessorCloseBlockHashes(&h1), accessorOk);
+    CHECK_EQ(h1, ACCESSOR_INIT);
+
+    CHECK_EQ(accessorOpenMemo(&m, a, SIZE_MAX), accessorOk);
+    for (size_t i = 0; i < TEST_CHANGED_SIZE; i += 100)
+        CHECK_EQ(accessorMemoAdd(m, a, i, 1, 1, malloc(1), 1, free), accessorOk);
+    CHECK_EQ(accessorOpenRecordIndex(&r, a, 64, testRecordLength, &callCount), accessorOk);
+    CHECK_EQ(accessorRecordIndexGetRecord(r, TEST_CHANGED_SIZE - 1, &offset, &size), accessorOk);
+    CHECK_EQ(accessorClose(&a), accessorOk);
+
+    data2[50000] = 1;       // record 50000 now includes byte 50001
+    data2[50001] = 1;       // which is a changed record length too
+    data2[80000] = 0xff;
+    CHECK_EQ(accessorOpenReadingMemory(&b, data2, TEST_CHANGED_SIZE + 1, accessorDontFreeOnClose, 0, ACCESSOR_UNTIL_END), accessorOk);
+    CHECK_EQ(accessorOpenReadingIndex(&x, b, dirPath, indexName, accessorPathOptionNone, accessorIndexOptionNone), accessorInvalidReadData);
+    CHECK_EQ(accessorOpenReadingIndex(&x, NULL, dirPath, indexName, accessorPathOptionNone, accessorIndexOptionIgnoreSource), accessorOk);
+    CHECK_EQ(accessorOpenIndexBlockHashes(&h1, x, TEST_CHANGED_TAG), accessorOk);
+    CHECK_EQ(accessorCloseIndex(&x), accessorOk);
+
+    CHECK_EQ(accessorOpenBlockHashes(&h2, b, TEST_CHANGED_BLOCK_SIZE), accessorOk);
+    CHECK_EQ(accessorCompareBlockHashes(h1, h2, &ranges, &rangeCount), accessorOk);
+    CHECK_EQ(rangeCount, 3);
+    CHECK_EQ(ranges[0].offset, 50000 / TEST_CHANGED_BLOCK_SIZE * TEST_CHANGED_BLOCK_SIZE);
+    CHECK_EQ(ranges[0].size, TEST_CHANGED_BLOCK_SIZE);
+    CHECK_EQ(ranges[1].offset, 80000 / TEST_CHANGED_BLOCK_SIZE * TEST_CHANGED_BLOCK_SIZE);
+    CHECK_EQ(ranges[1].size, TEST_CHANGED_BLOCK_SIZE);
+    CHECK_EQ(ranges[2].offset, TEST_CHANGED_SIZE / TEST_CHANGED_BLOCK_SIZE * TEST_CHANGED_BLOCK_SIZE);
+    CHECK_EQ(ranges[2].offset + ranges[2].size, TEST_CHANGED_SIZE + 1);
+
+    // only values and records depending on changed ranges are forgotten
+    CHECK_EQ(accessorMemoUpdate(m, b, ranges, rangeCount), accessorOk);
+    CHECK_EQ(accessorMemoFind(m, b, 0, 1, &value), accessorOk);
+    CHECK_EQ(accessorMemoFind(m, b, (ranges[0].offset - 1) / 100 * 100, 1, &value), accessorOk);
+    CHECK_EQ(accessorMemoFind(m, b, 50000, 1, &value), accessorNotFound);
+    CHECK_EQ(accessorMemoFind(m, b, 80000, 1, &value), accessorNotFound);
+    CHECK_EQ(accessorCloseMemo(&m), accessorOk);
+
+    CHECK_EQ(accessorRecordIndexUpdate(r, b, ranges, rangeCount), accessorOk);
+    callCount = 0;
+    CHECK_EQ(accessorRecordIndexGetRecord(r, 100, &offset, &size), accessorOk);
+    CHECK_EQ(callCount <= 64, 1);
+    CHECK_EQ(accessorRecordIndexGetRecord(r, 50000, &offset, &size), accessorOk);
+    CHECK_EQ(size, 2);
+    CHECK_EQ(accessorRecordIndexGetRecord(r, 50001, &offset, &size), accessorOk);
+    CHECK_EQ(offset, 50002);
+    CHECK_EQ(accessorRecordIndexGetRecord(r, 80000 - 1, &offset, &size), accessorOk);
+    CHECK_EQ(size, 256);
+    CHECK_EQ(accessorCloseRecordIndex(&r), accessorOk);
+
+    free(ranges);
+    CHECK_EQ(accessorCloseBlockHashes(&h1), accessorOk);
+    CHECK_EQ(accessorCloseBlockHashes(&h2), accessorOk);
+    CHECK_EQ(accessorClose(&b), accessorOk);
+    free(data1);
+    free(data2);
+
+    CHECK_EQ(accessorBuildPath(&fullPath, dirPath, indexName, accessorPathOptionNone, 0), accessorOk);
+    CHECK_EQ(unlink(fullPath), 0);
+    free(fullPath);
+    CHECK_EQ(rmdir(dirPath), 0);
+}
+
+
+
+void testMemo(void)
+{
+#define TEST_MEMO_NODE_COUNT    64
+    accessor_t * a = ACCESSOR_INIT;
+    accessor_t * b = ACCESSOR_INIT;
+    accessorMemo_t * m = ACCESSOR_INIT;
+    uint8_t graph[TEST_MEMO_NODE_COUNT * 5];
+    size_t coverageSize;
+    uint64_t fibonacci[TEST_MEMO_NODE_COUNT + 1];
+    uint64_t * values[3];
+    void * value;
+
+
+    // node i points to nodes i + 1 and i + 2: a heavily shared graph with fibonacci(n) paths
+    for (size_t i = 0; i < TEST_MEMO_NODE_COUNT; i++)
+    {
+        size_t childCount = TEST_MEMO_NODE_COUNT - 1 - i < 2 ? TEST_MEMO_NODE_COUNT - 1 - i : 2;
+
+        graph[i * 5] = (uint8_t) childCount;
+        for (size_t j = 0; j < childCount; j++)
+        {
+            graph[i * 5 + 1 + 2 * j] = (uint8_t) (((i + 1 + j) * 5) >> 8);
+            graph[i * 5 + 2 + 2 * j] = (uint8_t) ((i + 1 + j) * 5);
+        }
+    }
+    fibonacci[0] = 1;
+    fibonacci[1] = 1;
+    for (size_t i = 2; i <= TEST_MEMO_NODE_COUNT; i++)
+        fibonacci[i] = fibonacci[i - 1] + fibonacci[i - 2];
+
+    CHECK_EQ(accessorOpenReadingMemory(&a, graph, sizeof(graph), accessorDontFreeOnClose, 0, ACCESSOR_UNTIL_END), accessorOk);
+    CHECK_EQ(accessorOpenMemo(&m, a, SIZE_MAX), accessorOk);
+    accessorAllowCoverage(a, accessorEnableCoverage);
+
+    testMemoDecodeCount = 0;
+    testMemoReadCount = 0;
+    testMemoDestroyCount = 0;
+    CHECK_EQ(testMemoDecode(m, a, 0), fibonacci[TEST_MEMO_NODE_COUNT - 1]);
+    CHECK_EQ(testMemoDecodeCount, TEST_MEMO_NODE_COUNT);
+    accessorCoverageArray(a, &coverageSize);
+    CHECK_EQ(coverageSize, testMemoReadCount);       // every byte read once
+
+    // memoized values are found using any accessor of the same stream, offsets being relative to its window
+    CHECK_EQ(accessorOpenReadingAccessorWindow(&b, a, 5, ACCESSOR_UNTIL_END), accessorOk);
+    CHECK_EQ(accessorMemoFind(m, b, 0, 1, &value), accessorOk);
+    CHECK_EQ(*(uint64_t *) value, fibonacci[TEST_MEMO_NODE_COUNT - 2]);
+    CHECK_EQ(accessorMemoFind(m, b, 0, 2, &value), accessorNotFound);
+    CHECK_EQ(accessorClose(&b), accessorOk);
+    CHECK_EQ(accessorOpenReadingMemory(&b, graph, sizeof(graph), accessorDontFreeOnClose, 0, ACCESSOR_UNTIL_END), accessorOk);
+    CHECK_EQ(accessorMemoFind(m, b, 0, 1, &value), accessorInvalidParameter);
+    CHECK_EQ(accessorClose(&b), accessorOk);
+
+    accessorMemoClear(m);
+    CHECK_EQ(testMemoDestroyCount, TEST_MEMO_NODE_COUNT);
+    CHECK_EQ(accessorMemoFind(m, a, 0, 1, &value), accessorNotFound);
+    CHECK_EQ(accessorCloseMemo(&m), accessorOk);
+    CHECK_EQ(m, ACCESSOR_INIT);
+
+    // adding the same value again updates it in place, without destroying it
+    CHECK_EQ(accessorOpenMemo(&m, a, 2), accessorOk);
+    testMemoDestroyCount = 0;
+    for (size_t i = 0; i < 3; i++)
+    {
+        values[i] = malloc(sizeof(uint64_t));
+        CHECK_NE(values[i], NULL);
+        *values[i] = i;
+    }
+    CHECK_EQ(accessorMemoAdd(m, a, 0, 1, 1, values[0], 1, testMemoDestroy), accessorOk);
+    CHECK_EQ(accessorMemoAdd(m, a, 5, 1, 1, values[1], 1, testMemoDestroy), accessorOk);
+    CHECK_EQ(accessorMemoAdd(m, a, 0, 1, 1, values[0], 1, testMemoDestroy), accessorOk);
+    CHECK_EQ(testMemoDestroyCount, 0);
+    CHECK_EQ(accessorMemoAdd(m, a, 10, 1, 1, values[2], 1, testMemoDestroy), accessorOk);      // values[1] is now least recently used
+    CHECK_EQ(testMemoDestroyCount, 1);
+    CHECK_EQ(accessorMemoFind(m, a, 5, 1, &value), accessorNotFound);
+    CHECK_EQ(accessorMemoFind(m, a, 0, 1, &value), accessorOk);
+    CHECK_EQ(*(uint64_t *) value, 0);
+    CHECK_EQ(accessorMemoAdd(m, a, 0, 1, 1, values[0], 2, testMemoDestroy), accessorOk);      // a higher cost evicts others, never the value itself
+    CHECK_EQ(testMemoDestroyCount, 2);
+    CHECK_EQ(accessorMemoFind(m, a, 0, 1, &value), accessorOk);
+    CHECK_EQ(*(uint64_t *) value, 0);
+    CHECK_EQ(accessorCloseMemo(&m), accessorOk);
+    CHECK_EQ(testMemoDestroyCount, 3);
+
+    // bounded memo table
+    CHECK_EQ(accessorOpenMemo(&m, a, 4 * sizeof(uint64_t)), accessorOk);
+    testMemoDecodeCount = 0;
+    testMemoDestroyCount = 0;
+    CHECK_EQ(testMemoDecode(m, a, 0), fibonacci[TEST_MEMO_NODE_COUNT - 1]);
+    CHECK_EQ(testMemoDecodeCount, TEST_MEMO_NODE_COUNT);
+    CHECK_EQ(testMemoDestroyCount, TEST_MEMO_NODE_COUNT - 4);
+    CHECK_EQ(accessorMemoFind(m, a, 0, 1, &value), accessorOk);
+    CHECK_EQ(accessorMemoFind(m, a, (TEST_MEMO_NODE_COUNT - 1) * 5, 1, &value), accessorNotFound);
+    CHECK_EQ(accessorClose(&a), accessorOk);        // the memo table keeps it alive
+    CHECK_EQ(accessorCloseMemo(&m), accessorOk);
+    CHECK_EQ(testMemoDestroyCount, TEST_MEMO_NODE_COUNT);
+
+    // without memo, decoding time would be proportional to fibonacci(TEST_MEMO_NODE_COUNT)
+    CHECK_EQ(accessorOpenReadingMemory(&a, graph, 12 * 5, accessorDontFreeOnClose, 0, ACCESSOR_UNTIL_END), accessorOk);
+    graph[10 * 5] = 1;
+    graph[11 * 5] = 0;
+    testMemoDecodeCount = 0;
+    CHECK_EQ(testMemoDecode(NULL, a, 0), fibonacci[11]);
+    CHECK_EQ(testMemoDecodeCount > 12 * 5, 1);
+    CHECK_EQ(accessorClose(&a), accessorOk);
+}
+
+
+
+void testRecordIndex(void)
+{
+#define TEST_RECORD_COUNT       10000
+#define TEST_RECORD_INTERVAL    16
+    accessor_t * a = ACCESSOR_INIT;
+    accessor_t * b = ACCESSOR_INIT;
+    accessorRecordIndex_t * r = ACCESSOR_INIT;
+    static uint8_t stream[TEST_RECORD_COUNT * 7];
+    size_t streamSize;
+    size_t offsets[TEST_RECORD_COUNT];
+    size_t callCount = 0;
+    size_t offset;
+    size_t size;
+    size_t count;
+    uint8_t u8;
+
+
+    streamSize = 0;
+    for (size_t i = 0; i < TEST_RECORD_COUNT; i++)
+    {
+        offsets[i] = streamSize;
+        stream[streamSize++] = (uint8_t) (i % 7);
+        for (size_t j = 0; j < i % 7; j++) stream[streamSize++] = (uint8_t) i;
+    }
+    CHECK_EQ(accessorOpenWritingMemory(&a, 0, 0), accessorOk);
+    CHECK_EQ(accessorOpenRecordIndex(&r, a, TEST_RECORD_INTERVAL, testRecordLength, &callCount), accessorInvalidParameter);
+    CHECK_EQ(accessorClose(&a), accessorOk);
+    CHECK_EQ(accessorOpenReadingMemory(&a, stream, streamSize, accessorDontFreeOnClose, 0, ACCESSOR_UNTIL_END), accessorOk);
+
+    CHECK_EQ(accessorOpenRecordIndex(&r, a, 0, testRecordLength, &callCount), accessorInvalidParameter);
+    CHECK_EQ(accessorOpenRecordIndex(&r, a, TEST_RECORD_INTERVAL, testRecordLength, &callCount), accessorOk);
+    CHECK_EQ(accessorClose(&a), accessorOk);        // the record index keeps it alive
+    CHECK_EQ(callCount, 0);
+
+    CHECK_EQ(accessorRecordIndexGetRecord(r, TEST_RECORD_COUNT / 2, &offset, &size), accessorOk);
+    CHECK_EQ(offset, offsets[TEST_RECORD_COUNT / 2]);
+    CHECK_EQ(size, 1 + (TEST_RECORD_COUNT / 2) % 7);
+    CHECK_EQ(callCount, TEST_RECORD_COUNT / 2 + 1);
+
+    // random access to parsed records parses at most interval records
+    for (size_t i = 0; i < 1000; i++)
+    {
+        size_t index = (size_t) random() % (TEST_RECORD_COUNT / 2);
+
+        callCount = 0;
+        CHECK_EQ(accessorRecordIndexGetRecord(r, index, &offset, &size), accessorOk);
+        CHECK_EQ(offset, offsets[index]);
+        CHECK_EQ(size, 1 + index % 7);
+        CHECK_EQ(callCount <= TEST_RECORD_INTERVAL, 1);
+    }
+
+    CHECK_EQ(accessorOpenReadingRecord(&b, r, TEST_RECORD_COUNT - 1), accessorOk);
+    CHECK_EQ(accessorSize(b), 1 + (TEST_RECORD_COUNT - 1) % 7);
+    CHECK_EQ(accessorSeek(b, 1, SEEK_SET), accessorOk);
+    CHECK_EQ(accessorReadUInt8(b, &u8), accessorOk);
+    CHECK_EQ(u8, (uint8_t) (TEST_RECORD_COUNT - 1));
+    CHECK_EQ(accessorClose(&b), accessorOk);
+
+    CHECK_EQ(accessorRecordIndexGetRecord(r, TEST_RECORD_COUNT, &offset, &size), accessorBeyondEnd);
+    CHECK_EQ(accessorRecordIndexCount(r, &count), accessorOk);
+    CHECK_EQ(count, TEST_RECORD_COUNT);
+    CHECK_EQ(accessorCloseRecordIndex(&r), accessorOk);
+    CHECK_EQ(r, ACCESSOR_INIT);
+
+    // a truncated last record
+    CHECK_EQ(accessorOpenReadingMemory(&a, "\x01\x00\x05\x00", 4, accessorDontFreeOnClose, 0, ACCESSOR_UNTIL_END), accessorOk);
+    CHECK_EQ(accessorOpenRecordIndex(&r, a, 1, testRecordLength, &callCount), accessorOk);
+    CHECK_EQ(accessorRecordIndexGetRecord(r, 0, &offset, &size), accessorOk);
+    CHECK_EQ(size, 2);
+    CHECK_EQ(accessorRecordIndexGetRecord(r, 1, &offset, &size), accessorBeyondEnd);
+    CHECK_EQ(accessorRecordIndexCount(r, &count), accessorBeyondEnd);
+    CHECK_EQ(accessorCloseRecordIndex(&r), accessorOk);
+    CHECK_EQ(accessorClose(&a), accessorOk);
+
+    // whatever recordLength does to record, the next call gets a fresh one
+    CHECK_EQ(accessorOpenReadingMemory(&a, stream, streamSize, accessorDontFreeOnClose, 0, ACCESSOR_UNTIL_END), accessorOk);
+    CHECK_EQ(accessorSetCurrentEndianness(a, accessorBig), accessorOk);
+    callCount = 0;
+    CHECK_EQ(accessorOpenRecordIndex(&r, a, TEST_RECORD_INTERVAL, testDirtyRecordLength, &callCount), accessorOk);
+    CHECK_EQ(accessorRecordIndexGetRecord(r, 100, &offset, &size), accessorOk);
+    CHECK_EQ(offset, offsets[100]);
+    CHECK_EQ(callCount, 101);
+    CHECK_EQ(accessorCloseRecordIndex(&r), accessorOk);
+    CHECK_EQ(accessorClose(&a), accessorOk);
+}
+
+
+
+static accessorStatus testOpenCorruptedCatalog(accessor_t * a, const uint8_t * section, size_t size)
+{
+    accessorIndex_t * x = ACCESSOR_INIT;
+    accessorCatalog_t * c = ACCESSOR_INIT;
+    accessorStatus status;
+
+
+    CHECK_EQ(accessorOpenWritingIndex(&x, a, accessorIndexOptionNone), accessorOk);
+    CHECK_EQ(accessorIndexAddSection(x, 1, section, size), accessorOk);
+    status = accessorOpenIndexCatalog(&c, x, 1, a);
+    if (status == accessorOk)
+        CHECK_EQ(accessorCloseCatalog(&c), accessorOk);
+    CHECK_EQ(accessorCloseIndex(&x), accessorOk);
+
+    return status;
+}
+
+
+
+void testIndex(void)
+{
+#define TEST_INDEX_COUNT    1000
+#define TEST_INDEX_TAG_OFFSETS  1
+#define TEST_INDEX_TAG_CATALOG  2
+#define TEST_INDEX_TAG_MORE     3
+#define TEST_INDEX_TAG_NONE     4
+    accessor_t * a = ACCESSOR_INIT;
+    accessor_t * b = ACCESSOR_INIT;
+    accessorCatalog_t * c = ACCESSOR_INIT;
+    accessorIndex_t * x = ACCESSOR_INIT;
+    char dirPath[256] = "//tmp/accessorTest.XXXXXXXX";
+    char * sourceName = "source.bin";
+    char * indexName = "source.index";
+    char * fullPath;
+    uint8_t data[TEST_INDEX_COUNT];
+    uint32_t offsets[TEST_INDEX_COUNT];
+    char name[32];
+    const void * ptr;
+    const void * entryName;
+    size_t nameLength;
+    size_t offset;
+    size_t size;
+    size_t first;
+    size_t count;
+    uint8_t * corrupted;
+    uint8_t * slots;
+    uint64_t slotCount;
+    uint32_t u32;
+
+
+    for (size_t i = 0; i < TEST_INDEX_COUNT; i++) data[i] = (uint8_t) random();
+    for (size_t i = 0; i < TEST_INDEX_COUNT; i++) offsets[i] = (uint32_t) random();
+
+    mkdtemp(dirPath);
+    CHECK_EQ(accessorOpenWritingFile(&a, dirPath, sourceName, accessorPathOptionNone, 0666, 0, 0), accessorOk);
+    CHECK_EQ(accessorWriteBytes(a, data, sizeof(data)), accessorOk);
+    CHECK_EQ(accessorClose(&a), accessorOk);
+
+    // build and save an index
+    CHECK_EQ(accessorOpenReadingFile(&a, dirPath, sourceName, accessorPathOptionNone, 0, ACCESSOR_UNTIL_END), accessorOk);
+    CHECK_EQ(accessorOpenCatalog(&c, a, 0), accessorOk);
+    for (size_t i = 0; i < TEST_INDEX_COUNT; i++)
+    {
+        snprintf(name, sizeof(name), "entry%zu", i);
+        CHECK_EQ(accessorCatalogAddEntry(c, name, strlen(name), i, 1), accessorOk);
+    }
+    CHECK_EQ(accessorCatalogSort(c), accessorOk);
+    CHECK_EQ(accessorOpenWritingIndex(&x, a, accessorIndexOptionNone), accessorOk);
+    CHECK_EQ(accessorIndexAddSection(x, TEST_INDEX_TAG_OFFSETS, offsets, 3), accessorOk);
+    CHECK_EQ(accessorIndexAddCatalog(x, TEST_INDEX_TAG_CATALOG, c), accessorOk);
+    CHECK_EQ(accessorWriteIndexToFile(x, dirPath, indexName, accessorPathOptionNone, 0666), accessorOk);
+    CHECK_EQ(accessorIndexAddSection(x, TEST_INDEX_TAG_MORE, offsets, sizeof(offsets)), accessorOk);        // index can still be modified
+    CHECK_EQ(accessorWriteIndexToFile(x, dirPath, indexName, accessorPathOptionNone, 0666), accessorOk);
+    CHECK_EQ(accessorCloseIndex(&x), accessorOk);
+    CHECK_EQ(x, ACCESSOR_INIT);
+    CHECK_EQ(accessorCloseCatalog(&c), accessorOk);
+
+    // reopen it
+    CHECK_EQ(accessorOpenReadingIndex(&x, a, dirPath, indexName, accessorPathOptionNone, accessorIndexOptionNone), accessorOk);
+    CHECK_EQ(accessorIndexGetSection(x, TEST_INDEX_TAG_OFFSETS, &ptr, &size), accessorOk);
+    CHECK_EQ(size, 3);
+    CHECK_EQ(memcmp(ptr, offsets, size), 0);
+    CHECK_EQ(accessorIndexGetSection(x, TEST_INDEX_TAG_MORE, &ptr, &size), accessorOk);
+    CHECK_EQ(size, sizeof(offsets));
+    CHECK_EQ(memcmp(ptr, offsets, size), 0);
+    CHECK_EQ(accessorIndexGetSection(x, TEST_INDEX_TAG_NONE, &ptr, &size), accessorNotFound);
+    CHECK_EQ(accessorOpenIndexCatalog(&c, x, TEST_INDEX_TAG_OFFSETS, a), accessorInvalidReadData);
+    CHECK_EQ(accessorOpenIndexCatalog(&c, x, TEST_INDEX_TAG_CATALOG, a), accessorOk);
+    CHECK_EQ(accessorCatalogEntryCount(c), TEST_INDEX_COUNT);
+    for (size_t i = 0; i < TEST_INDEX_COUNT; i++)
+    {
+        snprintf(name, sizeof(name), "entry%zu", i);
+        CHECK_EQ(accessorCatalogFindEntry(c, name, strlen(name), &offset, &size), accessorOk);
+        CHECK_EQ(offset, i);
+        CHECK_EQ(size, 1);
+    }
+    CHECK_EQ(accessorCatalogFindPrefix(c, "entry99", 7, &first, &count), accessorOk);
+    CHECK_EQ(count, 11);
+    CHECK_EQ(accessorCatalogGetSortedEntry(c, first, &entryName, &nameLength, NULL, NULL), accessorOk);
+    CHECK_EQ(nameLength, 7);
+    CHECK_EQ(accessorCatalogAddEntry(c, "new", 3, 0, 1), accessorReadOnlyError);
+    CHECK_EQ(accessorOpenReadingCatalogEntry(&b, c, "entry7", 6), accessorOk);
+    CHECK_EQ(accessorReadUInt8(b, data), accessorOk);
+    CHECK_EQ(accessorClose(&b), accessorOk);
+    CHECK_EQ(accessorCloseCatalog(&c), accessorOk);
+
+    // corrupted catalog tables are rejected. section layout: 32 bytes header (entry count, slot count...), 32 bytes entries, 8 bytes slots (hash, entry + 1), uint32 sorted entries
+    CHECK_EQ(accessorIndexGetSection(x, TEST_INDEX_TAG_CATALOG, &ptr, &size), accessorOk);
+    corrupted = malloc(size);
+    CHECK_NE(corrupted, NULL);
+    memcpy(corrupted, ptr, size);
+    memcpy(&slotCount, corrupted + 8, sizeof(slotCount));
+    slots = corrupted + 32 + TEST_INDEX_COUNT * 32;
+    CHECK_EQ(testOpenCorruptedCatalog(a, corrupted, size), accessorOk);
+    for (size_t i = 0; i < slotCount; i++)
+    {
+        memcpy(&u32, slots + i * 8 + 4, sizeof(u32));
+        if (u32 != 0)
+        {
+            u32 = TEST_INDEX_COUNT + 1;                                         // entry index out of range
+            memcpy(slots + i * 8 + 4, &u32, sizeof(u32));
+            CHECK_EQ(testOpenCorruptedCatalog(a, corrupted, size), accessorInvalidReadData);
+            memcpy(corrupted, ptr, size);
+            break;
+        }
+    }
+    u32 = 1;
+    for (size_t i = 0; i < slotCount; i++)                                      // no empty slot: lookups would never end
+        memcpy(slots + i * 8 + 4, &u32, sizeof(u32));
+    CHECK_EQ(testOpenCorruptedCatalog(a, corrupted, size), accessorInvalidReadData);
+    memcpy(corrupted, ptr, size);
+    memset(corrupted + 32, 0xff, 8);                                            // first entry's name offset beyond names
+    CHECK_EQ(testOpenCorruptedCatalog(a, corrupted, size), accessorInvalidReadData);
+    memcpy(corrupted, ptr, size);
+    u32 = TEST_INDEX_COUNT;                                                     // first sorted entry out of range
+    memcpy(slots + slotCount * 8, &u32, sizeof(u32));
+    CHECK_EQ(testOpenCorruptedCatalog(a, corrupted, size), accessorInvalidReadData);
+    free(corrupted);
+    CHECK_EQ(accessorCloseIndex(&x), accessorOk);
+    CHECK_EQ(accessorOpenReadingIndex(&x, a, dirPath, sourceName, accessorPathOptionNone, accessorIndexOptionNone), accessorInvalidReadData);
+    CHECK_EQ(x, ACCESSOR_INIT);
+    CHECK_EQ(accessorClose(&a), accessorOk);
+
+    // a sub accessor has a different key
+    CHECK_EQ(accessorOpenReadingFile(&a, dirPath, sourceName, accessorPathOptionNone, 1, ACCESSOR_UNTIL_END), accessorOk);
+    CHECK_EQ(accessorOpenReadingIndex(&x, a, dirPath, indexName, accessorPathOptionNone, accessorIndexOptionNone), accessorInvalidReadData);
+    CHECK_EQ(accessorClose(&a), accessorOk);
+
+    // modifying source makes index stale
+    CHECK_EQ(accessorOpenWritingFile(&a, dirPath, sourceName, accessorPathOptionNone, 0666, 0, 0), accessorOk);
+    CHECK_EQ(accessorWriteBytes(a, data, sizeof(data) - 1), accessorOk);
+    CHECK_EQ(accessorClose(&a), accessorOk);
+    CHECK_EQ(accessorOpenReadingFile(&a, dirPath, sourceName, accessorPathOptionNone, 0, ACCESSOR_UNTIL_END), accessorOk);
+    CHECK_EQ(accessorOpenReadingIndex(&x, a, dirPath, indexName, accessorPathOptionNone, accessorIndexOptionNone), accessorInvalidReadData);
+    CHECK_EQ(accessorClose(&a), accessorOk);
+
+    // memory sources need a content hash
+    CHECK_EQ(accessorOpenReadingMemory(&a, data, sizeof(data), accessorDontFreeOnClose, 0, ACCESSOR_UNTIL_END), accessorOk);
+    CHECK_EQ(accessorOpenWritingIndex(&x, a, accessorIndexOptionNone), accessorInvalidParameter);
+    CHECK_EQ(accessorOpenWritingIndex(&x, a, accessorIndexOptionHashContent), accessorOk);
+    CHECK_EQ(accessorIndexAddSection(x, TEST_INDEX_TAG_OFFSETS, offsets, sizeof(offsets)), accessorOk);
+    CHECK_EQ(accessorWriteIndexToFile(x, dirPath, indexName, accessorPathOptionNone, 0666), accessorOk);
+    CHECK_EQ(accessorCloseIndex(&x), accessorOk);
+    CHECK_EQ(accessorOpenReadingIndex(&x, a, dirPath, indexName, accessorPathOptionNone, accessorIndexOptionNone), accessorOk);
+    CHECK_EQ(accessorCloseIndex(&x), accessorOk);
+    data[TEST_INDEX_COUNT / 2] ^= 1;
+    CHECK_EQ(accessorOpenReadingIndex(&x, a, dirPath, indexName, accessorPathOptionNone, accessorIndexOptionNone), accessorInvalidReadData);
+    CHECK_EQ(accessorClose(&a), accessorOk);
+
+    CHECK_EQ(accessorBuildPath(&fullPath, dirPath, sourceName, accessorPathOptionNone, 0), accessorOk);
+    CHECK_EQ(unlink(fullPath), 0);
+    free(fullPath);
+    CHECK_EQ(accessorBuildPath(&fullPath, dirPath, indexName, accessorPathOptionNone, 0), accessorOk);
+    CHECK_EQ(unlink(fullPath), 0);
+    free(fullPath);
+    CHECK_EQ(rmdir(dirPath), 0);
+}
+
+
+
+void testCatalog(void)
+{
+#define TEST_CATALOG_COUNT  10000
+    accessor_t * a = ACCESSOR_INIT;
+    accessor_t * b = ACCESSOR_INIT;
+    accessorCatalog_t * c = ACCESSOR_INIT;
+    uint8_t data[TEST_CATALOG_COUNT];
+    char name[32];
+    const void * entryName;
+    size_t nameLength;
+    size_t offset;
+    size_t size;
+    size_t first;
+    size_t count;
+    size_t baseline;
+    size_t unsortedInUse;
+    accessorMemoryBudget budget;
+    uint8_t u8;
+
+
+    for (size_t i = 0; i < TEST_CATALOG_COUNT; i++) data[i] = (uint8_t) random();
+    accessorGetMemoryBudget(&budget);
+    baseline = budget.inUse;
+
+    CHECK_EQ(accessorOpenReadingMemory(&a, data, sizeof(data), accessorDontFreeOnClose, 0, ACCESSOR_UNTIL_END), accessorOk);
+    CHECK_EQ(accessorOpenCatalog(&c, a, 0), accessorOk);
+
+    for (size_t i = 0; i < TEST_CATALOG_COUNT; i++)
+    {
+        snprintf(name, sizeof(name), "name%zu", i);
+        CHECK_EQ(accessorCatalogAddEntry(c, name, strlen(name), i, TEST_CATALOG_COUNT - i), accessorOk);
+    }
+    CHECK_EQ(accessorCatalogAddEntry(c, "beyond", 6, 1, TEST_CATALOG_COUNT), accessorBeyondEnd);
+    CHECK_EQ(accessorCatalogAddEntry(c, "name0", 5, 0, 1), accessorOk);              // replace existing entry
+    CHECK_EQ(accessorCatalogEntryCount(c), TEST_CATALOG_COUNT);
+
+    // close base accessor: the catalog keeps it alive
+    CHECK_EQ(accessorClose(&a), accessorOk);
+
+    for (size_t i = 0; i < TEST_CATALOG_COUNT; i++)
+    {
+        snprintf(name, sizeof(name), "name%zu", i);
+        CHECK_EQ(accessorCatalogFindEntry(c, name, strlen(name), &offset, &size), accessorOk);
+        CHECK_EQ(offset, i);
+        CHECK_EQ(size, i == 0 ? 1 : TEST_CATALOG_COUNT - i);
+    }
+    CHECK_EQ(accessorCatalogFindEntry(c, "name", 4, &offset, &size), accessorNotFound);
+    CHECK_EQ(accessorCatalogFindEntry(c, "name00", 6, NULL, NULL), accessorNotFound);
+
+    CHECK_EQ(accessorOpenReadingCatalogEntry(&b, c, "name42", 6), accessorOk);
+    CHECK_EQ(accessorSize(b), TEST_CATALOG_COUNT - 42);
+    CHECK_EQ(accessorReadUInt8(b, &u8), accessorOk);
+    CHECK_EQ(u8, data[42]);
+    CHECK_EQ(accessorClose(&b), accessorOk);
+    CHECK_EQ(accessorOpenReadingCatalogEntry(&b, c, "name-1", 6), accessorNotFound);
+
+    CHECK_EQ(accessorCatalogGetSortedEntry(c, 0, &entryName, &nameLength, NULL, NULL), accessorInvalidParameter);
+    accessorGetMemoryBudget(&budget);
+    unsortedInUse = budget.inUse;
+    CHECK_EQ(accessorCatalogFindPrefix(c, "name1", 5, &first, &count), accessorOk);
+    accessorGetMemoryBudget(&budget);
+    CHECK_EQ(budget.inUse, unsortedInUse + TEST_CATALOG_COUNT * sizeof(uint32_t));    // sorted entries are charged, the merge buffer is released
+    CHECK_EQ(count, 1 + 10 + 100 + 1000);
+    for (size_t i = first; i < first + count; i++)
+    {
+        CHECK_EQ(accessorCatalogGetSortedEntry(c, i, &entryName, &nameLength, NULL, NULL), accessorOk);
+        CHECK_EQ(memcmp(entryName, "name1", 5), 0);
+    }
+    CHECK_EQ(accessorCatalogGetSortedEntry(c, first - 1, &entryName, &nameLength, NULL, NULL), accessorOk);
+    CHECK_NE(memcmp(entryName, "name1", 5), 0);
+    CHECK_EQ(accessorCatalogGetSortedEntry(c, first + count, &entryName, &nameLength, NULL, NULL), accessorOk);
+    CHECK_NE(memcmp(entryName, "name1", 5), 0);
+    CHECK_EQ(accessorCatalogFindPrefix(c, "", 0, &first, &count), accessorOk);
+    CHECK_EQ(count, TEST_CATALOG_COUNT);
+    CHECK_EQ(accessorCatalogFindPrefix(c, "name99999", 9, &first, &count), accessorOk);
+    CHECK_EQ(count, 0);
+
+    CHECK_EQ(accessorCatalogGetEntry(c, TEST_CATALOG_COUNT - 1, &entryName, &nameLength, &offset, &size), accessorOk);
+    CHECK_EQ(nameLength, 8);
+    CHECK_EQ(memcmp(entryName, "name9999", nameLength), 0);
+    CHECK_EQ(accessorCatalogGetEntry(c, TEST_CATALOG_COUNT, &entryName, &nameLength, &offset, &size), accessorBeyondEnd);
+
+    CHECK_EQ(accessorCloseCatalog(&c), accessorOk);
+    CHECK_EQ(c, ACCESSOR_INIT);
+    accessorGetMemoryBudget(&budget);
+    CHECK_EQ(budget.inUse, baseline);
+}
+
+
+
+void testRelocations(void)
+{
+#define TEST_RELOCATIONS_COUNT  256
+    accessor_t * a = ACCESSOR_INIT;
+    accessor_t * r = ACCESSOR_INIT;
+    uint32_t fields32[TEST_RELOCATIONS_COUNT];
+    uint64_t fields64[TEST_RELOCATIONS_COUNT];
+    uint32_t u32;
+    uint64_t u64;
+    uint64_t base;
+
+
+    for (size_t i = 0; i < TEST_RELOCATIONS_COUNT; i++)
+    {
+        fields32[i] = (uint32_t) random();
+        fields64[i] = (uint64_t) random() << 32 | (uint64_t) random();
+    }
+    base = (uint64_t) random() << 32 | (uint64_t) random();
+
+    for (int e = 0; e < ACCESSOR_ENDIANNESS_COUNT; e++)
+    {
+        CHECK_EQ(accessorOpenWritingMemory(&a, 0, 0), accessorOk);
+        CHECK_EQ(accessorWriteEndianUInt32Array(a, fields32, TEST_RELOCATIONS_COUNT, endianness[e]), accessorOk);
+        CHECK_EQ(accessorWriteEndianUInt64Array(a, fields64, TEST_RELOCATIONS_COUNT, endianness[e]), accessorOk);
+
+        // relocation table: a sorted run on the first half of 32 bits fields, then every odd 32 bits field in decreasing order
+        CHECK_EQ(accessorOpenWritingMemory(&r, 0, 0), accessorOk);
+        CHECK_EQ(accessorSetCurrentEndianness(r, endianness[(e + 1) % ACCESSOR_ENDIANNESS_COUNT]), accessorOk);
+        for (size_t i = 0; i < TEST_RELOCATIONS_COUNT / 2; i++)
+            CHECK_EQ(accessorWriteUInt32(r, (uint32_t) (i * 4)), accessorOk);
+        for (size_t i = TEST_RELOCATIONS_COUNT - 1; i >= TEST_RELOCATIONS_COUNT / 2; i -= 2)
+            CHECK_EQ(accessorWriteUInt32(r, (uint32_t) (i * 4)), accessorOk);
+        CHECK_EQ(accessorSeek(r, 0, SEEK_SET), accessorOk);
+
+        CHECK_EQ(accessorApplyRelocations(a, r, TEST_RELOCATIONS_COUNT / 2 + TEST_RELOCATIONS_COUNT / 4, 4, 4, endianness[e], base), accessorOk);
+        CHECK_EQ(accessorAvailableBytesCount(r), 0);
+        CHECK_EQ(accessorCursor(a), accessorSize(a));
+
+        // 64 bits fields, using 64 bits offsets, the last one being out of window: nothing must be relocated
+        CHECK_EQ(accessorSeek(r, 0, SEEK_SET), accessorOk);
+        CHECK_EQ(accessorTruncate(r), accessorOk);
+        for (size_t i = 0; i < TEST_RELOCATIONS_COUNT; i++)
+            CHECK_EQ(accessorWriteUInt64(r, TEST_RELOCATIONS_COUNT * 4 + i * 8), accessorOk);
+        CHECK_EQ(accessorWriteUInt64(r, TEST_RELOCATIONS_COUNT * 12 - 7), accessorOk);
+        CHECK_EQ(accessorSeek(r, 0, SEEK_SET), accessorOk);
+        CHECK_EQ(accessorApplyRelocations(a, r, TEST_RELOCATIONS_COUNT + 1, 8, 8, endianness[e], base), accessorBeyondEnd);
+        CHECK_EQ(accessorCursor(r), 0);
+        CHECK_EQ(accessorApplyRelocations(a, r, TEST_RELOCATIONS_COUNT, 8, 8, endianness[e], base), accessorOk);
+
+        CHECK_EQ(accessorSeek(a, 0, SEEK_SET), accessorOk);
+        for (size_t i = 0; i < TEST_RELOCATIONS_COUNT; i++)
+        {
+            CHECK_EQ(accessorReadEndianUInt32(a, &u32, endianness[e]), accessorOk);
+            CHECK_EQ(u32, i < TEST_RELOCATIONS_COUNT / 2 || i % 2 ? fields32[i] + (uint32_t) base : fields32[i]);
+        }
+        for (size_t i = 0; i < TEST_RELOCATIONS_COUNT; i++)
+        {
+            CHECK_EQ(accessorReadEndianUInt64(a, &u64, endianness[e]), accessorOk);
+            CHECK_EQ(u64, fields64[i] + base);
+        }
+
+        CHECK_EQ(accessorSeek(r, 0, SEEK_SET), accessorOk);
+        CHECK_EQ(accessorApplyRelocations(r, a, 1, 4, 3, endianness[e], base), accessorInvalidParameter);
+        CHECK_EQ(accessorClose(&a), accessorOk);
+        CHECK_EQ(accessorOpenReadingMemory(&a, fields32, sizeof(fields32), accessorDontFreeOnClose, 0, ACCESSOR_UNTIL_END), accessorOk);
+        CHECK_EQ(accessorApplyRelocations(a, r, 1, 4, 4, endianness[e], base), accessorReadOnlyError);
+
+        CHECK_EQ(accessorClose(&r), accessorOk);
+        CHECK_EQ(accessorClose(&a), accessorOk);
+    }
+}
+
+
+
 void testLimits(void)
 {
 #define TEST_LIMITS_SIZE 65536
@@ -0,0 +1,452 @@
+// Replay of "accessor" access traces against a file, to compare I/O strategies on recorded access patterns
+//
+// Traces are recorded by accessors of a library compiled with ACCESSOR_TRACING, see accessorOpenTrace()
+// Each traced read is re-issued against --file with one of these backends:
+//  mmap:   file mapped by accessorOpenReadingFile(), with optional madvise() advice, and madvise(MADV_WILLNEED) --prefetch records ahead
+//  read:   file read in memory by accessorOpenReadingFile()
+//  cache:  file read by pread() through a direct mapped cache of --cache-blocks blocks of --block-size bytes,
+//          with optional posix_fadvise(POSIX_FADV_WILLNEED) --prefetch records ahead
+// Reported figures are the median replay time (open included), traced MB/s and reads/s, page faults and cache hit rate
+//
+// usage: tracereplay --trace path --file path [--backend mmap|read|cache|all] [--madvise normal|random|sequential|willneed] [--prefetch n]
+//                    [--block-size n] [--cache-blocks n] [--cold] [--repetitions n] [--cpu n|-1] [--json file|-]
+
+
+#include "accessor.h"
+#include "benchharness.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>         // for pread, sysconf
+#include <fcntl.h>          // for open, posix_fadvise
+#include <sys/mman.h>       // for madvise
+#include <sys/stat.h>       // for fstat
+#include <sys/resource.h>   // for getrusage
+
+
+#define REPLAY_DEFAULT_REPETITIONS  ((size_t) 5)
+#define REPLAY_MAX_REPETITIONS      ((size_t) 100)
+#define REPLAY_DEFAULT_BLOCK_SIZE   ((size_t) 64 * 1024)
+#define REPLAY_DEFAULT_CACHE_BLOCKS ((size_t) 256)
+
+#if defined(POSIX_FADV_DONTNEED)
+#define REPLAY_HAS_FADVISE          1
+#endif
+
+
+typedef enum
+{
+    replayMmap = 0,
+    replayRead,
+    replayCache,
+    replayBackendCount,
+} replayBackend;
+
+typedef struct
+{
+    uint64_t elapsedNs;
+    uint64_t cacheHits;
+    uint64_t cacheMisses;
+} replaySample;
+
+// direct mapped block cache
+typedef struct
+{
+    int file;
+    uint64_t fileSize;
+    uint8_t * blocks;
+    uint64_t * tags;                // block index + 1 of cached blocks, 0 if empty
+    uint64_t hits;
+    uint64_t misses;
+} replayCacheState;
+
+
+// global variables
+static const char * replayTracePath = NULL;
+static const char * replayFilePath = NULL;
+static int replayBackends[replayBackendCount] = { 1, 1, 1 };
+static int replayAdvice = -1;                               // madvise() advice, -1 for none
+static const char * replayAdviceName = "none";
+static size_t replayPrefetch = 0;                           // records ahead, 0 for no prefetch
+static size_t replayBlockSize = REPLAY_DEFAULT_BLOCK_SIZE;
+static size_t replayCacheBlocks = REPLAY_DEFAULT_CACHE_BLOCKS;
+static int replayCold = 0;
+static size_t replayRepetitions = REPLAY_DEFAULT_REPETITIONS;
+static int replayCpu = -2;                                  // -2: current cpu, -1: no pinning
+static FILE * replayJson = NULL;
+static accessorTraceRecord * replayRecords = NULL;
+static size_t replayRecordCount = 0;
+static uint64_t replayTracedBytes = 0;
+static volatile uint64_t replaySink;                        // read data is accumulated here, so that compilers can't discard reads
+
+static const char * replayBackendNames[replayBackendCount] = { "mmap", "read", "cache" };
+
+// prototypes
+void replayLoadTrace(uint64_t fileSize);
+void replayDropCache(void);
+uint64_t replaySum(const uint8_t * ptr, size_t size);
+replaySample replayAccessor(replayBackend backend);
+replaySample replayBlockCache(void);
+const uint8_t * replayCacheBlock(replayCacheState * c, uint64_t blockIndex);
+void replayMeasure(replayBackend backend);
+
+
+
+int main(int argc, char *argv[])
+{
+    struct stat st;
+    int selected = 0;
+
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (i + 1 < argc && strcmp(argv[i], "--trace") == 0)
+            replayTracePath = argv[++i];
+        else if (i + 1 < argc && strcmp(argv[i], "--file") == 0)
+            replayFilePath = argv[++i];
+        else if (i + 1 < argc && strcmp(argv[i], "--backend") == 0)
+        {
+            i++;
+            for (int b = 0; b < replayBackendCount; b++)
+            {
+                replayBackends[b] = strcmp(argv[i], "all") == 0 || strcmp(argv[i], replayBackendNames[b]) == 0;
+                selected += replayBackends[b];
+            }
+            if (selected == 0)
+            {
+                fprintf(stderr, "unknown backend %s\n", argv[i]);
+                return 1;
+            }
+        }
+        else if (i + 1 < argc && strcmp(argv[i], "--madvise") == 0)
+        {
+            replayAdviceName = argv[++i];
+            if (strcmp(replayAdviceName, "normal") == 0)
+                replayAdvice = MADV_NORMAL;
+            else if (strcmp(replayAdviceName, "random") == 0)
+                replayAdvice = MADV_RANDOM;
+            else if (strcmp(replayAdviceName, "sequential") == 0)
+                replayAdvice = MADV_SEQUENTIAL;
+            else if (strcmp(replayAdviceName, "willneed") == 0)
+                replayAdvice = MADV_WILLNEED;
+            else
+            {
+                fprintf(stderr, "unknown advice %s\n", replayAdviceName);
+                return 1;
+            }
+        }
+        else if (i + 1 < argc && strcmp(argv[i], "--prefetch") == 0)
+            replayPrefetch = strtoul(argv[++i], NULL, 0);
+        else if (i + 1 < argc && strcmp(argv[i], "--block-size") == 0)
+            replayBlockSize = strtoul(argv[++i], NULL, 0);
+        else if (i + 1 < argc && strcmp(argv[i], "--cache-blocks") == 0)
+            replayCacheBlocks = strtoul(argv[++i], NULL, 0);
+        else if (strcmp(argv[i], "--cold") == 0)
+            replayCold = 1;
+        else if (i + 1 < argc && strcmp(argv[i], "--repetitions") == 0)
+            replayRepetitions = strtoul(argv[++i], NULL, 0);
+        else if (i + 1 < argc && strcmp(argv[i], "--cpu") == 0)
+            replayCpu = atoi(argv[++i]);
+        else if (i + 1 < argc && strcmp(argv[i], "--json") == 0)
+        {
+            i++;
+            replayJson = strcmp(argv[i], "-") == 0 ? stdout : fopen(argv[i], "w");
+            if (replayJson == NULL)
+            {
+                perror(argv[i]);
+                return 1;
+            }
+        }
+        else
+            replayTracePath = NULL;     // usage
+    }
+
+    if (replayTracePath == NULL || replayFilePath == NULL || replayBlockSize == 0 || replayCacheBlocks == 0)
+    {
+        fprintf(stderr, "usage: %s --trace path --file path [--backend mmap|read|cache|all] [--madvise normal|random|sequential|willneed] [--prefetch n]\n", argv[0]);
+        fprintf(stderr, "       [--block-size n] [--cache-blocks n] [--cold] [--repetitions n] [--cpu n|-1] [--json file|-]\n");
+        return 1;
+    }
+
+    if (replayRepetitions < 1)
+        replayRepetitions = 1;
+    if (replayRepetitions > REPLAY_MAX_REPETITIONS)
+        replayRepetitions = REPLAY_MAX_REPETITIONS;
+
+    if (stat(replayFilePath, &st) != 0)
+    {
+        perror(replayFilePath);
+        return 1;
+    }
+    replayLoadTrace((uint64_t) st.st_size);
+
+    benchPin(replayCpu);
+#ifndef REPLAY_HAS_FADVISE
+    if (replayCold)
+        printf("--cold ignored: posix_fadvise(POSIX_FADV_DONTNEED) unsupported on this platform\n");
+#endif
+    printf("accessor build %u, %zu reads of %llu bytes, %zu repetitions, %s cache, madvise %s, prefetch %zu reads ahead\n", accessorBuildNumber(), replayRecordCount, (unsigned long long) replayTracedBytes, replayRepetitions, replayCold ? "cold" : "warm", replayAdviceName, replayPrefetch);
+    printf("%-8s %12s %10s %12s %12s %12s %10s\n", "backend", "median ms", "MB/s", "reads/s", "minor flt", "major flt", "hit rate");
+
+    for (int b = 0; b < replayBackendCount; b++)
+        if (replayBackends[b])
+            replayMeasure((replayBackend) b);
+
+    free(replayRecords);
+    if (replayJson != NULL && replayJson != stdout)
+        fclose(replayJson);
+
+    return 0;
+}
+
+
+
+// records beyond end of file are dropped, the trace may come from a larger version of the file
+void replayLoadTrace(uint64_t fileSize)
+{
+    accessor_t * t = ACCESSOR_INIT;
+    accessorTraceRecord record;
+    uint64_t previousEnd = 0;
+    size_t allocation = 0;
+    size_t droppedCount = 0;
+    accessorStatus status;
+
+
+    BENCH_CHECK(accessorOpenReadingFile(&t, NULL, replayTracePath, accessorPathOptionNone, 0, ACCESSOR_UNTIL_END));
+    if (accessorReadTraceHeader(t) != accessorOk)
+    {
+        fprintf(stderr, "%s: not a supported trace file\n", replayTracePath);
+        exit(1);
+    }
+
+    while ((status = accessorReadTraceRecord(t, &record, &previousEnd)) == accessorOk)
+    {
+        if (record.rootOffset > fileSize || record.size > fileSize - record.rootOffset)
+        {
+            droppedCount++;
+            continue;
+        }
+        if (replayRecordCount == allocation)
+        {
+            allocation = allocation < 1024 ? 1024 : 2 * allocation;
+            replayRecords = realloc(replayRecords, allocation * sizeof(*replayRecords));
+            if (replayRecords == NULL)
+                benchFailure(__FILE__, __LINE__);
+        }
+        replayRecords[replayRecordCount++] = record;
+        replayTracedBytes += record.size;
+    }
+    if (status != accessorBeyondEnd)
+        fprintf(stderr, "%s: truncated or invalid record after %zu records, ignored\n", replayTracePath, replayRecordCount + droppedCount);
+    if (droppedCount > 0)
+        printf("%zu reads beyond end of %s dropped\n", droppedCount, replayFilePath);
+
+    BENCH_CHECK(accessorClose(&t));
+}
+
+
+
+void replayDropCache(void)
+{
+#ifdef REPLAY_HAS_FADVISE
+    int file;
+
+
+    file = open(replayFilePath, O_RDONLY);
+    if (file == -1)
+        benchFailure(__FILE__, __LINE__);
+    posix_fadvise(file, 0, 0, POSIX_FADV_DONTNEED);
+    close(file);
+#endif
+}
+
+
+
+uint64_t replaySum(const uint8_t * ptr, size_t size)
+{
+    uint64_t sum = 0;
+
+
+    for (size_t i = 0; i < size; i++)
+        sum += ptr[i];
+
+    return sum;
+}
+
+
+
+// mmap and read backends differ by accessorSetMmapMinFileSize()
+replaySample replayAccessor(replayBackend backend)
+{
+    replaySample sample = { 0, 0, 0 };
+    accessor_t * a = ACCESSOR_INIT;
+    const void * ptr;
+    const uint8_t * base;
+    uintptr_t pageMask;
+    uint64_t start;
+    uint64_t sum = 0;
+    const accessorTraceRecord * ahead;
+
+
+    pageMask = (uintptr_t) sysconf(_SC_PAGESIZE) - 1;
+    accessorSetMmapMinFileSize(backend == replayMmap ? 0 : SIZE_MAX);
+
+    start = benchNow();
+    BENCH_CHECK(accessorOpenReadingFile(&a, NULL, replayFilePath, accessorPathOptionNone, 0, ACCESSOR_UNTIL_END));
+    accessorLookAheadAvailableBytes(a, (const void **) &base);
+    if (backend == replayMmap && replayAdvice != -1 && accessorSize(a) > 0)
+        madvise((void *) ((uintptr_t) base & ~pageMask), accessorSize(a) + ((uintptr_t) base & pageMask), replayAdvice);
+
+    for (size_t i = 0; i < replayRecordCount; i++)
+    {
+        if (backend == replayMmap && replayPrefetch > 0 && i + replayPrefetch < replayRecordCount)
+        {
+            ahead = &replayRecords[i + replayPrefetch];
+            if (ahead->size > 0)
+                madvise((void *) ((uintptr_t) (base + ahead->rootOffset) & ~pageMask), ahead->size + ((uintptr_t) (base + ahead->rootOffset) & pageMask), MADV_WILLNEED);
+        }
+        BENCH_CHECK(accessorSeek(a, (ssize_t) replayRecords[i].rootOffset, SEEK_SET));
+        BENCH_CHECK(accessorGetPointerForBytesToRead(a, &ptr, replayRecords[i].size));
+        sum += replaySum(ptr, replayRecords[i].size);
+    }
+
+    BENCH_CHECK(accessorClose(&a));
+    sample.elapsedNs = benchNow() - start;
+    replaySink += sum;
+
+    return sample;
+}
+
+
+
+const uint8_t * replayCacheBlock(replayCacheState * c, uint64_t blockIndex)
+{
+    size_t slot = (size_t) (blockIndex % replayCacheBlocks);
+    uint8_t * block = c->blocks + slot * replayBlockSize;
+    uint64_t offset = blockIndex * replayBlockSize;
+    size_t size;
+
+
+    if (c->tags[slot] == blockIndex + 1)
+    {
+        c->hits++;
+        return block;
+    }
+
+    c->misses++;
+    size = c->fileSize - offset < replayBlockSize ? (size_t) (c->fileSize - offset) : replayBlockSize;
+    if (pread(c->file, block, size, (off_t) offset) != (ssize_t) size)
+        benchFailure(__FILE__, __LINE__);
+    c->tags[slot] = blockIndex + 1;
+
+    return block;
+}
+
+
+
+replaySample replayBlockCache(void)
+{
+    replaySample sample = { 0, 0, 0 };
+    replayCacheState c;
+    struct stat st;
+    uint64_t start;
+    uint64_t sum = 0;
+    uint64_t offset;
+    uint64_t end;
+    size_t size;
+    const uint8_t * block;
+
+
+    start = benchNow();
+    c.file = open(replayFilePath, O_RDONLY);
+    if (c.file == -1 || fstat(c.file, &st) != 0)
+        benchFailure(__FILE__, __LINE__);
+    c.fileSize = (uint64_t) st.st_size;
+    c.blocks = malloc(replayCacheBlocks * replayBlockSize);
+    c.tags = calloc(replayCacheBlocks, sizeof(*c.tags));
+    if (c.blocks == NULL || c.tags == NULL)
+        benchFailure(__FILE__, __LINE__);
+    c.hits = 0;
+    c.misses = 0;
+
+    for (size_t i = 0; i < replayRecordCount; i++)
+    {
+#ifdef REPLAY_HAS_FADVISE
+        if (replayPrefetch > 0 && i + replayPrefetch < replayRecordCount)
+            posix_fadvise(c.file, (off_t) replayRecords[i + replayPrefetch].rootOffset, (off_t) replayRecords[i + replayPrefetch].size, POSIX_FADV_WILLNEED);
+#endif
+        offset = replayRecords[i].rootOffset;
+        end = offset + replayRecords[i].size;
+        while (offset < end)
+        {
+            block = replayCacheBlock(&c, offset / replayBlockSize);
+            size = (size_t) (replayBlockSize - offset % replayBlockSize);
+            if (size > end - offset)
+                size = (size_t) (end - offset);
+            sum += replaySum(block + offset % replayBlockSize, size);
+            offset += size;
+        }
+    }
+
+    free(c.blocks);
+    free(c.tags);
+    close(c.file);
+    sample.elapsedNs = benchNow() - start;
+    sample.cacheHits = c.hits;
+    sample.cacheMisses = c.misses;
+    replaySink += sum;
+
+    return sample;
+}
+
+
+
+void replayMeasure(replayBackend backend)
+{
+    double elapsedNs[REPLAY_MAX_REPETITIONS];
+    replaySample sample;
+    struct rusage before;
+    struct rusage after;
+    long minorFaults = 0;
+    long majorFaults = 0;
+    uint64_t cacheHits = 0;
+    uint64_t cacheMisses = 0;
+    double median;
+    double mbps;
+    double readsPerSecond;
+    char hitRateText[32];
+
+
+    for (size_t i = 0; i < replayRepetitions; i++)
+    {
+        if (replayCold)
+            replayDropCache();
+        getrusage(RUSAGE_SELF, &before);
+        sample = backend == replayCache ? replayBlockCache() : replayAccessor(backend);
+        getrusage(RUSAGE_SELF, &after);
+        elapsedNs[i] = (double) sample.elapsedNs;
+        minorFaults += after.ru_minflt - before.ru_minflt;
+        majorFaults += after.ru_majflt - before.ru_majflt;
+        cacheHits += sample.cacheHits;
+        cacheMisses += sample.cacheMisses;
+    }
+
+    qsort(elapsedNs, replayRepetitions, sizeof(*elapsedNs), benchCompareDouble);
+    median = benchPercentile(elapsedNs, replayRepetitions, 50);
+    mbps = (double) replayTracedBytes * 1000 / median;         // bytes per ns are 1000 MB/s
+    readsPerSecond = (double) replayRecordCount * 1e9 / median;
+    if (backend == replayCache && cacheHits + cacheMisses > 0)
+        snprintf(hitRateText, sizeof(hitRateText), "%.4f", (double) cacheHits / (double) (cacheHits + cacheMisses));
+    else
+        snprintf(hitRateText, sizeof(hitRateText), "-");
+
+    printf("%-8s %12.3f %10.1f %12.0f %12.1f %12.1f %10s\n", replayBackendNames[backend], median / 1e6, mbps, readsPerSecond,
+           (double) minorFaults / (double) replayRepetitions, (double) majorFaults / (double) replayRepetitions, hitRateText);
+
+    if (replayJson != NULL)
+        fprintf(replayJson, "{\"backend\":\"%s\",\"build\":%u,\"reads\":%zu,\"tracedBytes\":%llu,\"repetitions\":%zu,\"cold\":%d,\"madvise\":\"%s\",\"prefetch\":%zu,\"blockSize\":%zu,\"cacheBlocks\":%zu,\"medianNs\":%.0f,\"mbps\":%.2f,\"readsPerSecond\":%.0f,\"minorFaults\":%.1f,\"majorFaults\":%.1f,\"hitRate\":%s}\n",
+                replayBackendNames[backend], accessorBuildNumber(), replayRecordCount, (unsigned long long) replayTracedBytes, replayRepetitions, replayCold, replayAdviceName, replayPrefetch, replayBlockSize, replayCacheBlocks,
+                median, mbps, readsPerSecond, (double) minorFaults / (double) replayRepetitions, (double) majorFaults / (double) replayRepetitions, backend == replayCache ? hitRateText : "null");
+}